@@ -0,0 +1,61 @@
+using BenchmarkDotNet.Attributes;
+using LibreHardwareMonitor.Hardware;
+using PCMonitorClient.Benchmarks.Fixtures;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// Per-cycle collection cost with the hardware reads taken out: the LHM
+    /// tree walk on a mocked 16-core tree vs. the resolved SensorMap, and the
+    /// process/disk samplers on fixture counter sources.
+    /// </summary>
+    [MemoryDiagnoser]
+    public class CollectionBenchmarks
+    {
+        private IHardware[] _tree;
+        private SensorMap _map;
+        private ProcessSampler _procs;
+        private DiskSampler _disks;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _tree = MockSensorTree.CreateDesktop();
+            _map = SensorMap.Discover(_tree);
+            _procs = new ProcessSampler(new FakeProcessSource());
+            _disks = new DiskSampler(new FakeDiskSource());
+            _procs.Sample();
+            _disks.Sample();
+        }
+
+        [Benchmark]
+        public SystemStats SensorTree()
+        {
+            var s = new SystemStats();
+            SensorTreeReader.ReadCpu(_tree, s);
+            SensorTreeReader.ReadRam(_tree, s);
+            SensorTreeReader.ReadGpu(_tree, s);
+            return s;
+        }
+
+        [Benchmark]
+        public SystemStats SensorMapRead()
+        {
+            var s = new SystemStats();
+            _map.ReadCpu(s);
+            _map.ReadRam(s);
+            _map.ReadGpu(s);
+            return s;
+        }
+
+        [Benchmark]
+        public string ProcessTopN() => _procs.Sample();
+
+        [Benchmark]
+        public float DiskRates()
+        {
+            _disks.Sample();
+            return _disks.Total.ReadMBps;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+using System.Globalization;
+using System.Text;
+using BenchmarkDotNet.Attributes;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// Telemetry line formatting and ASCII encoding (what SerialPort.Write
+    /// does with the string), plus handshake response parsing.
+    ///
+    /// StringFormatLegacy is the hand-written string.Format the generated
+    /// StatsFrame codec replaced; EncodeSpan is what the data loop does now.
+    /// </summary>
+    [MemoryDiagnoser]
+    public class EncoderBenchmarks
+    {
+        private const string HANDSHAKE = "SCARAB_CLIENT_OK|H:1A2B3C4D|V:2.5.0|N:desk-left";
+
+        private readonly SystemStats _stats = new SystemStats
+        {
+            CpuLoad = 37.5f, CpuTemp = 66.5f,
+            GpuLoad = 64f, GpuTemp = 58f, GpuVramUsed = 6.1f, GpuVramTotal = 16f,
+            RamUsedGb = 21.4f, RamTotalGb = 64f,
+            NetType = "LAN", NetSpeed = "2.5 Gbps", NetDown = 112.4f, NetUp = 8.2f,
+            DiskReadMBps = 128f, DiskWriteMBps = 16f, DiskReadIops = 1000f, DiskWriteIops = 240f,
+            DiskQueue = 4f, DiskLatencyMs = 0.6f
+        };
+
+        private readonly byte[] _txBuf = new byte[StatsFrame.MAX_LENGTH];
+        private readonly SystemStats _decoded = new SystemStats();
+        private byte[] _line;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            int len = _stats.EncodeTelemetry(_txBuf);
+            _line = new byte[len - 1];                      // without '\n', as the parser sees it
+            System.Array.Copy(_txBuf, _line, len - 1);
+        }
+
+        [Benchmark(Baseline = true)]
+        public byte[] StringFormatLegacy() => Encoding.ASCII.GetBytes(string.Format(CultureInfo.InvariantCulture,
+            "CPU:{0},CPUT:{1:0.0},GPU:{2},GPUT:{3:0.0},VRAM:{4:0.0}/{5:0.0},RAM:{6:0.0}/{7:0.0},NET:{8},SPEED:{9},DOWN:{10:0.0},UP:{11:0.0},DSK:{12:0.0}/{13:0.0}/{14:0}/{15:0}/{16:0.0}/{17:0.0}\n",
+            (int)_stats.CpuLoad, _stats.CpuTemp, (int)_stats.GpuLoad, _stats.GpuTemp,
+            _stats.GpuVramUsed, _stats.GpuVramTotal, _stats.RamUsedGb, _stats.RamTotalGb,
+            _stats.NetType, _stats.NetSpeed, _stats.NetDown, _stats.NetUp,
+            _stats.DiskReadMBps, _stats.DiskWriteMBps, _stats.DiskReadIops, _stats.DiskWriteIops,
+            _stats.DiskQueue, _stats.DiskLatencyMs));
+
+        [Benchmark]
+        public int EncodeSpan() => _stats.EncodeTelemetry(_txBuf);
+
+        [Benchmark]
+        public int DecodeSpan() => StatsFrame.Decode(_line, _decoded);
+
+        [Benchmark]
+        public string FormatLine() => _stats.ToTelemetryLine();
+
+        [Benchmark]
+        public byte[] FormatAndEncode() => Encoding.ASCII.GetBytes(_stats.ToTelemetryLine());
+
+        [Benchmark]
+        public HandshakeInfo ParseHandshake() => HandshakeInfo.Parse(HANDSHAKE);
+
+        [Benchmark]
+        public DeviceCaps ParseCaps() => DeviceCaps.Parse(Fixtures.LoopbackDevice.CAPS);
+    }
+}
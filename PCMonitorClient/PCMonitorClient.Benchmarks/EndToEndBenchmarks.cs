@@ -0,0 +1,60 @@
+using BenchmarkDotNet.Attributes;
+using LibreHardwareMonitor.Hardware;
+using PCMonitorClient.Benchmarks.Fixtures;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// One data loop iteration from sensor values to bytes on the wire:
+    /// tree walk, disk/process sampling, line encoding and the port write
+    /// into the in-memory device.
+    /// </summary>
+    [MemoryDiagnoser]
+    public class EndToEndBenchmarks
+    {
+        private IHardware[] _tree;
+        private DiskSampler _disks;
+        private ProcessSampler _procs;
+        private readonly LoopbackDevice _device = new LoopbackDevice();
+        private readonly object _portLock = new object();
+        private readonly byte[] _txBuf = new byte[StatsFrame.MAX_LENGTH];
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _tree = MockSensorTree.CreateDesktop();
+            _disks = new DiskSampler(new FakeDiskSource());
+            _procs = new ProcessSampler(new FakeProcessSource());
+            _disks.Sample();
+            _procs.Sample();
+        }
+
+        [Benchmark]
+        public long SampleToWire()
+        {
+            var s = new SystemStats();
+            SensorTreeReader.ReadCpu(_tree, s);
+            SensorTreeReader.ReadRam(_tree, s);
+            SensorTreeReader.ReadGpu(_tree, s);
+
+            _disks.Sample();
+            var d = _disks.Total;
+            s.DiskReadMBps = d.ReadMBps;
+            s.DiskWriteMBps = d.WriteMBps;
+            s.DiskReadIops = d.ReadIops;
+            s.DiskWriteIops = d.WriteIops;
+            s.DiskQueue = d.QueueDepth;
+            s.DiskLatencyMs = d.LatencyMs;
+
+            int len = s.EncodeTelemetry(_txBuf);
+            lock (_portLock) _device.Write(_txBuf, 0, len);
+
+            string top = _procs.Sample();
+            if (top != null)
+            {
+                lock (_portLock) _device.Write(top);
+            }
+            return _device.WireBytes;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+using System.Collections.Generic;
+
+namespace PCMonitorClient.Benchmarks.Fixtures
+{
+    /// <summary>
+    /// Process table of a busy desktop: a fixed set of PIDs whose CPU time
+    /// advances at different rates, so the top-N ranking shifts a little
+    /// every sample (like real load).
+    /// </summary>
+    public sealed class FakeProcessSource : IProcessCounterSource
+    {
+        private readonly ProcessCounterSample[] _procs;
+        private int _tick;
+
+        public FakeProcessSource(int count = 300)
+        {
+            _procs = new ProcessCounterSample[count];
+            for (int i = 0; i < count; i++)
+            {
+                _procs[i] = new ProcessCounterSample
+                {
+                    Pid = 1000 + i * 4,
+                    StartTime = i,
+                    Name = "proc" + i,
+                    CpuTime100ns = 0,
+                    MemBytes = (16L + i * 7 % 900) * 1024 * 1024
+                };
+            }
+        }
+
+        public void Read(List<ProcessCounterSample> into, System.Func<int, long, bool> knownName)
+        {
+            _tick++;
+            for (int i = 0; i < _procs.Length; i++)
+            {
+                // Every 7th process is busy, the rest idle; busy ones rotate slowly
+                long step = (i % 7 == (_tick / 10) % 7) ? 200_000 + i * 100 : i % 5;
+                _procs[i].CpuTime100ns += step;
+
+                var s = _procs[i];
+                if (knownName(s.Pid, s.StartTime)) s.Name = null;
+                into.Add(s);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Two NVMe drives with steady traffic.
+    /// </summary>
+    public sealed class FakeDiskSource : IDiskCounterSource
+    {
+        private readonly DiskCounterSample[] _disks =
+        {
+            new DiskCounterSample { Name = "PhysicalDrive0" },
+            new DiskCounterSample { Name = "PhysicalDrive1" }
+        };
+
+        public void Read(List<DiskCounterSample> into)
+        {
+            for (int i = 0; i < _disks.Length; i++)
+            {
+                _disks[i].BytesRead += 64L * 1024 * 1024;
+                _disks[i].BytesWritten += 8L * 1024 * 1024;
+                _disks[i].Reads += 500;
+                _disks[i].Writes += 120;
+                _disks[i].BusyTime100ns += 620 * 2000;
+                _disks[i].QueueDepth = 2;
+                into.Add(_disks[i]);
+            }
+        }
+    }
+}
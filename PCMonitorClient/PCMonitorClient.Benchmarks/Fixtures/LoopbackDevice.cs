@@ -0,0 +1,254 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Text;
+
+namespace PCMonitorClient.Benchmarks.Fixtures
+{
+    /// <summary>
+    /// In-memory ESP32 stand-in behind ISerialLink. Replies to the handshake,
+    /// GET_CAPS and the chunked IMG_/FW_ upload protocol synchronously (the reply is
+    /// queued before Write returns), so benchmarks measure the client side
+    /// only - no USB latency, no polling delays.
+    ///
+    /// Stats/TOP lines are accepted and counted as wire bytes.
+    ///
+    /// FW_STAGE keeps the received offset across sessions (like the real
+    /// checkpoint) while size and CRC stay the same.
+    ///
+    /// BitErrorRate > 0 turns it into a noisy link: bits of incoming DATA
+    /// lines are flipped at random (seeded, so every run sees the same
+    /// errors) and the device checks chunk CRCs like FEAT:CRC firmware.
+    /// </summary>
+    public sealed class LoopbackDevice : ISerialLink
+    {
+        public const string IDENTITY_HASH = "1A2B3C4D";
+        public const string CAPS = "CAPS:1|LINE:4096|CHUNK:2032|ENC:HEX|TELE:1|WIN:1|DISP:4x240x240|FEAT:TOP,DSK,HIST,RPC,VIEW,SPR,STAGE,ALRT,BENCH,CRC,EXPR,PROF|DIAG:GET_CAPS,GET_FW_VER,IMG_STATUS,GET_USB_STATS,GET_POSTMORTEM,GET_METRICS";
+
+        private readonly Queue<byte> _rx = new Queue<byte>(256);
+        private readonly StringBuilder _line = new StringBuilder(4096);
+        private int _expectedOffset;
+        private string _stageKey;   // "<size>:<crc>" of the image being staged, null = FW_BEGIN/IMG session
+        private Random _random = new Random(1);
+        private long _bitsToError = -1;     // Clean bits before the next flip, -1 = not drawn yet
+
+        /// <summary>Bytes the client has written (ASCII, as SerialPort encodes them).</summary>
+        public long WireBytes { get; private set; }
+
+        /// <summary>Complete lines received.</summary>
+        public long Lines { get; private set; }
+
+        /// <summary>
+        /// Probability of a flipped bit in the offset/hex/CRC fields of a DATA
+        /// line. The command prefix stays intact: the real device ignores a
+        /// garbled one, and the client's 5 s response timeout would swamp
+        /// every other cost measured here.
+        /// </summary>
+        public double BitErrorRate { get; set; }
+
+        /// <summary>Seed of the bit error pattern, applied by Reset.</summary>
+        public int Seed { get; set; } = 1;
+
+        /// <summary>DATA lines answered with a NAK.</summary>
+        public long ChunksNaked { get; private set; }
+
+        public bool IsOpen => true;
+        public int BytesToRead => _rx.Count;
+
+        public void Write(string text)
+        {
+            WireBytes += Encoding.ASCII.GetByteCount(text);
+
+            foreach (char c in text)
+            {
+                if (c == '\n')
+                {
+                    Lines++;
+                    HandleLine(_line.ToString());
+                    _line.Clear();
+                }
+                else
+                {
+                    _line.Append(c);
+                }
+            }
+        }
+
+        public void Write(byte[] buffer, int offset, int count)
+        {
+            WireBytes += count;
+
+            for (int i = offset; i < offset + count; i++)
+            {
+                if (buffer[i] == '\n')
+                {
+                    Lines++;
+                    HandleLine(_line.ToString());
+                    _line.Clear();
+                }
+                else
+                {
+                    _line.Append((char)buffer[i]);
+                }
+            }
+        }
+
+        public int ReadByte() => _rx.Count > 0 ? _rx.Dequeue() : -1;
+
+        public void DiscardInBuffer() => _rx.Clear();
+
+        public void Reset()
+        {
+            _rx.Clear();
+            _line.Clear();
+            _expectedOffset = 0;
+            _stageKey = null;
+            _random = new Random(Seed);
+            _bitsToError = -1;
+            WireBytes = 0;
+            Lines = 0;
+            ChunksNaked = 0;
+        }
+
+        private void HandleLine(string line)
+        {
+            if (line == "WHO_ARE_YOU?")
+            {
+                Reply("SCARAB_CLIENT_OK|H:" + IDENTITY_HASH + "|V:2.5.0|N:bench");
+                return;
+            }
+            if (line == "GET_CAPS")
+            {
+                Reply(CAPS);
+                return;
+            }
+
+            int sep = line.IndexOf('_');
+            if (sep <= 0) return;               // Stats / TOP line
+            string prefix = line.Substring(0, sep);
+            if (prefix != "IMG" && prefix != "FW") return;
+            string cmd = line.Substring(sep + 1);
+
+            if (cmd.StartsWith("BEGIN:", StringComparison.Ordinal))
+            {
+                _expectedOffset = 0;
+                _stageKey = null;
+                Reply(prefix + "_OK:BEGIN");
+            }
+            else if (cmd.StartsWith("STAGE:", StringComparison.Ordinal))
+            {
+                string key = cmd.Substring(6);
+                if (key != _stageKey) _expectedOffset = 0;
+                _stageKey = key;
+                Reply(prefix + "_OK:BEGIN:" + _expectedOffset);
+            }
+            else if (cmd.StartsWith("DATA:", StringComparison.Ordinal))
+            {
+                HandleData(prefix, Corrupt(cmd.Substring(5)));
+            }
+            else if (cmd.StartsWith("END:", StringComparison.Ordinal))
+            {
+                Reply(prefix + (_stageKey != null ? "_OK:STAGED" : "_OK:COMPLETE"));
+            }
+        }
+
+        /// <summary>"&lt;offset&gt;:&lt;hex&gt;[:&lt;crc32&gt;]", checked in the firmware's order.</summary>
+        private void HandleData(string prefix, string fields)
+        {
+            int colon = fields.IndexOf(':');
+            if (colon <= 0 || !int.TryParse(fields.Substring(0, colon), NumberStyles.None,
+                                            CultureInfo.InvariantCulture, out int offset))
+            {
+                Reply(prefix + "_ERR:PARSE");
+                return;
+            }
+            if (offset != _expectedOffset)
+            {
+                Reply(prefix + "_ERR:OFFSET:" + _expectedOffset);
+                return;
+            }
+
+            string payload = fields.Substring(colon + 1);
+            int crcSep = payload.IndexOf(':');
+            if (crcSep < 0)
+            {
+                if (payload.Length % 2 != 0)
+                {
+                    Reply(prefix + "_ERR:HEX");
+                    return;
+                }
+                _expectedOffset += payload.Length / 2;
+                Reply(prefix + "_OK:DATA:" + _expectedOffset);
+                return;
+            }
+
+            byte[] chunk = DecodeHex(payload.Substring(0, crcSep));
+            string crcText = payload.Substring(crcSep + 1);
+            if (chunk == null || crcText.Length != 8
+                || !uint.TryParse(crcText, NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture, out uint crc)
+                || ImageConverter.ComputeCrc32(chunk) != crc)
+            {
+                ChunksNaked++;
+                Reply(prefix + "_NAK:" + _expectedOffset);
+                return;
+            }
+
+            _expectedOffset += chunk.Length;
+            Reply(prefix + "_OK:DATA:" + _expectedOffset);
+        }
+
+        /// <summary>Flips bits of text at BitErrorRate (gaps drawn geometrically, not per bit).</summary>
+        private string Corrupt(string text)
+        {
+            if (BitErrorRate <= 0) return text;
+            if (_bitsToError < 0) _bitsToError = NextErrorGap();
+
+            char[] chars = null;
+            long bits = text.Length * 8L;
+            while (_bitsToError < bits)
+            {
+                chars = chars ?? text.ToCharArray();
+                int bit = (int)_bitsToError;
+                chars[bit >> 3] ^= (char)(1 << (bit & 7));
+                _bitsToError += NextErrorGap() + 1;
+            }
+            _bitsToError -= bits;
+            return chars == null ? text : new string(chars);
+        }
+
+        private long NextErrorGap()
+        {
+            double gap = Math.Log(1.0 - _random.NextDouble()) / Math.Log(1.0 - BitErrorRate);
+            return gap >= long.MaxValue / 2 ? long.MaxValue / 2 : (long)gap;
+        }
+
+        private static byte[] DecodeHex(string hex)
+        {
+            if (hex.Length % 2 != 0) return null;
+
+            var bytes = new byte[hex.Length / 2];
+            for (int i = 0; i < bytes.Length; i++)
+            {
+                int hi = HexNibble(hex[i * 2]);
+                int lo = HexNibble(hex[i * 2 + 1]);
+                if (hi < 0 || lo < 0) return null;
+                bytes[i] = (byte)((hi << 4) | lo);
+            }
+            return bytes;
+        }
+
+        private static int HexNibble(char c)
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1;
+        }
+
+        private void Reply(string line)
+        {
+            foreach (char c in line) _rx.Enqueue((byte)c);
+            _rx.Enqueue((byte)'\n');
+        }
+    }
+}
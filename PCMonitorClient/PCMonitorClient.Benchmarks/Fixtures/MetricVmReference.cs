@@ -0,0 +1,112 @@
+using System;
+using System.Buffers.Binary;
+
+namespace PCMonitorClient.Benchmarks.Fixtures
+{
+    /// <summary>
+    /// Port of the firmware's metric VM (main/core/metric_vm.c): same table
+    /// layout, same straight-line interpreter, same N/A rules. The table is
+    /// trusted here (CustomMetrics only emits valid programs), the device
+    /// verifies it at load time.
+    /// </summary>
+    public sealed class MetricVmReference
+    {
+        private const int INPUT_COUNT = (int)MetricInput.DT + 1;
+
+        private readonly float[] _consts;
+        private readonly ushort[] _end;
+        private readonly byte[] _code;      // 4 bytes per op: opcode, dst, a, b
+        private readonly float[] _value;
+        private readonly float[] _in = new float[INPUT_COUNT];
+        private readonly float[] _r = new float[ProtocolConstants.METRIC_REGS];
+        private bool _hasLast;
+        private uint _lastMs;
+
+        public MetricVmReference(byte[] table)
+        {
+            var span = new ReadOnlySpan<byte>(table);
+            var h = MetricTableHeader.Read(span);
+            int pos = MetricTableHeader.SIZE;
+
+            _consts = new float[h.ConstCount];
+            for (int i = 0; i < _consts.Length; i++, pos += 4)
+                _consts[i] = BitConverter.ToSingle(table, pos);
+
+            _end = new ushort[h.SlotCount];
+            for (int i = 0; i < _end.Length; i++, pos += 2)
+                _end[i] = BinaryPrimitives.ReadUInt16LittleEndian(span.Slice(pos));
+
+            _code = new byte[h.OpCount * 4];
+            Array.Copy(table, pos, _code, 0, _code.Length);
+
+            _value = new float[h.SlotCount];
+            for (int i = 0; i < _value.Length; i++) _value[i] = float.NaN;
+        }
+
+        public int SlotCount => _value.Length;
+
+        public float this[int slot] => _value[slot];
+
+        /// <summary>All programs on one stats line (metric_vm_run).</summary>
+        public void Run(SystemStats s, uint nowMs)
+        {
+            _in[(int)MetricInput.CPU_LOAD] = Input(s.CpuLoad);
+            _in[(int)MetricInput.CPU_TEMP] = Input(s.CpuTemp);
+            _in[(int)MetricInput.GPU_LOAD] = Input(s.GpuLoad);
+            _in[(int)MetricInput.GPU_TEMP] = Input(s.GpuTemp);
+            _in[(int)MetricInput.VRAM_USED] = Input(s.GpuVramUsed);
+            _in[(int)MetricInput.VRAM_TOTAL] = Input(s.GpuVramTotal);
+            _in[(int)MetricInput.RAM_USED] = Input(s.RamUsedGb);
+            _in[(int)MetricInput.RAM_TOTAL] = Input(s.RamTotalGb);
+            _in[(int)MetricInput.NET_DOWN] = Input(s.NetDown);
+            _in[(int)MetricInput.NET_UP] = Input(s.NetUp);
+            _in[(int)MetricInput.DISK_READ] = Input(s.DiskReadMBps);
+            _in[(int)MetricInput.DISK_WRITE] = Input(s.DiskWriteMBps);
+            _in[(int)MetricInput.DISK_READ_IOPS] = Input(s.DiskReadIops);
+            _in[(int)MetricInput.DISK_WRITE_IOPS] = Input(s.DiskWriteIops);
+            _in[(int)MetricInput.DISK_QUEUE] = Input(s.DiskQueue);
+            _in[(int)MetricInput.DISK_LATENCY] = Input(s.DiskLatencyMs);
+            _in[(int)MetricInput.DT] = _hasLast ? (nowMs - _lastMs) / 1000f : float.NaN;
+            _hasLast = true;
+            _lastMs = nowMs;
+
+            float[] r = _r;
+            byte[] code = _code;
+            int pc = 0;
+
+            for (int slot = 0; slot < _value.Length; slot++)
+            {
+                int end = _end[slot] * 4;
+                for (; pc < end; pc += 4)
+                {
+                    var op = (MetricOp)code[pc];
+                    int dst = code[pc + 1];
+                    int ia = code[pc + 2];
+                    if (op == MetricOp.LDC) { r[dst] = _consts[ia]; continue; }
+                    if (op == MetricOp.LDF) { r[dst] = _in[ia]; continue; }
+                    if (op == MetricOp.LDM) { r[dst] = _value[ia]; continue; }
+
+                    float a = r[ia];
+                    float b = r[code[pc + 3]];
+                    switch (op)
+                    {
+                        case MetricOp.MOV: r[dst] = a; break;
+                        case MetricOp.ADD: r[dst] = a + b; break;
+                        case MetricOp.SUB: r[dst] = a - b; break;
+                        case MetricOp.MUL: r[dst] = a * b; break;
+                        case MetricOp.DIV: r[dst] = b == 0f ? float.NaN : a / b; break;
+                        case MetricOp.MIN: r[dst] = float.IsNaN(a) || float.IsNaN(b) ? float.NaN : Math.Min(a, b); break;
+                        case MetricOp.MAX: r[dst] = float.IsNaN(a) || float.IsNaN(b) ? float.NaN : Math.Max(a, b); break;
+                        case MetricOp.NEG: r[dst] = -a; break;
+                        case MetricOp.ABS: r[dst] = Math.Abs(a); break;
+                        case MetricOp.DEF: r[dst] = float.IsNaN(a) ? b : a; break;
+                        case MetricOp.RET: _value[slot] = float.IsInfinity(a) ? float.NaN : a; break;
+                    }
+                }
+            }
+        }
+
+        /// <summary>Stats use negative values for N/A.</summary>
+        private static float Input(float v) => v < 0f ? float.NaN : v;
+    }
+}
@@ -0,0 +1,137 @@
+using System;
+using System.Collections.Generic;
+using LibreHardwareMonitor.Hardware;
+
+namespace PCMonitorClient.Benchmarks.Fixtures
+{
+    /// <summary>
+    /// Static LibreHardwareMonitor tree shaped like a 16-core desktop with a
+    /// SuperIO chip and an NVIDIA GPU. No driver, no Ring0 - collection cost
+    /// is measured without the hardware reads.
+    /// </summary>
+    public static class MockSensorTree
+    {
+        public static IHardware[] CreateDesktop(int cores = 16)
+        {
+            var cpu = new MockHardware("AMD Ryzen 9 7950X", HardwareType.Cpu);
+            for (int i = 1; i <= cores; i++)
+            {
+                cpu.Add($"CPU Core #{i}", SensorType.Load, 20f + i);
+                cpu.Add($"CPU Core #{i}", SensorType.Clock, 4500f + i);
+                cpu.Add($"Core #{i}", SensorType.Temperature, 55f + i * 0.5f);
+            }
+            cpu.Add("CPU Total", SensorType.Load, 37.5f);
+            cpu.Add("Core Max", SensorType.Temperature, 68f);
+            cpu.Add("Core Average", SensorType.Temperature, 61f);
+            cpu.Add("Tctl/Tdie", SensorType.Temperature, 66.5f);
+            cpu.Add("Package", SensorType.Power, 142f);
+
+            var superIo = new MockHardware("Nuvoton NCT6799D", HardwareType.SuperIO);
+            for (int i = 1; i <= 7; i++) superIo.Add($"Fan #{i}", SensorType.Fan, 900f + i * 50);
+            for (int i = 1; i <= 6; i++) superIo.Add($"Temperature #{i}", SensorType.Temperature, 35f + i);
+            superIo.Add("CPU Socket", SensorType.Temperature, 48f);
+            for (int i = 0; i <= 14; i++) superIo.Add($"Voltage #{i}", SensorType.Voltage, 1.0f + i * 0.1f);
+            var board = new MockHardware("X670E", HardwareType.Motherboard, superIo);
+
+            var memory = new MockHardware("Generic Memory", HardwareType.Memory);
+            memory.Add("Memory Used", SensorType.Data, 21.4f);
+            memory.Add("Memory Available", SensorType.Data, 42.6f);
+            memory.Add("Memory", SensorType.Load, 33.4f);
+            memory.Add("Virtual Memory Used", SensorType.Data, 30.1f);
+            memory.Add("Virtual Memory Available", SensorType.Data, 60.2f);
+
+            var gpu = new MockHardware("NVIDIA GeForce RTX 4080", HardwareType.GpuNvidia);
+            gpu.Add("GPU Core", SensorType.Load, 64f);
+            gpu.Add("GPU Core", SensorType.Temperature, 58f);
+            gpu.Add("GPU Hot Spot", SensorType.Temperature, 71f);
+            gpu.Add("GPU Memory Used", SensorType.SmallData, 6210f);
+            gpu.Add("GPU Memory Total", SensorType.SmallData, 16376f);
+            gpu.Add("GPU Memory Free", SensorType.SmallData, 10166f);
+            gpu.Add("GPU Core", SensorType.Clock, 2610f);
+            gpu.Add("GPU Memory", SensorType.Clock, 11201f);
+            gpu.Add("GPU Package", SensorType.Power, 210f);
+            gpu.Add("GPU", SensorType.Fan, 1450f);
+
+            return new IHardware[] { board, cpu, memory, gpu };
+        }
+    }
+
+    public sealed class MockHardware : IHardware
+    {
+        private readonly List<ISensor> _sensors = new List<ISensor>();
+        private ISensor[] _sensorArray = Array.Empty<ISensor>();
+        private readonly IHardware[] _sub;
+
+        public MockHardware(string name, HardwareType type, params IHardware[] sub)
+        {
+            Name = name;
+            HardwareType = type;
+            Identifier = new Identifier("mock", type.ToString().ToLowerInvariant());
+            _sub = sub ?? Array.Empty<IHardware>();
+        }
+
+        public void Add(string name, SensorType type, float value)
+        {
+            _sensors.Add(new MockSensor(this, name, type, _sensors.Count, value));
+            _sensorArray = _sensors.ToArray();
+        }
+
+        public HardwareType HardwareType { get; }
+        public Identifier Identifier { get; }
+        public string Name { get; set; }
+        public IHardware Parent => null;
+        public IDictionary<string, string> Properties { get; } = new Dictionary<string, string>();
+        public ISensor[] Sensors => _sensorArray;
+        public IHardware[] SubHardware => _sub;
+
+#pragma warning disable CS0067 // Never raised: the mock tree is static
+        public event SensorEventHandler SensorAdded;
+        public event SensorEventHandler SensorRemoved;
+#pragma warning restore CS0067
+
+        public string GetReport() => "";
+        public void Update() { }
+
+        public void Accept(IVisitor visitor) => visitor.VisitHardware(this);
+
+        public void Traverse(IVisitor visitor)
+        {
+            foreach (var sub in _sub) sub.Accept(visitor);
+            foreach (var sensor in _sensorArray) sensor.Accept(visitor);
+        }
+    }
+
+    public sealed class MockSensor : ISensor
+    {
+        public MockSensor(IHardware hardware, string name, SensorType type, int index, float value)
+        {
+            Hardware = hardware;
+            Name = name;
+            SensorType = type;
+            Index = index;
+            Value = value;
+            Identifier = new Identifier(hardware.Identifier, type.ToString().ToLowerInvariant(), index.ToString());
+        }
+
+        public IControl Control => null;
+        public IHardware Hardware { get; }
+        public Identifier Identifier { get; }
+        public int Index { get; }
+        public bool IsDefaultHidden => false;
+        public float? Max => Value;
+        public float? Min => Value;
+        public string Name { get; set; }
+        public IReadOnlyList<IParameter> Parameters { get; } = Array.Empty<IParameter>();
+        public SensorType SensorType { get; }
+        public float? Value { get; set; }
+        public IEnumerable<SensorValue> Values => Array.Empty<SensorValue>();
+        public TimeSpan ValuesTimeWindow { get; set; }
+
+        public void ResetMin() { }
+        public void ResetMax() { }
+        public void ClearValues() { }
+
+        public void Accept(IVisitor visitor) => visitor.VisitSensor(this);
+        public void Traverse(IVisitor visitor) { }
+    }
+}
@@ -0,0 +1,59 @@
+using System.IO;
+using BenchmarkDotNet.Attributes;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// PNG -> RGB565A8 conversion. Fixtures are generated in memory: a
+    /// 240x240 image (no resize), a 1024x768 photo-sized one (downscale
+    /// + transparent padding) and a 100x100 logo, full-frame and cropped.
+    /// </summary>
+    [MemoryDiagnoser]
+    public class ImageConverterBenchmarks
+    {
+        private byte[] _native;
+        private byte[] _large;
+        private byte[] _logo;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _native = CreatePng(240, 240);
+            _large = CreatePng(1024, 768);
+            _logo = CreatePng(100, 100);
+        }
+
+        private static byte[] CreatePng(int width, int height)
+        {
+            using (var image = new Image<Rgba32>(width, height))
+            using (var ms = new MemoryStream())
+            {
+                for (int y = 0; y < height; y++)
+                {
+                    for (int x = 0; x < width; x++)
+                    {
+                        // Gradient with a soft alpha edge - exercises color and alpha paths
+                        byte a = (byte)(x < 16 || y < 16 ? x * y : 255);
+                        image[x, y] = new Rgba32((byte)x, (byte)y, (byte)(x ^ y), a);
+                    }
+                }
+                image.SaveAsPng(ms);
+                return ms.ToArray();
+            }
+        }
+
+        [Benchmark]
+        public byte[] Native240() => ImageConverter.ConvertToRgb565A8(_native).CombinedData;
+
+        [Benchmark]
+        public byte[] Downscale1024() => ImageConverter.ConvertToRgb565A8(_large).CombinedData;
+
+        [Benchmark]
+        public byte[] Logo100FullFrame() => ImageConverter.ConvertToRgb565A8(_logo).CombinedData;
+
+        [Benchmark]
+        public byte[] Logo100Cropped() => ImageConverter.ConvertToRgb565A8(_logo, cropToContent: true).CombinedData;
+    }
+}
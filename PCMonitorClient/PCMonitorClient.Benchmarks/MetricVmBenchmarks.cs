@@ -0,0 +1,94 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using BenchmarkDotNet.Attributes;
+using PCMonitorClient.Benchmarks.Fixtures;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// Custom metrics: compiling a metrics.txt of 50 expressions, and
+    /// evaluating all of them on one stats line with MetricVmReference.
+    /// That is a C# model of the firmware interpreter, not metric_vm.c:
+    /// EvaluateFrameModel tracks changes to the table layout and op mix,
+    /// not the device's speed. tools/metric_vm_bench.c times the real C on
+    /// the same table (ExportForNative writes it); BENCH case EXPR measures
+    /// it on the ESP32-S3.
+    ///
+    /// The expressions cycle through the typical kinds: ratios, EMAs,
+    /// min/max over sensors and references to earlier metrics.
+    /// </summary>
+    [MemoryDiagnoser]
+    public class MetricVmBenchmarks
+    {
+        private const int EXPRESSIONS = 50;
+
+        private static readonly string[] Templates =
+        {
+            "vram_usage{0} = vram_used / vram_total * 100",
+            "cpu_smooth{0} = ema(cpu_temp, 0.2)",
+            "ram_usage{0} = ram_used / ram_total * 100",
+            "hot_gap{0} = max(cpu_temp, gpu_temp) - 80",
+            "disk_total{0} = def(disk_read, 0) + def(disk_write, 0)",
+        };
+
+        private static readonly SystemStats Stats = new SystemStats
+        {
+            CpuLoad = 37.5f, CpuTemp = 66.5f,
+            GpuLoad = 64f, GpuTemp = 58f, GpuVramUsed = 6.1f, GpuVramTotal = 16f,
+            RamUsedGb = 21.4f, RamTotalGb = 64f,
+            NetType = "LAN", NetSpeed = "2.5 Gbps", NetDown = 112.4f, NetUp = 8.2f,
+            DiskReadMBps = 128f, DiskWriteMBps = 16f, DiskReadIops = 1000f, DiskWriteIops = 240f,
+            DiskQueue = 4f, DiskLatencyMs = 0.6f
+        };
+
+        private List<string> _lines;
+        private MetricVmReference _vm;
+        private uint _nowMs;
+
+        private static List<string> Expressions()
+        {
+            var lines = new List<string>();
+            for (int i = 0; i < EXPRESSIONS; i++)
+                lines.Add(string.Format(Templates[i % Templates.Length], i));
+            return lines;
+        }
+
+        /// <summary>
+        /// Writes the METRICS: line and the stats line this class evaluates,
+        /// as input for tools/metric_vm_bench.c.
+        /// </summary>
+        public static void ExportForNative(string path)
+        {
+            string metrics = CustomMetrics.Encode(Expressions(), out string error)
+                             ?? throw new InvalidOperationException(error);
+            File.WriteAllText(path, metrics + Stats.ToTelemetryLine());
+
+            var vm = new MetricVmReference(CustomMetrics.Compile(Expressions(), out _, out _));
+            vm.Run(Stats, 1000);
+            Console.WriteLine("Wrote " + path + " (model: last metric " + vm[EXPRESSIONS - 1] + " after one frame)");
+        }
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _lines = Expressions();
+
+            byte[] table = CustomMetrics.Compile(_lines, out _, out string error)
+                           ?? throw new InvalidOperationException(error);
+            _vm = new MetricVmReference(table);
+            Console.WriteLine("// " + EXPRESSIONS + " expressions: " + table.Length + " byte table");
+        }
+
+        [Benchmark]
+        public byte[] Compile() => CustomMetrics.Compile(_lines, out _, out _);
+
+        [Benchmark]
+        public float EvaluateFrameModel()
+        {
+            _nowMs += 1000;
+            _vm.Run(Stats, _nowMs);
+            return _vm[EXPRESSIONS - 1];
+        }
+    }
+}
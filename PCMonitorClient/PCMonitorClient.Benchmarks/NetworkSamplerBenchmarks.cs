@@ -0,0 +1,57 @@
+using System.Diagnostics;
+using System.Linq;
+using BenchmarkDotNet.Attributes;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// NetworkSampler (interface statistics deltas, all adapters) against the
+    /// two "Network Interface" PerformanceCounters it replaced. Live system
+    /// counters - results depend on the adapters present.
+    /// </summary>
+    [MemoryDiagnoser]
+    public class NetworkSamplerBenchmarks
+    {
+        private NetworkSampler _sampler;
+        private PerformanceCounter _down;
+        private PerformanceCounter _up;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _sampler = new NetworkSampler();
+            _sampler.Sample();
+
+            var instance = new PerformanceCounterCategory("Network Interface").GetInstanceNames().FirstOrDefault();
+            if (instance != null)
+            {
+                _down = new PerformanceCounter("Network Interface", "Bytes Received/sec", instance);
+                _up = new PerformanceCounter("Network Interface", "Bytes Sent/sec", instance);
+                _down.NextValue();
+                _up.NextValue();
+            }
+        }
+
+        [GlobalCleanup]
+        public void Cleanup()
+        {
+            _sampler?.Dispose();
+            _down?.Dispose();
+            _up?.Dispose();
+        }
+
+        [Benchmark(Baseline = true)]
+        public float PerformanceCounters()
+        {
+            if (_down == null) return 0f;
+            return _down.NextValue() + _up.NextValue();
+        }
+
+        [Benchmark]
+        public float InterfaceStatistics()
+        {
+            _sampler.Sample();
+            return _sampler.Aggregate.DownMBps;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+using BenchmarkDotNet.Configs;
+using BenchmarkDotNet.Diagnosers;
+using BenchmarkDotNet.Exporters;
+using BenchmarkDotNet.Exporters.Json;
+using BenchmarkDotNet.Running;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// Send-path benchmarks: collection, encoding, image conversion, upload
+    /// and the end-to-end "sample to bytes on the wire" path.
+    ///
+    ///   dotnet run -c Release -- --filter *            (all)
+    ///   dotnet run -c Release -- --filter *Upload*     (one class)
+    ///   dotnet run -c Release -- --export-metric-vm &lt;file&gt;
+    ///                                  (input for tools/metric_vm_bench.c)
+    ///
+    /// Compare the markdown reports in BenchmarkDotNet.Artifacts/results with
+    /// baseline/ and copy them over when a change is accepted.
+    /// </summary>
+    internal static class Program
+    {
+        private static void Main(string[] args)
+        {
+            if (args.Length == 2 && args[0] == "--export-metric-vm")
+            {
+                MetricVmBenchmarks.ExportForNative(args[1]);
+                return;
+            }
+
+            var config = DefaultConfig.Instance
+                .AddDiagnoser(MemoryDiagnoser.Default)
+                .AddExporter(MarkdownExporter.GitHub)
+                .AddExporter(JsonExporter.Brief);
+
+            BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args, config);
+        }
+    }
+}
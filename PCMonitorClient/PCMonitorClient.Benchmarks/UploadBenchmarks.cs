@@ -0,0 +1,44 @@
+using System.Threading.Tasks;
+using BenchmarkDotNet.Attributes;
+using PCMonitorClient.Benchmarks.Fixtures;
+
+namespace PCMonitorClient.Benchmarks
+{
+    /// <summary>
+    /// Full chunked upload (BEGIN / DATA chunks / END) of one screensaver
+    /// image against the in-memory device. Measures hex encoding, line
+    /// building and ACK parsing - not USB throughput.
+    ///
+    /// ChunkSize compares the legacy 1024 byte chunks with the GET_CAPS
+    /// limit of current firmware (fewer lines and ACK round trips).
+    /// </summary>
+    [MemoryDiagnoser]
+    public class UploadBenchmarks
+    {
+        private const int IMAGE_BYTES = 240 * 240 * 3;      // RGB565A8
+
+        private readonly LoopbackDevice _device = new LoopbackDevice();
+        private ChunkedSerialUploader _uploader;
+        private byte[] _payload;
+        private uint _crc;
+
+        [Params(ChunkedSerialUploader.DEFAULT_CHUNK_SIZE, 2032)]
+        public int ChunkSize { get; set; }
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _payload = new byte[IMAGE_BYTES];
+            for (int i = 0; i < _payload.Length; i++) _payload[i] = (byte)(i * 31);
+            _crc = ImageConverter.ComputeCrc32(_payload);
+            _uploader = new ChunkedSerialUploader(_device, new object(), "IMG") { ChunkSize = ChunkSize };
+        }
+
+        [Benchmark]
+        public Task<bool> UploadImage()
+        {
+            _device.Reset();
+            return _uploader.UploadAsync("IMG_BEGIN:0:" + IMAGE_BYTES, _payload, _crc);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Text;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// User alert rules from %AppData%\ScarabMonitor\alert_rules.txt, sent as
+    /// one ALERT_RULES: line after each handshake (FEAT:ALRT firmware only).
+    /// The device evaluates them on every stats line; without the file it
+    /// keeps its current table (built-in temperature colours by default).
+    ///
+    /// One rule per line, lines starting with '#' are comments:
+    ///   metric op threshold hysteresis hold_ms action target [arg]
+    ///   CPU_TEMP > 85 3 5000 COLOR CPU_TEMP FF0000
+    ///   CPU_TEMP > 60 0 0    COLOR CPU_TEMP THEME_WARM
+    ///   GPU_LOAD > 95 5 2000 BLINK GPU_ARC
+    ///   DISK_LATENCY > 50 10 3000 VIEW 2 1      (display 2 -> view 1)
+    ///   vram_usage > 90 2 5000 BLINK GPU_ARC    (custom metric, see CustomMetrics)
+    /// Names are the AlertMetric / AlertAction / AlertTarget values, or a
+    /// metric name from metrics.txt.
+    /// </summary>
+    public static class AlertRules
+    {
+        private static readonly string FilePath = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData),
+            "ScarabMonitor", "alert_rules.txt");
+
+        private static readonly string[] ThemeColors = { "THEME_COLD", "THEME_WARM", "THEME_HOT" };
+
+        /// <summary>
+        /// Builds the ALERT_RULES: line (newline-terminated) from the rules
+        /// file. Returns null if there is no file; sets error (and returns
+        /// null) if a line is malformed, so the device keeps its table.
+        /// </summary>
+        public static string LoadCommand(out string error)
+        {
+            error = null;
+            try
+            {
+                if (!File.Exists(FilePath)) return null;
+                return Encode(File.ReadAllLines(FilePath), out error, CustomMetrics.LoadNames());
+            }
+            catch (Exception ex)
+            {
+                error = ex.Message;
+                return null;
+            }
+        }
+
+        /// <summary>customMetrics: names in slot order, usable as metrics.</summary>
+        public static string Encode(IEnumerable<string> lines, out string error,
+                                    IReadOnlyList<string> customMetrics = null)
+        {
+            error = null;
+            var sb = new StringBuilder(ProtocolCommands.ALERT_RULES);
+            int count = 0;
+            int lineNo = 0;
+
+            foreach (string raw in lines)
+            {
+                lineNo++;
+                string line = raw.Trim();
+                if (line.Length == 0 || line[0] == '#') continue;
+
+                string rule = EncodeRule(line.Split((char[])null, StringSplitOptions.RemoveEmptyEntries), customMetrics);
+                if (rule == null)
+                {
+                    error = "line " + lineNo + ": " + line;
+                    return null;
+                }
+                if (++count > ProtocolConstants.ALERT_MAX_RULES)
+                {
+                    error = "more than " + ProtocolConstants.ALERT_MAX_RULES + " rules";
+                    return null;
+                }
+
+                if (count > 1) sb.Append(';');
+                sb.Append(rule);
+            }
+
+            return sb.Append('\n').ToString();
+        }
+
+        /// <summary>Wire form of one rule, or null if it is malformed.</summary>
+        private static string EncodeRule(string[] t, IReadOnlyList<string> customMetrics)
+        {
+            if (t.Length < 7 || t.Length > 8) return null;
+
+            if (!TryParseMetric(t[0], customMetrics, out int metric)) return null;
+            if (t[1] != ">" && t[1] != "<") return null;
+            if (!TryParseFloat(t[2], out float threshold)) return null;
+            if (!TryParseFloat(t[3], out float hysteresis) || hysteresis < 0f) return null;
+            if (!uint.TryParse(t[4], NumberStyles.None, CultureInfo.InvariantCulture, out uint holdMs)) return null;
+            if (!Enum.TryParse(t[5], true, out AlertAction action) || !Enum.IsDefined(typeof(AlertAction), action)) return null;
+
+            string arg = t.Length == 8 ? t[7] : null;
+            int target;
+            uint argValue;
+
+            switch (action)
+            {
+                case AlertAction.VIEW:
+                    // Target is the display, arg the view (0 normal, 1 alternate)
+                    if (!int.TryParse(t[6], NumberStyles.None, CultureInfo.InvariantCulture, out target) || target > 3) return null;
+                    if (arg != "0" && arg != "1") return null;
+                    argValue = arg == "1" ? 1u : 0u;
+                    break;
+
+                case AlertAction.COLOR:
+                    if (!TryParseTarget(t[6], out target) || arg == null) return null;
+                    int theme = Array.FindIndex(ThemeColors, c => c.Equals(arg, StringComparison.OrdinalIgnoreCase));
+                    if (theme >= 0)
+                        argValue = ProtocolConstants.ALERT_COLOR_THEME | (uint)theme;
+                    else if (!TryParseRgb(arg, out argValue))
+                        return null;
+                    break;
+
+                default:
+                    if (!TryParseTarget(t[6], out target) || arg != null) return null;
+                    argValue = 0;
+                    break;
+            }
+
+            return string.Join(",",
+                metric.ToString(CultureInfo.InvariantCulture),
+                t[1],
+                threshold.ToString("0.##", CultureInfo.InvariantCulture),
+                hysteresis.ToString("0.##", CultureInfo.InvariantCulture),
+                holdMs.ToString(CultureInfo.InvariantCulture),
+                ((int)action).ToString(CultureInfo.InvariantCulture),
+                target.ToString(CultureInfo.InvariantCulture),
+                argValue.ToString("X", CultureInfo.InvariantCulture));
+        }
+
+        private static bool TryParseMetric(string s, IReadOnlyList<string> customMetrics, out int metric)
+        {
+            if (Enum.TryParse(s, true, out AlertMetric m) && Enum.IsDefined(typeof(AlertMetric), m))
+            {
+                metric = (int)m;
+                return true;
+            }
+
+            metric = 0;
+            if (customMetrics == null) return false;
+            for (int i = 0; i < customMetrics.Count; i++)
+            {
+                if (!customMetrics[i].Equals(s, StringComparison.OrdinalIgnoreCase)) continue;
+                metric = ProtocolConstants.ALERT_METRIC_CUSTOM + i;
+                return true;
+            }
+            return false;
+        }
+
+        private static bool TryParseTarget(string s, out int target)
+        {
+            target = 0;
+            if (!Enum.TryParse(s, true, out AlertTarget t) || !Enum.IsDefined(typeof(AlertTarget), t)) return false;
+            target = (int)t;
+            return true;
+        }
+
+        private static bool TryParseFloat(string s, out float value)
+        {
+            return float.TryParse(s, NumberStyles.Float, CultureInfo.InvariantCulture, out value);
+        }
+
+        private static bool TryParseRgb(string s, out uint rgb)
+        {
+            if (s.StartsWith("#", StringComparison.Ordinal)) s = s.Substring(1);
+            else if (s.StartsWith("0x", StringComparison.OrdinalIgnoreCase)) s = s.Substring(2);
+
+            return uint.TryParse(s, NumberStyles.HexNumber, CultureInfo.InvariantCulture, out rgb)
+                   && s.Length == 6;
+        }
+    }
+}
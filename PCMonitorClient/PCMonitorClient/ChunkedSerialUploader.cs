@@ -1,5 +1,5 @@
 using System;
-using System.IO.Ports;
+using System.IO;
 using System.Text;
 using System.Threading;
 using System.Threading.Tasks;
@@ -25,34 +25,91 @@ namespace PCMonitorClient
     ///
     /// Protocol (PREFIX = "IMG" or "FW"):
     /// 1. Client: [begin command, e.g. IMG_BEGIN:slot:size or FW_BEGIN:size]
-    /// 2. ESP:    PREFIX_OK:BEGIN
-    /// 3. Client: PREFIX_DATA:[offset]:[hex]   (CHUNK_SIZE byte chunks)
+    /// 2. ESP:    PREFIX_OK:BEGIN[:resume-offset]
+    /// 3. Client: PREFIX_DATA:[offset]:[hex][:crc32]   (ChunkSize byte chunks)
     /// 4. ESP:    PREFIX_OK:DATA:[received]    or PREFIX_ERR:OFFSET:[expected]
+    ///                                         or PREFIX_NAK:[offset] (chunk damaged)
     /// 5. Client: PREFIX_END:[CRC32-hex]
-    /// 6. ESP:    PREFIX_OK:COMPLETE           or PREFIX_ERR:...
+    /// 6. ESP:    PREFIX_OK:COMPLETE / STAGED  or PREFIX_ERR:...
     ///
     /// Reliability:
     /// - All port WRITES go through a shared lock so they cannot interleave
     ///   with the stats data loop or user commands (corrupted lines).
     /// - Lost-ACK recovery: on PREFIX_ERR:OFFSET:[expected] the client resyncs
     ///   its send position to the offset the ESP reports, instead of failing.
+    /// - Per-chunk CRC (ChunkCrc, FEAT:CRC firmware): the device checks every
+    ///   chunk on arrival and NAKs a damaged one before writing it, so only
+    ///   that chunk is resent instead of failing the whole transfer at END.
+    /// - Background transfers (FW_STAGE) set MaxBytesPerSecond/HoldOff to share
+    ///   the link with telemetry, and SendAbortOnFailure=false so the device
+    ///   keeps its progress for the next session.
+    ///
+    /// The payload is streamed: an UploadPipeline reads, hashes and encodes
+    /// chunks a few lines ahead of the sender, so a firmware file is never
+    /// held in memory and the END CRC needs no pass of its own.
     /// </summary>
     public class ChunkedSerialUploader
     {
-        private const int CHUNK_SIZE = 1024;           // 1024 bytes = 2048 hex chars, fits ESP 4096 line buffer
+        public const int DEFAULT_CHUNK_SIZE = 1024;    // 1024 bytes = 2048 hex chars, fits ESP 4096 line buffer
         private const int RESPONSE_TIMEOUT_MS = 5000;  // Max wait for ESP response
         private const int MAX_RETRIES = 3;             // Retries per chunk (timeout case)
+        private const int MAX_NAK_RETRIES = 8;         // Resends of one damaged chunk (ChunkCrc)
 
-        private readonly SerialPort _port;
+        private readonly ISerialLink _port;
         private readonly object _writeLock;
         private readonly string _prefix;    // "IMG" or "FW"
 
+        private int _chunkSize = DEFAULT_CHUNK_SIZE;
+        private int _maxBytesPerSecond;
+
         public event EventHandler<UploadProgressEventArgs> ProgressChanged;
         public event EventHandler<string> LogMessage;
 
-        public ChunkedSerialUploader(SerialPort port, object writeLock, string prefix)
+        /// <summary>
+        /// Payload bytes per DATA line. Defaults to what every firmware
+        /// accepts; raise it to the device's GET_CAPS limit
+        /// (DeviceCaps.UploadChunkBytes) for fewer round trips.
+        /// </summary>
+        public int ChunkSize
+        {
+            get => _chunkSize;
+            set => _chunkSize = Math.Max(1, Math.Min(value, DeviceCaps.CLIENT_MAX_CHUNK));
+        }
+
+        /// <summary>
+        /// Payload rate limit in bytes/s (0 = as fast as the device ACKs).
+        /// </summary>
+        public int MaxBytesPerSecond
+        {
+            get => _maxBytesPerSecond;
+            set => _maxBytesPerSecond = Math.Max(0, value);
+        }
+
+        /// <summary>
+        /// While this returns true no chunk is sent (e.g. an exclusive upload
+        /// or a manual pause owns the port). Null = never hold off.
+        /// </summary>
+        public Func<bool> HoldOff { get; set; }
+
+        /// <summary>
+        /// Send PREFIX_ABORT when the upload fails or is cancelled (default).
+        /// Resumable transfers turn this off to keep the device-side progress.
+        /// </summary>
+        public bool SendAbortOnFailure { get; set; } = true;
+
+        /// <summary>
+        /// Append the CRC32 of each chunk to its DATA line (FEAT:CRC firmware,
+        /// DeviceCaps.UploadChunkCrc). Off for older firmware, which would
+        /// take the CRC for hex payload.
+        /// </summary>
+        public bool ChunkCrc { get; set; }
+
+        /// <summary>Chunks resent after a NAK in the last upload.</summary>
+        public int ChunksResent { get; private set; }
+
+        public ChunkedSerialUploader(ISerialLink link, object writeLock, string prefix)
         {
-            _port = port ?? throw new ArgumentNullException(nameof(port));
+            _port = link ?? throw new ArgumentNullException(nameof(link));
             _writeLock = writeLock ?? new object();
             _prefix = prefix;
         }
@@ -64,9 +121,31 @@ namespace PCMonitorClient
         /// <param name="data">Payload bytes</param>
         /// <param name="crc32">CRC32 of payload (sent with END)</param>
         /// <param name="ct">Cancellation token</param>
-        public async Task<bool> UploadAsync(string beginCommand, byte[] data, uint crc32, CancellationToken ct = default)
+        public Task<bool> UploadAsync(string beginCommand, byte[] data, uint crc32, CancellationToken ct = default)
         {
             if (data == null || data.Length == 0)
+            {
+                Log("Error: No data to upload");
+                return Task.FromResult(false);
+            }
+
+            return UploadAsync(beginCommand, new MemoryStream(data, false), data.Length, crc32, ct);
+        }
+
+        /// <summary>
+        /// Uploads length bytes of a seekable stream (from offset 0) using the
+        /// chunked protocol. The stream is read chunk by chunk while sending.
+        /// </summary>
+        /// <param name="beginCommand">Full begin command, e.g. "FW_BEGIN:1048576"</param>
+        /// <param name="source">Payload, e.g. a FileStream; the caller closes it</param>
+        /// <param name="length">Payload bytes</param>
+        /// <param name="crc32">CRC32 of payload if known up front (FW_STAGE); null = computed
+        /// while streaming. If given, a source that changed during the upload fails it.</param>
+        /// <param name="ct">Cancellation token</param>
+        public async Task<bool> UploadAsync(string beginCommand, Stream source, int length, uint? crc32,
+                                            CancellationToken ct = default)
+        {
+            if (source == null || length <= 0)
             {
                 Log("Error: No data to upload");
                 return false;
@@ -78,17 +157,27 @@ namespace PCMonitorClient
                 return false;
             }
 
-            int totalBytes = data.Length;
-            int totalChunks = (totalBytes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            int totalBytes = length;
+            int totalChunks = (totalBytes + _chunkSize - 1) / _chunkSize;
             string okBegin = _prefix + "_OK:BEGIN";
             string okData = _prefix + "_OK:DATA";
             string errOffsetPrefix = _prefix + "_ERR:OFFSET:";
             string errAny = _prefix + "_ERR";
+            string nakPrefix = _prefix + "_NAK:";
+
+            // With chunk CRCs on, a mis-resync to the same offset is a
+            // damaged offset field as often as a stuck peer
+            int maxStalls = ChunkCrc ? MAX_NAK_RETRIES : MAX_RETRIES;
+            ChunksResent = 0;
 
-            Log($"Starting upload: Size={totalBytes} bytes, Chunks={totalChunks}");
+            Log($"Starting upload: Size={totalBytes} bytes, Chunks={totalChunks} x {_chunkSize}");
 
+            var pipeline = new UploadPipeline(source, totalBytes, _prefix, _chunkSize, ChunkCrc);
             try
             {
+                // The first chunks are read and encoded while BEGIN is answered
+                await pipeline.RestartAsync(0);
+
                 // --- Phase 1: BEGIN ---
                 Log("TX: " + beginCommand);
                 DiscardStaleInput();
@@ -97,38 +186,105 @@ namespace PCMonitorClient
                 if (response == null || !response.Contains(okBegin))
                 {
                     Log($"Error: {_prefix}_BEGIN not acknowledged" + (response != null ? $" (got: {response})" : ""));
-                    SendAbort();
+                    AbortSession();
                     return false;
                 }
 
                 // --- Phase 2: DATA chunks with lost-ACK resync ---
-                int bytesSent = 0;
-                int chunksSent = 0;
+                int bytesSent = ParseResumeOffset(response, okBegin, totalBytes);
+                int chunksSent = bytesSent / _chunkSize;
                 int timeoutRetries = 0;
                 int resyncStalls = 0;   // consecutive resyncs without forward progress
+                int nakRetries = 0;     // consecutive NAKs of the current chunk
+                if (bytesSent > 0)
+                {
+                    Log($"Resuming at offset {bytesSent} ({bytesSent * 100L / totalBytes}% already on device)");
+                    ReportProgress(bytesSent, totalBytes, chunksSent, totalChunks, "Resuming...");
+                }
+
+                // Rate limit: payload ACKed since the last (re)start of the clock
+                var rateClock = System.Diagnostics.Stopwatch.StartNew();
+                long rateBytes = 0;
+
+                // Line for bytesSent; null = take the next one from the pipeline
+                UploadPipeline.Chunk chunk = null;
+                if (bytesSent > 0) await pipeline.RestartAsync(bytesSent);
 
                 while (bytesSent < totalBytes)
                 {
                     ct.ThrowIfCancellationRequested();
 
-                    int chunkSize = Math.Min(CHUNK_SIZE, totalBytes - bytesSent);
-                    string dataCmd = $"{_prefix}_DATA:{bytesSent}:{BytesToHex(data, bytesSent, chunkSize)}\n";
+                    if (HoldOff != null && HoldOff())
+                    {
+                        while (HoldOff())
+                            await Task.Delay(200, ct);
+                        rateClock.Restart();
+                        rateBytes = 0;
+                    }
+
+                    if (chunk == null) chunk = await pipeline.NextAsync(ct);
+                    if (chunk.Error != null)
+                    {
+                        Log("FATAL: Cannot read payload: " + chunk.Error + " - aborting upload");
+                        AbortSession();
+                        return false;
+                    }
+
+                    int chunkSize = chunk.Size;
+                    string dataCmd = chunk.Line;
 
                     if (chunksSent % 20 == 0 || bytesSent + chunkSize >= totalBytes)
                     {
                         Log($"TX Chunk {chunksSent + 1}/{totalChunks}: offset={bytesSent}, size={chunkSize}");
                     }
 
-                    response = await SendAndAwaitLineAsync(dataCmd, new[] { okData }, errAny, ct);
+                    response = await SendAndAwaitLineAsync(dataCmd, new[] { okData, nakPrefix }, errAny, ct);
 
                     if (response != null && response.Contains(okData))
                     {
                         // ACK received - advance
                         bytesSent += chunkSize;
+                        chunk = null;
                         chunksSent++;
                         timeoutRetries = 0;
                         resyncStalls = 0;
+                        nakRetries = 0;
                         ReportProgress(bytesSent, totalBytes, chunksSent, totalChunks, "Uploading...");
+
+                        if (_maxBytesPerSecond > 0)
+                        {
+                            rateBytes += chunkSize;
+                            long wait = rateBytes * 1000 / _maxBytesPerSecond - rateClock.ElapsedMilliseconds;
+                            if (wait > 0) await Task.Delay((int)wait, ct);
+                        }
+                        continue;
+                    }
+
+                    // NAK: the chunk arrived damaged and was dropped - resend it.
+                    // A line garbled beyond its CRC (hex or offset field) draws
+                    // HEX/PARSE instead; with CRCs on that means the same.
+                    if (response != null && IsDamagedChunkReply(response, nakPrefix))
+                    {
+                        if (++nakRetries > MAX_NAK_RETRIES)
+                        {
+                            Log($"FATAL: Chunk at offset {bytesSent} damaged {MAX_NAK_RETRIES} times - aborting upload");
+                            AbortSession();
+                            return false;
+                        }
+
+                        int nakIdx = response.IndexOf(nakPrefix, StringComparison.Ordinal);
+                        if (nakIdx >= 0
+                            && int.TryParse(response.Substring(nakIdx + nakPrefix.Length).Trim(), out int nakOffset)
+                            && nakOffset >= 0 && nakOffset <= totalBytes && nakOffset != bytesSent)
+                        {
+                            bytesSent = nakOffset;
+                            chunksSent = nakOffset / _chunkSize;
+                            chunk = null;
+                            await pipeline.RestartAsync(bytesSent);
+                        }
+
+                        ChunksResent++;
+                        Log($"Chunk at offset {bytesSent} damaged, resending ({nakRetries}/{MAX_NAK_RETRIES})");
                         continue;
                     }
 
@@ -145,16 +301,21 @@ namespace PCMonitorClient
                             // Guard against a stuck peer: resyncing to the same
                             // offset repeatedly means we make no progress.
                             resyncStalls = (expectedOffset == bytesSent) ? resyncStalls + 1 : 0;
-                            if (resyncStalls >= MAX_RETRIES)
+                            if (resyncStalls >= maxStalls)
                             {
                                 Log($"FATAL: Resync stalled at offset {bytesSent} - aborting upload");
-                                SendAbort();
+                                AbortSession();
                                 return false;
                             }
 
                             Log($"Resync: ESP expects offset {expectedOffset} (we were at {bytesSent})");
-                            bytesSent = expectedOffset;
-                            chunksSent = expectedOffset / CHUNK_SIZE;
+                            if (expectedOffset != bytesSent)
+                            {
+                                bytesSent = expectedOffset;
+                                chunksSent = expectedOffset / _chunkSize;
+                                chunk = null;
+                                await pipeline.RestartAsync(bytesSent);
+                            }
                             timeoutRetries = 0;
                             continue;
                         }
@@ -164,7 +325,7 @@ namespace PCMonitorClient
                     {
                         // Any other PREFIX_ERR is fatal (SIZE, NOMEM, WRITE, ...)
                         Log($"FATAL: ESP error: {response} - aborting upload");
-                        SendAbort();
+                        AbortSession();
                         return false;
                     }
 
@@ -173,7 +334,7 @@ namespace PCMonitorClient
                     if (timeoutRetries >= MAX_RETRIES)
                     {
                         Log($"FATAL: Chunk at offset {bytesSent} timed out {MAX_RETRIES} times - aborting upload");
-                        SendAbort();
+                        AbortSession();
                         return false;
                     }
                     Log($"No response for chunk at offset {bytesSent}, retrying ({timeoutRetries}/{MAX_RETRIES})...");
@@ -181,11 +342,19 @@ namespace PCMonitorClient
                 }
 
                 // --- Phase 3: END ---
-                string endCmd = $"{_prefix}_END:{crc32:X8}";
+                uint? streamed = await pipeline.FinishAsync();
+                if (streamed == null || (crc32.HasValue && streamed != crc32))
+                {
+                    Log("FATAL: Payload changed or shrank during the upload - aborting upload");
+                    AbortSession();
+                    return false;
+                }
+
+                string endCmd = $"{_prefix}_END:{streamed.Value:X8}";
                 Log("TX: " + endCmd);
 
                 response = await SendAndAwaitLineAsync(endCmd + "\n",
-                    new[] { _prefix + "_OK:END", _prefix + "_OK:COMPLETE" }, errAny, ct);
+                    new[] { _prefix + "_OK:END", _prefix + "_OK:COMPLETE", _prefix + "_OK:STAGED" }, errAny, ct);
 
                 if (response == null || response.Contains(errAny))
                 {
@@ -200,15 +369,47 @@ namespace PCMonitorClient
             catch (OperationCanceledException)
             {
                 Log("Upload cancelled");
-                SendAbort();
+                AbortSession();
                 return false;
             }
             catch (Exception ex)
             {
                 Log("Upload error: " + ex.Message);
-                SendAbort();
+                AbortSession();
                 return false;
             }
+            finally
+            {
+                await pipeline.StopAsync();
+            }
+        }
+
+        /// <summary>
+        /// True for a NAK, or with ChunkCrc for the errors a garbled DATA line
+        /// draws before its CRC can be checked (bad hex, unparsable offset).
+        /// </summary>
+        private bool IsDamagedChunkReply(string response, string nakPrefix)
+        {
+            if (response.Contains(nakPrefix)) return true;
+            return ChunkCrc && (response.Contains(_prefix + "_ERR:HEX") || response.Contains(_prefix + "_ERR:PARSE"));
+        }
+
+        /// <summary>
+        /// Offset the device wants to continue from (PREFIX_OK:BEGIN:[offset]),
+        /// 0 for a plain PREFIX_OK:BEGIN or an implausible value.
+        /// </summary>
+        private static int ParseResumeOffset(string response, string okBegin, int totalBytes)
+        {
+            int idx = response.IndexOf(okBegin + ":", StringComparison.Ordinal);
+            if (idx < 0) return 0;
+
+            string tail = response.Substring(idx + okBegin.Length + 1).Trim();
+            return int.TryParse(tail, out int offset) && offset > 0 && offset <= totalBytes ? offset : 0;
+        }
+
+        private void AbortSession()
+        {
+            if (SendAbortOnFailure) SendAbort();
         }
 
         /// <summary>
@@ -219,7 +420,6 @@ namespace PCMonitorClient
             lock (_writeLock)
             {
                 _port.Write(text);
-                _port.BaseStream.Flush();
             }
         }
 
@@ -314,16 +514,6 @@ namespace PCMonitorClient
             catch { }
         }
 
-        private static string BytesToHex(byte[] data, int offset, int length)
-        {
-            var sb = new StringBuilder(length * 2);
-            for (int i = 0; i < length; i++)
-            {
-                sb.Append(data[offset + i].ToString("X2"));
-            }
-            return sb.ToString();
-        }
-
         private void ReportProgress(int bytesSent, int totalBytes, int chunksSent, int totalChunks, string status)
         {
             ProgressChanged?.Invoke(this, new UploadProgressEventArgs
@@ -0,0 +1,417 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Text;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// User metrics from %AppData%\ScarabMonitor\metrics.txt, compiled to
+    /// bytecode and sent as one METRICS: line after each handshake (FEAT:EXPR
+    /// firmware only). The device runs them on every stats line; alert rules
+    /// can use them by name.
+    ///
+    /// One metric per line, lines starting with '#' are comments:
+    ///   vram_usage = vram_used / vram_total * 100
+    ///   cpu_smooth = ema(cpu_temp, 0.2)
+    ///   hot_gap = max(cpu_temp, gpu_temp) - 80
+    ///   peak = max(def(prev, 0), cpu_temp)
+    /// Inputs are the MetricInput names (cpu_load ... dt, in lower case) and
+    /// earlier metrics. Operators + - * / and parentheses; functions min, max,
+    /// abs, def(x, fallback) and ema(x, alpha), which smooths with the
+    /// metric's own previous value and so must be the whole expression.
+    /// prev is the metric's value on the previous stats line.
+    /// A value is N/A while a sensor it reads is N/A (def() replaces it).
+    /// Names must not clash with inputs, functions or AlertMetric names.
+    /// </summary>
+    public static class CustomMetrics
+    {
+        private static readonly string FilePath = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData),
+            "ScarabMonitor", "metrics.txt");
+
+        private static readonly string[] Functions = { "min", "max", "abs", "def", "ema", "prev" };
+
+        /// <summary>
+        /// Builds the METRICS: line (newline-terminated) from the metrics
+        /// file. Returns null if there is no file; sets error (and returns
+        /// null) if a line does not compile, so the device keeps its table.
+        /// </summary>
+        public static string LoadCommand(out string error)
+        {
+            error = null;
+            try
+            {
+                if (!File.Exists(FilePath)) return null;
+                return Encode(File.ReadAllLines(FilePath), out error);
+            }
+            catch (Exception ex)
+            {
+                error = ex.Message;
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Metric names in slot order, for alert rules. Empty without a file
+        /// or if it does not compile.
+        /// </summary>
+        public static IReadOnlyList<string> LoadNames()
+        {
+            try
+            {
+                if (!File.Exists(FilePath)) return Array.Empty<string>();
+                return Compile(File.ReadAllLines(FilePath), out List<string> names, out _) != null
+                    ? names : (IReadOnlyList<string>)Array.Empty<string>();
+            }
+            catch (Exception)
+            {
+                return Array.Empty<string>();
+            }
+        }
+
+        public static string Encode(IEnumerable<string> lines, out string error)
+        {
+            byte[] table = Compile(lines, out _, out error);
+            if (table == null) return null;
+
+            var sb = new StringBuilder(ProtocolCommands.METRICS, ProtocolCommands.METRICS.Length + table.Length * 2 + 1);
+            foreach (byte b in table) sb.Append(b.ToString("X2", CultureInfo.InvariantCulture));
+            return sb.Append('\n').ToString();
+        }
+
+        /// <summary>
+        /// Compiles the metric lines into a table (scarab_protocol.def layout,
+        /// CRC included). No metrics give an empty array. Null on error.
+        /// </summary>
+        public static byte[] Compile(IEnumerable<string> lines, out List<string> names, out string error)
+        {
+            error = null;
+            names = new List<string>();
+            var consts = new List<float>();
+            var code = new List<byte>();
+            var ends = new List<int>();
+            int lineNo = 0;
+
+            foreach (string raw in lines)
+            {
+                lineNo++;
+                string line = raw.Trim();
+                if (line.Length == 0 || line[0] == '#') continue;
+
+                int eq = line.IndexOf('=');
+                string name = eq > 0 ? line.Substring(0, eq).Trim() : null;
+                if (name == null || !IsName(name) || IsReserved(name)
+                    || names.Exists(n => n.Equals(name, StringComparison.OrdinalIgnoreCase)))
+                {
+                    error = "line " + lineNo + ": bad or duplicate name";
+                    return null;
+                }
+                if (names.Count == ProtocolConstants.METRIC_MAX_SLOTS)
+                {
+                    error = "more than " + ProtocolConstants.METRIC_MAX_SLOTS + " metrics";
+                    return null;
+                }
+
+                var c = new ExpressionCompiler(line.Substring(eq + 1), names.Count, names, consts, code);
+                if (!c.Compile(out string reason))
+                {
+                    error = "line " + lineNo + ": " + reason;
+                    return null;
+                }
+                if (code.Count / 4 > ProtocolConstants.METRIC_MAX_OPS)
+                {
+                    error = "line " + lineNo + ": more than " + ProtocolConstants.METRIC_MAX_OPS + " instructions in total";
+                    return null;
+                }
+                if (consts.Count > ProtocolConstants.METRIC_MAX_CONSTS)
+                {
+                    error = "line " + lineNo + ": more than " + ProtocolConstants.METRIC_MAX_CONSTS + " constants in total";
+                    return null;
+                }
+
+                names.Add(name);
+                ends.Add(code.Count / 4);
+            }
+
+            if (names.Count == 0) return Array.Empty<byte>();
+
+            int size = MetricTableHeader.SIZE + consts.Count * 4 + ends.Count * 2 + code.Count + 4;
+            var table = new byte[size];
+            var span = table.AsSpan();
+
+            new MetricTableHeader
+            {
+                Version = (byte)ProtocolConstants.METRIC_TABLE_VERSION,
+                SlotCount = (byte)names.Count,
+                ConstCount = (byte)consts.Count,
+                OpCount = (ushort)(code.Count / 4)
+            }.Write(span);
+
+            int pos = MetricTableHeader.SIZE;
+            foreach (float f in consts)
+            {
+                BinaryPrimitives.WriteInt32LittleEndian(span.Slice(pos), FloatBits(f));
+                pos += 4;
+            }
+            foreach (int end in ends)
+            {
+                BinaryPrimitives.WriteUInt16LittleEndian(span.Slice(pos), (ushort)end);
+                pos += 2;
+            }
+            code.CopyTo(table, pos);
+            pos += code.Count;
+
+            BinaryPrimitives.WriteUInt32LittleEndian(span.Slice(pos), ImageConverter.ComputeCrc32(table, 0, pos));
+            return table;
+        }
+
+        private static int FloatBits(float f) => BitConverter.ToInt32(BitConverter.GetBytes(f), 0);
+
+        private static bool IsName(string s)
+        {
+            if (!char.IsLetter(s[0]) && s[0] != '_') return false;
+            foreach (char ch in s)
+            {
+                if (!char.IsLetterOrDigit(ch) && ch != '_') return false;
+            }
+            return true;
+        }
+
+        private static bool IsReserved(string s)
+        {
+            return TryParseInput(s, out _)
+                   || (Enum.TryParse(s, true, out AlertMetric _) && !char.IsDigit(s[0]))
+                   || Array.Exists(Functions, f => f.Equals(s, StringComparison.OrdinalIgnoreCase));
+        }
+
+        private static bool TryParseInput(string s, out MetricInput input)
+        {
+            return Enum.TryParse(s, true, out input) && Enum.IsDefined(typeof(MetricInput), input)
+                   && !char.IsDigit(s[0]);
+        }
+
+        /// <summary>
+        /// Recursive descent over one expression. Each node compiles into
+        /// register "dst" and uses the registers above it for operands, so
+        /// nesting depth is what runs out of registers.
+        /// </summary>
+        private sealed class ExpressionCompiler
+        {
+            private readonly string _text;
+            private readonly int _slot;
+            private readonly List<string> _names;
+            private readonly List<float> _consts;
+            private readonly List<byte> _code;
+            private readonly int _start;
+            private int _pos;
+            private string _error;
+            private int _emaCount;
+            private int _emaStart;
+            private int _emaEnd;
+
+            public ExpressionCompiler(string text, int slot, List<string> names, List<float> consts, List<byte> code)
+            {
+                _text = text;
+                _slot = slot;
+                _names = names;
+                _consts = consts;
+                _code = code;
+                _start = code.Count;
+            }
+
+            public bool Compile(out string error)
+            {
+                bool ok = Expr(0);
+                SkipSpace();
+                if (ok && _pos < _text.Length) Fail("unexpected '" + _text[_pos] + "'");
+                else if (ok && _emaCount > 0 && (_emaCount > 1 || _emaStart != _start || _emaEnd != _code.Count))
+                    Fail("ema() must be the whole expression");
+
+                if (_error == null) Emit(MetricOp.RET, 0, 0, 0);
+                error = _error;
+                return _error == null;
+            }
+
+            // expr := term (('+' | '-') term)*
+            private bool Expr(int dst)
+            {
+                if (!Term(dst)) return false;
+                while (true)
+                {
+                    SkipSpace();
+                    if (!Peek('+') && !Peek('-')) return true;
+                    var op = _text[_pos++] == '+' ? MetricOp.ADD : MetricOp.SUB;
+                    if (!Reg(dst + 1) || !Term(dst + 1)) return false;
+                    Emit(op, dst, dst, dst + 1);
+                }
+            }
+
+            // term := unary (('*' | '/') unary)*
+            private bool Term(int dst)
+            {
+                if (!Unary(dst)) return false;
+                while (true)
+                {
+                    SkipSpace();
+                    if (!Peek('*') && !Peek('/')) return true;
+                    var op = _text[_pos++] == '*' ? MetricOp.MUL : MetricOp.DIV;
+                    if (!Reg(dst + 1) || !Unary(dst + 1)) return false;
+                    Emit(op, dst, dst, dst + 1);
+                }
+            }
+
+            // unary := '-' unary | primary
+            private bool Unary(int dst)
+            {
+                SkipSpace();
+                if (!Peek('-')) return Primary(dst);
+                _pos++;
+                if (!Unary(dst)) return false;
+                Emit(MetricOp.NEG, dst, dst, 0);
+                return true;
+            }
+
+            // primary := number | '(' expr ')' | name | function '(' args ')'
+            private bool Primary(int dst)
+            {
+                SkipSpace();
+                if (_pos >= _text.Length) return Fail("expression ends early");
+
+                char c = _text[_pos];
+                if (c == '(')
+                {
+                    _pos++;
+                    return Expr(dst) && Expect(')');
+                }
+                if (char.IsDigit(c) || c == '.') return Number(dst);
+                if (!char.IsLetter(c) && c != '_') return Fail("unexpected '" + c + "'");
+
+                int begin = _pos;
+                while (_pos < _text.Length && (char.IsLetterOrDigit(_text[_pos]) || _text[_pos] == '_')) _pos++;
+                string name = _text.Substring(begin, _pos - begin).ToLowerInvariant();
+
+                SkipSpace();
+                if (Peek('(')) return Call(name, dst);
+
+                if (name == "prev")
+                {
+                    Emit(MetricOp.LDM, dst, _slot, 0);
+                    return true;
+                }
+                if (TryParseInput(name, out MetricInput input))
+                {
+                    Emit(MetricOp.LDF, dst, (int)input, 0);
+                    return true;
+                }
+                int slot = _names.FindIndex(n => n.Equals(name, StringComparison.OrdinalIgnoreCase));
+                if (slot < 0) return Fail("unknown name '" + name + "'");
+                Emit(MetricOp.LDM, dst, slot, 0);
+                return true;
+            }
+
+            private bool Call(string name, int dst)
+            {
+                _pos++;     // '('
+                int start = _code.Count;
+
+                switch (name)
+                {
+                    case "abs":
+                        if (!Expr(dst) || !Expect(')')) return false;
+                        Emit(MetricOp.ABS, dst, dst, 0);
+                        return true;
+
+                    case "min":
+                    case "max":
+                    case "def":
+                        if (!Expr(dst) || !Expect(',') || !Reg(dst + 1) || !Expr(dst + 1) || !Expect(')')) return false;
+                        Emit(name == "min" ? MetricOp.MIN : name == "max" ? MetricOp.MAX : MetricOp.DEF, dst, dst, dst + 1);
+                        return true;
+
+                    case "ema":
+                        // prev = def(prev, x); value = prev + alpha * (x - prev)
+                        if (!Expr(dst) || !Expect(',') || !Reg(dst + 3) || !Expr(dst + 3) || !Expect(')')) return false;
+                        Emit(MetricOp.LDM, dst + 1, _slot, 0);
+                        Emit(MetricOp.DEF, dst + 1, dst + 1, dst);
+                        Emit(MetricOp.SUB, dst + 2, dst, dst + 1);
+                        Emit(MetricOp.MUL, dst + 2, dst + 2, dst + 3);
+                        Emit(MetricOp.ADD, dst, dst + 1, dst + 2);
+                        _emaCount++;
+                        _emaStart = start;
+                        _emaEnd = _code.Count;
+                        return true;
+
+                    default:
+                        return Fail("unknown function '" + name + "'");
+                }
+            }
+
+            private bool Number(int dst)
+            {
+                int begin = _pos;
+                while (_pos < _text.Length && (char.IsDigit(_text[_pos]) || _text[_pos] == '.')) _pos++;
+                if (_pos < _text.Length && (_text[_pos] == 'e' || _text[_pos] == 'E'))
+                {
+                    _pos++;
+                    if (_pos < _text.Length && (_text[_pos] == '+' || _text[_pos] == '-')) _pos++;
+                    while (_pos < _text.Length && char.IsDigit(_text[_pos])) _pos++;
+                }
+
+                string s = _text.Substring(begin, _pos - begin);
+                if (!float.TryParse(s, NumberStyles.Float, CultureInfo.InvariantCulture, out float value)
+                    || float.IsInfinity(value))
+                {
+                    return Fail("bad number '" + s + "'");
+                }
+
+                int index = _consts.FindIndex(v => FloatBits(v) == FloatBits(value));
+                if (index < 0)
+                {
+                    index = _consts.Count;
+                    _consts.Add(value);
+                }
+                if (index >= ProtocolConstants.METRIC_MAX_CONSTS) return Fail("more than " + ProtocolConstants.METRIC_MAX_CONSTS + " constants in total");
+
+                Emit(MetricOp.LDC, dst, index, 0);
+                return true;
+            }
+
+            private bool Reg(int r)
+            {
+                return r < ProtocolConstants.METRIC_REGS || Fail("expression nested too deeply");
+            }
+
+            private bool Expect(char c)
+            {
+                SkipSpace();
+                if (!Peek(c)) return Fail("'" + c + "' expected");
+                _pos++;
+                return true;
+            }
+
+            private bool Peek(char c) => _pos < _text.Length && _text[_pos] == c;
+
+            private void SkipSpace()
+            {
+                while (_pos < _text.Length && char.IsWhiteSpace(_text[_pos])) _pos++;
+            }
+
+            private bool Fail(string reason)
+            {
+                if (_error == null) _error = reason;
+                return false;
+            }
+
+            private void Emit(MetricOp op, int dst, int a, int b)
+            {
+                _code.Add((byte)op);
+                _code.Add((byte)dst);
+                _code.Add((byte)a);
+                _code.Add((byte)b);
+            }
+        }
+    }
+}
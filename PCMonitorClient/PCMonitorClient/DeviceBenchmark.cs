@@ -0,0 +1,272 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Runs the on-device self-benchmark (BENCH, FEAT:BENCH firmware) and
+    /// keeps the results per firmware version in
+    /// %AppData%\ScarabMonitor\bench\&lt;version&gt;.txt - the raw result
+    /// lines, so a later run can be compared with the previous firmware and
+    /// regressions between OTA builds show up on real hardware.
+    ///
+    /// Runs on a held port (MonitorCore.AcquirePortAsync): telemetry pauses
+    /// and the result lines come to the lease, not to the data loop.
+    /// </summary>
+    public sealed class DeviceBenchmark
+    {
+        private const int RESPONSE_TIMEOUT_MS = 30000;      // Whole suite, incl. LittleFS
+        private const int POLL_MS = 100;                    // Cancellation check while waiting for a line
+        public const double REGRESSION_THRESHOLD = 0.10;    // AVG slower by more than 10%
+
+        private static readonly string ResultDir = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData),
+            "ScarabMonitor", "bench");
+
+        private readonly PortLease _port;
+        private readonly object _writeLock;
+
+        public event EventHandler<string> LogMessage;
+
+        /// <summary>One BENCH: line.</summary>
+        public sealed class CaseResult
+        {
+            public string Name;
+            public int Runs;
+            public long AvgUs;
+            public long MaxUs;
+            public long Kbs;        // 0 = not a throughput case
+            public string Error;    // null = ran
+        }
+
+        /// <summary>A complete run (BENCH_BEGIN .. BENCH_END).</summary>
+        public sealed class Report
+        {
+            public string FirmwareVersion = "";
+            public long TotalMs;
+            public readonly List<CaseResult> Cases = new List<CaseResult>();
+            public readonly List<string> Lines = new List<string>();   // Wire lines, as stored
+
+            public CaseResult Find(string name) => Cases.FirstOrDefault(c => c.Name == name);
+        }
+
+        /// <param name="lease">The held port</param>
+        /// <param name="writeLock">Shared lock guarding all writes to the port</param>
+        public DeviceBenchmark(PortLease lease, object writeLock)
+        {
+            _port = lease ?? throw new ArgumentNullException(nameof(lease));
+            _writeLock = writeLock ?? new object();
+        }
+
+        /// <summary>
+        /// Sends BENCH and collects the result lines. Returns null on
+        /// timeout, BENCH_ERR or an incomplete run.
+        /// </summary>
+        public async Task<Report> RunAsync(CancellationToken ct = default)
+        {
+            lock (_writeLock)
+            {
+                _port.Write(ProtocolCommands.BENCH + "\n");
+            }
+
+            return await Task.Run(() => ReadReport(ct), ct);
+        }
+
+        private Report ReadReport(CancellationToken ct)
+        {
+            var lines = new List<string>();
+            var clock = Stopwatch.StartNew();
+
+            while (clock.ElapsedMilliseconds < RESPONSE_TIMEOUT_MS)
+            {
+                ct.ThrowIfCancellationRequested();
+
+                string line = _port.ReadLine(POLL_MS);
+                if (line == null)
+                {
+                    if (_port.IsOpen) continue;
+                    Log("Port closed");
+                    return null;
+                }
+
+                if (line.StartsWith(ProtocolCommands.BENCH_ERR, StringComparison.Ordinal))
+                {
+                    Log("Device refused: " + line);
+                    return null;
+                }
+                if (!line.StartsWith(ProtocolCommands.BENCH_BEGIN, StringComparison.Ordinal)
+                    && !line.StartsWith(ProtocolCommands.BENCH_RESULT, StringComparison.Ordinal)
+                    && !line.StartsWith(ProtocolCommands.BENCH_END, StringComparison.Ordinal))
+                {
+                    continue;   // ESP log output
+                }
+
+                lines.Add(line);
+                if (line.StartsWith(ProtocolCommands.BENCH_END, StringComparison.Ordinal))
+                {
+                    var report = Parse(lines);
+                    if (report == null) Log("Incomplete result");
+                    return report;
+                }
+            }
+
+            Log("Timeout waiting for " + ProtocolCommands.BENCH_END);
+            return null;
+        }
+
+        /// <summary>
+        /// Parses the lines of one run. Returns null if BENCH_BEGIN or
+        /// BENCH_END is missing.
+        /// </summary>
+        public static Report Parse(IEnumerable<string> lines)
+        {
+            var report = new Report();
+            bool begun = false, ended = false;
+
+            foreach (string line in lines)
+            {
+                if (line.StartsWith(ProtocolCommands.BENCH_BEGIN, StringComparison.Ordinal))
+                {
+                    string[] parts = line.Substring(ProtocolCommands.BENCH_BEGIN.Length).Split('|');
+                    report.FirmwareVersion = parts[0];
+                    begun = true;
+                }
+                else if (line.StartsWith(ProtocolCommands.BENCH_END, StringComparison.Ordinal))
+                {
+                    long.TryParse(line.Substring(ProtocolCommands.BENCH_END.Length), NumberStyles.None,
+                                  CultureInfo.InvariantCulture, out report.TotalMs);
+                    ended = true;
+                }
+                else if (line.StartsWith(ProtocolCommands.BENCH_RESULT, StringComparison.Ordinal))
+                {
+                    var result = ParseCase(line.Substring(ProtocolCommands.BENCH_RESULT.Length));
+                    if (result == null) continue;
+                    report.Cases.Add(result);
+                }
+                else
+                {
+                    continue;
+                }
+                report.Lines.Add(line);
+            }
+
+            return begun && ended ? report : null;
+        }
+
+        /// <summary>"CASE|N:3|AVG:..|MAX:..[|KBS:..]" or "CASE|ERR:reason".</summary>
+        private static CaseResult ParseCase(string text)
+        {
+            string[] parts = text.Split('|');
+            if (parts[0].Length == 0) return null;
+
+            var result = new CaseResult { Name = parts[0] };
+            for (int i = 1; i < parts.Length; i++)
+            {
+                int sep = parts[i].IndexOf(':');
+                if (sep <= 0) continue;
+                string key = parts[i].Substring(0, sep);
+                string value = parts[i].Substring(sep + 1);
+
+                if (key == "ERR")
+                {
+                    result.Error = value;
+                    continue;
+                }
+                if (!long.TryParse(value, NumberStyles.None, CultureInfo.InvariantCulture, out long n)) continue;
+
+                switch (key)
+                {
+                    case "N": result.Runs = (int)n; break;
+                    case "AVG": result.AvgUs = n; break;
+                    case "MAX": result.MaxUs = n; break;
+                    case "KBS": result.Kbs = n; break;
+                }
+            }
+            return result;
+        }
+
+        // ====================================================================
+        //  RESULTS PER FIRMWARE VERSION
+        // ====================================================================
+
+        /// <summary>Stores the run as bench\&lt;version&gt;.txt (replaces an older run of the same version).</summary>
+        public static void Save(Report report)
+        {
+            try
+            {
+                Directory.CreateDirectory(ResultDir);
+                File.WriteAllLines(PathFor(report.FirmwareVersion), report.Lines);
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine("[Bench] Result write failed: " + ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// The most recently stored run of any other firmware version, or
+        /// null if there is none.
+        /// </summary>
+        public static Report LoadPrevious(string firmwareVersion)
+        {
+            try
+            {
+                if (!Directory.Exists(ResultDir)) return null;
+
+                string current = PathFor(firmwareVersion);
+                var previous = new DirectoryInfo(ResultDir).GetFiles("*.txt")
+                    .Where(f => !string.Equals(f.FullName, current, StringComparison.OrdinalIgnoreCase))
+                    .OrderByDescending(f => f.LastWriteTimeUtc)
+                    .FirstOrDefault();
+
+                return previous == null ? null : Parse(File.ReadAllLines(previous.FullName));
+            }
+            catch
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Cases whose average got slower than baseline by more than
+        /// REGRESSION_THRESHOLD, as "CASE: old -> new us (+x%)".
+        /// </summary>
+        public static List<string> FindRegressions(Report baseline, Report current)
+        {
+            var regressions = new List<string>();
+            foreach (var now in current.Cases)
+            {
+                var before = baseline.Find(now.Name);
+                if (now.Error != null || before == null || before.Error != null || before.AvgUs <= 0) continue;
+
+                double change = (double)(now.AvgUs - before.AvgUs) / before.AvgUs;
+                if (change > REGRESSION_THRESHOLD)
+                {
+                    regressions.Add(string.Format(CultureInfo.InvariantCulture,
+                        "{0}: {1} -> {2} us (+{3:F0}%)", now.Name, before.AvgUs, now.AvgUs, change * 100));
+                }
+            }
+            return regressions;
+        }
+
+        private static string PathFor(string firmwareVersion)
+        {
+            string name = firmwareVersion.Length == 0 ? "unknown" : firmwareVersion;
+            foreach (char c in Path.GetInvalidFileNameChars())
+                name = name.Replace(c, '_');
+            return Path.Combine(ResultDir, name + ".txt");
+        }
+
+        private void Log(string message)
+        {
+            Console.WriteLine("[Bench] " + message);
+            LogMessage?.Invoke(this, message);
+        }
+    }
+}
@@ -0,0 +1,233 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Parsed GET_CAPS response:
+    /// CAPS:1|LINE:4096|CHUNK:2032|ENC:HEX|TELE:1|WIN:1|DISP:4x240x240|FEAT:TOP,DSK,VIEW|DIAG:...
+    ///
+    /// Firmware that predates GET_CAPS does not answer; Legacy then holds the
+    /// limits the client used to hard-code. Descriptors are cached per
+    /// identity hash + firmware build ID so reconnects skip the query.
+    /// </summary>
+    public sealed class DeviceCaps
+    {
+        public const string QUERY = ProtocolCommands.GET_CAPS + "\n";
+        public const string RESPONSE_PREFIX = ProtocolCommands.CAPS;
+
+        /// <summary>FEAT: token - screensaver images may be cropped and positioned (v2 header).</summary>
+        public const string FEATURE_SPRITES = "SPR";
+
+        /// <summary>FEAT: token - FW_STAGE background firmware staging (resumable, restart when idle).</summary>
+        public const string FEATURE_STAGED_OTA = "STAGE";
+
+        /// <summary>FEAT: token - HIST: history backfill after the handshake.</summary>
+        public const string FEATURE_HISTORY = "HIST";
+
+        /// <summary>FEAT: token - ALERT_RULES: threshold table evaluated on the device.</summary>
+        public const string FEATURE_ALERTS = "ALRT";
+
+        /// <summary>FEAT: token - BENCH on-device self-benchmark.</summary>
+        public const string FEATURE_BENCH = "BENCH";
+
+        /// <summary>FEAT: token - *_DATA lines may carry a chunk CRC; damaged chunks are NAKed.</summary>
+        public const string FEATURE_CHUNK_CRC = "CRC";
+
+        /// <summary>FEAT: token - @&lt;id&gt;: request IDs, echoed on the replies (DeviceRpc).</summary>
+        public const string FEATURE_RPC = "RPC";
+
+        /// <summary>FEAT: token - METRICS: custom metrics bytecode table (CustomMetrics).</summary>
+        public const string FEATURE_EXPR = "EXPR";
+
+        /// <summary>FEAT: token - PROFILE_* theme profiles stored on the device.</summary>
+        public const string FEATURE_PROFILES = "PROF";
+
+        /// <summary>Largest chunk the client will ever send, whatever the device offers.</summary>
+        public const int CLIENT_MAX_CHUNK = 4096;
+
+        /// <summary>Encodings this client can produce, fastest first.</summary>
+        private static readonly string[] ClientEncodings = { "HEX" };
+
+        /// <summary>Telemetry line versions this client can produce, newest first.</summary>
+        private static readonly int[] ClientTelemetryVersions = { 1 };
+
+        private static readonly string CachePath = SharedData.PathOf("device_caps.txt");
+
+        private static readonly object CacheLock = new object();
+
+        public int Version { get; private set; }
+        public int MaxLineBytes { get; private set; } = 4096;
+        public int MaxChunkBytes { get; private set; } = 1024;
+        public string[] Encodings { get; private set; } = { "HEX" };
+        public int[] TelemetryVersions { get; private set; } = { 1 };
+        public int TransferWindow { get; private set; } = 1;
+        public int DisplayCount { get; private set; } = 4;
+        public int DisplayWidth { get; private set; } = 240;
+        public int DisplayHeight { get; private set; } = 240;
+        public string[] Features { get; private set; } = Array.Empty<string>();
+        public string[] Diagnostics { get; private set; } = Array.Empty<string>();
+
+        /// <summary>True if the device did not answer GET_CAPS (defaults in use).</summary>
+        public bool IsLegacy => Version == 0;
+
+        /// <summary>Raw descriptor line (what gets cached).</summary>
+        public string Raw { get; private set; } = "";
+
+        /// <summary>Limits of firmware without GET_CAPS.</summary>
+        public static DeviceCaps Legacy { get; } = new DeviceCaps();
+
+        // --- Negotiated modes (fastest mutually supported) ---
+
+        /// <summary>Chunk size for IMG_/FW_ uploads.</summary>
+        public int UploadChunkBytes => Math.Max(1, Math.Min(MaxChunkBytes, CLIENT_MAX_CHUNK));
+
+        /// <summary>Payload encoding for *_DATA lines, or null if none is shared.</summary>
+        public string UploadEncoding => ClientEncodings.FirstOrDefault(e => Encodings.Contains(e));
+
+        /// <summary>True if *_DATA lines should carry a per-chunk CRC.</summary>
+        public bool UploadChunkCrc => HasFeature(FEATURE_CHUNK_CRC);
+
+        /// <summary>Highest telemetry line version both sides understand (0 = none).</summary>
+        public int TelemetryVersion => ClientTelemetryVersions.FirstOrDefault(v => TelemetryVersions.Contains(v));
+
+        public bool HasFeature(string feature) => Features.Contains(feature);
+
+        public bool HasDiagnostic(string command) => Diagnostics.Contains(command);
+
+        /// <summary>
+        /// Parses one response line. Returns null if it is not a caps descriptor.
+        /// Unknown keys are ignored so newer firmware can extend the format.
+        /// </summary>
+        public static DeviceCaps Parse(string line)
+        {
+            if (line == null) return null;
+            line = line.Trim();
+            if (!line.StartsWith(RESPONSE_PREFIX, StringComparison.Ordinal)) return null;
+
+            var caps = new DeviceCaps { Raw = line };
+            foreach (string field in line.Split('|'))
+            {
+                int colon = field.IndexOf(':');
+                if (colon <= 0) continue;
+                string key = field.Substring(0, colon);
+                string value = field.Substring(colon + 1);
+
+                switch (key)
+                {
+                    case "CAPS": caps.Version = ParseInt(value, 0); break;
+                    case "LINE": caps.MaxLineBytes = ParseInt(value, caps.MaxLineBytes); break;
+                    case "CHUNK": caps.MaxChunkBytes = ParseInt(value, caps.MaxChunkBytes); break;
+                    case "ENC": caps.Encodings = ParseList(value); break;
+                    case "TELE": caps.TelemetryVersions = ParseList(value).Select(v => ParseInt(v, 0)).ToArray(); break;
+                    case "WIN": caps.TransferWindow = ParseInt(value, caps.TransferWindow); break;
+                    case "FEAT": caps.Features = ParseList(value); break;
+                    case "DIAG": caps.Diagnostics = ParseList(value); break;
+                    case "DISP":
+                        var dims = value.Split('x');
+                        if (dims.Length == 3)
+                        {
+                            caps.DisplayCount = ParseInt(dims[0], caps.DisplayCount);
+                            caps.DisplayWidth = ParseInt(dims[1], caps.DisplayWidth);
+                            caps.DisplayHeight = ParseInt(dims[2], caps.DisplayHeight);
+                        }
+                        break;
+                }
+            }
+
+            // A zero version means the line was garbled - don't trust the rest
+            return caps.Version > 0 ? caps : null;
+        }
+
+        public override string ToString()
+        {
+            if (IsLegacy) return "legacy (no GET_CAPS), chunk " + MaxChunkBytes;
+            return $"v{Version}, chunk {UploadChunkBytes}, {UploadEncoding ?? "no shared encoding"}, " +
+                   $"window {TransferWindow}, {DisplayCount}x{DisplayWidth}x{DisplayHeight}, " +
+                   $"features {string.Join(",", Features)}";
+        }
+
+        // ====================================================================
+        //  CACHE (one line per device: HASH|BUILD|<descriptor>)
+        // ====================================================================
+
+        /// <summary>
+        /// Returns the cached descriptor for this device, or null if there is
+        /// none, it was recorded for a different firmware build, or the
+        /// firmware reports no build ID.
+        /// </summary>
+        public static DeviceCaps LoadCached(string identityHash, string buildId)
+        {
+            if (string.IsNullOrEmpty(buildId)) return null;
+
+            string entry;
+            lock (CacheLock)
+            {
+                entry = ReadCache().TryGetValue(identityHash ?? "", out var e) ? e : null;
+            }
+            if (entry == null) return null;
+
+            int sep = entry.IndexOf('|');
+            if (sep < 0 || entry.Substring(0, sep) != buildId) return null;
+
+            // Entries written before the build ID key may hold an empty (Legacy) descriptor
+            return Parse(entry.Substring(sep + 1));
+        }
+
+        /// <summary>
+        /// Stores a descriptor the device actually sent. Legacy (no reply) is
+        /// never stored: silence may just be a slow boot.
+        /// </summary>
+        public static void SaveCached(string identityHash, string buildId, DeviceCaps caps)
+        {
+            if (string.IsNullOrEmpty(identityHash) || string.IsNullOrEmpty(buildId) ||
+                caps == null || caps.IsLegacy) return;
+
+            try
+            {
+                lock (CacheLock)
+                {
+                    var entries = ReadCache();
+                    entries[identityHash] = buildId + "|" + caps.Raw;
+
+                    SharedData.WriteAllLines(CachePath, entries.Select(kv => kv.Key + "|" + kv.Value));
+                }
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine("  [Caps]     Cache write failed: " + ex.Message);
+            }
+        }
+
+        private static Dictionary<string, string> ReadCache()
+        {
+            var entries = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase);
+            try
+            {
+                if (!File.Exists(CachePath)) return entries;
+                foreach (string line in File.ReadAllLines(CachePath))
+                {
+                    int sep = line.IndexOf('|');
+                    if (sep > 0) entries[line.Substring(0, sep)] = line.Substring(sep + 1);
+                }
+            }
+            catch { }
+            return entries;
+        }
+
+        private static int ParseInt(string s, int fallback)
+        {
+            return int.TryParse(s, NumberStyles.Integer, CultureInfo.InvariantCulture, out int v) ? v : fallback;
+        }
+
+        private static string[] ParseList(string s)
+        {
+            return s.Split(new[] { ',' }, StringSplitOptions.RemoveEmptyEntries)
+                    .Select(v => v.Trim())
+                    .ToArray();
+        }
+    }
+}
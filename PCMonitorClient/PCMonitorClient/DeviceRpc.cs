@@ -0,0 +1,279 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Control commands with request IDs (FEAT:RPC firmware). Each call goes
+    /// out as @&lt;id&gt;:&lt;command&gt;; the device tags every reply line with
+    /// the ID and ends with @&lt;id&gt;:RPC_END:OK (or :UNKNOWN). Many calls can
+    /// be in flight at once and each reply reaches the call that caused it,
+    /// whatever order the lines arrive in.
+    ///
+    /// DeviceRpc never reads the port: the connection's SerialDispatcher
+    /// hands it every tagged line (HandleLine). Calls therefore keep working
+    /// while an upload, the benchmark or background staging holds the port -
+    /// their replies are untagged and go to the holder.
+    /// </summary>
+    public sealed class DeviceRpc
+    {
+        public const int DEFAULT_TIMEOUT_MS = 2000;
+        public const int MAX_IN_FLIGHT = 16;    // Commands are short; keeps well inside the device RX buffer
+
+        private readonly ISerialLink _port;
+        private readonly object _writeLock;
+        private readonly object _sync = new object();
+        private readonly Dictionary<int, Pending> _pending = new Dictionary<int, Pending>();
+        private readonly SemaphoreSlim _window = new SemaphoreSlim(MAX_IN_FLIGHT);
+        private int _lastId;
+
+        // Metrics (under _sync)
+        private long _calls;
+        private long _unknown;
+        private long _timeouts;
+        private long _failed;
+        private long _answered;
+        private double _latencySumMs;
+        private double _latencyMaxMs;
+
+        public event EventHandler<string> LogMessage;
+
+        public enum ReplyStatus
+        {
+            Ok,         // Handled by the device
+            Unknown,    // No handler took the command
+            Timeout,    // No RPC_END within the timeout
+            Failed      // Write error, port lost or cancelled
+        }
+
+        /// <summary>Outcome of one call.</summary>
+        public sealed class Reply
+        {
+            public int Id;
+            public string Command;
+            public ReplyStatus Status;
+            public double LatencyMs;                                // Send to RPC_END (or give-up)
+            public readonly List<string> Lines = new List<string>(); // Reply lines before RPC_END, tag removed
+
+            public bool Ok => Status == ReplyStatus.Ok;
+        }
+
+        /// <summary>Counters since construction.</summary>
+        public sealed class Metrics
+        {
+            public long Calls;
+            public long Ok;
+            public long Unknown;
+            public long Timeouts;
+            public long Failed;
+            public int InFlight;
+            public double AvgLatencyMs;     // Answered calls (OK + UNKNOWN)
+            public double MaxLatencyMs;
+
+            public override string ToString() => string.Format(CultureInfo.InvariantCulture,
+                "{0} calls, {1} ok, {2} unknown, {3} timeouts, {4} failed, avg {5:F1} ms, max {6:F1} ms",
+                Calls, Ok, Unknown, Timeouts, Failed, AvgLatencyMs, MaxLatencyMs);
+        }
+
+        private sealed class Pending
+        {
+            public readonly Reply Reply = new Reply();
+            public readonly Stopwatch Clock = Stopwatch.StartNew();
+            public readonly TaskCompletionSource<Reply> Done =
+                new TaskCompletionSource<Reply>(TaskCreationOptions.RunContinuationsAsynchronously);
+        }
+
+        /// <param name="link">Where requests are written (replies come through HandleLine)</param>
+        /// <param name="writeLock">Shared lock guarding all writes to the port</param>
+        public DeviceRpc(ISerialLink link, object writeLock)
+        {
+            _port = link ?? throw new ArgumentNullException(nameof(link));
+            _writeLock = writeLock ?? new object();
+        }
+
+        /// <summary>
+        /// Sends one command (without newline) and completes when the device
+        /// has handled it. Does not wait for earlier calls; at most
+        /// MAX_IN_FLIGHT are outstanding, further calls queue for a slot.
+        /// </summary>
+        public async Task<Reply> CallAsync(string command, int timeoutMs = DEFAULT_TIMEOUT_MS, CancellationToken ct = default)
+        {
+            try
+            {
+                await _window.WaitAsync(ct);
+            }
+            catch (OperationCanceledException)
+            {
+                return new Reply { Command = command, Status = ReplyStatus.Failed };
+            }
+
+            try
+            {
+                Pending p = Register(command);
+                try
+                {
+                    lock (_writeLock)
+                    {
+                        _port.Write(ProtocolCommands.RPC_TAG + p.Reply.Id.ToString(CultureInfo.InvariantCulture)
+                                    + ":" + command + "\n");
+                    }
+                }
+                catch (Exception ex)
+                {
+                    Log("Write failed: " + ex.Message);
+                    return Complete(p, ReplyStatus.Failed);
+                }
+
+                var timeout = Task.Delay(timeoutMs, ct);
+                if (await Task.WhenAny(p.Done.Task, timeout) != p.Done.Task)
+                {
+                    if (!ct.IsCancellationRequested) Log($"Timeout: #{p.Reply.Id} {command}");
+                    return Complete(p, ct.IsCancellationRequested ? ReplyStatus.Failed : ReplyStatus.Timeout);
+                }
+                return await p.Done.Task;
+            }
+            finally
+            {
+                _window.Release();
+            }
+        }
+
+        /// <summary>
+        /// Fails all outstanding calls (connection lost). Late replies are
+        /// dropped.
+        /// </summary>
+        public void CancelAll()
+        {
+            lock (_sync)
+            {
+                foreach (var p in _pending.Values.ToList())
+                    CompleteLocked(p, ReplyStatus.Failed);
+            }
+        }
+
+        public Metrics GetMetrics()
+        {
+            lock (_sync)
+            {
+                return new Metrics
+                {
+                    Calls = _calls,
+                    Ok = _answered - _unknown,
+                    Unknown = _unknown,
+                    Timeouts = _timeouts,
+                    Failed = _failed,
+                    InFlight = _pending.Count,
+                    AvgLatencyMs = _answered > 0 ? _latencySumMs / _answered : 0,
+                    MaxLatencyMs = _latencyMaxMs
+                };
+            }
+        }
+
+        // ====================================================================
+        //  REQUEST TABLE
+        // ====================================================================
+
+        private Pending Register(string command)
+        {
+            var p = new Pending();
+            p.Reply.Command = command;
+
+            lock (_sync)
+            {
+                // IDs 1..RPC_ID_MAX, skipping any still in flight
+                do
+                {
+                    _lastId = _lastId % ProtocolConstants.RPC_ID_MAX + 1;
+                } while (_pending.ContainsKey(_lastId));
+
+                p.Reply.Id = _lastId;
+                _pending.Add(_lastId, p);
+                _calls++;
+            }
+            return p;
+        }
+
+        /// <summary>
+        /// Ends a call with the given status, unless the reader completed it
+        /// first - then that result stands.
+        /// </summary>
+        private Reply Complete(Pending p, ReplyStatus status)
+        {
+            lock (_sync)
+            {
+                CompleteLocked(p, status);
+            }
+            return p.Done.Task.Result;
+        }
+
+        private void CompleteLocked(Pending p, ReplyStatus status)
+        {
+            if (!_pending.Remove(p.Reply.Id)) return;
+
+            p.Reply.Status = status;
+            p.Reply.LatencyMs = p.Clock.Elapsed.TotalMilliseconds;
+
+            switch (status)
+            {
+                case ReplyStatus.Timeout: _timeouts++; break;
+                case ReplyStatus.Failed: _failed++; break;
+                default:
+                    if (status == ReplyStatus.Unknown) _unknown++;
+                    _answered++;
+                    _latencySumMs += p.Reply.LatencyMs;
+                    _latencyMaxMs = Math.Max(_latencyMaxMs, p.Reply.LatencyMs);
+                    break;
+            }
+
+            p.Done.TrySetResult(p.Reply);
+        }
+
+        // ====================================================================
+        //  REPLIES (from SerialDispatcher)
+        // ====================================================================
+
+        /// <summary>
+        /// One "@&lt;id&gt;:&lt;reply&gt;" line. Called on the dispatcher's reader
+        /// thread; lines that are not replies to a pending call are dropped.
+        /// </summary>
+        public void HandleLine(string line)
+        {
+            if (!line.StartsWith(ProtocolCommands.RPC_TAG, StringComparison.Ordinal)) return;
+
+            int colon = line.IndexOf(':');
+            if (colon <= ProtocolCommands.RPC_TAG.Length
+                || !int.TryParse(line.Substring(ProtocolCommands.RPC_TAG.Length, colon - ProtocolCommands.RPC_TAG.Length),
+                                 NumberStyles.None, CultureInfo.InvariantCulture, out int id))
+            {
+                return;
+            }
+            string body = line.Substring(colon + 1);
+
+            lock (_sync)
+            {
+                if (!_pending.TryGetValue(id, out Pending p)) return;    // Late reply of a timed-out call
+
+                if (body.StartsWith(ProtocolCommands.RPC_END, StringComparison.Ordinal))
+                {
+                    bool ok = body.Substring(ProtocolCommands.RPC_END.Length) == "OK";
+                    CompleteLocked(p, ok ? ReplyStatus.Ok : ReplyStatus.Unknown);
+                }
+                else
+                {
+                    p.Reply.Lines.Add(body);
+                }
+            }
+        }
+
+        private void Log(string message)
+        {
+            Console.WriteLine("[RPC] " + message);
+            LogMessage?.Invoke(this, message);
+        }
+    }
+}
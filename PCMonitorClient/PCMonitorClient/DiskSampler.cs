@@ -0,0 +1,322 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Runtime.InteropServices;
+using Microsoft.Win32.SafeHandles;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Raw cumulative I/O counters of one physical disk.
+    /// </summary>
+    public struct DiskCounterSample
+    {
+        public string Name;
+        public long BytesRead;
+        public long BytesWritten;
+        public long Reads;
+        public long Writes;
+        public long BusyTime100ns;      // Time spent servicing I/O (read + write)
+        public long QueueTime100ns;     // Linux: weighted I/O time (integral of queue length), else 0
+        public int QueueDepth;          // Instantaneous in-flight requests
+    }
+
+    /// <summary>
+    /// Backend that reads cumulative counters for all physical disks.
+    /// </summary>
+    public interface IDiskCounterSource
+    {
+        void Read(List<DiskCounterSample> into);
+    }
+
+    /// <summary>
+    /// Per-disk I/O rates derived from two counter snapshots.
+    /// </summary>
+    public sealed class DiskRates
+    {
+        public string Name { get; internal set; } = "";
+        public float ReadMBps { get; internal set; }
+        public float WriteMBps { get; internal set; }
+        public float ReadIops { get; internal set; }
+        public float WriteIops { get; internal set; }
+        public float QueueDepth { get; internal set; }      // Average over the interval where available
+        public float LatencyMs { get; internal set; }       // Mean service time per I/O
+    }
+
+    /// <summary>
+    /// Disk I/O sampler: throughput, IOPS, queue depth and latency per disk,
+    /// computed from deltas of cumulative counters (no PerformanceCounter
+    /// category lookups). Backends: /proc/diskstats on Linux,
+    /// IOCTL_DISK_PERFORMANCE on \\.\PhysicalDriveN on Windows.
+    /// </summary>
+    public sealed class DiskSampler
+    {
+        private readonly IDiskCounterSource _source;
+        private readonly Dictionary<string, DiskCounterSample> _last = new Dictionary<string, DiskCounterSample>();
+        private readonly Dictionary<string, DiskRates> _rates = new Dictionary<string, DiskRates>();
+        private readonly List<DiskCounterSample> _samples = new List<DiskCounterSample>(8);
+        private readonly System.Diagnostics.Stopwatch _wall = System.Diagnostics.Stopwatch.StartNew();
+        private long _lastWallTicks;
+        private bool _failed;
+
+        /// <summary>Sum over all disks (queue depth summed, latency I/O-weighted).</summary>
+        public DiskRates Total { get; } = new DiskRates { Name = "All" };
+
+        /// <summary>Per-disk rates from the last Sample().</summary>
+        public IEnumerable<DiskRates> Disks => _rates.Values;
+
+        /// <summary>False if the backend failed or found no disk.</summary>
+        public bool IsAvailable => !_failed && _rates.Count > 0;
+
+        public DiskSampler(IDiskCounterSource source)
+        {
+            _source = source ?? throw new ArgumentNullException(nameof(source));
+        }
+
+        public static DiskSampler CreateDefault()
+        {
+            if (Environment.OSVersion.Platform == PlatformID.Unix && File.Exists("/proc/diskstats"))
+                return new DiskSampler(new ProcDiskStatsSource("/proc/diskstats", "/sys/block"));
+            return new DiskSampler(new WinDiskPerformanceSource());
+        }
+
+        /// <summary>
+        /// Reads counters and updates per-disk and total rates. The first
+        /// call only primes the baselines.
+        /// </summary>
+        public void Sample()
+        {
+            if (_failed) return;
+
+            _samples.Clear();
+            try
+            {
+                _source.Read(_samples);
+            }
+            catch (Exception ex)
+            {
+                _failed = true;
+                Console.WriteLine("  [Disk]     Sampler disabled - " + ex.Message);
+                return;
+            }
+
+            long now = _wall.Elapsed.Ticks;
+            double seconds = _lastWallTicks > 0 ? (now - _lastWallTicks) / (double)TimeSpan.TicksPerSecond : 0;
+            _lastWallTicks = now;
+
+            float rMB = 0, wMB = 0, rIops = 0, wIops = 0, queue = 0;
+            long ios = 0, busy = 0;
+
+            foreach (var cur in _samples)
+            {
+                if (!_rates.TryGetValue(cur.Name, out var r))
+                {
+                    r = new DiskRates { Name = cur.Name };
+                    _rates[cur.Name] = r;
+                }
+
+                if (seconds > 0 && _last.TryGetValue(cur.Name, out var prev))
+                {
+                    long dReads = Math.Max(0, cur.Reads - prev.Reads);
+                    long dWrites = Math.Max(0, cur.Writes - prev.Writes);
+                    long dBusy = Math.Max(0, cur.BusyTime100ns - prev.BusyTime100ns);
+
+                    r.ReadMBps = (float)(Math.Max(0, cur.BytesRead - prev.BytesRead) / seconds / (1024.0 * 1024.0));
+                    r.WriteMBps = (float)(Math.Max(0, cur.BytesWritten - prev.BytesWritten) / seconds / (1024.0 * 1024.0));
+                    r.ReadIops = (float)(dReads / seconds);
+                    r.WriteIops = (float)(dWrites / seconds);
+                    r.LatencyMs = (dReads + dWrites) > 0 ? (float)(dBusy / 10000.0 / (dReads + dWrites)) : 0f;
+
+                    // Average queue = integral of queue length / interval (Little's law)
+                    // when the backend provides it, else the instantaneous depth
+                    long dQueue = cur.QueueTime100ns - prev.QueueTime100ns;
+                    r.QueueDepth = (cur.QueueTime100ns > 0 && dQueue >= 0)
+                        ? (float)(dQueue / (seconds * TimeSpan.TicksPerSecond))
+                        : cur.QueueDepth;
+
+                    rMB += r.ReadMBps; wMB += r.WriteMBps;
+                    rIops += r.ReadIops; wIops += r.WriteIops;
+                    queue += r.QueueDepth;
+                    ios += dReads + dWrites;
+                    busy += dBusy;
+                }
+                _last[cur.Name] = cur;
+            }
+
+            // Drop disks that disappeared (USB drive unplugged)
+            if (_rates.Count > _samples.Count)
+            {
+                var live = new HashSet<string>();
+                foreach (var cur in _samples) live.Add(cur.Name);
+                foreach (var name in new List<string>(_rates.Keys))
+                {
+                    if (!live.Contains(name)) { _rates.Remove(name); _last.Remove(name); }
+                }
+            }
+
+            Total.ReadMBps = rMB;
+            Total.WriteMBps = wMB;
+            Total.ReadIops = rIops;
+            Total.WriteIops = wIops;
+            Total.QueueDepth = queue;
+            Total.LatencyMs = ios > 0 ? (float)(busy / 10000.0 / ios) : 0f;
+        }
+    }
+
+    /// <summary>
+    /// Linux backend: /proc/diskstats. Only whole disks (entries that exist
+    /// in /sys/block) are reported - partitions would double count. Paths are
+    /// configurable so captured fixtures can be used.
+    /// </summary>
+    public sealed class ProcDiskStatsSource : IDiskCounterSource
+    {
+        private const long SECTOR_BYTES = 512;  // diskstats sectors are always 512 B
+        private readonly string _statsPath;
+        private readonly string _sysBlock;
+
+        public ProcDiskStatsSource(string statsPath, string sysBlockDir)
+        {
+            _statsPath = statsPath;
+            _sysBlock = sysBlockDir;
+        }
+
+        public void Read(List<DiskCounterSample> into)
+        {
+            bool haveSys = _sysBlock != null && Directory.Exists(_sysBlock);
+
+            foreach (string line in File.ReadLines(_statsPath))
+            {
+                if (!TryParseLine(line, out var s)) continue;
+                if (IsVirtual(s.Name)) continue;
+                if (haveSys && !Directory.Exists(Path.Combine(_sysBlock, s.Name))) continue;
+                into.Add(s);
+            }
+        }
+
+        private static bool IsVirtual(string name)
+        {
+            // Loop mounts and RAM-backed devices (zram swap) are not storage I/O
+            return name.StartsWith("loop", StringComparison.Ordinal)
+                || name.StartsWith("ram", StringComparison.Ordinal)
+                || name.StartsWith("zram", StringComparison.Ordinal);
+        }
+
+        /// <summary>
+        /// "maj min name rd rd_merged rd_sectors rd_ms wr wr_merged wr_sectors
+        ///  wr_ms in_flight io_ms weighted_ms ..." (times in ms)
+        /// </summary>
+        internal static bool TryParseLine(string line, out DiskCounterSample s)
+        {
+            s = default;
+            var f = line.Split((char[])null, StringSplitOptions.RemoveEmptyEntries);
+            if (f.Length < 14) return false;
+
+            var v = new long[11];
+            for (int i = 0; i < 11; i++)
+            {
+                if (!long.TryParse(f[3 + i], NumberStyles.Integer, CultureInfo.InvariantCulture, out v[i])) return false;
+            }
+
+            s.Name = f[2];
+            s.Reads = v[0];
+            s.BytesRead = v[2] * SECTOR_BYTES;
+            s.Writes = v[4];
+            s.BytesWritten = v[6] * SECTOR_BYTES;
+            s.BusyTime100ns = (v[3] + v[7]) * 10000;
+            s.QueueDepth = (int)v[8];
+            s.QueueTime100ns = v[10] * 10000;
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Windows backend: IOCTL_DISK_PERFORMANCE returns cumulative byte/IO
+    /// counters per physical drive. The drive is opened with zero access
+    /// rights, which is allowed without admin.
+    /// </summary>
+    public sealed class WinDiskPerformanceSource : IDiskCounterSource
+    {
+        private const uint IOCTL_DISK_PERFORMANCE = 0x70020;
+        private const uint FILE_SHARE_READ_WRITE = 0x3;
+        private const uint OPEN_EXISTING = 3;
+        private const int MAX_DRIVES = 16;
+        private const int RESCAN_INTERVAL = 60;     // Samples between probing for new drives
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct DISK_PERFORMANCE
+        {
+            public long BytesRead;
+            public long BytesWritten;
+            public long ReadTime;
+            public long WriteTime;
+            public long IdleTime;
+            public uint ReadCount;
+            public uint WriteCount;
+            public uint QueueDepth;
+            public uint SplitCount;
+            public long QueryTime;
+            public uint StorageDeviceNumber;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = 8)]
+            public ushort[] StorageManagerName;
+        }
+
+        [DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+        private static extern SafeFileHandle CreateFile(string name, uint access, uint share, IntPtr security,
+            uint creation, uint flags, IntPtr template);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool DeviceIoControl(SafeFileHandle device, uint code, IntPtr inBuf, int inSize,
+            out DISK_PERFORMANCE outBuf, int outSize, out int returned, IntPtr overlapped);
+
+        private readonly SafeFileHandle[] _handles = new SafeFileHandle[MAX_DRIVES];
+        private int _sinceRescan = RESCAN_INTERVAL;
+
+        ~WinDiskPerformanceSource()
+        {
+            foreach (var h in _handles) h?.Dispose();
+        }
+
+        public void Read(List<DiskCounterSample> into)
+        {
+            // Handles stay open between samples; only probe for new drives occasionally
+            if (++_sinceRescan >= RESCAN_INTERVAL)
+            {
+                _sinceRescan = 0;
+                for (int i = 0; i < MAX_DRIVES; i++)
+                {
+                    if (_handles[i] != null && !_handles[i].IsInvalid) continue;
+                    var h = CreateFile(@"\\.\PhysicalDrive" + i, 0, FILE_SHARE_READ_WRITE, IntPtr.Zero, OPEN_EXISTING, 0, IntPtr.Zero);
+                    if (h.IsInvalid) { h.Dispose(); _handles[i] = null; }
+                    else _handles[i] = h;
+                }
+            }
+
+            int size = Marshal.SizeOf(typeof(DISK_PERFORMANCE));
+            for (int i = 0; i < MAX_DRIVES; i++)
+            {
+                var h = _handles[i];
+                if (h == null) continue;
+
+                if (!DeviceIoControl(h, IOCTL_DISK_PERFORMANCE, IntPtr.Zero, 0, out var p, size, out _, IntPtr.Zero))
+                {
+                    // Drive removed - close, rescan will pick up a new one
+                    h.Dispose();
+                    _handles[i] = null;
+                    continue;
+                }
+
+                into.Add(new DiskCounterSample
+                {
+                    Name = "PhysicalDrive" + i,
+                    BytesRead = p.BytesRead,
+                    BytesWritten = p.BytesWritten,
+                    Reads = p.ReadCount,
+                    Writes = p.WriteCount,
+                    BusyTime100ns = p.ReadTime + p.WriteTime,
+                    QueueDepth = (int)p.QueueDepth
+                });
+            }
+        }
+    }
+}
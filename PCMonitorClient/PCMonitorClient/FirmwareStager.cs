@@ -0,0 +1,304 @@
+using System;
+using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Background firmware update job (FW_STAGE, device feature FEAT:STAGE).
+    ///
+    /// The chosen image is remembered in %AppData%\ScarabMonitor\fw_stage.txt
+    /// together with the device it is meant for, so the trickle continues
+    /// after a reconnect or client restart - the device reports how much of
+    /// the image it already holds. Telemetry keeps running the whole time.
+    /// After FW_OK:STAGED the job is done: the device switches to the new
+    /// firmware by itself the next time it is idle (screensaver), so the only
+    /// downtime is the reboot.
+    /// </summary>
+    public sealed class FirmwareStager
+    {
+        private const int MAX_ATTEMPTS = 3;         // Failed sessions before the job is dropped
+        private const int RETRY_DELAY_MS = 30000;   // Pause between failed sessions
+
+        // Per user, never in SharedData: the job names a file that is streamed
+        // to the device, and the service would send whatever it points at.
+        private static readonly string JobPath = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData),
+            "ScarabMonitor", "fw_stage.txt");
+
+        private sealed class Job
+        {
+            public string DeviceHash;
+            public string BinPath;
+            public int Size;
+            public uint Crc32;
+        }
+
+        private readonly object _lock = new object();
+        private Job _job;
+        private int _failures;
+        private int _lastPercent;
+        private volatile bool _isRunning;
+
+        public event EventHandler<UploadProgressEventArgs> ProgressChanged;
+        public event EventHandler<string> LogMessage;
+
+        /// <summary>One-line state for the UI ("Staging 42%...", "Staged", ...).</summary>
+        public event EventHandler<string> StatusChanged;
+
+        public FirmwareStager()
+        {
+            _job = LoadJob();
+            Status = _job != null ? $"Pending: {Path.GetFileName(_job.BinPath)} (resumes when the device connects)" : "";
+        }
+
+        /// <summary>True while an image is queued or being trickled.</summary>
+        public bool HasJob
+        {
+            get { lock (_lock) { return _job != null; } }
+        }
+
+        /// <summary>True while a transfer session is active on the port.</summary>
+        public bool IsRunning => _isRunning;
+
+        public string Status { get; private set; }
+
+        /// <summary>
+        /// Queues an image for the given device (replaces any previous job).
+        /// Returns null if OK, otherwise a human-readable error.
+        /// </summary>
+        public string Start(string binPath, string deviceHash)
+        {
+            string error = FirmwareUploader.ValidateFirmwareFile(binPath);
+            if (error != null) return error;
+            if (string.IsNullOrEmpty(deviceHash)) return "No device identity - connect first.";
+
+            var job = new Job { DeviceHash = deviceHash, BinPath = binPath };
+            try
+            {
+                using (var fs = FirmwareUploader.OpenImage(binPath))
+                {
+                    job.Size = (int)fs.Length;
+                    job.Crc32 = ImageConverter.ComputeCrc32(fs);
+                }
+            }
+            catch (Exception ex) { return "Cannot read file: " + ex.Message; }
+
+            lock (_lock)
+            {
+                _job = job;
+                _failures = 0;
+                _lastPercent = 0;
+                SaveJob(job);
+            }
+
+            Log($"Queued {Path.GetFileName(binPath)} ({job.Size:N0} bytes, CRC32 {job.Crc32:X8}) for device {deviceHash}");
+            SetStatus($"Queued: {Path.GetFileName(binPath)}");
+            return null;
+        }
+
+        /// <summary>
+        /// Forgets the job. The caller still has to send FW_ABORT so the device
+        /// drops a staged image it would otherwise boot into.
+        /// </summary>
+        public void Cancel()
+        {
+            lock (_lock)
+            {
+                _job = null;
+                try { File.Delete(JobPath); } catch { }
+            }
+            SetStatus("Background update cancelled.");
+        }
+
+        /// <summary>
+        /// Trickles the queued image to the connected device until it is
+        /// staged, the job fails for good, or <paramref name="ct"/> fires
+        /// (disconnect / exit - progress is kept on both sides). Each session
+        /// holds the port (FW_OK/FW_NAK replies come through the dispatcher);
+        /// it is given back between retries.
+        /// </summary>
+        /// <param name="holdOff">While true no chunk is sent (exclusive upload / pause)</param>
+        public async Task RunAsync(SerialDispatcher dispatcher, object writeLock, DeviceCaps caps, string deviceHash,
+                                   Func<bool> holdOff, CancellationToken ct)
+        {
+            while (!ct.IsCancellationRequested)
+            {
+                Job job;
+                lock (_lock) { job = _job; }
+                if (job == null || !string.Equals(job.DeviceHash, deviceHash, StringComparison.OrdinalIgnoreCase))
+                    return;
+
+                if (caps == null || !caps.HasFeature(DeviceCaps.FEATURE_STAGED_OTA))
+                {
+                    SetStatus("Pending: device firmware cannot stage in the background - use Flash Firmware.");
+                    return;
+                }
+
+                FileStream image = OpenImage(job);
+                if (image == null)
+                {
+                    Log($"{job.BinPath} is missing or changed since it was queued - dropping background update");
+                    DropJob(job, "Background update dropped: firmware file changed or missing.");
+                    return;
+                }
+
+                PortLease lease;
+                try
+                {
+                    lease = await dispatcher.AcquireAsync("FW_STAGE", ct);
+                }
+                catch (OperationCanceledException)
+                {
+                    image.Dispose();
+                    return;
+                }
+
+                // Cancelled while waiting for the port (exclusive flash)
+                bool current;
+                lock (_lock) { current = _job == job; }
+                if (!current)
+                {
+                    lease.Dispose();
+                    image.Dispose();
+                    return;
+                }
+
+                var uploader = new FirmwareUploader(lease, writeLock, caps);
+                uploader.LogMessage += (s, m) => LogMessage?.Invoke(this, m);
+                uploader.ProgressChanged += (s, p) =>
+                {
+                    _lastPercent = (int)p.PercentComplete;
+                    ProgressChanged?.Invoke(this, p);
+                    SetStatus($"Staging in background: {p.BytesSent:N0}/{p.TotalBytes:N0} bytes ({p.PercentComplete:F0}%)");
+                };
+
+                bool success;
+                _isRunning = true;
+                try
+                {
+                    success = await uploader.StageFirmwareAsync(image, job.Crc32, holdOff, ct);
+                }
+                finally
+                {
+                    _isRunning = false;
+                    lease.Dispose();
+                    image.Dispose();
+                }
+
+                if (success)
+                {
+                    DropJob(job, "Staged - the device switches to the new firmware when it is idle (screensaver).");
+                    return;
+                }
+
+                if (ct.IsCancellationRequested)
+                {
+                    SetStatus($"Paused at {_lastPercent}% - resumes when the device reconnects.");
+                    return;
+                }
+
+                if (++_failures >= MAX_ATTEMPTS)
+                {
+                    Log($"Staging failed {MAX_ATTEMPTS} times - dropping background update");
+                    DropJob(job, "Background update failed - see debug log. Device keeps its current firmware.");
+                    return;
+                }
+
+                SetStatus($"Staging interrupted at {_lastPercent}% - retrying in {RETRY_DELAY_MS / 1000}s.");
+                try { await Task.Delay(RETRY_DELAY_MS, ct); }
+                catch (OperationCanceledException) { return; }
+            }
+        }
+
+        // ====================================================================
+        //  PERSISTENCE (one line: HASH|SIZE|CRC32|PATH)
+        // ====================================================================
+
+        private void DropJob(Job job, string status)
+        {
+            lock (_lock)
+            {
+                if (_job == job)
+                {
+                    _job = null;
+                    try { File.Delete(JobPath); } catch { }
+                }
+            }
+            SetStatus(status);
+        }
+
+        /// <summary>
+        /// The job's image, rewound, if it still has the queued size and CRC
+        /// (checked by streaming, the file is never loaded whole). Null if not.
+        /// </summary>
+        private static FileStream OpenImage(Job job)
+        {
+            FileStream fs = null;
+            try
+            {
+                if (FirmwareUploader.ValidateFirmwareFile(job.BinPath) != null) return null;
+                fs = FirmwareUploader.OpenImage(job.BinPath);
+                if (fs.Length != job.Size || ImageConverter.ComputeCrc32(fs) != job.Crc32)
+                {
+                    fs.Dispose();
+                    return null;
+                }
+                fs.Position = 0;
+                return fs;
+            }
+            catch
+            {
+                fs?.Dispose();
+                return null;
+            }
+        }
+
+        private static Job LoadJob()
+        {
+            try
+            {
+                if (!File.Exists(JobPath)) return null;
+                string[] parts = File.ReadAllText(JobPath).Trim().Split(new[] { '|' }, 4);
+                if (parts.Length != 4) return null;
+
+                if (!int.TryParse(parts[1], out int size)
+                    || !uint.TryParse(parts[2], System.Globalization.NumberStyles.HexNumber, null, out uint crc))
+                    return null;
+
+                return new Job { DeviceHash = parts[0], Size = size, Crc32 = crc, BinPath = parts[3] };
+            }
+            catch
+            {
+                return null;
+            }
+        }
+
+        private void SaveJob(Job job)
+        {
+            try
+            {
+                Directory.CreateDirectory(Path.GetDirectoryName(JobPath));
+                File.WriteAllText(JobPath, $"{job.DeviceHash}|{job.Size}|{job.Crc32:X8}|{job.BinPath}");
+            }
+            catch (Exception ex)
+            {
+                Log("Job file write failed (update will not resume after restart): " + ex.Message);
+            }
+        }
+
+        private void SetStatus(string status)
+        {
+            Status = status;
+            StatusChanged?.Invoke(this, status);
+        }
+
+        private void Log(string message)
+        {
+            Console.WriteLine($"[FirmwareStager] {message}");
+            System.Diagnostics.Debug.WriteLine($"[FirmwareStager] {message}");
+            LogMessage?.Invoke(this, message);
+        }
+    }
+}
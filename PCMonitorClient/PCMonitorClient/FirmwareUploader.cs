@@ -1,6 +1,5 @@
 using System;
 using System.IO;
-using System.IO.Ports;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -17,6 +16,10 @@ namespace PCMonitorClient
     ///
     /// Requires firmware >= 2.4 (OTA partition table). Devices still on the
     /// old factory-only partition table need one final cable flash.
+    ///
+    /// StageFirmwareAsync is the background variant (FEAT:STAGE): the image
+    /// is trickled in alongside telemetry, the device only switches slots and
+    /// restarts once it is idle. See FirmwareStager.
     /// </summary>
     public class FirmwareUploader
     {
@@ -27,16 +30,29 @@ namespace PCMonitorClient
         private const int FW_MIN_SIZE = 0x10000;        // 64 KB
         private const int FW_MAX_SIZE = 4 * 1024 * 1024;
 
+        /// <summary>
+        /// Background staging rate. Each chunk costs the ESP's USB task a flash
+        /// write (plus a sector erase every other chunk); 8 KB/s keeps that
+        /// around a tenth of its time, so stats lines are never held up.
+        /// </summary>
+        public const int STAGE_BYTES_PER_SECOND = 8 * 1024;
+
         private readonly ChunkedSerialUploader _uploader;
 
         public event EventHandler<UploadProgressEventArgs> ProgressChanged;
         public event EventHandler<string> LogMessage;
 
-        /// <param name="port">Open serial port</param>
+        /// <param name="port">The held port (MonitorCore.AcquirePortAsync)</param>
         /// <param name="writeLock">Shared lock guarding ALL writes to this port</param>
-        public FirmwareUploader(SerialPort port, object writeLock = null)
+        /// <param name="caps">Device capabilities (chunk size, chunk CRC); null = legacy limits</param>
+        public FirmwareUploader(ISerialLink port, object writeLock = null, DeviceCaps caps = null)
         {
-            _uploader = new ChunkedSerialUploader(port, writeLock, "FW");
+            caps = caps ?? DeviceCaps.Legacy;
+            _uploader = new ChunkedSerialUploader(port, writeLock, "FW")
+            {
+                ChunkSize = caps.UploadChunkBytes,
+                ChunkCrc = caps.UploadChunkCrc
+            };
             _uploader.ProgressChanged += (s, e) => ProgressChanged?.Invoke(this, e);
             _uploader.LogMessage += (s, m) => LogMessage?.Invoke(this, m);
         }
@@ -88,12 +104,22 @@ namespace PCMonitorClient
                 return false;
             }
 
-            byte[] data = File.ReadAllBytes(binPath);
-            uint crc32 = ImageConverter.ComputeCrc32(data);
-
-            Log($"Firmware image: {Path.GetFileName(binPath)}, {data.Length:N0} bytes, CRC32: {crc32:X8}");
-
-            bool success = await _uploader.UploadAsync($"FW_BEGIN:{data.Length}", data, crc32, ct);
+            bool success;
+            try
+            {
+                // Streamed from disk; the CRC for FW_END is computed on the way
+                using (var fs = OpenImage(binPath))
+                {
+                    int size = (int)fs.Length;
+                    Log($"Firmware image: {Path.GetFileName(binPath)}, {size:N0} bytes");
+                    success = await _uploader.UploadAsync($"FW_BEGIN:{size}", fs, size, null, ct);
+                }
+            }
+            catch (Exception ex) when (ex is IOException || ex is UnauthorizedAccessException)
+            {
+                Log("Error: Cannot read file: " + ex.Message);
+                return false;
+            }
 
             if (success)
             {
@@ -102,6 +128,38 @@ namespace PCMonitorClient
             return success;
         }
 
+        /// <summary>
+        /// Trickles an image into the device's inactive slot without stopping
+        /// telemetry. The device resumes from its last checkpoint if it has
+        /// seen this image (size + CRC) before; nothing is aborted on failure
+        /// so the next session continues. Returns true once FW_OK:STAGED.
+        /// </summary>
+        /// <param name="holdOff">While true no chunk is sent (exclusive upload / pause)</param>
+        /// <param name="image">Image stream (OpenImage), size and CRC already checked</param>
+        public async Task<bool> StageFirmwareAsync(Stream image, uint crc32, Func<bool> holdOff, CancellationToken ct = default)
+        {
+            _uploader.MaxBytesPerSecond = STAGE_BYTES_PER_SECOND;
+            _uploader.HoldOff = holdOff;
+            _uploader.SendAbortOnFailure = false;
+
+            int size = (int)image.Length;
+            Log($"Staging firmware in background: {size:N0} bytes, CRC32: {crc32:X8}, " +
+                $"{STAGE_BYTES_PER_SECOND / 1024} KB/s");
+
+            return await _uploader.UploadAsync($"FW_STAGE:{size}:{crc32:X8}", image, size, crc32, ct);
+        }
+
+        /// <summary>
+        /// Opens an image for streaming. A rebuild may overwrite the file
+        /// meanwhile (staging takes minutes); the CRC check at the end of the
+        /// upload catches that.
+        /// </summary>
+        public static FileStream OpenImage(string binPath)
+        {
+            return new FileStream(binPath, FileMode.Open, FileAccess.Read,
+                                  FileShare.ReadWrite | FileShare.Delete, 64 * 1024, FileOptions.SequentialScan);
+        }
+
         private void Log(string message)
         {
             Console.WriteLine($"[FirmwareUploader] {message}");
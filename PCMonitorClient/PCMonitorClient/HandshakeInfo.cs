@@ -0,0 +1,59 @@
+using System;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Parsed handshake response:
+    /// SCARAB_CLIENT_OK|H:XXXXXXXX|V:x.y.z|N:device-name|B:xxxxxxxx
+    /// (|V: and |N: added in FW 2.4, |B: later - absent on older firmware)
+    /// </summary>
+    public sealed class HandshakeInfo
+    {
+        public const string RESPONSE_TOKEN = ProtocolCommands.HANDSHAKE_OK;
+
+        /// <summary>Identity hash, "00000000" for firmware without hash support.</summary>
+        public string Hash { get; private set; } = "00000000";
+        public string FwVersion { get; private set; } = "";
+        public string DeviceName { get; private set; } = "";
+
+        /// <summary>Build ID (firmware ELF SHA-256 prefix), "" on older firmware.</summary>
+        public string BuildId { get; private set; } = "";
+
+        /// <summary>
+        /// Parses one response line. Returns null if it is not a handshake response.
+        /// </summary>
+        public static HandshakeInfo Parse(string response)
+        {
+            if (response == null || !response.Contains(RESPONSE_TOKEN)) return null;
+
+            var info = new HandshakeInfo
+            {
+                FwVersion = ParseField(response, "|V:"),
+                DeviceName = ParseField(response, "|N:"),
+                BuildId = ParseField(response, "|B:")
+            };
+
+            int hashPos = response.IndexOf("|H:", StringComparison.Ordinal);
+            if (hashPos >= 0 && response.Length >= hashPos + 11)
+            {
+                info.Hash = response.Substring(hashPos + 3, 8);
+            }
+            return info;
+        }
+
+        /// <summary>
+        /// Extracts the value of a |KEY: field (value runs until the next '|'
+        /// or end of line). Returns "" if absent.
+        /// </summary>
+        internal static string ParseField(string response, string key)
+        {
+            int pos = response.IndexOf(key, StringComparison.Ordinal);
+            if (pos < 0) return "";
+
+            string value = response.Substring(pos + key.Length).Trim();
+            int nextSep = value.IndexOf('|');
+            if (nextSep >= 0) value = value.Substring(0, nextSep);
+            return value.Trim();
+        }
+    }
+}
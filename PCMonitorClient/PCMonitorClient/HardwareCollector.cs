@@ -5,8 +5,10 @@ using System.Linq;
 using System.Management;
 using System.Net.NetworkInformation;
 using System.Net.Sockets;
+using System.Runtime.InteropServices;
 using System.Text.RegularExpressions;
 using System.Threading;
+using System.Threading.Tasks;
 using LibreHardwareMonitor.Hardware;
 using NvAPIWrapper;
 using NvAPIWrapper.GPU;
@@ -30,20 +32,36 @@ namespace PCMonitorClient
 
     public sealed class HardwareCollector : IDisposable
     {
-        private Computer _computer;
+        private Computer _computer;             // Set once the background init succeeded (Full Mode)
+        private SensorMap _map;                 // Sensors GetStats reads in Full Mode
+        private readonly SensorMap.Cached _cache;       // Null if missing or from other hardware
+        private readonly object _sync = new object();   // GetStats vs. the Lite -> Full switch
         private readonly UpdateVisitor _visitor = new UpdateVisitor();
+        private Task _fullInit;
+        private bool _disposed;
+        private int _identityChanged;
         private bool _nvApiAvailable;
         private PhysicalGPU _gpu;
 
-        // Network perf counters
-        private PerformanceCounter _netBytesRecv;
-        private PerformanceCounter _netBytesSent;
+        /// <summary>Update passes (250ms apart) spent waiting for cached sensors to read.</summary>
+        private const int CACHED_BIND_PASSES = 10;
 
-        // Lite Mode: WMI-based CPU fallback
-        private PerformanceCounter _cpuCounter;
+        /// <summary>Full Mode reads in a row without a mapped GPU value before the map is rediscovered.</summary>
+        private const int GPU_MISSES_BEFORE_REDISCOVERY = 10;
+        private int _gpuMisses;
+        private bool _gpuRediscovered;
+
+        // Network: per-interface byte counter deltas (all adapters)
+        private NetworkSampler _net;
+        private DiskSampler _disk;
+
+        // Lite Mode: CPU load from GetSystemTimes deltas
+        private long _lastIdle, _lastKernel, _lastUser;
 
         /// <summary>
-        /// True if running without admin rights (limited sensor access).
+        /// True while values come from the cheap sources only: during startup
+        /// until LibreHardwareMonitor is ready, and for good without admin
+        /// rights (limited sensor access).
         /// </summary>
         public bool IsLiteMode { get; private set; }
 
@@ -52,6 +70,12 @@ namespace PCMonitorClient
         /// </summary>
         public string InitStatus { get; private set; }
 
+        /// <summary>
+        /// Raised on a worker thread when the background init has finished -
+        /// IsLiteMode / InitStatus are final from then on.
+        /// </summary>
+        public event EventHandler ModeChanged;
+
         // ========================================================================
         //  Hardware Identity (for sync with ESP)
         // ========================================================================
@@ -81,38 +105,41 @@ namespace PCMonitorClient
         /// </summary>
         public string IdentityHash { get; private set; } = "00000000";
 
+        /// <summary>
+        /// Starts in Lite Mode with sources that need no driver and no bus
+        /// scan, so the first packet can go out within a few hundred ms.
+        /// Call StartFullInit() to bring up LibreHardwareMonitor behind it.
+        /// </summary>
         public HardwareCollector()
         {
             Console.WriteLine("  [System]   Process Architecture: " + (Environment.Is64BitProcess ? "x64" : "x86"));
             Console.WriteLine("  [System]   Admin: " + (IsAdmin() ? "YES" : "NO"));
 
-            IsLiteMode = false;
-            InitStatus = "";
+            IsLiteMode = true;
+            InitStatus = "Starting (Lite values until sensors are ready)";
+            _cache = SensorMap.Load();
+            if (_cache != null && _cache.Fingerprint != SensorMap.HardwareFingerprint())
+            {
+                // CPU or GPU swapped: cached names and sensor paths are someone else's
+                Console.WriteLine("  [Identity] Hardware changed since the last run - cache ignored");
+                _cache = null;
+            }
 
-            // --- Try NvAPI first (works without admin for basic GPU info) ---
+            // --- NvAPI (works without admin for basic GPU info) ---
             InitNvApi();
 
-            // --- Try LibreHardwareMonitor (requires admin for Ring0) ---
-            if (!InitLibreHardwareMonitor())
-            {
-                // Ring0 failed - switch to Lite Mode
-                IsLiteMode = true;
-                InitStatus = "Lite Mode (no admin rights)";
-                Console.WriteLine("  [LHM]      Switching to LITE MODE");
-
-                // Initialize WMI-based CPU counter as fallback
-                InitLiteModeFallbacks();
-            }
-            else
-            {
-                InitStatus = "Full Mode (admin)";
-            }
+            // --- Cheap CPU/RAM sources until LHM is up ---
+            InitLiteModeFallbacks();
 
-            // --- Network PerformanceCounters (works without admin) ---
+            // --- Network interface statistics (works without admin) ---
             InitNetwork();
+            InitDisk();
 
-            // --- Detect Hardware Identity ---
-            DetectHardwareIdentity();
+            // --- Hardware Identity (cached names skip WMI) ---
+            if (_cache != null)
+                LoadCachedIdentity(_cache);
+            else
+                DetectHardwareIdentity();
         }
 
         // ========================================================================
@@ -139,11 +166,68 @@ namespace PCMonitorClient
             }
         }
 
-        private bool InitLibreHardwareMonitor()
+        /// <summary>
+        /// Opens LibreHardwareMonitor on a worker thread and switches GetStats
+        /// to the full sensor set once it is ready. If Ring0 fails the
+        /// collector stays in Lite Mode. Either way ModeChanged fires.
+        /// </summary>
+        public void StartFullInit()
+        {
+            if (_fullInit != null) return;
+            _fullInit = Task.Run(() => RunFullInit());
+        }
+
+        private void RunFullInit()
         {
+            var sw = Stopwatch.StartNew();
+            var computer = OpenLibreHardwareMonitor(out var map);
+
+            if (computer == null)
+            {
+                // Ring0 failed - stay in Lite Mode
+                InitStatus = "Lite Mode (no admin rights)";
+                Console.WriteLine("  [LHM]      Staying in LITE MODE");
+                if (_cache == null) SensorMap.Save(CpuName, GpuName, null);
+                ModeChanged?.Invoke(this, EventArgs.Empty);
+                return;
+            }
+
+            lock (_sync)
+            {
+                if (_disposed)
+                {
+                    try { computer.Close(); } catch { }
+                    return;
+                }
+                _computer = computer;
+                _map = map;
+                IsLiteMode = false;
+                InitStatus = "Full Mode (admin)";
+            }
+            Console.WriteLine("  [LHM]      Full Mode ready after " + sw.ElapsedMilliseconds + " ms");
+
+            // LHM names may differ from the cached/WMI ones - the caller re-syncs
+            string previousHash = IdentityHash;
+            DetectHardwareIdentity();
+            if (IdentityHash != previousHash)
+                Interlocked.Exchange(ref _identityChanged, 1);
+
+            SensorMap.Save(CpuName, GpuName, map);
+            ModeChanged?.Invoke(this, EventArgs.Empty);
+        }
+
+        /// <summary>
+        /// Opens a Ring0 Computer and resolves the sensor map. Returns null if
+        /// the driver cannot be loaded (common without admin).
+        /// </summary>
+        private Computer OpenLibreHardwareMonitor(out SensorMap map)
+        {
+            map = null;
+            Computer computer = null;
+
             try
             {
-                _computer = new Computer
+                computer = new Computer
                 {
                     IsCpuEnabled = true,
                     IsMemoryEnabled = true,
@@ -155,90 +239,90 @@ namespace PCMonitorClient
                 };
 
                 // This is where Ring0 driver loads - may fail without admin
-                _computer.Open();
+                computer.Open();
                 Console.WriteLine("  [LHM]      Computer opened (Ring0 driver loaded)");
 
-                // Wait for Ring0 driver to finish scanning buses
-                Console.WriteLine("  [LHM]      Waiting 2s for bus scan...");
-                Thread.Sleep(2000);
+                // Known machine: bind the cached sensors as soon as they read,
+                // no fixed bus scan wait, no dump
+                if (_cache?.SensorIds != null)
+                {
+                    for (int pass = 0; pass < CACHED_BIND_PASSES; pass++)
+                    {
+                        if (pass > 0) Thread.Sleep(250);
+                        computer.Accept(_visitor);
+                        map = SensorMap.Bind(computer.Hardware, _cache);
+                        if (map != null && map.HasValues) break;
+                    }
 
-                // First update pass
-                _computer.Accept(_visitor);
+                    if (map != null)
+                    {
+                        Console.WriteLine("  [LHM]      Sensor map from cache");
+                        return computer;
+                    }
+                    Console.WriteLine("  [LHM]      Cached sensor map does not match - rediscovering");
+                    computer.Accept(_visitor);
+                }
+                else
+                {
+                    // Wait for Ring0 driver to finish scanning buses
+                    Console.WriteLine("  [LHM]      Waiting 2s for bus scan...");
+                    Thread.Sleep(2000);
+
+                    // First update pass
+                    computer.Accept(_visitor);
 
-                // Second update pass — some sensors need two reads
-                Thread.Sleep(500);
-                _computer.Accept(_visitor);
+                    // Second update pass — some sensors need two reads
+                    Thread.Sleep(500);
+                    computer.Accept(_visitor);
+                }
 
                 // Debug: dump hardware nodes
                 Console.WriteLine("  [LHM]      --- Hardware Dump ---");
-                foreach (var hw in _computer.Hardware)
+                foreach (var hw in computer.Hardware)
                 {
                     DumpHardwareTemps(hw, 0);
                 }
                 Console.WriteLine("  [LHM]      --- End Dump ---");
 
-                return true;
+                map = SensorMap.Discover(computer.Hardware);
+                return computer;
             }
             catch (UnauthorizedAccessException ex)
             {
                 Console.WriteLine("  [LHM]      FAIL (UnauthorizedAccess) - " + ex.Message);
-                SafeCloseComputer();
-                return false;
+                SafeClose(computer);
+                return null;
             }
             catch (Exception ex)
             {
                 // Ring0 driver failed to load (common without admin)
                 Console.WriteLine("  [LHM]      FAIL - " + ex.Message);
-                SafeCloseComputer();
-                return false;
+                SafeClose(computer);
+                return null;
             }
         }
 
-        private void SafeCloseComputer()
+        private static void SafeClose(Computer computer)
         {
-            if (_computer != null)
+            if (computer != null)
             {
-                try { _computer.Close(); } catch { }
-                _computer = null;
+                try { computer.Close(); } catch { }
             }
         }
 
         private void InitLiteModeFallbacks()
         {
-            // WMI-based CPU usage counter (works without admin)
+            // GetSystemTimes / GlobalMemoryStatusEx: no driver, no counter
+            // registry load - ready immediately, first CPU delta primed here
             try
             {
-                _cpuCounter = new PerformanceCounter("Processor", "% Processor Time", "_Total");
-                _cpuCounter.NextValue(); // First call returns 0
-                Console.WriteLine("  [Lite]     CPU PerformanceCounter initialized");
+                if (GetSystemTimes(out _lastIdle, out _lastKernel, out _lastUser))
+                    Console.WriteLine("  [Lite]     CPU/RAM from system counters");
             }
             catch (Exception ex)
             {
                 Console.WriteLine("  [Lite]     CPU counter FAIL - " + ex.Message);
             }
-
-            // Initialize a minimal Computer for RAM only (usually works without Ring0)
-            try
-            {
-                _computer = new Computer
-                {
-                    IsCpuEnabled = false,
-                    IsMemoryEnabled = true,
-                    IsMotherboardEnabled = false,
-                    IsControllerEnabled = false,
-                    IsGpuEnabled = false,
-                    IsStorageEnabled = false,
-                    IsNetworkEnabled = false
-                };
-                _computer.Open();
-                _computer.Accept(_visitor);
-                Console.WriteLine("  [Lite]     RAM monitoring OK");
-            }
-            catch (Exception ex)
-            {
-                Console.WriteLine("  [Lite]     RAM monitoring FAIL - " + ex.Message);
-                SafeCloseComputer();
-            }
         }
 
         private static void DumpHardwareTemps(IHardware hw, int depth)
@@ -272,69 +356,50 @@ namespace PCMonitorClient
         }
 
         // ========================================================================
-        //  Recursive Sensor Helper
+        //  Network
         // ========================================================================
 
-        private static IEnumerable<ISensor> GetAllSensorsRecursive(IHardware hardware)
+        private void InitNetwork()
         {
-            foreach (var sensor in hardware.Sensors)
-                yield return sensor;
-
-            foreach (var sub in hardware.SubHardware)
+            try
+            {
+                _net = new NetworkSampler();
+                _net.Sample();     // Enumerate interfaces + prime counters
+            }
+            catch (Exception ex)
             {
-                foreach (var sensor in GetAllSensorsRecursive(sub))
-                    yield return sensor;
+                Console.WriteLine("  [Network]  FAIL - " + ex.Message);
+                _net = null;
             }
         }
 
+        /// <summary>
+        /// Network sampler (aggregate + primary interface), null if init failed.
+        /// </summary>
+        public NetworkSampler Network => _net;
+
         // ========================================================================
-        //  Network
+        //  Disk I/O
         // ========================================================================
 
-        private void InitNetwork()
+        private void InitDisk()
         {
             try
             {
-                var instanceName = GetBestNetworkInstanceName();
-                if (instanceName == null)
-                {
-                    Console.WriteLine("  [Network]  No active adapter found");
-                    return;
-                }
-
-                _netBytesRecv = new PerformanceCounter("Network Interface", "Bytes Received/sec", instanceName);
-                _netBytesSent = new PerformanceCounter("Network Interface", "Bytes Sent/sec", instanceName);
-                _netBytesRecv.NextValue();
-                _netBytesSent.NextValue();
+                _disk = DiskSampler.CreateDefault();
+                _disk.Sample();    // Open drives + prime counters
             }
             catch (Exception ex)
             {
-                Console.WriteLine("  [Network]  FAIL - " + ex.Message);
+                Console.WriteLine("  [Disk]     FAIL - " + ex.Message);
+                _disk = null;
             }
         }
 
-        private static string GetBestNetworkInstanceName()
-        {
-            var interfaces = NetworkInterface.GetAllNetworkInterfaces()
-                .Where(n => n.OperationalStatus == OperationalStatus.Up
-                         && n.NetworkInterfaceType != NetworkInterfaceType.Loopback
-                         && n.GetIPProperties().UnicastAddresses
-                             .Any(a => a.Address.AddressFamily == AddressFamily.InterNetwork))
-                .ToList();
-
-            if (interfaces.Count == 0) return null;
-
-            var best = interfaces.FirstOrDefault(n => n.NetworkInterfaceType == NetworkInterfaceType.Ethernet)
-                    ?? interfaces.FirstOrDefault(n => n.NetworkInterfaceType == NetworkInterfaceType.Wireless80211)
-                    ?? interfaces[0];
-
-            Console.WriteLine("  [Network]  Selected: " + best.Description + " (" + best.NetworkInterfaceType + ")");
-
-            return best.Description
-                .Replace('(', '[')
-                .Replace(')', ']')
-                .Replace('/', '_');
-        }
+        /// <summary>
+        /// Disk sampler (per-disk + total rates), null if init failed.
+        /// </summary>
+        public DiskSampler Disk => _disk;
 
         // ========================================================================
         //  GetStats (main collection loop)
@@ -344,23 +409,27 @@ namespace PCMonitorClient
         {
             var stats = new SystemStats();
 
-            if (IsLiteMode)
+            lock (_sync)
             {
-                CollectCpuLite(stats);
-                CollectRamLite(stats);
-                CollectGpuLite(stats);
-            }
-            else
-            {
-                if (_computer != null)
-                    _computer.Accept(_visitor);
+                if (IsLiteMode)
+                {
+                    CollectCpuLite(stats);
+                    CollectRamLite(stats);
+                    CollectGpuLite(stats);
+                }
+                else
+                {
+                    if (_computer != null)
+                        _computer.Accept(_visitor);
 
-                CollectCpu(stats);
-                CollectRam(stats);
-                CollectGpu(stats);
+                    CollectCpu(stats);
+                    CollectRam(stats);
+                    CollectGpu(stats);
+                }
             }
 
             CollectNetwork(stats);
+            CollectDisk(stats);
 
             return stats;
         }
@@ -375,51 +444,32 @@ namespace PCMonitorClient
 
             try
             {
-                foreach (var hw in _computer.Hardware)
-                {
-                    if (hw.HardwareType != HardwareType.Cpu) continue;
-
-                    var allSensors = GetAllSensorsRecursive(hw).ToList();
-
-                    // --- Load ---
-                    foreach (var sensor in allSensors)
-                    {
-                        if (sensor.SensorType == SensorType.Load && sensor.Name == "CPU Total")
-                        {
-                            if (sensor.Value.HasValue)
-                                s.CpuLoad = sensor.Value.Value;
-                            break;
-                        }
-                    }
-
-                    // --- Temp ---
-                    float rawTemp = FindBestTempFromSensors(allSensors,
-                        "Package", "Core Max", "Core Average", "Tctl");
-
-                    if (rawTemp <= 0f)
-                        rawTemp = FindMotherboardCpuTemp();
-
-                    if (rawTemp > 0f)
-                        s.CpuTemp = rawTemp;
-
-                    break;
-                }
+                // Mapped sensors first; tree walk if the temp has no reading
+                if (_map == null || !_map.ReadCpu(s))
+                    SensorTreeReader.ReadCpu(_computer.Hardware, s);
             }
             catch { /* sensor read failed */ }
         }
 
         // ========================================================================
-        //  CPU (Lite Mode - WMI/PerformanceCounter)
+        //  CPU (Lite Mode - GetSystemTimes)
         // ========================================================================
 
         private void CollectCpuLite(SystemStats s)
         {
-            // CPU Load via PerformanceCounter
+            // CPU Load from system time deltas (kernel time includes idle)
             try
             {
-                if (_cpuCounter != null)
+                if (GetSystemTimes(out long idle, out long kernel, out long user))
                 {
-                    s.CpuLoad = _cpuCounter.NextValue();
+                    long total = (kernel - _lastKernel) + (user - _lastUser);
+                    long busy = total - (idle - _lastIdle);
+                    if (total > 0)
+                        s.CpuLoad = Math.Max(0f, Math.Min(100f, 100f * busy / total));
+
+                    _lastIdle = idle;
+                    _lastKernel = kernel;
+                    _lastUser = user;
                 }
             }
             catch { }
@@ -428,46 +478,6 @@ namespace PCMonitorClient
             s.CpuTemp = -1f;
         }
 
-        private static float FindBestTempFromSensors(List<ISensor> sensors, params string[] priorities)
-        {
-            var tempSensors = sensors
-                .Where(s => s.SensorType == SensorType.Temperature)
-                .ToList();
-
-            if (tempSensors.Count == 0) return 0f;
-
-            foreach (var keyword in priorities)
-            {
-                var match = tempSensors.FirstOrDefault(
-                    s => s.Name.IndexOf(keyword, StringComparison.OrdinalIgnoreCase) >= 0);
-                if (match != null)
-                    return match.Value ?? 0f;
-            }
-
-            foreach (var sensor in tempSensors)
-            {
-                float val = sensor.Value ?? 0f;
-                if (val > 0f) return val;
-            }
-
-            return tempSensors[0].Value ?? 0f;
-        }
-
-        private float FindMotherboardCpuTemp()
-        {
-            if (_computer == null) return 0f;
-
-            foreach (var hw in _computer.Hardware)
-            {
-                if (hw.HardwareType != HardwareType.Motherboard) continue;
-
-                var allSensors = GetAllSensorsRecursive(hw).ToList();
-                float val = FindBestTempFromSensors(allSensors, "CPU", "Socket");
-                if (val > 0f) return val;
-            }
-            return 0f;
-        }
-
         // ========================================================================
         //  RAM (Full Mode)
         // ========================================================================
@@ -478,47 +488,31 @@ namespace PCMonitorClient
 
             try
             {
-                foreach (var hw in _computer.Hardware)
-                {
-                    if (hw.HardwareType != HardwareType.Memory) continue;
-
-                    float used = -1f, available = -1f;
-                    foreach (var sensor in hw.Sensors)
-                    {
-                        if (sensor.SensorType == SensorType.Data && sensor.Name == "Memory Used")
-                            used = sensor.Value ?? -1f;
-                        if (sensor.SensorType == SensorType.Data && sensor.Name == "Memory Available")
-                            available = sensor.Value ?? -1f;
-                    }
-
-                    if (used > 0f && available >= 0f)
-                    {
-                        s.RamUsedGb = used;
-                        s.RamTotalGb = used + available;
-                    }
-                    break;
-                }
+                if (_map == null || !_map.ReadRam(s))
+                    SensorTreeReader.ReadRam(_computer.Hardware, s);
             }
             catch { /* sensor read failed */ }
         }
 
         // ========================================================================
-        //  RAM (Lite Mode - WMI)
+        //  RAM (Lite Mode - GlobalMemoryStatusEx)
         // ========================================================================
 
         private void CollectRamLite(SystemStats s)
         {
-            // Try LibreHardwareMonitor first (sometimes works without Ring0)
-            if (_computer != null)
+            // Same source LHM's Memory node reads, without opening a Computer
+            try
             {
-                try
+                var mem = new MEMORYSTATUSEX { dwLength = (uint)Marshal.SizeOf(typeof(MEMORYSTATUSEX)) };
+                if (GlobalMemoryStatusEx(ref mem) && mem.ullTotalPhys > 0)
                 {
-                    _computer.Accept(_visitor);
-                    CollectRam(s);
-                    if (s.RamUsedGb > 0f) return;
+                    const float GB = 1024f * 1024f * 1024f;
+                    s.RamTotalGb = mem.ullTotalPhys / GB;
+                    s.RamUsedGb = (mem.ullTotalPhys - mem.ullAvailPhys) / GB;
+                    return;
                 }
-                catch { }
             }
+            catch { }
 
             // Fallback: WMI
             try
@@ -582,30 +576,32 @@ namespace PCMonitorClient
 
             try
             {
-                foreach (var hw in _computer.Hardware)
+                if (_map != null && _map.ReadGpu(s))
                 {
-                    if (hw.HardwareType != HardwareType.GpuNvidia
-                        && hw.HardwareType != HardwareType.GpuAmd
-                        && hw.HardwareType != HardwareType.GpuIntel)
-                        continue;
-
-                    foreach (var sensor in GetAllSensorsRecursive(hw))
-                    {
-                        if (sensor.SensorType == SensorType.Load && sensor.Name == "GPU Core" && sensor.Value.HasValue)
-                            s.GpuLoad = sensor.Value.Value;
-                        if (sensor.SensorType == SensorType.Temperature && sensor.Name == "GPU Core" && sensor.Value.HasValue && sensor.Value.Value > 0f)
-                            s.GpuTemp = sensor.Value.Value;
-                        if (sensor.SensorType == SensorType.SmallData && sensor.Name == "GPU Memory Used" && sensor.Value.HasValue)
-                            s.GpuVramUsed = sensor.Value.Value / 1024f;
-                        if (sensor.SensorType == SensorType.SmallData && sensor.Name == "GPU Memory Total" && sensor.Value.HasValue)
-                            s.GpuVramTotal = sensor.Value.Value / 1024f;
-                    }
-                    break;
+                    _gpuMisses = 0;
+                    return;
                 }
+
+                // Mapped sensors gone quiet (cached path no longer exists) - walk the tree
+                SensorTreeReader.ReadGpu(_computer.Hardware, s);
+                if (_map != null && !_gpuRediscovered && ++_gpuMisses >= GPU_MISSES_BEFORE_REDISCOVERY)
+                    RediscoverSensorMap();
             }
             catch { /* sensor read failed */ }
         }
 
+        /// <summary>
+        /// Maps the sensors again from the live tree and replaces the cached
+        /// map (once per run - after that the tree walk stays the fallback).
+        /// </summary>
+        private void RediscoverSensorMap()
+        {
+            _gpuRediscovered = true;
+            Console.WriteLine("  [LHM]      Mapped GPU sensors stopped reading - rediscovering");
+            _map = SensorMap.Discover(_computer.Hardware);
+            SensorMap.Save(CpuName, GpuName, _map);
+        }
+
         // ========================================================================
         //  GPU (Lite Mode - NvAPI only, no Ring0 needed)
         // ========================================================================
@@ -638,12 +634,33 @@ namespace PCMonitorClient
         {
             try
             {
-                if (_netBytesRecv == null || _netBytesSent == null) return;
+                if (_net == null) return;
 
-                s.NetDown = _netBytesRecv.NextValue() / (1024f * 1024f);
-                s.NetUp = _netBytesSent.NextValue() / (1024f * 1024f);
+                _net.Sample();
+
+                // Rates: all physical adapters; type/speed: primary interface
+                s.NetDown = _net.Aggregate.DownMBps;
+                s.NetUp = _net.Aggregate.UpMBps;
+                s.NetType = _net.Primary.LinkType;
+                s.NetSpeed = _net.Primary.LinkSpeed;
             }
-            catch { /* counter read failed */ }
+            catch { /* interface read failed */ }
+        }
+
+        private void CollectDisk(SystemStats s)
+        {
+            if (_disk == null) return;
+
+            _disk.Sample();
+            if (!_disk.IsAvailable) return;
+
+            var t = _disk.Total;
+            s.DiskReadMBps = t.ReadMBps;
+            s.DiskWriteMBps = t.WriteMBps;
+            s.DiskReadIops = t.ReadIops;
+            s.DiskWriteIops = t.WriteIops;
+            s.DiskQueue = t.QueueDepth;
+            s.DiskLatencyMs = t.LatencyMs;
         }
 
         // ========================================================================
@@ -652,12 +669,41 @@ namespace PCMonitorClient
 
         public void Dispose()
         {
-            SafeCloseComputer();
-            if (_netBytesRecv != null) { try { _netBytesRecv.Dispose(); } catch { } }
-            if (_netBytesSent != null) { try { _netBytesSent.Dispose(); } catch { } }
-            if (_cpuCounter != null) { try { _cpuCounter.Dispose(); } catch { } }
+            lock (_sync)
+            {
+                // A still-running background init closes its Computer itself
+                _disposed = true;
+                SafeClose(_computer);
+                _computer = null;
+            }
+            if (_net != null) { try { _net.Dispose(); } catch { } }
+        }
+
+        // ========================================================================
+        //  Native (Lite Mode sources)
+        // ========================================================================
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct MEMORYSTATUSEX
+        {
+            public uint dwLength;
+            public uint dwMemoryLoad;
+            public ulong ullTotalPhys;
+            public ulong ullAvailPhys;
+            public ulong ullTotalPageFile;
+            public ulong ullAvailPageFile;
+            public ulong ullTotalVirtual;
+            public ulong ullAvailVirtual;
+            public ulong ullAvailExtendedVirtual;
         }
 
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool GlobalMemoryStatusEx(ref MEMORYSTATUSEX buffer);
+
+        // FILETIMEs as 100ns ticks
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool GetSystemTimes(out long idleTime, out long kernelTime, out long userTime);
+
         // ========================================================================
         //  Admin Check
         // ========================================================================
@@ -877,7 +923,35 @@ namespace PCMonitorClient
                 Console.WriteLine("  [Identity] GPU detection failed: " + ex.Message);
             }
 
-            // --- Network Type ---
+            DetectNetworkType();
+            UpdateIdentityHash();
+        }
+
+        /// <summary>
+        /// Identity from the names cached by the last run (no WMI query);
+        /// the network type is still detected live.
+        /// </summary>
+        private void LoadCachedIdentity(SensorMap.Cached cached)
+        {
+            CpuName = cached.CpuName;
+            GpuName = cached.GpuName;
+            Console.WriteLine("  [Identity] CPU/GPU (cached): " + CpuName + " / " + GpuName);
+
+            DetectNetworkType();
+            UpdateIdentityHash();
+        }
+
+        /// <summary>
+        /// True once after the background init changed the identity hash
+        /// (names resolved by LHM differ from the cached/WMI ones).
+        /// </summary>
+        public bool TakeIdentityChange()
+        {
+            return Interlocked.Exchange(ref _identityChanged, 0) != 0;
+        }
+
+        private void DetectNetworkType()
+        {
             try
             {
                 var iface = NetworkInterface.GetAllNetworkInterfaces()
@@ -893,8 +967,10 @@ namespace PCMonitorClient
                 }
             }
             catch { }
+        }
 
-            // --- Generate Identity Hash ---
+        private void UpdateIdentityHash()
+        {
             string combined = CpuName + "|" + GpuName + "|" + RamName + "|" + NetName;
             IdentityHash = ComputeCrc32(combined).ToString("X8");
             Console.WriteLine("  [Identity] Hash: " + IdentityHash + " (from: " + combined + ")");
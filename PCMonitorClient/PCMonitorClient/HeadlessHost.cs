@@ -0,0 +1,265 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.ServiceProcess;
+using System.Threading;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Headless host: the same MonitorCore as the tray app, without
+    /// WinForms - no forms, icons, timers or UI thread, logging to a file.
+    ///
+    ///   start /wait PCMonitorClient.exe --headless [--config path]   foreground, Ctrl+C to stop
+    ///   PCMonitorClient.exe --service  [--config path]   under the Service Control Manager
+    ///
+    /// Settings come from %ProgramData%\ScarabMonitor\headless.ini (written
+    /// with defaults on first start). Image/firmware uploads stay with the
+    /// tray app; a queued background firmware update still continues here.
+    /// </summary>
+    internal static class HeadlessHost
+    {
+        public const string SERVICE_NAME = "ScarabMonitor";
+
+        private const string ARG_HEADLESS = "--headless";
+        private const string ARG_SERVICE = "--service";
+        private const string ARG_CONFIG = "--config";
+
+        private static readonly string DefaultConfigPath = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.CommonApplicationData),
+            "ScarabMonitor", "headless.ini");
+
+        private const int ATTACH_PARENT_PROCESS = -1;
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool AttachConsole(int processId);
+
+        public static bool IsHeadlessArgs(string[] args)
+        {
+            return args.Length > 0 && (args[0] == ARG_HEADLESS || args[0] == ARG_SERVICE);
+        }
+
+        public static void Run(string[] args)
+        {
+            string configPath = DefaultConfigPath;
+            for (int i = 1; i + 1 < args.Length; i++)
+            {
+                if (args[i] == ARG_CONFIG) configPath = args[i + 1];
+            }
+
+            var config = HeadlessConfig.Load(configPath);
+
+            if (args[0] == ARG_SERVICE)
+            {
+                ServiceBase.Run(new HeadlessService(config));
+                return;
+            }
+
+            // WinExe has no console of its own - borrow the caller's for log
+            // output and Ctrl+C
+            AttachConsole(ATTACH_PARENT_PROCESS);
+
+            using (var session = new Session(config))
+            using (var stop = new ManualResetEvent(false))
+            {
+                Console.CancelKeyPress += (s, e) =>
+                {
+                    e.Cancel = true;
+                    stop.Set();
+                };
+
+                session.Start();
+                stop.WaitOne();
+            }
+        }
+
+        /// <summary>MonitorCore + log file, shared by console and service mode.</summary>
+        private sealed class Session : IDisposable
+        {
+            private readonly HeadlessConfig _config;
+            private readonly object _logLock = new object();
+            private MonitorCore _core;
+            private StreamWriter _log;
+
+            public Session(HeadlessConfig config)
+            {
+                _config = config;
+            }
+
+            public void Start()
+            {
+                OpenLog();
+                Log("[Host] Headless start (config: " + _config.Path + ")");
+
+                if (!File.Exists(Path.Combine(AppDomain.CurrentDomain.BaseDirectory, "LibreHardwareMonitorLib.dll")))
+                    Log("[Host] LibreHardwareMonitorLib.dll missing - Lite values only");
+
+                _core = new MonitorCore(_config.Port)
+                {
+                    IntervalMs = _config.IntervalMs,
+                    SendProcessList = _config.ProcessList
+                };
+                _core.LogMessage += (s, line) => Log(line);
+                _core.FirmwareStager.StatusChanged += (s, status) => Log("[FW-Stage] " + status);
+                _core.Start();
+            }
+
+            public void Dispose()
+            {
+                try { _core?.Stop(); } catch { }
+                Log("[Host] Stopped");
+
+                lock (_logLock)
+                {
+                    try { _log?.Dispose(); } catch { }
+                    _log = null;
+                }
+            }
+
+            private void OpenLog()
+            {
+                if (string.IsNullOrEmpty(_config.LogFile)) return;
+
+                try
+                {
+                    Directory.CreateDirectory(Path.GetDirectoryName(_config.LogFile));
+                    _log = new StreamWriter(_config.LogFile, append: true) { AutoFlush = true };
+                }
+                catch (Exception ex)
+                {
+                    Program.LogCrash("HeadlessHost.OpenLog", ex);
+                }
+            }
+
+            private void Log(string line)
+            {
+                string stamped = DateTime.Now.ToString("yyyy-MM-dd HH:mm:ss", CultureInfo.InvariantCulture) + " " + line;
+                Console.WriteLine(stamped);
+
+                lock (_logLock)
+                {
+                    try { _log?.WriteLine(stamped); } catch { }
+                }
+            }
+        }
+
+        private sealed class HeadlessService : ServiceBase
+        {
+            private readonly HeadlessConfig _config;
+            private Session _session;
+
+            public HeadlessService(HeadlessConfig config)
+            {
+                _config = config;
+                ServiceName = SERVICE_NAME;
+                CanStop = true;
+                CanShutdown = true;
+            }
+
+            protected override void OnStart(string[] args)
+            {
+                _session = new Session(_config);
+                _session.Start();
+            }
+
+            protected override void OnStop()
+            {
+                _session?.Dispose();
+                _session = null;
+            }
+
+            protected override void OnShutdown()
+            {
+                OnStop();
+            }
+        }
+    }
+
+    /// <summary>
+    /// headless.ini - key=value lines, '#' comments. Unknown keys are ignored,
+    /// missing keys keep their defaults.
+    /// </summary>
+    internal sealed class HeadlessConfig
+    {
+        private const int MIN_INTERVAL_MS = 250;
+
+        public string Path { get; private set; }
+
+        /// <summary>COM port, or null to find the device by handshake ("auto").</summary>
+        public string Port { get; private set; }
+
+        public int IntervalMs { get; private set; } = 1000;
+        public bool ProcessList { get; private set; } = true;
+        public string LogFile { get; private set; }
+
+        public static HeadlessConfig Load(string path)
+        {
+            path = System.IO.Path.GetFullPath(path);
+            var config = new HeadlessConfig
+            {
+                Path = path,
+                LogFile = System.IO.Path.Combine(System.IO.Path.GetDirectoryName(path), "headless.log")
+            };
+
+            try
+            {
+                if (!File.Exists(path))
+                {
+                    WriteDefaults(config);
+                    return config;
+                }
+
+                var values = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase);
+                foreach (string raw in File.ReadAllLines(path))
+                {
+                    string line = raw.Trim();
+                    if (line.Length == 0 || line[0] == '#') continue;
+                    int eq = line.IndexOf('=');
+                    if (eq > 0) values[line.Substring(0, eq).Trim()] = line.Substring(eq + 1).Trim();
+                }
+
+                if (values.TryGetValue("port", out var port))
+                    config.Port = port.Equals("auto", StringComparison.OrdinalIgnoreCase) ? null : port;
+
+                if (values.TryGetValue("interval_ms", out var interval)
+                    && int.TryParse(interval, NumberStyles.Integer, CultureInfo.InvariantCulture, out int ms))
+                    config.IntervalMs = Math.Max(MIN_INTERVAL_MS, ms);
+
+                if (values.TryGetValue("process_list", out var procs))
+                    config.ProcessList = !(procs == "0" || procs.Equals("false", StringComparison.OrdinalIgnoreCase));
+
+                if (values.TryGetValue("log_file", out var log))
+                    config.LogFile = log;
+            }
+            catch (Exception ex)
+            {
+                Program.LogCrash("HeadlessConfig.Load", ex);
+            }
+
+            return config;
+        }
+
+        private static void WriteDefaults(HeadlessConfig config)
+        {
+            try
+            {
+                Directory.CreateDirectory(System.IO.Path.GetDirectoryName(config.Path));
+                File.WriteAllLines(config.Path, new[]
+                {
+                    "# Scarab Monitor headless host (--headless / --service)",
+                    "# COM port of the display, or auto to find it by handshake",
+                    "port=auto",
+                    "# Stats interval in ms (min " + MIN_INTERVAL_MS + ")",
+                    "interval_ms=" + config.IntervalMs,
+                    "# Top-5 process list for the CPU view (true/false)",
+                    "process_list=true",
+                    "# Log file (empty = none)",
+                    "log_file=" + config.LogFile
+                });
+            }
+            catch { }
+        }
+    }
+}
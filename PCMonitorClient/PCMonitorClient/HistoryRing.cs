@@ -0,0 +1,118 @@
+using System;
+using System.Diagnostics;
+using System.Globalization;
+using System.Text;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Short ring of recent network/disk rates, replayed to the device as one
+    /// HIST: line after a (re)connect so its charts resume with real history
+    /// instead of 60 zeros. Only sent when the firmware reports FEAT:HIST.
+    ///
+    /// HIST:[n][|GAP:g]|DOWN:v,v,...|UP:v,...[|DSKR:v,...|DSKW:v,...]
+    ///
+    /// The device charts advance one point per stats packet, so the ring holds
+    /// one entry per data-loop cycle and POINTS entries at most. Values are
+    /// reduced to what the charts can show: 0.1 MB/s integers, negative
+    /// (counter error / no disk data) as 0.
+    ///
+    /// Each sample keeps its send time. GAP is the number of packets missed
+    /// since the newest one; samples pushed off the chart by it are not sent,
+    /// and nothing is sent once the gap covers the whole chart.
+    /// </summary>
+    public sealed class HistoryRing
+    {
+        /// <summary>Device chart width (HISTORY_POINTS in system_types.h).</summary>
+        public const int POINTS = 60;
+
+        private readonly int[] _down = new int[POINTS];
+        private readonly int[] _up = new int[POINTS];
+        private readonly int[] _read = new int[POINTS];
+        private readonly int[] _write = new int[POINTS];
+        private readonly long[] _stampMs = new long[POINTS];
+        private int _next;          // Slot the next sample goes to
+        private int _count;
+        private bool _hasDisk;      // At least one sample carried disk rates
+
+        /// <summary>Samples currently held (0..POINTS).</summary>
+        public int Count => _count;
+
+        /// <summary>Records the rates of one sent stats packet.</summary>
+        public void Add(SystemStats s)
+        {
+            _stampMs[_next] = NowMs();
+            _down[_next] = ToTenths(s.NetDown);
+            _up[_next] = ToTenths(s.NetUp);
+            _read[_next] = ToTenths(s.DiskReadMBps);
+            _write[_next] = ToTenths(s.DiskWriteMBps);
+            _hasDisk |= s.DiskReadMBps >= 0f;
+
+            _next = (_next + 1) % POINTS;
+            if (_count < POINTS) _count++;
+        }
+
+        public void Clear()
+        {
+            _next = 0;
+            _count = 0;
+            _hasDisk = false;
+        }
+
+        /// <summary>
+        /// Builds the backfill line (oldest sample first, newline-terminated),
+        /// or null if there is nothing left on the chart to replay.
+        /// </summary>
+        /// <param name="intervalMs">Data-loop cadence (one chart point per packet)</param>
+        public string EncodeBackfill(int intervalMs)
+        {
+            if (_count == 0) return null;
+
+            // Packets missed since the newest sample: the next live one takes
+            // the slot one interval after it
+            int gap = 0;
+            if (intervalMs > 0)
+            {
+                long ageMs = NowMs() - _stampMs[(_next - 1 + POINTS) % POINTS];
+                long slots = (ageMs + intervalMs / 2) / intervalMs - 1;
+                if (slots >= POINTS) return null;
+                gap = (int)Math.Max(0, slots);
+            }
+            int keep = Math.Min(_count, POINTS - gap);
+
+            var sb = new StringBuilder(64 + keep * 4 * 6);
+            sb.Append(ProtocolCommands.HISTORY).Append(keep.ToString(CultureInfo.InvariantCulture));
+            if (gap > 0) sb.Append("|GAP:").Append(gap.ToString(CultureInfo.InvariantCulture));
+            AppendList(sb, "|DOWN:", _down, keep);
+            AppendList(sb, "|UP:", _up, keep);
+            if (_hasDisk)
+            {
+                AppendList(sb, "|DSKR:", _read, keep);
+                AppendList(sb, "|DSKW:", _write, keep);
+            }
+            return sb.Append('\n').ToString();
+        }
+
+        /// <summary>Appends the newest <paramref name="keep"/> values, oldest first.</summary>
+        private void AppendList(StringBuilder sb, string key, int[] values, int keep)
+        {
+            sb.Append(key);
+            int first = (_next - keep + POINTS) % POINTS;
+            for (int i = 0; i < keep; i++)
+            {
+                if (i > 0) sb.Append(',');
+                sb.Append(values[(first + i) % POINTS].ToString(CultureInfo.InvariantCulture));
+            }
+        }
+
+        private static long NowMs()
+        {
+            return Stopwatch.GetTimestamp() / (Stopwatch.Frequency / 1000);
+        }
+
+        private static int ToTenths(float mbs)
+        {
+            return mbs > 0f ? (int)Math.Round(mbs * 10f) : 0;
+        }
+    }
+}
@@ -14,18 +14,20 @@ namespace PCMonitorClient
     /// RGB565A8 = 16-bit color (RGB565) + 8-bit alpha channel (separate plane)
     /// Total: 3 bytes per pixel (2 for color, 1 for alpha)
     ///
-    /// Output format: 16-byte SCARAB header + pixel data
+    /// Output format: SCARAB header + pixel data.
+    /// - Full frame (any firmware): 16-byte v1 header, 240x240 RGB565A8.
+    /// - Cropped (firmware with FEAT:SPR): 20-byte v2 header, only the
+    ///   bounding box of non-transparent pixels, placed by offset. Fully
+    ///   opaque crops are sent as RGB565 (no alpha plane).
     /// </summary>
     public static class ImageConverter
     {
         public const int TARGET_WIDTH = 240;
         public const int TARGET_HEIGHT = 240;
 
-        // SCARAB image header constants (must match ESP32 scarab_img_header_t)
-        private const uint SCARAB_IMG_MAGIC = 0x53434152;  // "SCAR" in little-endian
-        private const int SCARAB_HEADER_SIZE = 16;
-        private const byte SCARAB_FORMAT_RGB565A8 = 1;     // 0=RGB565, 1=RGB565A8
-        private const byte SCARAB_VERSION = 1;
+        // SCARAB image header: layout and constants are generated from
+        // protocol/scarab_protocol.def (same source as the ESP32 struct)
+        private const int SCARAB_HEADER_SIZE = ScarabImgHeader.SIZE;
 
         /// <summary>
         /// Result of image conversion
@@ -35,18 +37,26 @@ namespace PCMonitorClient
             /// <summary>RGB565 color data (2 bytes per pixel, row-major)</summary>
             public byte[] ColorData { get; set; }
 
-            /// <summary>Alpha channel data (1 byte per pixel, row-major)</summary>
+            /// <summary>Alpha channel data (1 byte per pixel, row-major); empty for RGB565</summary>
             public byte[] AlphaData { get; set; }
 
-            /// <summary>Combined data: 16-byte SCARAB header + ColorData + AlphaData</summary>
+            /// <summary>Combined data: SCARAB header + ColorData + AlphaData</summary>
             public byte[] CombinedData { get; set; }
 
-            /// <summary>Image width (always 240)</summary>
+            /// <summary>Image width (240 unless cropped)</summary>
             public int Width { get; set; }
 
-            /// <summary>Image height (always 240)</summary>
+            /// <summary>Image height (240 unless cropped)</summary>
             public int Height { get; set; }
 
+            /// <summary>Position of the top-left pixel on the 240x240 display</summary>
+            public int OffsetX { get; set; }
+
+            /// <summary>Position of the top-left pixel on the 240x240 display</summary>
+            public int OffsetY { get; set; }
+
+            public ScarabImgFormat Format { get; set; }
+
             /// <summary>CRC32 checksum of CombinedData</summary>
             public uint Crc32 { get; set; }
         }
@@ -56,39 +66,40 @@ namespace PCMonitorClient
         /// Image is resized to 240x240, maintaining aspect ratio with transparent padding.
         /// </summary>
         /// <param name="imagePath">Path to source image (PNG, JPG, etc.)</param>
+        /// <param name="cropToContent">Trim transparent borders (needs firmware with FEAT:SPR)</param>
         /// <returns>Conversion result with RGB565A8 data</returns>
-        public static ConversionResult ConvertToRgb565A8(string imagePath)
+        public static ConversionResult ConvertToRgb565A8(string imagePath, bool cropToContent = false)
         {
             using (var image = Image.Load<Rgba32>(imagePath))
             {
-                return ConvertImage(image);
+                return ConvertImage(image, cropToContent);
             }
         }
 
         /// <summary>
         /// Converts an image from a stream to RGB565A8 format.
         /// </summary>
-        public static ConversionResult ConvertToRgb565A8(Stream stream)
+        public static ConversionResult ConvertToRgb565A8(Stream stream, bool cropToContent = false)
         {
             using (var image = Image.Load<Rgba32>(stream))
             {
-                return ConvertImage(image);
+                return ConvertImage(image, cropToContent);
             }
         }
 
         /// <summary>
         /// Converts an image from byte array to RGB565A8 format.
         /// </summary>
-        public static ConversionResult ConvertToRgb565A8(byte[] imageData)
+        public static ConversionResult ConvertToRgb565A8(byte[] imageData, bool cropToContent = false)
         {
             using (var ms = new MemoryStream(imageData))
             using (var image = Image.Load<Rgba32>(ms))
             {
-                return ConvertImage(image);
+                return ConvertImage(image, cropToContent);
             }
         }
 
-        private static ConversionResult ConvertImage(Image<Rgba32> sourceImage)
+        private static ConversionResult ConvertImage(Image<Rgba32> sourceImage, bool cropToContent)
         {
             int srcWidth = sourceImage.Width;
             int srcHeight = sourceImage.Height;
@@ -129,11 +140,40 @@ namespace PCMonitorClient
                 // Draw image onto canvas (centered)
                 canvas.Mutate(x => x.DrawImage(sourceImage, new Point(offsetX, offsetY), 1f));
 
-                // Convert to RGB565A8
-                return ExtractRgb565A8(canvas);
+                if (!cropToContent)
+                {
+                    // Full frame, v1 header - understood by every firmware
+                    return ExtractRgb565A8(canvas, new Rectangle(0, 0, TARGET_WIDTH, TARGET_HEIGHT), legacyHeader: true);
+                }
+
+                return ExtractRgb565A8(canvas, FindContentBounds(canvas), legacyHeader: false);
             }
         }
 
+        /// <summary>
+        /// Bounding box of all pixels with alpha > 0. A fully transparent
+        /// image yields a single pixel in the top-left corner.
+        /// </summary>
+        private static Rectangle FindContentBounds(Image<Rgba32> image)
+        {
+            int minX = image.Width, minY = image.Height, maxX = -1, maxY = -1;
+
+            for (int y = 0; y < image.Height; y++)
+            {
+                for (int x = 0; x < image.Width; x++)
+                {
+                    if (image[x, y].A == 0) continue;
+                    if (x < minX) minX = x;
+                    if (x > maxX) maxX = x;
+                    if (y < minY) minY = y;
+                    maxY = y;
+                }
+            }
+
+            if (maxX < 0) return new Rectangle(0, 0, 1, 1);
+            return new Rectangle(minX, minY, maxX - minX + 1, maxY - minY + 1);
+        }
+
         /// <summary>
         /// Extracts RGB565A8 data in LVGL v9 PLANAR format.
         ///
@@ -156,23 +196,35 @@ namespace PCMonitorClient
         /// - Color and alpha are stored in separate contiguous blocks
         /// - Stride for LVGL = width × 2 (RGB565 row width)
         /// </summary>
-        private static ConversionResult ExtractRgb565A8(Image<Rgba32> image)
+        private static ConversionResult ExtractRgb565A8(Image<Rgba32> image, Rectangle area, bool legacyHeader)
         {
-            int pixelCount = TARGET_WIDTH * TARGET_HEIGHT;  // 57,600 pixels
+            int width = area.Width;
+            int height = area.Height;
+            int pixelCount = width * height;  // 57,600 pixels for a full frame
+
+            // A crop without any translucent pixel needs no alpha plane (RGB565)
+            bool opaque = !legacyHeader;
+            for (int y = area.Y; opaque && y < area.Bottom; y++)
+            {
+                for (int x = area.X; x < area.Right; x++)
+                {
+                    if (image[x, y].A != 255) { opaque = false; break; }
+                }
+            }
 
-            // Block 1: RGB565 color data - 2 bytes per pixel (115,200 bytes total)
+            // Block 1: RGB565 color data - 2 bytes per pixel (115,200 bytes for a full frame)
             byte[] rgbData = new byte[pixelCount * 2];
 
-            // Block 2: Alpha channel data - 1 byte per pixel (57,600 bytes total)
-            byte[] alphaData = new byte[pixelCount];
+            // Block 2: Alpha channel data - 1 byte per pixel (57,600 bytes for a full frame)
+            byte[] alphaData = opaque ? Array.Empty<byte>() : new byte[pixelCount];
 
             int rgbIdx = 0;
             int alphaIdx = 0;
 
             // Iterate row by row, column by column (row-major order)
-            for (int y = 0; y < TARGET_HEIGHT; y++)
+            for (int y = area.Y; y < area.Bottom; y++)
             {
-                for (int x = 0; x < TARGET_WIDTH; x++)
+                for (int x = area.X; x < area.Right; x++)
                 {
                     Rgba32 pixel = image[x, y];
 
@@ -184,64 +236,49 @@ namespace PCMonitorClient
                     rgbData[rgbIdx++] = (byte)((rgb565 >> 8) & 0xFF);  // High byte second
 
                     // Store alpha channel (0-255)
-                    alphaData[alphaIdx++] = pixel.A;
+                    if (!opaque) alphaData[alphaIdx++] = pixel.A;
                 }
             }
 
-            // Total pixel data: RGB block + Alpha block = 172,800 bytes
+            // Total pixel data: RGB block + Alpha block (172,800 bytes for a full frame)
             int pixelDataSize = rgbData.Length + alphaData.Length;
+            var format = opaque ? ScarabImgFormat.RGB565 : ScarabImgFormat.RGB565A8;
 
-            // Final output: 16-byte SCARAB header + pixel data
-            byte[] combinedData = new byte[SCARAB_HEADER_SIZE + pixelDataSize];
-
-            // ═══════════════════════════════════════════════════════════
-            // Build 16-byte SCARAB header (matches ESP32 scarab_img_header_t)
-            // ═══════════════════════════════════════════════════════════
-            int offset = 0;
+            // v1 header is the first 16 bytes of the v2 layout (no placement fields)
+            int headerSize = legacyHeader ? ProtocolConstants.SCARAB_IMG_HEADER_V1_SIZE : SCARAB_HEADER_SIZE;
+            byte[] combinedData = new byte[headerSize + pixelDataSize];
 
-            // [0-3] magic: uint32 - "SCAR" = 0x53434152 (Little-Endian)
-            combinedData[offset++] = 0x52;  // 'R'
-            combinedData[offset++] = 0x41;  // 'A'
-            combinedData[offset++] = 0x43;  // 'C'
-            combinedData[offset++] = 0x53;  // 'S'
-
-            // [4-5] width: uint16 (Little-Endian)
-            combinedData[offset++] = (byte)(TARGET_WIDTH & 0xFF);
-            combinedData[offset++] = (byte)((TARGET_WIDTH >> 8) & 0xFF);
-
-            // [6-7] height: uint16 (Little-Endian)
-            combinedData[offset++] = (byte)(TARGET_HEIGHT & 0xFF);
-            combinedData[offset++] = (byte)((TARGET_HEIGHT >> 8) & 0xFF);
-
-            // [8] format: uint8 - 1 = SCARAB_FMT_RGB565A8
-            combinedData[offset++] = SCARAB_FORMAT_RGB565A8;
-
-            // [9] version: uint8
-            combinedData[offset++] = SCARAB_VERSION;
-
-            // [10-11] reserved: uint16 - padding for 4-byte alignment
-            combinedData[offset++] = 0;
-            combinedData[offset++] = 0;
-
-            // [12-15] data_size: uint32 - pixel data size (Little-Endian)
-            combinedData[offset++] = (byte)(pixelDataSize & 0xFF);
-            combinedData[offset++] = (byte)((pixelDataSize >> 8) & 0xFF);
-            combinedData[offset++] = (byte)((pixelDataSize >> 16) & 0xFF);
-            combinedData[offset++] = (byte)((pixelDataSize >> 24) & 0xFF);
+            Span<byte> header = stackalloc byte[SCARAB_HEADER_SIZE];
+            new ScarabImgHeader
+            {
+                Magic = ProtocolConstants.SCARAB_IMG_MAGIC,
+                Width = (ushort)width,
+                Height = (ushort)height,
+                Format = (byte)format,
+                Version = (byte)(legacyHeader ? 1 : ProtocolConstants.SCARAB_IMG_VERSION),
+                Align = (byte)(legacyHeader ? ScarabImgAlign.CENTER : ScarabImgAlign.TOP_LEFT),
+                DataSize = (uint)pixelDataSize,
+                OffsetX = (short)(legacyHeader ? 0 : area.X),
+                OffsetY = (short)(legacyHeader ? 0 : area.Y)
+            }.Write(header);
+            header.Slice(0, headerSize).CopyTo(combinedData);
 
             // ═══════════════════════════════════════════════════════════
             // Append pixel data in PLANAR format: RGB block, then Alpha block
             // ═══════════════════════════════════════════════════════════
-            Buffer.BlockCopy(rgbData, 0, combinedData, SCARAB_HEADER_SIZE, rgbData.Length);
-            Buffer.BlockCopy(alphaData, 0, combinedData, SCARAB_HEADER_SIZE + rgbData.Length, alphaData.Length);
+            Buffer.BlockCopy(rgbData, 0, combinedData, headerSize, rgbData.Length);
+            Buffer.BlockCopy(alphaData, 0, combinedData, headerSize + rgbData.Length, alphaData.Length);
 
             return new ConversionResult
             {
                 ColorData = rgbData,
                 AlphaData = alphaData,
                 CombinedData = combinedData,
-                Width = TARGET_WIDTH,
-                Height = TARGET_HEIGHT,
+                Width = width,
+                Height = height,
+                OffsetX = area.X,
+                OffsetY = area.Y,
+                Format = format,
                 Crc32 = ComputeCrc32(combinedData)
             };
         }
@@ -265,20 +302,51 @@ namespace PCMonitorClient
         /// <summary>
         /// Computes CRC32 checksum of byte array.
         /// </summary>
-        public static uint ComputeCrc32(byte[] data)
+        public static uint ComputeCrc32(byte[] data) => ComputeCrc32(data, 0, data.Length);
+
+        /// <summary>
+        /// Computes CRC32 checksum of count bytes starting at offset.
+        /// </summary>
+        public static uint ComputeCrc32(byte[] data, int offset, int count)
+        {
+            return ~UpdateCrc32(CRC32_INIT, data, offset, count);
+        }
+
+        /// <summary>
+        /// Computes CRC32 checksum of a stream from its current position to
+        /// the end, in blocks (the stream is never held in memory).
+        /// </summary>
+        public static uint ComputeCrc32(Stream stream)
         {
-            uint crc = 0xFFFFFFFF;
+            var block = new byte[64 * 1024];
+            uint crc = CRC32_INIT;
+            int n;
+            while ((n = stream.Read(block, 0, block.Length)) > 0)
+            {
+                crc = UpdateCrc32(crc, block, 0, n);
+            }
+            return ~crc;
+        }
+
+        /// <summary>Start value of a running CRC32 (UpdateCrc32).</summary>
+        public const uint CRC32_INIT = 0xFFFFFFFF;
 
-            foreach (byte b in data)
+        /// <summary>
+        /// Feeds count bytes into a running CRC32. Start with CRC32_INIT; the
+        /// checksum is the bitwise NOT of the final value.
+        /// </summary>
+        public static uint UpdateCrc32(uint crc, byte[] data, int offset, int count)
+        {
+            for (int n = offset; n < offset + count; n++)
             {
-                crc ^= b;
+                crc ^= data[n];
                 for (int i = 0; i < 8; i++)
                 {
                     crc = (crc >> 1) ^ (0xEDB88320 & ~((crc & 1) - 1));
                 }
             }
 
-            return ~crc;
+            return crc;
         }
 
         /// <summary>
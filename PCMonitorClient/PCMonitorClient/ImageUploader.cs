@@ -1,6 +1,5 @@
 using System;
 using System.IO;
-using System.IO.Ports;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -25,36 +24,53 @@ namespace PCMonitorClient
     public class ImageUploader
     {
         private readonly ChunkedSerialUploader _uploader;
+        private readonly bool _cropToContent;
 
         public event EventHandler<UploadProgressEventArgs> ProgressChanged;
         public event EventHandler<string> LogMessage;
 
-        /// <param name="port">Open serial port</param>
+        /// <param name="port">The held port (MonitorCore.AcquirePortAsync)</param>
         /// <param name="writeLock">Shared lock guarding ALL writes to this port
         /// (data loop, commands, uploads) - prevents interleaved lines.</param>
-        public ImageUploader(SerialPort port, object writeLock = null)
+        /// <param name="caps">Device capabilities (chunk size, chunk CRC); null = legacy limits</param>
+        public ImageUploader(ISerialLink port, object writeLock = null, DeviceCaps caps = null)
         {
-            _uploader = new ChunkedSerialUploader(port, writeLock, "IMG");
+            caps = caps ?? DeviceCaps.Legacy;
+            _uploader = new ChunkedSerialUploader(port, writeLock, "IMG")
+            {
+                ChunkSize = caps.UploadChunkBytes,
+                ChunkCrc = caps.UploadChunkCrc
+            };
+            // Positioned sprites need firmware that reads the v2 header
+            _cropToContent = caps.HasFeature(DeviceCaps.FEATURE_SPRITES);
             _uploader.ProgressChanged += (s, e) => ProgressChanged?.Invoke(this, e);
             _uploader.LogMessage += (s, m) => LogMessage?.Invoke(this, m);
         }
 
         /// <summary>
-        /// Uploads an image file to the specified slot on the ESP32.
+        /// Uploads an image file to the specified slot on the ESP32: a display
+        /// slot (ImageSlot, 0-3) or, with FEAT:PROF, any image library slot up
+        /// to SS_IMG_LIBRARY-1 for profiles to reference (PROFILE_IMG).
         /// </summary>
-        public async Task<bool> UploadImageAsync(string imagePath, ImageSlot slot, CancellationToken ct = default)
+        public async Task<bool> UploadImageAsync(string imagePath, int slot, CancellationToken ct = default)
         {
             if (!File.Exists(imagePath))
             {
                 Log("Error: File not found: " + imagePath);
                 return false;
             }
+            if (slot < 0 || slot >= ProtocolConstants.SS_IMG_LIBRARY)
+            {
+                Log("Error: No image slot " + slot);
+                return false;
+            }
 
             try
             {
                 Log("Converting image to RGB565A8...");
-                var result = ImageConverter.ConvertToRgb565A8(imagePath);
-                Log($"Converted: {result.CombinedData.Length} bytes, CRC32: {result.Crc32:X8}");
+                var result = ImageConverter.ConvertToRgb565A8(imagePath, _cropToContent);
+                Log($"Converted: {result.Width}x{result.Height} at {result.OffsetX},{result.OffsetY} " +
+                    $"{result.Format}, {result.CombinedData.Length} bytes, CRC32: {result.Crc32:X8}");
 
                 return await UploadDataAsync(result.CombinedData, result.Crc32, slot, ct);
             }
@@ -68,9 +84,12 @@ namespace PCMonitorClient
         /// <summary>
         /// Uploads pre-converted RGB565A8 data to the ESP32.
         /// </summary>
-        public Task<bool> UploadDataAsync(byte[] data, uint crc32, ImageSlot slot, CancellationToken ct = default)
+        public Task<bool> UploadDataAsync(byte[] data, uint crc32, int slot, CancellationToken ct = default)
         {
-            string beginCommand = $"IMG_BEGIN:{(int)slot}:{data?.Length ?? 0}";
+            if (slot < 0 || slot >= ProtocolConstants.SS_IMG_LIBRARY)
+                throw new ArgumentOutOfRangeException(nameof(slot));
+
+            string beginCommand = $"IMG_BEGIN:{slot}:{data?.Length ?? 0}";
             return _uploader.UploadAsync(beginCommand, data, crc32, ct);
         }
 
@@ -0,0 +1,1152 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO.Ports;
+using System.Linq;
+using System.Management;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace PCMonitorClient
+{
+    /// <summary>Connection state for the UI / log.</summary>
+    public sealed class MonitorStatusEventArgs : EventArgs
+    {
+        public string Status { get; set; }
+        public bool IsConnected { get; set; }
+        public bool IsLiteMode { get; set; }
+    }
+
+    /// <summary>What an exclusive holder of the port does (MonitorCore.AcquirePortAsync).</summary>
+    public enum PortUse
+    {
+        ImageUpload,
+        FirmwareFlash,
+        Benchmark
+    }
+
+    /// <summary>
+    /// Collector + transport core: finds the device, handshakes, keeps the
+    /// stats/process stream going and reconnects. No UI types - the tray app
+    /// (TrayContext) and the headless host (HeadlessHost) both drive this
+    /// and only differ in what they do with the events.
+    /// </summary>
+    public sealed class MonitorCore
+    {
+        private const string HANDSHAKE_QUERY = ProtocolCommands.HANDSHAKE_QUERY + "\n";
+        private const int ESP_RESET_TIMEOUT_MS = 2000;  // Handshake retries after opening the data port
+        private const int SCAN_TIMEOUT_MS = 1000;       // Handshake retries per port during discovery
+
+        // Identity Sync Protocol
+        private const string NAME_CMD_CPU = "NAME_CPU=";
+        private const string NAME_CMD_GPU = "NAME_GPU=";
+        private const string NAME_CMD_HASH = "NAME_HASH=";
+
+        // NOTE: The ESP32-S3's native USB port enumerates as "USB JTAG/serial
+        // debug unit" when the Espressif driver is installed - and that IS our
+        // device. So keywords here only LOWER scan priority (tried last),
+        // they never exclude a port. The handshake decides.
+        private static readonly string[] DEPRIORITIZE_PORT_KEYWORDS = { "Debugger", "JLink", "ST-Link" };
+        private static readonly string[] PREFER_PORT_KEYWORDS = { "USB Serial", "USB-SERIAL", "USB JTAG/serial", "CP210", "CH340", "CH341", "FTDI", "Silicon Labs" };
+
+        /// <summary>Footprint log interval ([Perf] working set / CPU).</summary>
+        private const int FOOTPRINT_INTERVAL_MS = 10 * 60 * 1000;
+
+        private readonly string _fixedPort;           // null = auto-detect by handshake
+
+        // === STATE ===
+        private HardwareCollector _collector;
+        private ProcessSampler _procSampler;
+        private readonly HistoryRing _history = new HistoryRing();  // Outlives connections: replayed on reconnect
+        private CancellationTokenSource _cts;
+        private Task _backgroundTask;
+        private SerialPort _activePort;
+        private volatile SerialDispatcher _dispatcher;  // Sole reader of _activePort
+        private readonly object _portLock = new object();
+        private Timer _footprintTimer;
+        private TimeSpan _lastCpuTime;
+        private DateTime _lastFootprintAt;
+
+        private volatile bool _isConnected = false;
+        private volatile bool _isLiteMode = false;
+        private int _exclusiveUsers;                  // Holders of AcquirePortAsync - pauses the data loop
+        private volatile bool _isPaused = false;      // Manual pause by user
+        private volatile string _espFwVersion = "";   // Firmware version from handshake (|V:x.y.z)
+        private volatile string _espDeviceName = "";  // User-assigned device name from handshake (|N:...)
+        private volatile string _espBuildId = "";     // Firmware build ID from handshake (|B:...)
+        private volatile DeviceCaps _deviceCaps = DeviceCaps.Legacy;  // GET_CAPS descriptor of the connected device
+        private volatile string _espHash = "";        // Identity hash of the connected device
+        private volatile string _portName = "";       // Port of the current connection
+        private volatile DeviceRpc _rpc;              // Request-ID commands (FEAT:RPC), null otherwise
+        private bool _firstPacketSent;                // Time-to-first-packet logged once per process
+
+        // === BACKGROUND FIRMWARE UPDATE ===
+        private readonly FirmwareStager _fwStager = new FirmwareStager();
+        private CancellationTokenSource _stagingCts;  // Per connection; cancel keeps progress
+        private Task _stagingTask;
+
+        /// <summary>Log lines ("[Serial] ...", "[Init] ...").</summary>
+        public event EventHandler<string> LogMessage;
+
+        /// <summary>Connection / mode state changed (searching, connected, Lite/Full).</summary>
+        public event EventHandler<MonitorStatusEventArgs> StatusChanged;
+
+        /// <summary>A device finished connecting, or the connection was lost.</summary>
+        public event EventHandler ConnectionChanged;
+
+        /// <summary>Stats line just sent ("TX: ..."). Only built while someone listens.</summary>
+        public event EventHandler<string> DataSent;
+
+        /// <param name="fixedPort">COM port to use, or null to scan for the device</param>
+        public MonitorCore(string fixedPort)
+        {
+            _fixedPort = string.IsNullOrEmpty(fixedPort) ? null : fixedPort;
+            _fwStager.LogMessage += (s, msg) => Log("[FW-Stage] " + msg);
+        }
+
+        /// <summary>Target interval between stats packets.</summary>
+        public int IntervalMs { get; set; } = 1000;
+
+        /// <summary>Send the top-N process list (set before Start).</summary>
+        public bool SendProcessList { get; set; } = true;
+
+        public bool IsConnected => _isConnected;
+        public bool IsLiteMode => _isLiteMode;
+        public string PortName => _portName;
+        public string DeviceName => _espDeviceName;
+        public string FwVersion => _espFwVersion;
+        public DeviceCaps DeviceCaps => _deviceCaps;
+        public string LocalIdentityHash => _collector?.IdentityHash ?? "";
+        public FirmwareStager FirmwareStager => _fwStager;
+
+        /// <summary>Guards all writes to the port (AcquirePortAsync holders included).</summary>
+        public object PortLock => _portLock;
+
+        /// <summary>True while an exclusive upload or the benchmark holds the port (data loop paused).</summary>
+        public bool IsUploadMode => Volatile.Read(ref _exclusiveUsers) > 0;
+
+        /// <summary>
+        /// Takes the port for an exclusive image/firmware upload or the device
+        /// benchmark. Telemetry pauses and the device's untagged replies go to
+        /// the returned lease until it is disposed; RPC calls keep working.
+        /// Waits for background staging to let go of the port. Null if not
+        /// connected.
+        /// </summary>
+        public async Task<PortLease> AcquirePortAsync(PortUse use, CancellationToken ct = default)
+        {
+            var dispatcher = _dispatcher;
+            if (dispatcher == null || !dispatcher.IsOpen) return null;
+
+            Interlocked.Increment(ref _exclusiveUsers);     // No new staging session from here on
+            try
+            {
+                await Task.Run(StopFirmwareStaging);
+
+                // FW_BEGIN discards the device's staged image; the queued job
+                // would otherwise restage its (older) image afterwards
+                if (use == PortUse.FirmwareFlash && _fwStager.HasJob)
+                {
+                    _fwStager.Cancel();
+                    Log("[FW] Background update cancelled for exclusive flash");
+                }
+                var lease = await dispatcher.AcquireAsync(use.ToString(), ct, OnExclusivePortReleased);
+
+                // A stats line being written when the mode changed is complete
+                // once the write lock is free - nothing of it can interleave
+                lock (_portLock) { }
+                Log("[Serial] Port held for " + use);
+                return lease;
+            }
+            catch
+            {
+                OnExclusivePortReleased();
+                throw;
+            }
+        }
+
+        private void OnExclusivePortReleased()
+        {
+            if (Interlocked.Decrement(ref _exclusiveUsers) == 0)
+                RunFirmwareStaging();       // Queued background update continues
+        }
+
+        /// <summary>Request-ID command latency and failure counters (null without FEAT:RPC).</summary>
+        public DeviceRpc.Metrics RpcMetrics => _rpc?.GetMetrics();
+
+        /// <summary>Manual pause by the user.</summary>
+        public bool IsPaused
+        {
+            get => _isPaused;
+            set => _isPaused = value;
+        }
+
+        /// <summary>Starts the collector and the connect/data loop on a worker thread.</summary>
+        public void Start()
+        {
+            if (_backgroundTask != null) return;
+
+            _cts = new CancellationTokenSource();
+            _lastCpuTime = Process.GetCurrentProcess().TotalProcessorTime;
+            _lastFootprintAt = DateTime.UtcNow;
+            _footprintTimer = new Timer(_ => LogFootprint(), null, FOOTPRINT_INTERVAL_MS, FOOTPRINT_INTERVAL_MS);
+            _backgroundTask = Task.Run(() => MonitorLoop(_cts.Token));
+        }
+
+        /// <summary>
+        /// Stops the loop (waits up to 1.5s), closes the port and disposes the
+        /// collector.
+        /// </summary>
+        public void Stop()
+        {
+            try { _footprintTimer?.Dispose(); } catch { }
+
+            // Cancel background task
+            try { _cts?.Cancel(); } catch { }
+
+            // Close serial port to unblock reads
+            lock (_portLock)
+            {
+                if (_activePort != null)
+                {
+                    try { _activePort.Close(); _activePort.Dispose(); } catch { }
+                    _activePort = null;
+                }
+            }
+
+            // Wait for background task (max 1.5s)
+            try { _backgroundTask?.Wait(1500); } catch { }
+
+            // Dispose hardware collector
+            try { _collector?.Dispose(); } catch { }
+        }
+
+        /// <summary>
+        /// Sends a command string to the ESP32 via serial port.
+        /// Thread-safe, can be called from any thread.
+        /// </summary>
+        public void SendCommand(string command)
+        {
+            if (string.IsNullOrEmpty(command)) return;
+
+            var rpc = _rpc;
+            if (rpc != null)
+            {
+                _ = SendCommandRpcAsync(rpc, command.TrimEnd('\n'));
+                return;
+            }
+
+            lock (_portLock)
+            {
+                if (_activePort == null || !_activePort.IsOpen)
+                {
+                    Log("[Cmd] Error: Not connected");
+                    return;
+                }
+
+                try
+                {
+                    string line = command.EndsWith("\n") ? command : command + "\n";
+                    _activePort.Write(line);
+                    _activePort.BaseStream.Flush();
+                    Log("[Cmd] TX: " + command);
+                }
+                catch (Exception ex)
+                {
+                    Log("[Cmd] Error: " + ex.Message);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Sends a command and waits until the device has handled it; the
+        /// reply lines (PROFILE_OK, PROFILE_ERR, ...) are in Reply.Lines.
+        /// Needs FEAT:RPC - Failed without it or when not connected.
+        /// </summary>
+        public async Task<DeviceRpc.Reply> CallAsync(string command)
+        {
+            var rpc = _rpc;
+            if (rpc == null)
+                return new DeviceRpc.Reply { Command = command, Status = DeviceRpc.ReplyStatus.Failed };
+
+            var reply = await rpc.CallAsync(command);
+            Log($"[Cmd] TX: {command} -> {reply.Status} ({reply.LatencyMs:F0} ms)");
+            return reply;
+        }
+
+        /// <summary>
+        /// FEAT:RPC: the command carries a request ID, so a command the device
+        /// does not know or never answers shows up in the log with its latency.
+        /// </summary>
+        private async Task SendCommandRpcAsync(DeviceRpc rpc, string command)
+        {
+            var reply = await rpc.CallAsync(command);
+            Log($"[Cmd] TX: {command} -> {reply.Status} ({reply.LatencyMs:F0} ms)");
+        }
+
+        private DeviceRpc CreateRpc(SerialPort port, DeviceCaps caps)
+        {
+            if (!caps.HasFeature(DeviceCaps.FEATURE_RPC)) return null;
+
+            var rpc = new DeviceRpc(new SerialPortLink(port), _portLock);
+            rpc.LogMessage += (s, msg) => Log("[RPC] " + msg);
+            return rpc;
+        }
+
+        /// <summary>
+        /// Returns list of available COM port names (settings UI).
+        /// </summary>
+        public static string[] GetAvailablePortNames()
+        {
+            try
+            {
+                return SerialPort.GetPortNames();
+            }
+            catch
+            {
+                return new string[0];
+            }
+        }
+
+        // ====================================================================
+        //  BACKGROUND MONITOR LOOP
+        // ====================================================================
+
+        private void MonitorLoop(CancellationToken ct)
+        {
+            try
+            {
+                // Initialize hardware collector
+                Log("[Init] Starting hardware collector...");
+                Log("[Init] Admin: " + (HardwareCollector.IsAdmin() ? "YES" : "NO"));
+
+                // Starts on the cheap Lite sources; LHM comes up in the background
+                _collector = new HardwareCollector();
+                _collector.ModeChanged += OnCollectorModeChanged;
+                _isLiteMode = _collector.IsLiteMode;
+                _collector.StartFullInit();
+                _procSampler = SendProcessList ? ProcessSampler.CreateDefault() : null;
+
+                Log("[Init] " + _collector.InitStatus);
+                SetStatus("Initialized", false);
+
+                string cliPort = _fixedPort;
+
+                while (!ct.IsCancellationRequested)
+                {
+                    // --- CONNECT ---
+                    _isConnected = false;
+                    SetStatus("Searching...", false);
+
+                    string portName = cliPort ?? FindEsp32ByHandshake(ct);
+                    if (string.IsNullOrEmpty(portName))
+                    {
+                        // Wait and retry (in chunks for fast cancel)
+                        for (int i = 0; i < 30 && !ct.IsCancellationRequested; i++)
+                            Thread.Sleep(100);
+                        continue;
+                    }
+
+                    Log("[Serial] Connecting to " + portName + "...");
+
+                    try
+                    {
+                        using (var port = new SerialPort(portName, 115200))
+                        {
+                            port.DtrEnable = true;
+                            port.ReadTimeout = 500;
+                            port.WriteTimeout = 1000;
+
+                            lock (_portLock)
+                            {
+                                if (ct.IsCancellationRequested) break;
+                                port.Open();
+                                _activePort = port;
+                            }
+
+                            using (var dispatcher = new SerialDispatcher(port))
+                            {
+                                string espHash;
+                                using (var lease = dispatcher.Acquire("CONNECT", 0))    // Nobody else has it yet
+                                {
+                                    // Verify handshake and get ESP hash (polled while an ESP32 reset settles)
+                                    espHash = WaitForHandshake(lease, ESP_RESET_TIMEOUT_MS, ct);
+                                    if (ct.IsCancellationRequested) break;
+                                    if (espHash == null)
+                                    {
+                                        Log("[Serial] Handshake FAILED on " + portName);
+                                        lock (_portLock) { _activePort = null; }
+                                        for (int i = 0; i < 20 && !ct.IsCancellationRequested; i++)
+                                            Thread.Sleep(100);
+                                        continue;
+                                    }
+
+                                    // === FIRST CONNECTION ESTABLISHED ===
+                                    Log("[Serial] Connected to " + portName);
+
+                                    // Sync hardware identity if needed
+                                    SyncIdentityIfNeeded(port, espHash);
+
+                                    // Capabilities (cached per device + firmware version)
+                                    _deviceCaps = ResolveDeviceCaps(lease, espHash);
+                                }
+                                _rpc = CreateRpc(port, _deviceCaps);
+                                dispatcher.Rpc = _rpc;
+                                _dispatcher = dispatcher;
+                                _espHash = espHash;
+                                _portName = portName;
+                                _isConnected = true;
+
+                                SetStatus("Connected: " + portName, true);
+                                ConnectionChanged?.Invoke(this, EventArgs.Empty);
+
+                                // Charts resume with the rates from before the disconnect
+                                SendHistoryBackfill(port);
+
+                                // User metrics first - alert rules may refer to them
+                                SendCustomMetrics(port);
+
+                                // User alert rules (the device skips an unchanged table)
+                                SendAlertRules(port);
+
+                                // Watchdog post-mortem of the previous run, if any
+                                ReportPostMortem();
+
+                                // Queued background firmware update continues alongside the data loop
+                                RunFirmwareStaging();
+
+                                // --- DATA LOOP ---
+                                RunDataLoop(port, ct);
+
+                                _dispatcher = null;
+                                StopFirmwareStaging();
+                                lock (_portLock) { _activePort = null; }
+                            }
+                        }
+                    }
+                    catch (OperationCanceledException)
+                    {
+                        break;
+                    }
+                    catch (Exception ex)
+                    {
+                        Program.LogCrash("MonitorLoop", ex);
+                        Log("[Error] " + ex.Message);
+                        _dispatcher = null;
+                        lock (_portLock) { _activePort = null; }
+
+                        if (!ct.IsCancellationRequested)
+                        {
+                            for (int i = 0; i < 20 && !ct.IsCancellationRequested; i++)
+                                Thread.Sleep(100);
+                        }
+                    }
+
+                    StopFirmwareStaging();
+                    var rpc = Interlocked.Exchange(ref _rpc, null);
+                    if (rpc != null)
+                    {
+                        rpc.CancelAll();
+                        Log("[RPC] " + rpc.GetMetrics());
+                    }
+                    _isConnected = false;
+                    _deviceCaps = DeviceCaps.Legacy;
+                    _espHash = "";
+                    _portName = "";
+                    SetStatus("Disconnected", false);
+                    ConnectionChanged?.Invoke(this, EventArgs.Empty);
+
+                    // If auto-detected, re-scan
+                    cliPort = _fixedPort;
+                }
+            }
+            catch (Exception ex)
+            {
+                Program.LogCrash("MonitorLoop_Outer", ex);
+                Log("[FATAL] " + ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// Replays the recent network/disk rates as one HIST: line so the
+        /// device charts do not restart from zeros (FEAT:HIST firmware only).
+        /// </summary>
+        private void SendHistoryBackfill(SerialPort port)
+        {
+            var caps = _deviceCaps;
+            if (!caps.HasFeature(DeviceCaps.FEATURE_HISTORY)) return;
+
+            string line = _history.EncodeBackfill(IntervalMs);
+            if (line == null || line.Length > caps.MaxLineBytes) return;
+
+            try
+            {
+                lock (_portLock)
+                {
+                    port.Write(line);
+                    port.BaseStream.Flush();
+                }
+                Log("[Serial] History backfill: " + line.Length + " bytes");
+            }
+            catch (Exception ex)
+            {
+                Log("[Serial] History backfill failed: " + ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// Uploads metrics.txt, compiled, as one METRICS: line (FEAT:EXPR
+        /// firmware only). Without the file the device keeps its table.
+        /// </summary>
+        private void SendCustomMetrics(SerialPort port)
+        {
+            var caps = _deviceCaps;
+            if (!caps.HasFeature(DeviceCaps.FEATURE_EXPR)) return;
+
+            string line = CustomMetrics.LoadCommand(out string error);
+            if (error != null)
+            {
+                Log("[Metrics] metrics.txt not sent - " + error);
+                return;
+            }
+            if (line == null) return;
+            if (line.Length > caps.MaxLineBytes)
+            {
+                Log("[Metrics] metrics.txt not sent - table longer than " + caps.MaxLineBytes + " bytes");
+                return;
+            }
+
+            try
+            {
+                lock (_portLock)
+                {
+                    port.Write(line);
+                    port.BaseStream.Flush();
+                }
+                Log("[Metrics] Metric table sent");
+            }
+            catch (Exception ex)
+            {
+                Log("[Metrics] Metric table upload failed: " + ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// Uploads alert_rules.txt as one ALERT_RULES: line (FEAT:ALRT
+        /// firmware only). Without the file the device keeps its table.
+        /// </summary>
+        private void SendAlertRules(SerialPort port)
+        {
+            var caps = _deviceCaps;
+            if (!caps.HasFeature(DeviceCaps.FEATURE_ALERTS)) return;
+
+            string line = AlertRules.LoadCommand(out string error);
+            if (error != null)
+            {
+                Log("[Alerts] alert_rules.txt not sent - " + error);
+                return;
+            }
+            if (line == null) return;
+            if (line.Length > caps.MaxLineBytes)
+            {
+                Log("[Alerts] alert_rules.txt not sent - table longer than " + caps.MaxLineBytes + " bytes");
+                return;
+            }
+
+            try
+            {
+                lock (_portLock)
+                {
+                    port.Write(line);
+                    port.BaseStream.Flush();
+                }
+                Log("[Alerts] Rule table sent");
+            }
+            catch (Exception ex)
+            {
+                Log("[Alerts] Rule table upload failed: " + ex.Message);
+            }
+        }
+
+        // ====================================================================
+        //  BACKGROUND FIRMWARE UPDATE (FW_STAGE)
+        // ====================================================================
+
+        /// <summary>
+        /// Starts trickling the queued firmware image to the connected device
+        /// (no-op without a job for this device or while a session runs).
+        /// Chunks wait while an exclusive upload or manual pause owns the port.
+        /// </summary>
+        private void RunFirmwareStaging()
+        {
+            var dispatcher = _dispatcher;
+            if (dispatcher == null || !_fwStager.HasJob || IsUploadMode) return;     // Restarted when the port is given back
+            if (_stagingTask != null && !_stagingTask.IsCompleted) return;
+
+            var cts = CancellationTokenSource.CreateLinkedTokenSource(_cts.Token);
+            _stagingCts = cts;
+            DeviceCaps caps = _deviceCaps;
+            string hash = _espHash;
+            _stagingTask = Task.Run(() => _fwStager.RunAsync(dispatcher, _portLock, caps, hash,
+                () => IsUploadMode || _isPaused, cts.Token));
+        }
+
+        /// <summary>
+        /// Stops the current staging session. The job and the device-side
+        /// progress are kept - the next connection resumes.
+        /// </summary>
+        private void StopFirmwareStaging()
+        {
+            var cts = Interlocked.Exchange(ref _stagingCts, null);
+            if (cts == null) return;
+
+            try { cts.Cancel(); } catch { }
+            try { _stagingTask?.Wait(1000); } catch { }
+            cts.Dispose();
+        }
+
+        /// <summary>
+        /// Settings UI: queue an image for background staging. Returns an error or null.
+        /// </summary>
+        public string StartFirmwareStaging(string binPath)
+        {
+            if (!_isConnected) return "Not connected to any device!";
+
+            StopFirmwareStaging();
+            string error = _fwStager.Start(binPath, _espHash);
+            if (error == null) RunFirmwareStaging();
+            return error;
+        }
+
+        /// <summary>
+        /// Settings UI: drop the background update. FW_ABORT makes the device
+        /// discard its partial/staged image and keep booting the running one.
+        /// </summary>
+        public void CancelFirmwareStaging()
+        {
+            StopFirmwareStaging();
+            _fwStager.Cancel();
+            if (_isConnected) SendCommand("FW_ABORT");
+        }
+
+        /// <summary>
+        /// Process start to the first stats line on the wire (includes CLR
+        /// startup, collector init and port discovery).
+        /// </summary>
+        private void LogTimeToFirstPacket()
+        {
+            try
+            {
+                var ms = (DateTime.Now - Process.GetCurrentProcess().StartTime).TotalMilliseconds;
+                Log($"[Perf] Time to first packet: {ms:F0} ms ({(_isLiteMode ? "Lite" : "Full")} values)");
+            }
+            catch { }
+        }
+
+        /// <summary>
+        /// Background sensor init finished: Full Mode (or Lite for good).
+        /// </summary>
+        private void OnCollectorModeChanged(object sender, EventArgs e)
+        {
+            _isLiteMode = _collector.IsLiteMode;
+            Log("[Init] " + _collector.InitStatus);
+
+            bool connected = _isConnected;
+            SetStatus(connected ? "Connected: " + _portName : "Searching...", connected);
+        }
+
+        private void RunDataLoop(SerialPort port, CancellationToken ct)
+        {
+            // Target interval between packets. We measure how long GetStats()
+            // + Write take and subtract that, so the ESP receives data at a
+            // steady ~1s cadence instead of 1s PLUS the (variable, up to ~800ms
+            // in Full Mode) collection time - which otherwise let the gap creep
+            // past the stale threshold and flash the red "disconnected" dot.
+            int targetIntervalMs = IntervalMs;
+            var iterTimer = new System.Diagnostics.Stopwatch();
+
+            // Fresh connection: the device has no process list yet
+            _procSampler?.ForceNextSend();
+
+            // Stats line is encoded straight into this buffer (no per-cycle string)
+            var txBuf = new byte[StatsFrame.MAX_LENGTH];
+
+            while (!ct.IsCancellationRequested && port.IsOpen)
+            {
+                try
+                {
+                    // Pause data transmission during image upload OR manual pause
+                    if (IsUploadMode || _isPaused)
+                    {
+                        Thread.Sleep(200);
+                        continue;
+                    }
+
+                    iterTimer.Restart();
+
+                    var s = _collector.GetStats();
+                    _history.Add(s);
+
+                    // Encode stats line (codec generated from the protocol schema,
+                    // same source as the ESP32 parser)
+                    int txLen = s.EncodeTelemetry(txBuf);
+
+                    // All port writes go through _portLock: the data loop, user
+                    // commands (SendCommand) and image/firmware uploads run
+                    // on different threads - unsynchronized writes interleave
+                    // bytes and corrupt protocol lines on the ESP.
+                    lock (_portLock)
+                    {
+                        port.Write(txBuf, 0, txLen);
+                        port.BaseStream.Flush();
+                    }
+
+                    if (!_firstPacketSent)
+                    {
+                        _firstPacketSent = true;
+                        LogTimeToFirstPacket();
+                    }
+
+                    // Background sensor init resolved different hardware names
+                    if (_collector.TakeIdentityChange())
+                    {
+                        lock (_portLock) { SyncIdentityIfNeeded(port, _espHash); }
+                    }
+
+                    // Top-N process list - only sent when the ranking changed
+                    string top = _procSampler?.Sample();
+                    if (top != null)
+                    {
+                        lock (_portLock)
+                        {
+                            port.Write(top);
+                            port.BaseStream.Flush();
+                        }
+                    }
+
+                    // Status form (the headless host does not listen - no string built)
+                    var dataSent = DataSent;
+                    if (dataSent != null)
+                        dataSent(this, "TX: " + System.Text.Encoding.ASCII.GetString(txBuf, 0, txLen - 1));
+
+                    // Sleep the remainder of the target interval (min 100ms),
+                    // in 100ms chunks for fast cancellation
+                    int remaining = targetIntervalMs - (int)iterTimer.ElapsedMilliseconds;
+                    if (remaining < 100) remaining = 100;
+                    int chunks = (remaining + 99) / 100;
+                    for (int i = 0; i < chunks && !ct.IsCancellationRequested; i++)
+                        Thread.Sleep(100);
+                }
+                catch (OperationCanceledException)
+                {
+                    break;
+                }
+                catch (Exception ex)
+                {
+                    Program.LogCrash("DataLoop", ex);
+                    Log("[TX Error] " + ex.Message);
+                    break;
+                }
+            }
+        }
+
+        // ====================================================================
+        //  HANDSHAKE & PORT DISCOVERY
+        // ====================================================================
+
+        /// <summary>
+        /// Verifies handshake and returns ESP's identity hash (or null on failure).
+        /// Response format: SCARAB_CLIENT_OK|H:XXXXXXXX|V:x.y.z|N:device-name
+        /// (|V: and |N: added in FW 2.4 - absent on older firmware)
+        /// </summary>
+        private string VerifyHandshakeAndGetHash(PortLease lease)
+        {
+            const int REPLY_TIMEOUT_MS = 200;
+
+            try
+            {
+                lease.DiscardInBuffer();
+                lock (_portLock) { lease.Write(HANDSHAKE_QUERY); }
+
+                // ESP log lines may come first
+                var clock = Stopwatch.StartNew();
+                string line;
+                while ((line = lease.ReadLine(REPLY_TIMEOUT_MS - (int)clock.ElapsedMilliseconds)) != null)
+                {
+                    var info = HandshakeInfo.Parse(line);
+                    if (info != null)
+                    {
+                        // Optional fields (FW >= 2.4)
+                        _espFwVersion = info.FwVersion;
+                        _espDeviceName = info.DeviceName;
+                        _espBuildId = info.BuildId;
+                        return info.Hash;
+                    }
+                }
+            }
+            catch { }
+            return null; // Handshake failed
+        }
+
+        /// <summary>
+        /// Returns the device's GET_CAPS descriptor. Uses the cached copy for
+        /// this identity hash if the firmware build still matches, otherwise
+        /// queries the device. Only real CAPS: replies are cached, and only
+        /// for firmware that reports a build ID (|B:) - PROJECT_VER stays the
+        /// same across builds that add FEAT tokens. Silence (old firmware or
+        /// a slow boot) gives DeviceCaps.Legacy for this connection only.
+        /// </summary>
+        private DeviceCaps ResolveDeviceCaps(PortLease lease, string espHash)
+        {
+            string buildId = _espBuildId;
+            var caps = DeviceCaps.LoadCached(espHash, buildId);
+            if (caps != null)
+            {
+                Log("[Caps] Cached: " + caps);
+                return caps;
+            }
+
+            caps = QueryDeviceCaps(lease);
+            if (caps == null)
+            {
+                // Port error (not just silence) - don't cache, retry next connect
+                Log("[Caps] Query failed - using legacy limits");
+                return DeviceCaps.Legacy;
+            }
+
+            if (!caps.IsLegacy) DeviceCaps.SaveCached(espHash, buildId, caps);
+            Log("[Caps] " + caps);
+            return caps;
+        }
+
+        /// <summary>
+        /// Sends GET_CAPS and waits up to CAPS_TIMEOUT_MS for the CAPS: line,
+        /// skipping ESP log lines. Returns Legacy on timeout, null on port error.
+        /// </summary>
+        private DeviceCaps QueryDeviceCaps(PortLease lease)
+        {
+            const int CAPS_TIMEOUT_MS = 300;
+
+            try
+            {
+                lock (_portLock) { lease.Write(DeviceCaps.QUERY); }
+
+                var clock = Stopwatch.StartNew();
+                string line;
+                while ((line = lease.ReadLine(CAPS_TIMEOUT_MS - (int)clock.ElapsedMilliseconds)) != null)
+                {
+                    var caps = DeviceCaps.Parse(line);
+                    if (caps != null) return caps;
+                }
+                return lease.IsOpen ? DeviceCaps.Legacy : null;
+            }
+            catch
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Repeats the handshake until the device answers or timeoutMs has
+        /// passed. Replaces a fixed wait after opening the port: a device that
+        /// did not reset answers on the first try, one that is still booting
+        /// as soon as it is up.
+        /// </summary>
+        private string WaitForHandshake(PortLease lease, int timeoutMs, CancellationToken ct)
+        {
+            var sw = Stopwatch.StartNew();
+            while (!ct.IsCancellationRequested)
+            {
+                string hash = VerifyHandshakeAndGetHash(lease);
+                if (hash != null || sw.ElapsedMilliseconds >= timeoutMs) return hash;
+                Thread.Sleep(100);
+            }
+            return null;
+        }
+
+        /// <summary>
+        /// Syncs hardware identity if ESP hash differs from local.
+        /// Sends NAME_CPU, NAME_GPU, NAME_HASH commands.
+        /// </summary>
+        private void SyncIdentityIfNeeded(SerialPort port, string espHash)
+        {
+            if (_collector == null) return;
+
+            string localHash = _collector.IdentityHash;
+
+            if (espHash == localHash)
+            {
+                Log("[Sync] Hash match: " + localHash);
+                return;
+            }
+
+            Log("[Sync] Hash mismatch! ESP=" + espHash + " Local=" + localHash);
+            Log("[Sync] Sending hardware names...");
+
+            var rpc = _rpc;
+            if (rpc != null)
+            {
+                _ = SyncIdentityRpcAsync(rpc, localHash);
+                return;
+            }
+
+            try
+            {
+                // Send CPU name
+                string cmdCpu = NAME_CMD_CPU + _collector.CpuName + "\n";
+                port.Write(cmdCpu);
+                port.BaseStream.Flush();
+                Thread.Sleep(50);
+
+                // Send GPU name
+                string cmdGpu = NAME_CMD_GPU + _collector.GpuName + "\n";
+                port.Write(cmdGpu);
+                port.BaseStream.Flush();
+                Thread.Sleep(50);
+
+                // Send new hash (ESP will store it)
+                string cmdHash = NAME_CMD_HASH + localHash + "\n";
+                port.Write(cmdHash);
+                port.BaseStream.Flush();
+                Thread.Sleep(50);
+
+                Log("[Sync] Names sent: CPU=" + _collector.CpuName + ", GPU=" + _collector.GpuName);
+            }
+            catch (Exception ex)
+            {
+                Log("[Sync] Error: " + ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// FEAT:RPC: the three NAME_ commands go out back to back, in order,
+        /// and each is confirmed - no fixed gaps between them.
+        /// </summary>
+        private async Task SyncIdentityRpcAsync(DeviceRpc rpc, string localHash)
+        {
+            var replies = await Task.WhenAll(
+                rpc.CallAsync(NAME_CMD_CPU + _collector.CpuName),
+                rpc.CallAsync(NAME_CMD_GPU + _collector.GpuName),
+                rpc.CallAsync(NAME_CMD_HASH + localHash));
+
+            var failed = replies.Where(r => !r.Ok).ToList();
+            if (failed.Count == 0)
+                Log($"[Sync] Names sent: CPU={_collector.CpuName}, GPU={_collector.GpuName} ({replies.Max(r => r.LatencyMs):F0} ms)");
+            else
+                Log("[Sync] Not confirmed: " + string.Join(", ", failed.Select(r => r.Command + " -> " + r.Status)));
+        }
+
+        /// <summary>
+        /// GET_POSTMORTEM (DIAG, needs FEAT:RPC): when the device's previous
+        /// run ended in a watchdog reset, its counter report goes to the log.
+        /// </summary>
+        private void ReportPostMortem()
+        {
+            var rpc = _rpc;
+            if (rpc == null || !_deviceCaps.HasDiagnostic(ProtocolCommands.GET_POSTMORTEM)) return;
+
+            _ = ReportPostMortemRpcAsync(rpc);
+        }
+
+        private async Task ReportPostMortemRpcAsync(DeviceRpc rpc)
+        {
+            var reply = await rpc.CallAsync(ProtocolCommands.GET_POSTMORTEM);
+            if (!reply.Ok) return;
+
+            var lines = reply.Lines
+                .Where(l => l.StartsWith(ProtocolCommands.POSTMORTEM, StringComparison.Ordinal))
+                .Select(l => l.Substring(ProtocolCommands.POSTMORTEM.Length))
+                .ToList();
+
+            // PM:BOOT|N:<boots>|...  and  PM:WDT|BOOT:<boot that hung>|...
+            long boots = PostMortemField(lines.FirstOrDefault(l => l.StartsWith("BOOT|", StringComparison.Ordinal)), "N");
+            long hungBoot = PostMortemField(lines.FirstOrDefault(l => l.StartsWith("WDT|", StringComparison.Ordinal)), "BOOT");
+
+            if (boots <= 0 || hungBoot != boots - 1)
+            {
+                Log("[PM] No watchdog reset before this boot (" + boots + " boots)");
+                return;
+            }
+
+            Log("[PM] Previous run ended in a watchdog reset:");
+            foreach (string line in lines)
+                Log("[PM]   " + line);
+        }
+
+        private static long PostMortemField(string line, string key)
+        {
+            if (line == null) return -1;
+
+            foreach (string part in line.Split('|'))
+            {
+                if (part.StartsWith(key + ":", StringComparison.Ordinal)
+                    && long.TryParse(part.Substring(key.Length + 1), NumberStyles.None, CultureInfo.InvariantCulture, out long value))
+                {
+                    return value;
+                }
+            }
+            return -1;
+        }
+
+        private string FindEsp32ByHandshake(CancellationToken ct)
+        {
+            var ports = GetFilteredPorts();
+            if (ports.Count == 0) return null;
+
+            Log("[Serial] Scanning " + ports.Count + " ports...");
+
+            foreach (var portInfo in ports)
+            {
+                if (ct.IsCancellationRequested) return null;
+
+                Log("  " + portInfo.Name + ": Trying..." + (portInfo.IsDeprioritized ? " (low priority)" : ""));
+
+                try
+                {
+                    using (var port = new SerialPort(portInfo.Name, 115200))
+                    {
+                        port.DtrEnable = true;
+                        port.ReadTimeout = 200;
+                        port.WriteTimeout = 500;
+                        port.Open();
+
+                        bool found;
+                        using (var dispatcher = new SerialDispatcher(port))
+                        using (var lease = dispatcher.Acquire("SCAN", 0))
+                        {
+                            found = WaitForHandshake(lease, SCAN_TIMEOUT_MS, ct) != null;
+                            port.Close();       // Ends the dispatcher's read at once
+                        }
+
+                        if (found)
+                        {
+                            Log("  " + portInfo.Name + ": FOUND!");
+                            return portInfo.Name;
+                        }
+                    }
+                }
+                catch (UnauthorizedAccessException)
+                {
+                    Log("  " + portInfo.Name + ": In use");
+                }
+                catch { }
+            }
+
+            return null;
+        }
+
+        private class PortInfo
+        {
+            public string Name;
+            public string Caption;
+            public bool IsDeprioritized;
+            public bool IsPreferred;
+        }
+
+        private List<PortInfo> GetFilteredPorts()
+        {
+            var result = new List<PortInfo>();
+
+            try
+            {
+                var systemPorts = SerialPort.GetPortNames().ToHashSet(StringComparer.OrdinalIgnoreCase);
+                if (systemPorts.Count == 0) return result;
+
+                // WMI for port details
+                using (var searcher = new ManagementObjectSearcher("SELECT * FROM Win32_PnPEntity WHERE Caption LIKE '%(COM%'"))
+                {
+                    foreach (ManagementObject obj in searcher.Get())
+                    {
+                        try
+                        {
+                            string caption = obj["Caption"]?.ToString() ?? "";
+                            int start = caption.LastIndexOf("(COM");
+                            int end = caption.LastIndexOf(")");
+
+                            if (start >= 0 && end > start)
+                            {
+                                string portName = caption.Substring(start + 1, end - start - 1);
+                                if (systemPorts.Contains(portName))
+                                {
+                                    result.Add(new PortInfo
+                                    {
+                                        Name = portName,
+                                        Caption = caption,
+                                        IsDeprioritized = DEPRIORITIZE_PORT_KEYWORDS.Any(k => caption.IndexOf(k, StringComparison.OrdinalIgnoreCase) >= 0),
+                                        IsPreferred = PREFER_PORT_KEYWORDS.Any(k => caption.IndexOf(k, StringComparison.OrdinalIgnoreCase) >= 0)
+                                    });
+                                    systemPorts.Remove(portName);
+                                }
+                            }
+                        }
+                        catch { }
+                    }
+                }
+
+                // Add remaining (unknown) ports
+                foreach (var port in systemPorts)
+                {
+                    result.Add(new PortInfo { Name = port, Caption = port, IsDeprioritized = false, IsPreferred = false });
+                }
+            }
+            catch
+            {
+                // Fallback
+                foreach (var port in SerialPort.GetPortNames())
+                {
+                    result.Add(new PortInfo { Name = port, Caption = port, IsDeprioritized = false, IsPreferred = false });
+                }
+            }
+
+            // Sort: preferred first, deprioritized (debugger) ports last
+            return result
+                .OrderBy(p => p.IsDeprioritized ? 1 : 0)
+                .ThenByDescending(p => p.IsPreferred)
+                .ThenByDescending(p => p.Name)
+                .ToList();
+        }
+
+        // ====================================================================
+        //  EVENTS
+        // ====================================================================
+
+        private void Log(string line)
+        {
+            LogMessage?.Invoke(this, line);
+        }
+
+        private void SetStatus(string status, bool connected)
+        {
+            StatusChanged?.Invoke(this, new MonitorStatusEventArgs
+            {
+                Status = status,
+                IsConnected = connected,
+                IsLiteMode = _isLiteMode
+            });
+        }
+
+        /// <summary>
+        /// Working set, private bytes and CPU share since the last sample -
+        /// the same line in tray and headless mode, for side-by-side runs.
+        /// </summary>
+        private void LogFootprint()
+        {
+            try
+            {
+                using (var p = Process.GetCurrentProcess())
+                {
+                    var now = DateTime.UtcNow;
+                    var cpu = p.TotalProcessorTime;
+                    double wallMs = (now - _lastFootprintAt).TotalMilliseconds * Environment.ProcessorCount;
+                    double cpuPct = wallMs > 0 ? 100.0 * (cpu - _lastCpuTime).TotalMilliseconds / wallMs : 0;
+                    _lastCpuTime = cpu;
+                    _lastFootprintAt = now;
+
+                    Log($"[Perf] Footprint: working set {p.WorkingSet64 / (1024.0 * 1024.0):F1} MB, " +
+                        $"private {p.PrivateMemorySize64 / (1024.0 * 1024.0):F1} MB, CPU {cpuPct:F2}%");
+                }
+            }
+            catch { }
+        }
+    }
+}
@@ -0,0 +1,251 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Net.NetworkInformation;
+using System.Net.Sockets;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Throughput and link info of one interface (or the aggregate).
+    /// Rates in MB/s (1024*1024), matching SystemStats.NetDown/NetUp.
+    /// </summary>
+    public sealed class NetworkSnapshot
+    {
+        public string Name { get; internal set; } = "";
+        public string LinkType { get; internal set; } = "LAN";     // LAN / WLAN / VPN
+        public string LinkSpeed { get; internal set; } = "";       // "1000 Mbps", "2.5 Gbps", ...
+        public long SpeedBitsPerSec { get; internal set; }
+        public float DownMBps { get; internal set; }
+        public float UpMBps { get; internal set; }
+    }
+
+    /// <summary>
+    /// Multi-adapter network sampler.
+    ///
+    /// Replaces the two "Network Interface" PerformanceCounters bound to one
+    /// adapter chosen at startup. Every active interface is tracked through
+    /// its cumulative byte counters (GetIPStatistics = GetIfEntry2 on
+    /// Windows, /proc/net/dev on Linux) and rates are computed from deltas.
+    ///
+    /// The interface list, link type and speed are only re-read when the OS
+    /// raises a NetworkChange event (cable plugged, WLAN joined, VPN up) -
+    /// not every cycle.
+    ///
+    /// Aggregate = sum of all physical interfaces. Tunnels/PPP (VPN) are
+    /// excluded from the sum because their traffic is also counted on the
+    /// physical adapter underneath. Primary = the interface carrying the
+    /// default route (Ethernet preferred over WLAN), VPN if one is up.
+    /// </summary>
+    public sealed class NetworkSampler : IDisposable
+    {
+        private sealed class IfState
+        {
+            public NetworkInterface Nic;
+            public NetworkSnapshot Snap = new NetworkSnapshot();
+            public long LastRx;
+            public long LastTx;
+            public bool IsTunnel;
+        }
+
+        private readonly List<IfState> _ifs = new List<IfState>();
+        private readonly Stopwatch _wall = Stopwatch.StartNew();
+        private readonly Stopwatch _cost = new Stopwatch();
+        private volatile bool _topologyDirty = true;
+        private long _lastWallTicks;
+        private IfState _primary;
+        private long _samples;
+
+        public NetworkSnapshot Aggregate { get; } = new NetworkSnapshot { Name = "All" };
+
+        /// <summary>Primary interface (never null; empty snapshot if offline).</summary>
+        public NetworkSnapshot Primary => _primary?.Snap ?? _offline;
+        private readonly NetworkSnapshot _offline = new NetworkSnapshot { Name = "None", LinkSpeed = "Offline" };
+
+        /// <summary>All tracked interfaces from the last sample.</summary>
+        public IEnumerable<NetworkSnapshot> Interfaces => _ifs.Select(i => i.Snap);
+
+        /// <summary>Mean wall-clock cost of one Sample() call in microseconds.</summary>
+        public double AvgSampleMicros => _samples > 0 ? _cost.Elapsed.TotalMilliseconds * 1000.0 / _samples : 0;
+
+        /// <summary>Raised (on the sampling thread) after the interface set was re-read.</summary>
+        public event EventHandler TopologyChanged;
+
+        public NetworkSampler()
+        {
+            NetworkChange.NetworkAddressChanged += OnNetworkChanged;
+            NetworkChange.NetworkAvailabilityChanged += OnNetworkChanged;
+        }
+
+        private void OnNetworkChanged(object sender, EventArgs e)
+        {
+            // Runs on a thread-pool thread - only flag, refresh on next Sample()
+            _topologyDirty = true;
+        }
+
+        /// <summary>
+        /// Reads all interface counters and updates Aggregate/Primary.
+        /// The first call (and the first after a topology change) primes
+        /// counters and reports 0 for new interfaces.
+        /// </summary>
+        public void Sample()
+        {
+            _cost.Start();
+            try
+            {
+                if (_topologyDirty)
+                {
+                    _topologyDirty = false;
+                    RefreshTopology();
+                    TopologyChanged?.Invoke(this, EventArgs.Empty);
+                }
+
+                long now = _wall.Elapsed.Ticks;
+                double seconds = _lastWallTicks > 0 ? (now - _lastWallTicks) / (double)TimeSpan.TicksPerSecond : 0;
+                _lastWallTicks = now;
+
+                float sumDown = 0, sumUp = 0;
+                foreach (var st in _ifs)
+                {
+                    long rx, tx;
+                    try
+                    {
+                        var stats = st.Nic.GetIPStatistics();
+                        rx = stats.BytesReceived;
+                        tx = stats.BytesSent;
+                    }
+                    catch
+                    {
+                        // Adapter vanished between events - keep last rates at 0
+                        st.Snap.DownMBps = st.Snap.UpMBps = 0;
+                        continue;
+                    }
+
+                    if (seconds > 0 && st.LastRx > 0)
+                    {
+                        // Negative delta = counter reset (adapter re-init) -> treat as 0
+                        st.Snap.DownMBps = (float)(Math.Max(0, rx - st.LastRx) / seconds / (1024.0 * 1024.0));
+                        st.Snap.UpMBps = (float)(Math.Max(0, tx - st.LastTx) / seconds / (1024.0 * 1024.0));
+                    }
+                    st.LastRx = rx;
+                    st.LastTx = tx;
+
+                    if (!st.IsTunnel)
+                    {
+                        sumDown += st.Snap.DownMBps;
+                        sumUp += st.Snap.UpMBps;
+                    }
+                }
+
+                Aggregate.DownMBps = sumDown;
+                Aggregate.UpMBps = sumUp;
+            }
+            finally
+            {
+                _cost.Stop();
+                _samples++;
+            }
+        }
+
+        /// <summary>
+        /// Re-enumerates interfaces. Keeps counter baselines for interfaces
+        /// that survive the change so their rate does not drop to 0.
+        /// </summary>
+        private void RefreshTopology()
+        {
+            var old = _ifs.ToDictionary(i => i.Nic.Id);
+            _ifs.Clear();
+            _primary = null;
+
+            NetworkInterface[] nics;
+            try { nics = NetworkInterface.GetAllNetworkInterfaces(); }
+            catch (Exception ex)
+            {
+                Console.WriteLine("  [Network]  Enumerate FAIL - " + ex.Message);
+                return;
+            }
+
+            IfState bestGateway = null;
+            IfState tunnel = null;
+            IfState fallback = null;
+
+            foreach (var nic in nics)
+            {
+                if (nic.OperationalStatus != OperationalStatus.Up) continue;
+                if (nic.NetworkInterfaceType == NetworkInterfaceType.Loopback) continue;
+
+                IPInterfaceProperties props;
+                try { props = nic.GetIPProperties(); }
+                catch { continue; }
+
+                bool hasIp = props.UnicastAddresses.Any(a =>
+                    a.Address.AddressFamily == AddressFamily.InterNetwork ||
+                    (a.Address.AddressFamily == AddressFamily.InterNetworkV6 && !a.Address.IsIPv6LinkLocal));
+                if (!hasIp) continue;
+
+                var st = old.TryGetValue(nic.Id, out var prev) ? prev : new IfState();
+                st.Nic = nic;
+                st.IsTunnel = IsTunnel(nic);
+                st.Snap.Name = nic.Name;
+                st.Snap.LinkType = st.IsTunnel ? "VPN"
+                    : nic.NetworkInterfaceType == NetworkInterfaceType.Wireless80211 ? "WLAN" : "LAN";
+                st.Snap.SpeedBitsPerSec = SafeSpeed(nic);
+                st.Snap.LinkSpeed = FormatSpeed(st.Snap.SpeedBitsPerSec);
+                _ifs.Add(st);
+
+                bool hasGateway = props.GatewayAddresses.Any(g =>
+                    !g.Address.Equals(System.Net.IPAddress.Any) && !g.Address.Equals(System.Net.IPAddress.IPv6Any));
+
+                if (st.IsTunnel) { if (tunnel == null) tunnel = st; continue; }
+                if (hasGateway && (bestGateway == null || Rank(st) < Rank(bestGateway))) bestGateway = st;
+                if (fallback == null || Rank(st) < Rank(fallback)) fallback = st;
+            }
+
+            // A VPN that is up carries the default route in practice
+            _primary = tunnel ?? bestGateway ?? fallback;
+
+            Console.WriteLine("  [Network]  " + _ifs.Count + " active interface(s), primary: "
+                + (_primary != null ? _primary.Nic.Description + " (" + _primary.Snap.LinkType + ", " + _primary.Snap.LinkSpeed + ")" : "none"));
+        }
+
+        private static int Rank(IfState st)
+        {
+            return st.Nic.NetworkInterfaceType == NetworkInterfaceType.Ethernet ? 0
+                 : st.Nic.NetworkInterfaceType == NetworkInterfaceType.Wireless80211 ? 1 : 2;
+        }
+
+        private static bool IsTunnel(NetworkInterface nic)
+        {
+            var t = nic.NetworkInterfaceType;
+            return t == NetworkInterfaceType.Tunnel || t == NetworkInterfaceType.Ppp;
+        }
+
+        private static long SafeSpeed(NetworkInterface nic)
+        {
+            try { return Math.Max(0, nic.Speed); }
+            catch { return 0; }     // Not supported on some virtual adapters
+        }
+
+        /// <summary>
+        /// "100 Mbps", "1000 Mbps", "2.5 Gbps", "10 Gbps". The 1000 Mbps
+        /// spelling is kept for gigabit because that is what the device has
+        /// always shown. Fits the device's 16-byte net_speed field.
+        /// </summary>
+        internal static string FormatSpeed(long bitsPerSec)
+        {
+            // Virtual adapters report 0 or garbage (e.g. UINT_MAX kbit/s)
+            if (bitsPerSec <= 0 || bitsPerSec > 400_000_000_000L) return "? Mbps";
+            long mbps = bitsPerSec / 1000000;
+            if (mbps <= 1000) return mbps + " Mbps";
+            double gbps = bitsPerSec / 1e9;
+            return gbps.ToString(gbps % 1 == 0 ? "0" : "0.#", System.Globalization.CultureInfo.InvariantCulture) + " Gbps";
+        }
+
+        public void Dispose()
+        {
+            NetworkChange.NetworkAddressChanged -= OnNetworkChanged;
+            NetworkChange.NetworkAvailabilityChanged -= OnNetworkChanged;
+        }
+    }
+}
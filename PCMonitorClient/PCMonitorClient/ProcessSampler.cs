@@ -0,0 +1,393 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// One raw per-process counter reading. CPU time is cumulative
+    /// (user + kernel) in 100ns units, memory is the resident set.
+    /// </summary>
+    public struct ProcessCounterSample
+    {
+        public int Pid;
+        public long StartTime;  // Creation time (backend units) - tells a reused PID apart
+        public string Name;     // May be null if the backend reuses a cached name
+        public long CpuTime100ns;
+        public long MemBytes;
+    }
+
+    /// <summary>
+    /// Backend that reads raw cumulative counters for all processes.
+    /// Implementations must be cheap: no per-process objects, no handles.
+    /// </summary>
+    public interface IProcessCounterSource
+    {
+        /// <summary>
+        /// Fills <paramref name="into"/> (cleared by the caller) with one
+        /// sample per live process. <paramref name="knownName"/>(pid, start
+        /// time) lets the backend skip name decoding for processes the sampler
+        /// already knows - a reused PID has a different start time.
+        /// </summary>
+        void Read(List<ProcessCounterSample> into, Func<int, long, bool> knownName);
+    }
+
+    /// <summary>
+    /// Top-N process sampler for the device's process-list view.
+    ///
+    /// Incremental: each cycle the backend returns raw cumulative counters,
+    /// the sampler diffs them against a per-PID cache from the previous
+    /// cycle. No System.Diagnostics.Process objects are created (those open
+    /// a handle per process and re-query everything on each property access).
+    ///
+    /// Output line (sent only when the ranking changes, plus a slow value
+    /// refresh so percentages on the device do not go stale):
+    ///   TOP:name|cpu|memMB;name|cpu|memMB;...\n
+    /// cpu = share of ALL cores (0-100, one decimal), memMB = resident MB.
+    /// </summary>
+    public sealed class ProcessSampler
+    {
+        public const int TOP_COUNT = 5;
+        private const int NAME_MAX = 15;                // Device field is char[16]
+        private const int VALUE_REFRESH_MS = 10000;     // Resend unchanged ranking after this
+
+        private sealed class PidState
+        {
+            public string Name;
+            public long StartTime;
+            public long LastCpu;
+            public int SeenCycle;
+        }
+
+        private struct Ranked
+        {
+            public string Name;
+            public float Cpu;
+            public long MemBytes;
+        }
+
+        private readonly IProcessCounterSource _source;
+        private readonly Dictionary<int, PidState> _pids = new Dictionary<int, PidState>();
+        private readonly List<ProcessCounterSample> _samples = new List<ProcessCounterSample>(512);
+        private readonly List<Ranked> _ranked = new List<Ranked>(512);
+        private readonly System.Diagnostics.Stopwatch _wall = System.Diagnostics.Stopwatch.StartNew();
+        private readonly int _cpuCount = Math.Max(1, Environment.ProcessorCount);
+
+        private long _lastWallTicks;
+        private int _cycle;
+        private string _lastRanking = "";
+        private long _lastSendMs = long.MinValue / 2;
+        private bool _failed;
+
+        public ProcessSampler(IProcessCounterSource source)
+        {
+            _source = source ?? throw new ArgumentNullException(nameof(source));
+        }
+
+        /// <summary>
+        /// Picks the backend for the current OS: /proc on Linux, a single
+        /// NtQuerySystemInformation snapshot on Windows.
+        /// </summary>
+        public static ProcessSampler CreateDefault()
+        {
+            if (Environment.OSVersion.Platform == PlatformID.Unix && Directory.Exists("/proc"))
+                return new ProcessSampler(new ProcFsProcessSource("/proc"));
+            return new ProcessSampler(new NtProcessSource());
+        }
+
+        /// <summary>
+        /// Forces the next Sample() to emit a line (e.g. after reconnect,
+        /// the device has no list yet).
+        /// </summary>
+        public void ForceNextSend()
+        {
+            _lastRanking = "";
+        }
+
+        /// <summary>
+        /// Takes one snapshot. Returns the TOP: line to send, or null if the
+        /// ranking is unchanged (or this is the priming cycle).
+        /// </summary>
+        public string Sample()
+        {
+            if (_failed) return null;
+
+            List<Ranked> top;
+            try
+            {
+                top = TakeSnapshot();
+            }
+            catch (Exception ex)
+            {
+                // Backend unavailable (e.g. restricted /proc) - disable, don't spam
+                _failed = true;
+                Console.WriteLine("  [Proc]     Sampler disabled - " + ex.Message);
+                return null;
+            }
+            if (top == null) return null;
+
+            var ranking = new StringBuilder();
+            for (int i = 0; i < top.Count; i++) ranking.Append(top[i].Name).Append(';');
+            string rankingKey = ranking.ToString();
+
+            long nowMs = _wall.ElapsedMilliseconds;
+            if (rankingKey == _lastRanking && nowMs - _lastSendMs < VALUE_REFRESH_MS)
+                return null;
+
+            _lastRanking = rankingKey;
+            _lastSendMs = nowMs;
+            return FormatLine(top);
+        }
+
+        /// <summary>
+        /// Diffs the current counters against the cache and returns the top
+        /// entries, or null on the first call (no previous counters yet).
+        /// </summary>
+        private List<Ranked> TakeSnapshot()
+        {
+            _samples.Clear();
+            _source.Read(_samples, (pid, start) => _pids.TryGetValue(pid, out var known) && known.StartTime == start);
+
+            long wallTicks = _wall.Elapsed.Ticks;   // TimeSpan ticks = 100ns
+            long wallDelta = wallTicks - _lastWallTicks;
+            bool primed = _lastWallTicks != 0 && wallDelta > 0;
+            _lastWallTicks = wallTicks;
+            _cycle++;
+
+            _ranked.Clear();
+            double scale = primed ? 100.0 / ((double)wallDelta * _cpuCount) : 0.0;
+
+            foreach (var s in _samples)
+            {
+                if (!_pids.TryGetValue(s.Pid, out var st) || st.StartTime != s.StartTime)
+                {
+                    // New process (or a new one under a reused PID, the backend
+                    // read its name) - cache name and counters, no delta this cycle
+                    _pids[s.Pid] = new PidState
+                    {
+                        Name = Sanitize(s.Name), StartTime = s.StartTime, LastCpu = s.CpuTime100ns, SeenCycle = _cycle
+                    };
+                    continue;
+                }
+
+                long cpuDelta = s.CpuTime100ns - st.LastCpu;
+                st.LastCpu = s.CpuTime100ns;
+                st.SeenCycle = _cycle;
+
+                if (!primed || cpuDelta < 0 || st.Name.Length == 0) continue;
+                _ranked.Add(new Ranked { Name = st.Name, Cpu = (float)(cpuDelta * scale), MemBytes = s.MemBytes });
+            }
+
+            // Evict PIDs that disappeared (only touch the cache when needed)
+            if (_pids.Count > _samples.Count)
+            {
+                var gone = new List<int>();
+                foreach (var kv in _pids)
+                    if (kv.Value.SeenCycle != _cycle) gone.Add(kv.Key);
+                foreach (int pid in gone) _pids.Remove(pid);
+            }
+
+            if (!primed) return null;
+
+            _ranked.Sort((a, b) =>
+            {
+                int c = b.Cpu.CompareTo(a.Cpu);
+                return c != 0 ? c : b.MemBytes.CompareTo(a.MemBytes);
+            });
+
+            int n = Math.Min(TOP_COUNT, _ranked.Count);
+            return _ranked.GetRange(0, n);
+        }
+
+        private static string FormatLine(List<Ranked> top)
+        {
+            var sb = new StringBuilder(ProtocolCommands.PROC_TOP, 4 + TOP_COUNT * 28);
+            for (int i = 0; i < top.Count; i++)
+            {
+                if (i > 0) sb.Append(';');
+                float cpu = Math.Min(100f, Math.Max(0f, top[i].Cpu));
+                sb.Append(top[i].Name).Append('|')
+                  .Append(cpu.ToString("0.0", CultureInfo.InvariantCulture)).Append('|')
+                  .Append((top[i].MemBytes / (1024 * 1024)).ToString(CultureInfo.InvariantCulture));
+            }
+            sb.Append('\n');
+            return sb.ToString();
+        }
+
+        /// <summary>
+        /// Strips ".exe", drops protocol separators / non-ASCII and truncates
+        /// to the device field size.
+        /// </summary>
+        internal static string Sanitize(string name)
+        {
+            if (string.IsNullOrEmpty(name)) return "";
+            if (name.EndsWith(".exe", StringComparison.OrdinalIgnoreCase))
+                name = name.Substring(0, name.Length - 4);
+
+            var sb = new StringBuilder(Math.Min(name.Length, NAME_MAX));
+            foreach (char c in name)
+            {
+                if (sb.Length >= NAME_MAX) break;
+                if (c < 0x20 || c > 0x7E || c == '|' || c == ';' || c == ',') continue;
+                sb.Append(c);
+            }
+            return sb.ToString();
+        }
+    }
+
+    /// <summary>
+    /// Linux backend: parses /proc/[pid]/stat (utime, stime, starttime, rss). The root
+    /// is configurable so it can be pointed at a captured fixture tree.
+    /// </summary>
+    public sealed class ProcFsProcessSource : IProcessCounterSource
+    {
+        private const long CLK_TCK = 100;   // USER_HZ, fixed at 100 on all mainstream kernels
+        private readonly string _root;
+        private readonly long _pageSize = Environment.SystemPageSize;
+
+        public ProcFsProcessSource(string root)
+        {
+            _root = root;
+        }
+
+        public void Read(List<ProcessCounterSample> into, Func<int, long, bool> knownName)
+        {
+            foreach (string dir in Directory.EnumerateDirectories(_root))
+            {
+                string leaf = Path.GetFileName(dir);
+                if (leaf.Length == 0 || leaf[0] < '0' || leaf[0] > '9') continue;
+                if (!int.TryParse(leaf, NumberStyles.None, CultureInfo.InvariantCulture, out int pid)) continue;
+
+                string line;
+                try { line = File.ReadAllText(Path.Combine(dir, "stat")); }
+                catch (IOException) { continue; }                   // Process exited meanwhile
+                catch (UnauthorizedAccessException) { continue; }
+
+                if (TryParseStat(line, out string name, out long ticks, out long startTicks, out long rssPages))
+                {
+                    into.Add(new ProcessCounterSample
+                    {
+                        Pid = pid,
+                        StartTime = startTicks,
+                        Name = knownName(pid, startTicks) ? null : name,
+                        CpuTime100ns = ticks * (TimeSpan.TicksPerSecond / CLK_TCK),
+                        MemBytes = rssPages * _pageSize
+                    });
+                }
+            }
+        }
+
+        /// <summary>
+        /// "pid (comm) state ppid ..." - comm may contain spaces and ')', so
+        /// split at the LAST ')'. utime/stime are fields 14/15, starttime
+        /// (clock ticks after boot) is 22, rss is 24.
+        /// </summary>
+        internal static bool TryParseStat(string line, out string name, out long ticks, out long startTicks, out long rssPages)
+        {
+            name = null; ticks = 0; startTicks = 0; rssPages = 0;
+            int open = line.IndexOf('(');
+            int close = line.LastIndexOf(')');
+            if (open < 0 || close < open || close + 2 >= line.Length) return false;     // Truncated read
+
+            name = line.Substring(open + 1, close - open - 1);
+            string[] f = line.Substring(close + 2).Split(' ');
+            // f[0] = field 3 (state) -> field N is f[N - 3]
+            if (f.Length < 22) return false;
+
+            if (!long.TryParse(f[11], NumberStyles.Integer, CultureInfo.InvariantCulture, out long utime)) return false;
+            if (!long.TryParse(f[12], NumberStyles.Integer, CultureInfo.InvariantCulture, out long stime)) return false;
+            if (!long.TryParse(f[19], NumberStyles.Integer, CultureInfo.InvariantCulture, out startTicks)) return false;
+            long.TryParse(f[21], NumberStyles.Integer, CultureInfo.InvariantCulture, out rssPages);
+            ticks = utime + stime;
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Windows backend: one NtQuerySystemInformation(SystemProcessInformation)
+    /// call returns every process in a single buffer. Offsets are for the
+    /// x64 SYSTEM_PROCESS_INFORMATION layout (the client is built x64 only).
+    /// </summary>
+    public sealed class NtProcessSource : IProcessCounterSource
+    {
+        private const int SystemProcessInformation = 5;
+        private const uint STATUS_INFO_LENGTH_MISMATCH = 0xC0000004;
+
+        private const int OFS_NEXT = 0x00;
+        private const int OFS_CREATE_TIME = 0x20;
+        private const int OFS_USER_TIME = 0x28;
+        private const int OFS_KERNEL_TIME = 0x30;
+        private const int OFS_NAME_LEN = 0x38;
+        private const int OFS_NAME_BUF = 0x40;
+        private const int OFS_PID = 0x50;
+        private const int OFS_WORKING_SET = 0x90;
+
+        [DllImport("ntdll.dll")]
+        private static extern uint NtQuerySystemInformation(int infoClass, IntPtr buffer, int length, out int returnLength);
+
+        private IntPtr _buffer = IntPtr.Zero;
+        private int _bufferSize;
+
+        ~NtProcessSource()
+        {
+            if (_buffer != IntPtr.Zero) Marshal.FreeHGlobal(_buffer);
+        }
+
+        public void Read(List<ProcessCounterSample> into, Func<int, long, bool> knownName)
+        {
+            // Buffer is kept between calls; grow on STATUS_INFO_LENGTH_MISMATCH
+            if (_buffer == IntPtr.Zero) Grow(256 * 1024);
+
+            uint status;
+            while ((status = NtQuerySystemInformation(SystemProcessInformation, _buffer, _bufferSize, out int needed))
+                   == STATUS_INFO_LENGTH_MISMATCH)
+            {
+                Grow(Math.Max(needed, _bufferSize) + 64 * 1024);
+            }
+            if (status != 0)
+                throw new InvalidOperationException("NtQuerySystemInformation failed: 0x" + status.ToString("X8"));
+
+            long offset = 0;
+            while (true)
+            {
+                IntPtr entry = IntPtr.Add(_buffer, (int)offset);
+                int pid = (int)Marshal.ReadIntPtr(entry, OFS_PID).ToInt64();
+
+                if (pid != 0)   // Skip the Idle pseudo-process
+                {
+                    long created = Marshal.ReadInt64(entry, OFS_CREATE_TIME);
+                    string name = null;
+                    if (!knownName(pid, created))
+                    {
+                        int len = Marshal.ReadInt16(entry, OFS_NAME_LEN) & 0xFFFF;
+                        IntPtr buf = Marshal.ReadIntPtr(entry, OFS_NAME_BUF);
+                        name = (buf != IntPtr.Zero && len > 0) ? Marshal.PtrToStringUni(buf, len / 2) : "";
+                    }
+
+                    into.Add(new ProcessCounterSample
+                    {
+                        Pid = pid,
+                        StartTime = created,
+                        Name = name,
+                        CpuTime100ns = Marshal.ReadInt64(entry, OFS_USER_TIME) + Marshal.ReadInt64(entry, OFS_KERNEL_TIME),
+                        MemBytes = Marshal.ReadIntPtr(entry, OFS_WORKING_SET).ToInt64()
+                    });
+                }
+
+                int next = Marshal.ReadInt32(entry, OFS_NEXT);
+                if (next == 0) break;
+                offset += next;
+            }
+        }
+
+        private void Grow(int size)
+        {
+            if (_buffer != IntPtr.Zero) Marshal.FreeHGlobal(_buffer);
+            _buffer = Marshal.AllocHGlobal(size);
+            _bufferSize = size;
+        }
+    }
+}
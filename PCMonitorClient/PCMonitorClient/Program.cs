@@ -1,17 +1,9 @@
 using System;
-using System.Collections.Generic;
 using System.Diagnostics;
 using System.Drawing;
 using System.Drawing.Drawing2D;
-using System.Globalization;
 using System.IO;
-using System.IO.Ports;
-using System.Linq;
-using System.Management;
-using System.Net.NetworkInformation;
-using System.Net.Sockets;
-using System.Threading;
-using System.Threading.Tasks;
+using System.Runtime.CompilerServices;
 using System.Windows.Forms;
 
 namespace PCMonitorClient
@@ -30,6 +22,23 @@ namespace PCMonitorClient
                 LogCrash("UnhandledException", e.ExceptionObject as Exception);
             };
 
+            // --headless / --service: no tray, no forms, no UI thread
+            if (HeadlessHost.IsHeadlessArgs(args))
+            {
+                HeadlessHost.Run(args);
+                return;
+            }
+
+            RunTray(args);
+        }
+
+        /// <summary>
+        /// Tray app. Kept out of Main so the headless path never JIT-compiles
+        /// a method that references WinForms (the assembly is not loaded).
+        /// </summary>
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static void RunTray(string[] args)
+        {
             Application.ThreadException += (s, e) =>
             {
                 LogCrash("ThreadException", e.Exception);
@@ -73,26 +82,10 @@ namespace PCMonitorClient
 
     internal class TrayContext : ApplicationContext
     {
-        private const string HANDSHAKE_QUERY = "WHO_ARE_YOU?\n";
-        private const string HANDSHAKE_RESPONSE = "SCARAB_CLIENT_OK";
-
-        // Identity Sync Protocol
-        private const string NAME_CMD_CPU = "NAME_CPU=";
-        private const string NAME_CMD_GPU = "NAME_GPU=";
-        private const string NAME_CMD_HASH = "NAME_HASH=";
-
-        // NOTE: The ESP32-S3's native USB port enumerates as "USB JTAG/serial
-        // debug unit" when the Espressif driver is installed - and that IS our
-        // device. So keywords here only LOWER scan priority (tried last),
-        // they never exclude a port. The handshake decides.
-        private static readonly string[] DEPRIORITIZE_PORT_KEYWORDS = { "Debugger", "JLink", "ST-Link" };
-        private static readonly string[] PREFER_PORT_KEYWORDS = { "USB Serial", "USB-SERIAL", "USB JTAG/serial", "CP210", "CH340", "CH341", "FTDI", "Silicon Labs" };
-
         private readonly NotifyIcon _trayIcon;
         private readonly StatusForm _statusForm;
         private readonly SettingsForm _settingsForm;
         private readonly ContextMenuStrip _contextMenu;
-        private readonly string[] _args;
 
         // === ICON SYSTEM ===
         private readonly Icon _baseIcon;      // Original icon from file
@@ -107,23 +100,12 @@ namespace PCMonitorClient
         private volatile bool _isFirstConnect = true;  // True until first successful connection
 
         // === STATE ===
-        private HardwareCollector _collector;
-        private CancellationTokenSource _cts;
-        private Task _backgroundTask;
-        private SerialPort _activePort;
-        private readonly object _portLock = new object();
-
+        private readonly MonitorCore _core;           // Collector + serial transport (no UI)
         private volatile bool _isShuttingDown = false;
-        private volatile bool _isConnected = false;
-        private volatile bool _isLiteMode = false;
-        private volatile bool _isUploadMode = false;  // Pauses data loop during image upload
-        private volatile bool _isPaused = false;      // Manual pause by user
-        private volatile string _espFwVersion = "";   // Firmware version from handshake (|V:x.y.z)
-        private volatile string _espDeviceName = "";  // User-assigned device name from handshake (|N:...)
 
         public TrayContext(string[] args)
         {
-            _args = args;
+            _core = new MonitorCore(args.Length > 0 ? args[0] : null);
 
             // ============================================================
             // 1. ICON LOADING & GENERATION
@@ -144,16 +126,29 @@ namespace PCMonitorClient
             // ============================================================
             _settingsForm = new SettingsForm
             {
-                SendCommand = SendCommandToEsp,
-                IsConnected = () => _isConnected,
-                GetSerialPort = () => _activePort,
-                GetPortWriteLock = () => _portLock,
-                SetUploadMode = (mode) => _isUploadMode = mode,
-                SetPaused = (paused) => _isPaused = paused,
-                IsPaused = () => _isPaused,
-                GetAvailablePorts = GetAvailablePortNames
+                SendCommand = _core.SendCommand,
+                CallDevice = _core.CallAsync,
+                IsConnected = () => _core.IsConnected,
+                GetPortWriteLock = () => _core.PortLock,
+                GetDeviceCaps = () => _core.DeviceCaps,
+                AcquirePort = use => _core.AcquirePortAsync(use),
+                StageFirmware = _core.StartFirmwareStaging,
+                CancelFirmwareStaging = _core.CancelFirmwareStaging,
+                HasFirmwareStagingJob = () => _core.FirmwareStager.HasJob,
+                SetPaused = (paused) => _core.IsPaused = paused,
+                IsPaused = () => _core.IsPaused,
+                GetAvailablePorts = MonitorCore.GetAvailablePortNames
             };
 
+            var stager = _core.FirmwareStager;
+            stager.StatusChanged += (s, status) => _settingsForm.SetFwStagingStatus(status);
+            if (stager.Status != "") _settingsForm.SetFwStagingStatus(stager.Status);
+
+            _core.LogMessage += (s, line) => _statusForm.AppendLog(line);
+            _core.DataSent += (s, line) => _statusForm.UpdateData(line);
+            _core.StatusChanged += OnCoreStatusChanged;
+            _core.ConnectionChanged += OnCoreConnectionChanged;
+
             // ============================================================
             // 3. CONTEXT MENU
             // ============================================================
@@ -192,8 +187,7 @@ namespace PCMonitorClient
             // ============================================================
             // 6. START BACKGROUND LOOP
             // ============================================================
-            _cts = new CancellationTokenSource();
-            _backgroundTask = Task.Run(() => MonitorLoop(_cts.Token));
+            _core.Start();
         }
 
         // ====================================================================
@@ -367,12 +361,12 @@ namespace PCMonitorClient
                 string tooltip;
 
                 // Status logic: Red if disconnected, Yellow if Lite, Green if Full
-                if (!_isConnected)
+                if (!_core.IsConnected)
                 {
                     newIcon = _iconRed;
                     tooltip = "Scarab Monitor: Disconnected";
                 }
-                else if (_isLiteMode)
+                else if (_core.IsLiteMode)
                 {
                     newIcon = _iconYellow;
                     tooltip = "Scarab Monitor: Connected (LITE)";
@@ -434,49 +428,27 @@ namespace PCMonitorClient
             }
         }
 
-        /// <summary>
-        /// Sends a command string to the ESP32 via serial port.
-        /// Thread-safe, can be called from UI.
-        /// </summary>
-        private void SendCommandToEsp(string command)
-        {
-            if (string.IsNullOrEmpty(command)) return;
-
-            lock (_portLock)
-            {
-                if (_activePort == null || !_activePort.IsOpen)
-                {
-                    _statusForm.AppendLog("[Cmd] Error: Not connected");
-                    return;
-                }
+        // ====================================================================
+        //  CORE EVENTS (worker thread)
+        // ====================================================================
 
-                try
-                {
-                    string line = command.EndsWith("\n") ? command : command + "\n";
-                    _activePort.Write(line);
-                    _activePort.BaseStream.Flush();
-                    _statusForm.AppendLog("[Cmd] TX: " + command);
-                }
-                catch (Exception ex)
-                {
-                    _statusForm.AppendLog("[Cmd] Error: " + ex.Message);
-                }
-            }
+        private void OnCoreStatusChanged(object sender, MonitorStatusEventArgs e)
+        {
+            UpdateTrayIcon();
+            _statusForm.UpdateConnectionStatus(e.Status, e.IsConnected, e.IsLiteMode);
         }
 
-        /// <summary>
-        /// Returns list of available COM port names for SettingsForm.
-        /// </summary>
-        private string[] GetAvailablePortNames()
+        private void OnCoreConnectionChanged(object sender, EventArgs e)
         {
-            try
-            {
-                return SerialPort.GetPortNames();
-            }
-            catch
+            bool connected = _core.IsConnected;
+
+            // Stop heartbeat animation on first connect
+            if (connected && _isFirstConnect)
             {
-                return new string[0];
+                OnFirstConnect();
             }
+
+            UpdateSettingsFormStatus(connected, connected ? _core.PortName : "");
         }
 
         /// <summary>
@@ -487,12 +459,13 @@ namespace PCMonitorClient
             try
             {
                 // Prefer the device-stored name (SET_ID) over the bare port name
-                string displayName = (connected && !string.IsNullOrEmpty(_espDeviceName))
-                    ? _espDeviceName + " (" + portName + ")"
+                string deviceName = _core.DeviceName;
+                string displayName = (connected && !string.IsNullOrEmpty(deviceName))
+                    ? deviceName + " (" + portName + ")"
                     : portName;
 
-                _settingsForm.SetConnectionStatus(connected, displayName, _collector?.IdentityHash ?? "",
-                    connected ? _espFwVersion : "");
+                _settingsForm.SetConnectionStatus(connected, displayName, _core.LocalIdentityHash,
+                    connected ? _core.FwVersion : "");
             }
             catch { }
         }
@@ -528,471 +501,14 @@ namespace PCMonitorClient
             // 1. Stop blink timer
             try { _blinkTimer.Stop(); _blinkTimer.Dispose(); } catch { }
 
-            // 2. Cancel background task
-            try { _cts.Cancel(); } catch { }
-
-            // 3. Close serial port to unblock reads
-            lock (_portLock)
-            {
-                if (_activePort != null)
-                {
-                    try { _activePort.Close(); _activePort.Dispose(); } catch { }
-                    _activePort = null;
-                }
-            }
+            // 2. Stop the monitor loop, close the port, dispose the collector
+            try { _core.Stop(); } catch { }
 
-            // 4. Wait for background task (max 1.5s)
-            try { _backgroundTask?.Wait(1500); } catch { }
-
-            // 5. Dispose hardware collector
-            try { _collector?.Dispose(); } catch { }
-
-            // 6. Hide tray icon
+            // 3. Hide tray icon
             try { _trayIcon.Visible = false; _trayIcon.Dispose(); } catch { }
 
-            // 7. Exit application
+            // 4. Exit application
             Application.Exit();
         }
-
-        // ====================================================================
-        //  BACKGROUND MONITOR LOOP
-        // ====================================================================
-
-        private void MonitorLoop(CancellationToken ct)
-        {
-            try
-            {
-                // Initialize hardware collector
-                _statusForm.AppendLog("[Init] Starting hardware collector...");
-                _statusForm.AppendLog("[Init] Admin: " + (HardwareCollector.IsAdmin() ? "YES" : "NO"));
-
-                _collector = new HardwareCollector();
-                _isLiteMode = _collector.IsLiteMode;
-
-                _statusForm.AppendLog("[Init] " + _collector.InitStatus);
-                _statusForm.UpdateConnectionStatus("Initialized", false, _isLiteMode);
-
-                string cliPort = (_args.Length > 0) ? _args[0] : null;
-
-                while (!ct.IsCancellationRequested)
-                {
-                    // --- CONNECT ---
-                    _isConnected = false;
-                    UpdateTrayIcon();
-                    _statusForm.UpdateConnectionStatus("Searching...", false, _isLiteMode);
-
-                    string portName = cliPort ?? FindEsp32ByHandshake(ct);
-                    if (string.IsNullOrEmpty(portName))
-                    {
-                        // Wait and retry (in chunks for fast cancel)
-                        for (int i = 0; i < 30 && !ct.IsCancellationRequested; i++)
-                            Thread.Sleep(100);
-                        continue;
-                    }
-
-                    _statusForm.AppendLog("[Serial] Connecting to " + portName + "...");
-
-                    try
-                    {
-                        using (var port = new SerialPort(portName, 115200))
-                        {
-                            port.DtrEnable = true;
-                            port.ReadTimeout = 500;
-                            port.WriteTimeout = 1000;
-
-                            lock (_portLock)
-                            {
-                                if (ct.IsCancellationRequested) break;
-                                port.Open();
-                                _activePort = port;
-                            }
-
-                            // Wait for ESP32 reset (in chunks)
-                            for (int i = 0; i < 20 && !ct.IsCancellationRequested; i++)
-                                Thread.Sleep(100);
-
-                            if (ct.IsCancellationRequested) break;
-
-                            // Verify handshake and get ESP hash
-                            string espHash = VerifyHandshakeAndGetHash(port);
-                            if (espHash == null)
-                            {
-                                _statusForm.AppendLog("[Serial] Handshake FAILED on " + portName);
-                                lock (_portLock) { _activePort = null; }
-                                for (int i = 0; i < 20 && !ct.IsCancellationRequested; i++)
-                                    Thread.Sleep(100);
-                                continue;
-                            }
-
-                            // === FIRST CONNECTION ESTABLISHED ===
-                            _statusForm.AppendLog("[Serial] Connected to " + portName);
-
-                            // Sync hardware identity if needed
-                            SyncIdentityIfNeeded(port, espHash);
-                            _isConnected = true;
-
-                            // Stop heartbeat animation on first connect
-                            if (_isFirstConnect)
-                            {
-                                OnFirstConnect();
-                            }
-
-                            UpdateTrayIcon();
-                            _statusForm.UpdateConnectionStatus("Connected: " + portName, true, _isLiteMode);
-                            UpdateSettingsFormStatus(true, portName);
-
-                            // --- DATA LOOP ---
-                            RunDataLoop(port, ct);
-
-                            lock (_portLock) { _activePort = null; }
-                        }
-                    }
-                    catch (OperationCanceledException)
-                    {
-                        break;
-                    }
-                    catch (Exception ex)
-                    {
-                        Program.LogCrash("MonitorLoop", ex);
-                        _statusForm.AppendLog("[Error] " + ex.Message);
-                        lock (_portLock) { _activePort = null; }
-
-                        if (!ct.IsCancellationRequested)
-                        {
-                            for (int i = 0; i < 20 && !ct.IsCancellationRequested; i++)
-                                Thread.Sleep(100);
-                        }
-                    }
-
-                    _isConnected = false;
-                    UpdateTrayIcon();
-                    _statusForm.UpdateConnectionStatus("Disconnected", false, _isLiteMode);
-                    UpdateSettingsFormStatus(false);
-
-                    // If auto-detected, re-scan
-                    if (_args.Length == 0) cliPort = null;
-                }
-            }
-            catch (Exception ex)
-            {
-                Program.LogCrash("MonitorLoop_Outer", ex);
-                _statusForm.AppendLog("[FATAL] " + ex.Message);
-            }
-        }
-
-        private void RunDataLoop(SerialPort port, CancellationToken ct)
-        {
-            // Detect network info once
-            string netType = "LAN", netSpeed = "1000 Mbps";
-            try
-            {
-                var iface = NetworkInterface.GetAllNetworkInterfaces()
-                    .FirstOrDefault(n => n.OperationalStatus == OperationalStatus.Up
-                        && n.NetworkInterfaceType != NetworkInterfaceType.Loopback
-                        && n.GetIPProperties().UnicastAddresses
-                            .Any(a => a.Address.AddressFamily == AddressFamily.InterNetwork));
-
-                if (iface != null)
-                {
-                    netType = (iface.NetworkInterfaceType == NetworkInterfaceType.Wireless80211) ? "WLAN" : "LAN";
-                    netSpeed = (iface.Speed / 1000000) + " Mbps";
-                }
-            }
-            catch { }
-
-            // Target interval between packets. We measure how long GetStats()
-            // + Write take and subtract that, so the ESP receives data at a
-            // steady ~1s cadence instead of 1s PLUS the (variable, up to ~800ms
-            // in Full Mode) collection time - which otherwise let the gap creep
-            // past the stale threshold and flash the red "disconnected" dot.
-            const int TARGET_INTERVAL_MS = 1000;
-            var iterTimer = new System.Diagnostics.Stopwatch();
-
-            while (!ct.IsCancellationRequested && port.IsOpen)
-            {
-                try
-                {
-                    // Pause data transmission during image upload OR manual pause
-                    if (_isUploadMode || _isPaused)
-                    {
-                        Thread.Sleep(200);
-                        continue;
-                    }
-
-                    iterTimer.Restart();
-
-                    var s = _collector.GetStats();
-
-                    // Format data string (matches ESP32 parser)
-                    string data = string.Format(CultureInfo.InvariantCulture,
-                        "CPU:{0},CPUT:{1:0.0},GPU:{2},GPUT:{3:0.0},VRAM:{4:0.0}/{5:0.0},RAM:{6:0.0}/{7:0.0},NET:{8},SPEED:{9},DOWN:{10:0.0},UP:{11:0.0}\n",
-                        (int)s.CpuLoad, s.CpuTemp,
-                        (int)s.GpuLoad, s.GpuTemp,
-                        s.GpuVramUsed, s.GpuVramTotal,
-                        s.RamUsedGb, s.RamTotalGb,
-                        netType, netSpeed,
-                        s.NetDown, s.NetUp);
-
-                    // All port writes go through _portLock: the data loop, user
-                    // commands (SendCommandToEsp) and image/firmware uploads run
-                    // on different threads - unsynchronized writes interleave
-                    // bytes and corrupt protocol lines on the ESP.
-                    lock (_portLock)
-                    {
-                        port.Write(data);
-                        port.BaseStream.Flush();
-                    }
-
-                    // Update status form (only if visible, handled internally)
-                    _statusForm.UpdateData("TX: " + data.Trim());
-
-                    // Sleep the remainder of the target interval (min 100ms),
-                    // in 100ms chunks for fast cancellation
-                    int remaining = TARGET_INTERVAL_MS - (int)iterTimer.ElapsedMilliseconds;
-                    if (remaining < 100) remaining = 100;
-                    int chunks = (remaining + 99) / 100;
-                    for (int i = 0; i < chunks && !ct.IsCancellationRequested; i++)
-                        Thread.Sleep(100);
-                }
-                catch (OperationCanceledException)
-                {
-                    break;
-                }
-                catch (Exception ex)
-                {
-                    Program.LogCrash("DataLoop", ex);
-                    _statusForm.AppendLog("[TX Error] " + ex.Message);
-                    break;
-                }
-            }
-        }
-
-        // ====================================================================
-        //  HANDSHAKE & PORT DISCOVERY
-        // ====================================================================
-
-        /// <summary>
-        /// Extracts the value of a |KEY: field from the handshake response
-        /// (value runs until the next '|' or end of line). Returns "" if absent.
-        /// </summary>
-        private static string ParseHandshakeField(string response, string key)
-        {
-            int pos = response.IndexOf(key, StringComparison.Ordinal);
-            if (pos < 0) return "";
-
-            string value = response.Substring(pos + key.Length).Trim();
-            int nextSep = value.IndexOf('|');
-            if (nextSep >= 0) value = value.Substring(0, nextSep);
-            return value.Trim();
-        }
-
-        /// <summary>
-        /// Verifies handshake and returns ESP's identity hash (or null on failure).
-        /// Response format: SCARAB_CLIENT_OK|H:XXXXXXXX|V:x.y.z|N:device-name
-        /// (|V: and |N: added in FW 2.4 - absent on older firmware)
-        /// </summary>
-        private string VerifyHandshakeAndGetHash(SerialPort port)
-        {
-            try
-            {
-                port.DiscardInBuffer();
-                port.Write(HANDSHAKE_QUERY);
-                port.BaseStream.Flush();
-
-                int origTimeout = port.ReadTimeout;
-                port.ReadTimeout = 200;
-
-                try
-                {
-                    string response = port.ReadLine();
-                    if (response != null && response.Contains(HANDSHAKE_RESPONSE))
-                    {
-                        // Optional fields (FW >= 2.4)
-                        _espFwVersion = ParseHandshakeField(response, "|V:");
-                        _espDeviceName = ParseHandshakeField(response, "|N:");
-
-                        // Parse hash: SCARAB_CLIENT_OK|H:XXXXXXXX
-                        int hashPos = response.IndexOf("|H:");
-                        if (hashPos >= 0 && response.Length >= hashPos + 11)
-                        {
-                            return response.Substring(hashPos + 3, 8);
-                        }
-                        return "00000000"; // Old firmware without hash support
-                    }
-                }
-                finally
-                {
-                    port.ReadTimeout = origTimeout;
-                }
-            }
-            catch { }
-            return null; // Handshake failed
-        }
-
-        private bool VerifyHandshake(SerialPort port)
-        {
-            return VerifyHandshakeAndGetHash(port) != null;
-        }
-
-        /// <summary>
-        /// Syncs hardware identity if ESP hash differs from local.
-        /// Sends NAME_CPU, NAME_GPU, NAME_HASH commands.
-        /// </summary>
-        private void SyncIdentityIfNeeded(SerialPort port, string espHash)
-        {
-            if (_collector == null) return;
-
-            string localHash = _collector.IdentityHash;
-
-            if (espHash == localHash)
-            {
-                _statusForm.AppendLog("[Sync] Hash match: " + localHash);
-                return;
-            }
-
-            _statusForm.AppendLog("[Sync] Hash mismatch! ESP=" + espHash + " Local=" + localHash);
-            _statusForm.AppendLog("[Sync] Sending hardware names...");
-
-            try
-            {
-                // Send CPU name
-                string cmdCpu = NAME_CMD_CPU + _collector.CpuName + "\n";
-                port.Write(cmdCpu);
-                port.BaseStream.Flush();
-                Thread.Sleep(50);
-
-                // Send GPU name
-                string cmdGpu = NAME_CMD_GPU + _collector.GpuName + "\n";
-                port.Write(cmdGpu);
-                port.BaseStream.Flush();
-                Thread.Sleep(50);
-
-                // Send new hash (ESP will store it)
-                string cmdHash = NAME_CMD_HASH + localHash + "\n";
-                port.Write(cmdHash);
-                port.BaseStream.Flush();
-                Thread.Sleep(50);
-
-                _statusForm.AppendLog("[Sync] Names sent: CPU=" + _collector.CpuName + ", GPU=" + _collector.GpuName);
-            }
-            catch (Exception ex)
-            {
-                _statusForm.AppendLog("[Sync] Error: " + ex.Message);
-            }
-        }
-
-        private string FindEsp32ByHandshake(CancellationToken ct)
-        {
-            var ports = GetFilteredPorts();
-            if (ports.Count == 0) return null;
-
-            _statusForm.AppendLog("[Serial] Scanning " + ports.Count + " ports...");
-
-            foreach (var portInfo in ports)
-            {
-                if (ct.IsCancellationRequested) return null;
-
-                _statusForm.AppendLog("  " + portInfo.Name + ": Trying..." + (portInfo.IsDeprioritized ? " (low priority)" : ""));
-
-                try
-                {
-                    using (var port = new SerialPort(portInfo.Name, 115200))
-                    {
-                        port.DtrEnable = true;
-                        port.ReadTimeout = 200;
-                        port.WriteTimeout = 500;
-                        port.Open();
-
-                        Thread.Sleep(1000); // Wait for device
-
-                        if (VerifyHandshake(port))
-                        {
-                            _statusForm.AppendLog("  " + portInfo.Name + ": FOUND!");
-                            port.Close();
-                            return portInfo.Name;
-                        }
-                        port.Close();
-                    }
-                }
-                catch (UnauthorizedAccessException)
-                {
-                    _statusForm.AppendLog("  " + portInfo.Name + ": In use");
-                }
-                catch { }
-            }
-
-            return null;
-        }
-
-        private class PortInfo
-        {
-            public string Name;
-            public string Caption;
-            public bool IsDeprioritized;
-            public bool IsPreferred;
-        }
-
-        private List<PortInfo> GetFilteredPorts()
-        {
-            var result = new List<PortInfo>();
-
-            try
-            {
-                var systemPorts = SerialPort.GetPortNames().ToHashSet(StringComparer.OrdinalIgnoreCase);
-                if (systemPorts.Count == 0) return result;
-
-                // WMI for port details
-                using (var searcher = new ManagementObjectSearcher("SELECT * FROM Win32_PnPEntity WHERE Caption LIKE '%(COM%'"))
-                {
-                    foreach (ManagementObject obj in searcher.Get())
-                    {
-                        try
-                        {
-                            string caption = obj["Caption"]?.ToString() ?? "";
-                            int start = caption.LastIndexOf("(COM");
-                            int end = caption.LastIndexOf(")");
-
-                            if (start >= 0 && end > start)
-                            {
-                                string portName = caption.Substring(start + 1, end - start - 1);
-                                if (systemPorts.Contains(portName))
-                                {
-                                    result.Add(new PortInfo
-                                    {
-                                        Name = portName,
-                                        Caption = caption,
-                                        IsDeprioritized = DEPRIORITIZE_PORT_KEYWORDS.Any(k => caption.IndexOf(k, StringComparison.OrdinalIgnoreCase) >= 0),
-                                        IsPreferred = PREFER_PORT_KEYWORDS.Any(k => caption.IndexOf(k, StringComparison.OrdinalIgnoreCase) >= 0)
-                                    });
-                                    systemPorts.Remove(portName);
-                                }
-                            }
-                        }
-                        catch { }
-                    }
-                }
-
-                // Add remaining (unknown) ports
-                foreach (var port in systemPorts)
-                {
-                    result.Add(new PortInfo { Name = port, Caption = port, IsDeprioritized = false, IsPreferred = false });
-                }
-            }
-            catch
-            {
-                // Fallback
-                foreach (var port in SerialPort.GetPortNames())
-                {
-                    result.Add(new PortInfo { Name = port, Caption = port, IsDeprioritized = false, IsPreferred = false });
-                }
-            }
-
-            // Sort: preferred first, deprioritized (debugger) ports last
-            return result
-                .OrderBy(p => p.IsDeprioritized ? 1 : 0)
-                .ThenByDescending(p => p.IsPreferred)
-                .ThenByDescending(p => p.Name)
-                .ToList();
-        }
     }
 }
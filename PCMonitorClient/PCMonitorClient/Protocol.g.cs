@@ -0,0 +1,601 @@
+// <auto-generated>
+// GENERATED by tools/protogen.py from protocol/scarab_protocol.def - DO NOT EDIT
+// </auto-generated>
+using System;
+using System.Buffers.Binary;
+
+namespace PCMonitorClient
+{
+    /// <summary>Command / line tokens (scarab_protocol.def).</summary>
+    public static class ProtocolCommands
+    {
+        public const string HANDSHAKE_QUERY = "WHO_ARE_YOU?";
+        public const string HANDSHAKE_OK = "SCARAB_CLIENT_OK";
+        public const string GET_CAPS = "GET_CAPS";
+        public const string CAPS = "CAPS:";
+        public const string PROC_TOP = "TOP:";
+        public const string HISTORY = "HIST:";
+        public const string SET_VIEW = "SET_VIEW:";
+        public const string GET_FW_VER = "GET_FW_VER";
+        public const string IMG_STATUS = "IMG_STATUS";
+        public const string GET_USB_STATS = "GET_USB_STATS";
+        public const string USB_STATS = "USB_STATS:";
+        public const string ALERT_RULES = "ALERT_RULES:";
+        public const string ALERT_OK = "ALERT_OK:";
+        public const string ALERT_ERR = "ALERT_ERR:";
+        public const string BENCH = "BENCH";
+        public const string BENCH_BEGIN = "BENCH_BEGIN:";
+        public const string BENCH_RESULT = "BENCH:";
+        public const string BENCH_END = "BENCH_END:";
+        public const string BENCH_ERR = "BENCH_ERR:";
+        public const string RPC_TAG = "@";
+        public const string RPC_END = "RPC_END:";
+        public const string GET_POSTMORTEM = "GET_POSTMORTEM";
+        public const string POSTMORTEM = "PM:";
+        public const string POSTMORTEM_END = "PM_END:";
+        public const string METRICS = "METRICS:";
+        public const string METRICS_OK = "METRICS_OK:";
+        public const string METRICS_ERR = "METRICS_ERR:";
+        public const string GET_METRICS = "GET_METRICS";
+        public const string METRIC_VALUES = "METRIC_VAL:";
+        public const string PROFILE_SAVE = "PROFILE_SAVE:";
+        public const string PROFILE_IMG = "PROFILE_IMG:";
+        public const string PROFILE_ACTIVATE = "PROFILE_ACTIVATE:";
+        public const string PROFILE_DELETE = "PROFILE_DELETE:";
+        public const string PROFILE_LIST = "PROFILE_LIST";
+        public const string PROFILE = "PROFILE:";
+        public const string PROFILE_END = "PROFILE_END:";
+        public const string PROFILE_OK = "PROFILE_OK:";
+        public const string PROFILE_ERR = "PROFILE_ERR:";
+    }
+
+    /// <summary>Format constants (scarab_protocol.def).</summary>
+    public static class ProtocolConstants
+    {
+        public const uint SCARAB_IMG_MAGIC = 0x53434152;  // "SCAR" in little-endian
+        public const int SCARAB_IMG_VERSION = 2;
+        public const int SCARAB_IMG_HEADER_V1_SIZE = 16;
+        public const int ALERT_MAX_RULES = 16;
+        public const uint ALERT_COLOR_THEME = 0x01000000;  // arg flag: theme temperature colour
+        public const int ALERT_METRIC_CUSTOM = 32;  // metric 32 + n = custom metric slot n
+        public const int BENCH_CASES = 15;
+        public const int RPC_ID_MAX = 65535;
+        public const int METRIC_TABLE_VERSION = 1;
+        public const int METRIC_MAX_SLOTS = 64;
+        public const int METRIC_MAX_CONSTS = 64;
+        public const int METRIC_MAX_OPS = 400;  // Instruction budget per stats line
+        public const int METRIC_REGS = 16;
+        public const int PROFILE_SLOTS = 4;
+        public const int PROFILE_NAME_MAX = 15;
+        public const int PROFILE_IMG_NONE = 255;
+        public const int SS_IMG_LIBRARY = 16;
+    }
+
+    public enum ScarabImgFormat : byte
+    {
+        RGB565 = 0,  // 16-bit color, no alpha (2 bytes/pixel)
+        RGB565A8 = 1,  // 16-bit color + 8-bit alpha (3 bytes/pixel)
+    }
+
+    public enum ScarabImgAlign : byte
+    {
+        CENTER = 0,  // v1 files (reserved byte was 0)
+        TOP_LEFT = 1,
+        TOP_MID = 2,
+        TOP_RIGHT = 3,
+        LEFT_MID = 4,
+        RIGHT_MID = 5,
+        BOTTOM_LEFT = 6,
+        BOTTOM_MID = 7,
+        BOTTOM_RIGHT = 8,
+    }
+
+    public enum AlertMetric : byte
+    {
+        CPU_LOAD = 0,  // %
+        CPU_TEMP = 1,  // C
+        GPU_LOAD = 2,  // %
+        GPU_TEMP = 3,  // C
+        RAM_PCT = 4,  // % of total
+        VRAM_PCT = 5,  // % of total
+        NET_DOWN = 6,  // Mbps
+        NET_UP = 7,  // Mbps
+        DISK_QUEUE = 8,  // average queue depth
+        DISK_LATENCY = 9,  // ms per I/O
+    }
+
+    public enum AlertAction : byte
+    {
+        COLOR = 0,  // recolour the target
+        BLINK = 1,  // blink the target
+        VIEW = 2,  // force a display to a view
+    }
+
+    public enum AlertTarget : byte
+    {
+        CPU_TEMP = 0,  // CPU temperature label
+        GPU_TEMP = 1,  // GPU temperature label
+        CPU_ARC = 2,  // CPU load arc
+        GPU_ARC = 3,  // GPU load arc
+    }
+
+    public enum MetricOp : byte
+    {
+        LDC = 0,  // dst = const[a]
+        LDF = 1,  // dst = input a (metric_input)
+        LDM = 2,  // dst = slot a (this line if already run, else the previous one)
+        MOV = 3,  // dst = Ra
+        ADD = 4,  // dst = Ra + Rb
+        SUB = 5,  // dst = Ra - Rb
+        MUL = 6,  // dst = Ra * Rb
+        DIV = 7,  // dst = Ra / Rb (N/A if Rb is 0)
+        MIN = 8,  // dst = min(Ra, Rb)
+        MAX = 9,  // dst = max(Ra, Rb)
+        NEG = 10,  // dst = -Ra
+        ABS = 11,  // dst = |Ra|
+        DEF = 12,  // dst = Ra, or Rb if Ra is N/A
+        RET = 13,  // slot value = Ra, end of program
+    }
+
+    public enum MetricInput : byte
+    {
+        CPU_LOAD = 0,  // %
+        CPU_TEMP = 1,  // C
+        GPU_LOAD = 2,  // %
+        GPU_TEMP = 3,  // C
+        VRAM_USED = 4,  // GB
+        VRAM_TOTAL = 5,  // GB
+        RAM_USED = 6,  // GB
+        RAM_TOTAL = 7,  // GB
+        NET_DOWN = 8,  // Mbps
+        NET_UP = 9,  // Mbps
+        DISK_READ = 10,  // MB/s
+        DISK_WRITE = 11,  // MB/s
+        DISK_READ_IOPS = 12,
+        DISK_WRITE_IOPS = 13,
+        DISK_QUEUE = 14,  // average queue depth
+        DISK_LATENCY = 15,  // ms per I/O
+        DT = 16,  // s since the previous stats line (N/A on the first)
+    }
+
+    /// <summary>scarab_img_header_t - 20 bytes, little-endian, packed.</summary>
+    public struct ScarabImgHeader
+    {
+        public const int SIZE = 20;
+
+        /// <summary>Must be SCARAB_IMG_MAGIC</summary>
+        public uint Magic;
+        /// <summary>Image width (1..240)</summary>
+        public ushort Width;
+        /// <summary>Image height (1..240)</summary>
+        public ushort Height;
+        /// <summary>scarab_img_format_t</summary>
+        public byte Format;
+        /// <summary>Header version</summary>
+        public byte Version;
+        /// <summary>scarab_img_align_t (v2+)</summary>
+        public byte Align;
+        /// <summary>Must be 0</summary>
+        public byte Reserved;
+        /// <summary>Size of pixel data in bytes</summary>
+        public uint DataSize;
+        /// <summary>v2+: shift from the aligned position</summary>
+        public short OffsetX;
+        /// <summary>v2+: shift from the aligned position</summary>
+        public short OffsetY;
+
+        public void Write(Span<byte> dst)
+        {
+            BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(0), Magic);
+            BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(4), Width);
+            BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(6), Height);
+            dst[8] = Format;
+            dst[9] = Version;
+            dst[10] = Align;
+            dst[11] = Reserved;
+            BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(12), DataSize);
+            BinaryPrimitives.WriteInt16LittleEndian(dst.Slice(16), OffsetX);
+            BinaryPrimitives.WriteInt16LittleEndian(dst.Slice(18), OffsetY);
+        }
+
+        public static ScarabImgHeader Read(ReadOnlySpan<byte> src)
+        {
+            return new ScarabImgHeader
+            {
+                Magic = BinaryPrimitives.ReadUInt32LittleEndian(src.Slice(0)),
+                Width = BinaryPrimitives.ReadUInt16LittleEndian(src.Slice(4)),
+                Height = BinaryPrimitives.ReadUInt16LittleEndian(src.Slice(6)),
+                Format = src[8],
+                Version = src[9],
+                Align = src[10],
+                Reserved = src[11],
+                DataSize = BinaryPrimitives.ReadUInt32LittleEndian(src.Slice(12)),
+                OffsetX = BinaryPrimitives.ReadInt16LittleEndian(src.Slice(16)),
+                OffsetY = BinaryPrimitives.ReadInt16LittleEndian(src.Slice(18))
+            };
+        }
+    }
+
+    /// <summary>metric_table_header_t - 8 bytes, little-endian, packed.</summary>
+    public struct MetricTableHeader
+    {
+        public const int SIZE = 8;
+
+        /// <summary>METRIC_TABLE_VERSION</summary>
+        public byte Version;
+        /// <summary>Programs / slots (0..METRIC_MAX_SLOTS)</summary>
+        public byte SlotCount;
+        /// <summary>0..METRIC_MAX_CONSTS</summary>
+        public byte ConstCount;
+        /// <summary>Must be 0</summary>
+        public byte Reserved;
+        /// <summary>All programs (0..METRIC_MAX_OPS)</summary>
+        public ushort OpCount;
+        /// <summary>Must be 0</summary>
+        public ushort Reserved2;
+
+        public void Write(Span<byte> dst)
+        {
+            dst[0] = Version;
+            dst[1] = SlotCount;
+            dst[2] = ConstCount;
+            dst[3] = Reserved;
+            BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(4), OpCount);
+            BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(6), Reserved2);
+        }
+
+        public static MetricTableHeader Read(ReadOnlySpan<byte> src)
+        {
+            return new MetricTableHeader
+            {
+                Version = src[0],
+                SlotCount = src[1],
+                ConstCount = src[2],
+                Reserved = src[3],
+                OpCount = BinaryPrimitives.ReadUInt16LittleEndian(src.Slice(4)),
+                Reserved2 = BinaryPrimitives.ReadUInt16LittleEndian(src.Slice(6))
+            };
+        }
+    }
+
+    /// <summary>
+    /// stats line codec: CPU:..,CPUT:..,GPU:..,GPUT:..,VRAM:..,RAM:..,NET:..,SPEED:..,DOWN:..,UP:..,DSK:..
+    /// </summary>
+    public static class StatsFrame
+    {
+        /// <summary>Longest possible line incl. newline.</summary>
+        public const int MAX_LENGTH = 287;
+        public const int MIN_FIELDS = 5;
+
+        /// <summary>
+        /// Writes the line (incl. '\n') to dst, which must hold MAX_LENGTH
+        /// bytes. Returns the number of bytes written.
+        /// </summary>
+        public static int Encode(SystemStats s, Span<byte> dst)
+        {
+            if (dst.Length < MAX_LENGTH) throw new ArgumentException("Buffer smaller than MAX_LENGTH", nameof(dst));
+
+            int pos = 0;
+            ProtocolAscii.PutLiteral(dst, ref pos, "CPU:");
+            ProtocolAscii.PutInt(dst, ref pos, (int)s.CpuLoad);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",CPUT:");
+            ProtocolAscii.PutFixed(dst, ref pos, s.CpuTemp, 1);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",GPU:");
+            ProtocolAscii.PutInt(dst, ref pos, (int)s.GpuLoad);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",GPUT:");
+            ProtocolAscii.PutFixed(dst, ref pos, s.GpuTemp, 1);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",VRAM:");
+            ProtocolAscii.PutFixed(dst, ref pos, s.GpuVramUsed, 1);
+            dst[pos++] = (byte)'/';
+            ProtocolAscii.PutFixed(dst, ref pos, s.GpuVramTotal, 1);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",RAM:");
+            ProtocolAscii.PutFixed(dst, ref pos, s.RamUsedGb, 1);
+            dst[pos++] = (byte)'/';
+            ProtocolAscii.PutFixed(dst, ref pos, s.RamTotalGb, 1);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",NET:");
+            ProtocolAscii.PutText(dst, ref pos, s.NetType, 15, ',');
+            ProtocolAscii.PutLiteral(dst, ref pos, ",SPEED:");
+            ProtocolAscii.PutText(dst, ref pos, s.NetSpeed, 15, ',');
+            ProtocolAscii.PutLiteral(dst, ref pos, ",DOWN:");
+            ProtocolAscii.PutFixed(dst, ref pos, s.NetDown, 1);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",UP:");
+            ProtocolAscii.PutFixed(dst, ref pos, s.NetUp, 1);
+            ProtocolAscii.PutLiteral(dst, ref pos, ",DSK:");
+            ProtocolAscii.PutFixed(dst, ref pos, s.DiskReadMBps, 1);
+            dst[pos++] = (byte)'/';
+            ProtocolAscii.PutFixed(dst, ref pos, s.DiskWriteMBps, 1);
+            dst[pos++] = (byte)'/';
+            ProtocolAscii.PutFixed(dst, ref pos, s.DiskReadIops, 0);
+            dst[pos++] = (byte)'/';
+            ProtocolAscii.PutFixed(dst, ref pos, s.DiskWriteIops, 0);
+            dst[pos++] = (byte)'/';
+            ProtocolAscii.PutFixed(dst, ref pos, s.DiskQueue, 1);
+            dst[pos++] = (byte)'/';
+            ProtocolAscii.PutFixed(dst, ref pos, s.DiskLatencyMs, 1);
+            dst[pos++] = (byte)'\n';
+            return pos;
+        }
+
+        /// <summary>
+        /// Parses a line (without newline) into s, same rules as the firmware:
+        /// absent keys get their schema default. Returns the number of fields parsed.
+        /// </summary>
+        public static int Decode(ReadOnlySpan<byte> line, SystemStats s)
+        {
+            s.CpuLoad = 0;
+            s.CpuTemp = 0;
+            s.GpuLoad = 0;
+            s.GpuTemp = 0;
+            s.GpuVramUsed = 0;
+            s.GpuVramTotal = 0;
+            s.RamUsedGb = 0;
+            s.RamTotalGb = 0;
+            s.NetType = "";
+            s.NetSpeed = "";
+            s.NetDown = 0;
+            s.NetUp = 0;
+            s.DiskReadMBps = -1;
+            s.DiskWriteMBps = -1;
+            s.DiskReadIops = -1;
+            s.DiskWriteIops = -1;
+            s.DiskQueue = -1;
+            s.DiskLatencyMs = -1;
+
+            Span<float> v = stackalloc float[6];
+            int fields = 0;
+            int p = 0;
+            while (p < line.Length)
+            {
+                int end = line.Slice(p).IndexOf((byte)',');
+                end = end < 0 ? line.Length : p + end;
+                int colon = line.Slice(p, end - p).IndexOf((byte)':');
+
+                if (colon > 0)
+                {
+                    var key = line.Slice(p, colon);
+                    int val = p + colon + 1;
+                    if (Is(key, "CPU"))
+                    {
+                        ProtocolAscii.ScanInt(line, val, end, out int i);
+                        s.CpuLoad = i;
+                        fields++;
+                    }
+                    else if (Is(key, "CPUT"))
+                    {
+                        ProtocolAscii.ScanNum(line, val, end, out float f);
+                        s.CpuTemp = f;
+                        fields++;
+                    }
+                    else if (Is(key, "GPU"))
+                    {
+                        ProtocolAscii.ScanInt(line, val, end, out int i);
+                        s.GpuLoad = i;
+                        fields++;
+                    }
+                    else if (Is(key, "GPUT"))
+                    {
+                        ProtocolAscii.ScanNum(line, val, end, out float f);
+                        s.GpuTemp = f;
+                        fields++;
+                    }
+                    else if (Is(key, "VRAM"))
+                    {
+                        if (ProtocolAscii.ScanList(line, val, end, v.Slice(0, 2)))
+                        {
+                            s.GpuVramUsed = v[0];
+                            s.GpuVramTotal = v[1];
+                            fields++;
+                        }
+                        else
+                        {
+                            s.GpuVramUsed = -1;
+                            s.GpuVramTotal = -1;
+                        }
+                    }
+                    else if (Is(key, "RAM"))
+                    {
+                        if (ProtocolAscii.ScanList(line, val, end, v.Slice(0, 2)))
+                        {
+                            s.RamUsedGb = v[0];
+                            s.RamTotalGb = v[1];
+                            fields++;
+                        }
+                        else
+                        {
+                            s.RamUsedGb = -1;
+                            s.RamTotalGb = -1;
+                        }
+                    }
+                    else if (Is(key, "NET"))
+                    {
+                        s.NetType = ProtocolAscii.ReadText(line, val, end, 15);
+                        fields++;
+                    }
+                    else if (Is(key, "SPEED"))
+                    {
+                        s.NetSpeed = ProtocolAscii.ReadText(line, val, end, 15);
+                        fields++;
+                    }
+                    else if (Is(key, "DOWN"))
+                    {
+                        ProtocolAscii.ScanNum(line, val, end, out float f);
+                        s.NetDown = f;
+                        fields++;
+                    }
+                    else if (Is(key, "UP"))
+                    {
+                        ProtocolAscii.ScanNum(line, val, end, out float f);
+                        s.NetUp = f;
+                        fields++;
+                    }
+                    else if (Is(key, "DSK"))
+                    {
+                        if (ProtocolAscii.ScanList(line, val, end, v.Slice(0, 6)))
+                        {
+                            s.DiskReadMBps = v[0];
+                            s.DiskWriteMBps = v[1];
+                            s.DiskReadIops = v[2];
+                            s.DiskWriteIops = v[3];
+                            s.DiskQueue = v[4];
+                            s.DiskLatencyMs = v[5];
+                            fields++;
+                        }
+                        else
+                        {
+                            s.DiskReadMBps = -1;
+                            s.DiskWriteMBps = -1;
+                            s.DiskReadIops = -1;
+                            s.DiskWriteIops = -1;
+                            s.DiskQueue = -1;
+                            s.DiskLatencyMs = -1;
+                        }
+                    }
+                }
+
+                p = end + 1;
+            }
+            return fields;
+        }
+
+        private static bool Is(ReadOnlySpan<byte> key, string name)
+        {
+            if (key.Length != name.Length) return false;
+            for (int i = 0; i < name.Length; i++)
+                if (key[i] != name[i]) return false;
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// ASCII scanners/writers shared by the generated codecs (same rules as
+    /// the firmware side: no culture, no allocation).
+    /// </summary>
+    internal static class ProtocolAscii
+    {
+        private static readonly int[] Scales = { 1, 10, 100, 1000, 10000 };
+
+        /// <summary>Index after the integer at [pos, end), or -1 if there are no digits.</summary>
+        public static int ScanInt(ReadOnlySpan<byte> s, int pos, int end, out int value)
+        {
+            bool neg = false;
+            if (pos < end && (s[pos] == '-' || s[pos] == '+')) { neg = s[pos] == '-'; pos++; }
+            int start = pos, v = 0;
+            while (pos < end && s[pos] >= '0' && s[pos] <= '9')
+            {
+                if (v < 100000000) v = v * 10 + (s[pos] - '0');
+                pos++;
+            }
+            value = neg ? -v : v;
+            return pos == start ? -1 : pos;
+        }
+
+        /// <summary>Index after the decimal number at [pos, end), or -1 if there are no digits.</summary>
+        public static int ScanNum(ReadOnlySpan<byte> s, int pos, int end, out float value)
+        {
+            bool neg = false;
+            if (pos < end && (s[pos] == '-' || s[pos] == '+')) { neg = s[pos] == '-'; pos++; }
+            int start = pos;
+            uint ip = 0, frac = 0, div = 1;
+            while (pos < end && s[pos] >= '0' && s[pos] <= '9')
+            {
+                if (ip < 1000000000u) ip = ip * 10 + (uint)(s[pos] - '0');
+                pos++;
+            }
+            if (pos < end && s[pos] == '.')
+            {
+                pos++;
+                while (pos < end && s[pos] >= '0' && s[pos] <= '9')
+                {
+                    if (div < 100000000u) { frac = frac * 10 + (uint)(s[pos] - '0'); div *= 10; }
+                    pos++;
+                }
+            }
+            float v = (float)ip + (float)frac / div;
+            value = neg ? -v : v;
+            bool noDigits = pos == start || (pos == start + 1 && s[start] == '.');
+            return noDigits ? -1 : pos;
+        }
+
+        /// <summary>n numbers separated by '/', filling exactly [pos, end).</summary>
+        public static bool ScanList(ReadOnlySpan<byte> s, int pos, int end, Span<float> values)
+        {
+            for (int i = 0; i < values.Length; i++)
+            {
+                pos = ScanNum(s, pos, end, out values[i]);
+                if (pos < 0) return false;
+                if (i < values.Length - 1)
+                {
+                    if (pos >= end || s[pos] != '/') return false;
+                    pos++;
+                }
+            }
+            return pos == end;
+        }
+
+        public static string ReadText(ReadOnlySpan<byte> s, int pos, int end, int max)
+        {
+            int len = Math.Min(end - pos, max);
+            var chars = new char[len];
+            for (int i = 0; i < len; i++) chars[i] = (char)s[pos + i];
+            return new string(chars);
+        }
+
+        public static void PutLiteral(Span<byte> d, ref int pos, string s)
+        {
+            for (int i = 0; i < s.Length; i++) d[pos++] = (byte)s[i];
+        }
+
+        /// <summary>Text truncated to max chars; separators/newlines become ' ', non-ASCII '?'.</summary>
+        public static void PutText(Span<byte> d, ref int pos, string s, int max, char sep)
+        {
+            if (s == null) return;
+            int n = Math.Min(s.Length, max);
+            for (int i = 0; i < n; i++)
+            {
+                char c = s[i];
+                d[pos++] = (c == sep || c == '\n' || c == '\r') ? (byte)' ' : (c > 127 ? (byte)'?' : (byte)c);
+            }
+        }
+
+        public static void PutUInt(Span<byte> d, ref int pos, ulong v)
+        {
+            int start = pos;
+            do { d[pos++] = (byte)('0' + (int)(v % 10)); v /= 10; } while (v != 0);
+            // Digits were written least significant first
+            for (int i = start, j = pos - 1; i < j; i++, j--)
+            {
+                byte t = d[i]; d[i] = d[j]; d[j] = t;
+            }
+        }
+
+        public static void PutInt(Span<byte> d, ref int pos, int v)
+        {
+            if (v < 0) { d[pos++] = (byte)'-'; PutUInt(d, ref pos, (ulong)(-(long)v)); }
+            else PutUInt(d, ref pos, (ulong)v);
+        }
+
+        /// <summary>
+        /// Fixed-point, rounded half away from zero. NaN is sent as -1 (N/A);
+        /// magnitude is clamped to 999999999.
+        /// </summary>
+        public static void PutFixed(Span<byte> d, ref int pos, float v, int decimals)
+        {
+            if (float.IsNaN(v)) v = -1f;
+            if (v > 999999999f) v = 999999999f;
+            if (v < -999999999f) v = -999999999f;
+
+            int scale = Scales[decimals];
+            bool neg = v < 0;
+            ulong s = (ulong)Math.Round((neg ? -(double)v : v) * scale, MidpointRounding.AwayFromZero);
+            if (neg && s != 0) d[pos++] = (byte)'-';
+            PutUInt(d, ref pos, s / (ulong)scale);
+            if (decimals > 0)
+            {
+                d[pos++] = (byte)'.';
+                ulong frac = s % (ulong)scale;
+                for (int div = scale / 10; div > 0; div /= 10)
+                    d[pos++] = (byte)('0' + (int)(frac / (ulong)div % 10));
+            }
+        }
+    }
+}
@@ -0,0 +1,280 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using LibreHardwareMonitor.Hardware;
+using Microsoft.Win32;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// The LibreHardwareMonitor sensors the collector reads, resolved once.
+    ///
+    /// Discovery (name matching over the whole tree, same rules as
+    /// SensorTreeReader) runs on the first Full Mode start; the chosen sensor
+    /// identifiers are persisted in %ProgramData%\ScarabMonitor\shared\sensor_map.txt
+    /// together with the hardware names, so later starts bind straight to
+    /// them instead of waiting for the bus scan and dumping the tree. If a
+    /// cached sensor is gone (hardware or LHM version changed) the map is
+    /// rediscovered. The cache also holds a registry fingerprint of CPU and
+    /// display adapters (HardwareFingerprint); after a CPU or GPU swap it no
+    /// longer matches and the whole cache is ignored.
+    /// </summary>
+    public sealed class SensorMap
+    {
+        private static readonly string CachePath = SharedData.PathOf("sensor_map.txt");
+
+        // Cache keys (one KEY|value line each)
+        private const string KEY_CPU_NAME = "CPU";
+        private const string KEY_GPU_NAME = "GPU";
+        private const string KEY_HARDWARE = "HW";
+
+        private const string DISPLAY_CLASS_KEY =
+            @"SYSTEM\CurrentControlSet\Control\Class\{4d36e968-e325-11ce-bfc1-08002be10318}";
+        private static readonly string[] SensorKeys =
+        {
+            "CPU_LOAD", "CPU_TEMP", "RAM_USED", "RAM_AVAIL",
+            "GPU_LOAD", "GPU_TEMP", "VRAM_USED", "VRAM_TOTAL"
+        };
+
+        public ISensor CpuLoad;
+        public ISensor CpuTemp;
+        public ISensor RamUsed;
+        public ISensor RamAvailable;
+        public ISensor GpuLoad;
+        public ISensor GpuTemp;
+        public ISensor GpuVramUsed;
+        public ISensor GpuVramTotal;
+
+        private ISensor[] All => new[] { CpuLoad, CpuTemp, RamUsed, RamAvailable, GpuLoad, GpuTemp, GpuVramUsed, GpuVramTotal };
+
+        /// <summary>
+        /// Picks the sensors by name from an updated tree. Call after the bus
+        /// scan - sensors that appear later are not seen.
+        /// </summary>
+        public static SensorMap Discover(IEnumerable<IHardware> hardware)
+        {
+            var map = new SensorMap();
+            var hw = hardware.ToList();
+
+            var cpu = hw.FirstOrDefault(h => h.HardwareType == HardwareType.Cpu);
+            if (cpu != null)
+            {
+                var sensors = SensorTreeReader.GetAllSensorsRecursive(cpu).ToList();
+                map.CpuLoad = sensors.FirstOrDefault(s => s.SensorType == SensorType.Load && s.Name == "CPU Total");
+                map.CpuTemp = SensorTreeReader.FindCpuTempSensor(hw, sensors);
+            }
+
+            var memory = hw.FirstOrDefault(h => h.HardwareType == HardwareType.Memory);
+            if (memory != null)
+            {
+                map.RamUsed = memory.Sensors.FirstOrDefault(s => s.SensorType == SensorType.Data && s.Name == "Memory Used");
+                map.RamAvailable = memory.Sensors.FirstOrDefault(s => s.SensorType == SensorType.Data && s.Name == "Memory Available");
+            }
+
+            var gpu = hw.FirstOrDefault(h => h.HardwareType == HardwareType.GpuNvidia
+                                          || h.HardwareType == HardwareType.GpuAmd
+                                          || h.HardwareType == HardwareType.GpuIntel);
+            if (gpu != null)
+            {
+                // Last match wins, as in SensorTreeReader.ReadGpu
+                var sensors = SensorTreeReader.GetAllSensorsRecursive(gpu).ToList();
+                map.GpuLoad = sensors.LastOrDefault(s => s.SensorType == SensorType.Load && s.Name == "GPU Core");
+                map.GpuTemp = sensors.LastOrDefault(s => s.SensorType == SensorType.Temperature && s.Name == "GPU Core");
+                map.GpuVramUsed = sensors.LastOrDefault(s => s.SensorType == SensorType.SmallData && s.Name == "GPU Memory Used");
+                map.GpuVramTotal = sensors.LastOrDefault(s => s.SensorType == SensorType.SmallData && s.Name == "GPU Memory Total");
+            }
+
+            return map;
+        }
+
+        /// <summary>
+        /// Binds cached identifiers to the sensors of an opened tree. Returns
+        /// null if any cached sensor is missing (rediscover instead).
+        /// </summary>
+        public static SensorMap Bind(IEnumerable<IHardware> hardware, Cached cached)
+        {
+            if (cached?.SensorIds == null) return null;
+
+            var byId = new Dictionary<string, ISensor>(StringComparer.Ordinal);
+            foreach (var hw in hardware)
+            {
+                foreach (var sensor in SensorTreeReader.GetAllSensorsRecursive(hw))
+                    byId[sensor.Identifier.ToString()] = sensor;
+            }
+
+            var found = new ISensor[SensorKeys.Length];
+            for (int i = 0; i < SensorKeys.Length; i++)
+            {
+                string id = cached.SensorIds[i];
+                if (id.Length == 0) continue;
+                if (!byId.TryGetValue(id, out found[i])) return null;
+            }
+
+            return new SensorMap
+            {
+                CpuLoad = found[0], CpuTemp = found[1], RamUsed = found[2], RamAvailable = found[3],
+                GpuLoad = found[4], GpuTemp = found[5], GpuVramUsed = found[6], GpuVramTotal = found[7]
+            };
+        }
+
+        /// <summary>True once every mapped sensor has produced a reading.</summary>
+        public bool HasValues => All.All(s => s == null || s.Value.HasValue);
+
+        /// <summary>
+        /// CPU load/temp from the mapped sensors. Returns false if the temp
+        /// has no usable reading - the caller then walks the tree
+        /// (SensorTreeReader.ReadCpu also tries the motherboard sensors).
+        /// </summary>
+        public bool ReadCpu(SystemStats s)
+        {
+            if (CpuLoad?.Value != null) s.CpuLoad = CpuLoad.Value.Value;
+
+            float temp = CpuTemp?.Value ?? 0f;
+            if (temp <= 0f) return false;
+            s.CpuTemp = temp;
+            return true;
+        }
+
+        public bool ReadRam(SystemStats s)
+        {
+            float used = RamUsed?.Value ?? -1f;
+            float available = RamAvailable?.Value ?? -1f;
+            if (used <= 0f || available < 0f) return false;
+
+            s.RamUsedGb = used;
+            s.RamTotalGb = used + available;
+            return true;
+        }
+
+        /// <summary>
+        /// GPU values from the mapped sensors. Returns false if GPU sensors
+        /// are mapped but none of them has a reading (device gone after a
+        /// driver reset or swap) - the caller walks the tree.
+        /// </summary>
+        public bool ReadGpu(SystemStats s)
+        {
+            if (GpuLoad == null && GpuTemp == null && GpuVramUsed == null && GpuVramTotal == null)
+                return true;    // No GPU on this machine (or NvAPI reads it)
+
+            bool read = false;
+            if (GpuLoad?.Value != null) { s.GpuLoad = GpuLoad.Value.Value; read = true; }
+            if (GpuTemp?.Value > 0f) { s.GpuTemp = GpuTemp.Value.Value; read = true; }
+            if (GpuVramUsed?.Value != null) { s.GpuVramUsed = GpuVramUsed.Value.Value / 1024f; read = true; }
+            if (GpuVramTotal?.Value != null) { s.GpuVramTotal = GpuVramTotal.Value.Value / 1024f; read = true; }
+            return read;
+        }
+
+        // ====================================================================
+        //  CACHE (KEY|value per line)
+        // ====================================================================
+
+        /// <summary>Contents of sensor_map.txt.</summary>
+        public sealed class Cached
+        {
+            public string CpuName;
+            public string GpuName;
+
+            /// <summary>HardwareFingerprint() when the cache was written (null in older files).</summary>
+            public string Fingerprint;
+
+            /// <summary>Identifiers in SensorKeys order ("" = not mapped), null if never discovered.</summary>
+            public string[] SensorIds;
+        }
+
+        /// <summary>Returns the cache, or null if there is none (first start).</summary>
+        public static Cached Load()
+        {
+            try
+            {
+                if (!File.Exists(CachePath)) return null;
+
+                var values = new Dictionary<string, string>(StringComparer.Ordinal);
+                foreach (string line in File.ReadAllLines(CachePath))
+                {
+                    int sep = line.IndexOf('|');
+                    if (sep > 0) values[line.Substring(0, sep)] = line.Substring(sep + 1);
+                }
+
+                var cached = new Cached
+                {
+                    CpuName = values.TryGetValue(KEY_CPU_NAME, out var cpu) ? cpu : null,
+                    GpuName = values.TryGetValue(KEY_GPU_NAME, out var gpu) ? gpu : null,
+                    Fingerprint = values.TryGetValue(KEY_HARDWARE, out var hardware) ? hardware : null
+                };
+                if (string.IsNullOrEmpty(cached.CpuName) || string.IsNullOrEmpty(cached.GpuName)) return null;
+
+                if (SensorKeys.All(values.ContainsKey))
+                    cached.SensorIds = SensorKeys.Select(k => values[k]).ToArray();
+
+                return cached;
+            }
+            catch
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Stores the hardware names and, if given, the sensor identifiers
+        /// (Lite Mode stores names only - there is no tree to map).
+        /// </summary>
+        public static void Save(string cpuName, string gpuName, SensorMap map)
+        {
+            try
+            {
+                var lines = new List<string>
+                {
+                    KEY_CPU_NAME + "|" + cpuName,
+                    KEY_GPU_NAME + "|" + gpuName,
+                    KEY_HARDWARE + "|" + HardwareFingerprint()
+                };
+
+                if (map != null)
+                {
+                    var sensors = map.All;
+                    for (int i = 0; i < SensorKeys.Length; i++)
+                        lines.Add(SensorKeys[i] + "|" + (sensors[i]?.Identifier.ToString() ?? ""));
+                }
+
+                SharedData.WriteAllLines(CachePath, lines);
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine("  [LHM]      Sensor map cache write failed: " + ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// CPU name and installed display adapters as the registry lists
+        /// them - a few key reads, no WMI. Changes when the CPU or GPU does.
+        /// </summary>
+        public static string HardwareFingerprint()
+        {
+            string cpu = "";
+            var adapters = new SortedSet<string>(StringComparer.Ordinal);
+
+            try
+            {
+                using (var key = Registry.LocalMachine.OpenSubKey(@"HARDWARE\DESCRIPTION\System\CentralProcessor\0"))
+                    cpu = (key?.GetValue("ProcessorNameString") as string)?.Trim() ?? "";
+
+                using (var display = Registry.LocalMachine.OpenSubKey(DISPLAY_CLASS_KEY))
+                {
+                    // Adapter instances are 0000, 0001, ...; "Properties" is not readable
+                    foreach (string name in display?.GetSubKeyNames() ?? new string[0])
+                    {
+                        if (name.Length != 4 || !name.All(char.IsDigit)) continue;
+                        using (var adapter = display.OpenSubKey(name))
+                        {
+                            if (adapter?.GetValue("DriverDesc") is string desc) adapters.Add(desc.Trim());
+                        }
+                    }
+                }
+            }
+            catch { /* partial fingerprint - still compared as is */ }
+
+            return cpu + ";" + string.Join(";", adapters);
+        }
+    }
+}
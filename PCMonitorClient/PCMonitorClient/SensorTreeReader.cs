@@ -0,0 +1,180 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using LibreHardwareMonitor.Hardware;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Extracts CPU/RAM/GPU values from a LibreHardwareMonitor hardware tree.
+    ///
+    /// Works on the IHardware/ISensor interfaces only, so it runs the same on
+    /// the live Computer and on a mocked tree (benchmarks). The caller owns
+    /// updating the tree (Computer.Accept) and error handling.
+    /// </summary>
+    public static class SensorTreeReader
+    {
+        public static IEnumerable<ISensor> GetAllSensorsRecursive(IHardware hardware)
+        {
+            foreach (var sensor in hardware.Sensors)
+                yield return sensor;
+
+            foreach (var sub in hardware.SubHardware)
+            {
+                foreach (var sensor in GetAllSensorsRecursive(sub))
+                    yield return sensor;
+            }
+        }
+
+        /// <summary>
+        /// CPU load ("CPU Total") and temperature. Falls back to a motherboard
+        /// (SuperIO) CPU/socket sensor if the CPU node has no usable temp.
+        /// </summary>
+        public static void ReadCpu(IEnumerable<IHardware> hardware, SystemStats s)
+        {
+            foreach (var hw in hardware)
+            {
+                if (hw.HardwareType != HardwareType.Cpu) continue;
+
+                var allSensors = GetAllSensorsRecursive(hw).ToList();
+
+                // --- Load ---
+                foreach (var sensor in allSensors)
+                {
+                    if (sensor.SensorType == SensorType.Load && sensor.Name == "CPU Total")
+                    {
+                        if (sensor.Value.HasValue)
+                            s.CpuLoad = sensor.Value.Value;
+                        break;
+                    }
+                }
+
+                // --- Temp ---
+                float rawTemp = FindBestTempFromSensors(allSensors,
+                    "Package", "Core Max", "Core Average", "Tctl");
+
+                if (rawTemp <= 0f)
+                    rawTemp = FindMotherboardCpuTemp(hardware);
+
+                if (rawTemp > 0f)
+                    s.CpuTemp = rawTemp;
+
+                break;
+            }
+        }
+
+        /// <summary>
+        /// RAM used/total in GB from the Memory node.
+        /// </summary>
+        public static void ReadRam(IEnumerable<IHardware> hardware, SystemStats s)
+        {
+            foreach (var hw in hardware)
+            {
+                if (hw.HardwareType != HardwareType.Memory) continue;
+
+                float used = -1f, available = -1f;
+                foreach (var sensor in hw.Sensors)
+                {
+                    if (sensor.SensorType == SensorType.Data && sensor.Name == "Memory Used")
+                        used = sensor.Value ?? -1f;
+                    if (sensor.SensorType == SensorType.Data && sensor.Name == "Memory Available")
+                        available = sensor.Value ?? -1f;
+                }
+
+                if (used > 0f && available >= 0f)
+                {
+                    s.RamUsedGb = used;
+                    s.RamTotalGb = used + available;
+                }
+                break;
+            }
+        }
+
+        /// <summary>
+        /// GPU load, core temperature and VRAM from the first GPU node
+        /// (used when NvAPI is unavailable).
+        /// </summary>
+        public static void ReadGpu(IEnumerable<IHardware> hardware, SystemStats s)
+        {
+            foreach (var hw in hardware)
+            {
+                if (hw.HardwareType != HardwareType.GpuNvidia
+                    && hw.HardwareType != HardwareType.GpuAmd
+                    && hw.HardwareType != HardwareType.GpuIntel)
+                    continue;
+
+                foreach (var sensor in GetAllSensorsRecursive(hw))
+                {
+                    if (sensor.SensorType == SensorType.Load && sensor.Name == "GPU Core" && sensor.Value.HasValue)
+                        s.GpuLoad = sensor.Value.Value;
+                    if (sensor.SensorType == SensorType.Temperature && sensor.Name == "GPU Core" && sensor.Value.HasValue && sensor.Value.Value > 0f)
+                        s.GpuTemp = sensor.Value.Value;
+                    if (sensor.SensorType == SensorType.SmallData && sensor.Name == "GPU Memory Used" && sensor.Value.HasValue)
+                        s.GpuVramUsed = sensor.Value.Value / 1024f;
+                    if (sensor.SensorType == SensorType.SmallData && sensor.Name == "GPU Memory Total" && sensor.Value.HasValue)
+                        s.GpuVramTotal = sensor.Value.Value / 1024f;
+                }
+                break;
+            }
+        }
+
+        /// <summary>
+        /// The sensor ReadCpu takes the temperature from: the best CPU node
+        /// temp, or the motherboard CPU/socket sensor if that has no reading.
+        /// Null if neither exists.
+        /// </summary>
+        public static ISensor FindCpuTempSensor(IEnumerable<IHardware> hardware, List<ISensor> cpuSensors)
+        {
+            var best = FindBestTempSensor(cpuSensors, "Package", "Core Max", "Core Average", "Tctl");
+            if (best != null && (best.Value ?? 0f) > 0f) return best;
+            return FindMotherboardCpuTempSensor(hardware) ?? best;
+        }
+
+        private static float FindBestTempFromSensors(List<ISensor> sensors, params string[] priorities)
+        {
+            return FindBestTempSensor(sensors, priorities)?.Value ?? 0f;
+        }
+
+        private static ISensor FindBestTempSensor(List<ISensor> sensors, params string[] priorities)
+        {
+            var tempSensors = sensors
+                .Where(s => s.SensorType == SensorType.Temperature)
+                .ToList();
+
+            if (tempSensors.Count == 0) return null;
+
+            foreach (var keyword in priorities)
+            {
+                var match = tempSensors.FirstOrDefault(
+                    s => s.Name.IndexOf(keyword, StringComparison.OrdinalIgnoreCase) >= 0);
+                if (match != null)
+                    return match;
+            }
+
+            foreach (var sensor in tempSensors)
+            {
+                if ((sensor.Value ?? 0f) > 0f) return sensor;
+            }
+
+            return tempSensors[0];
+        }
+
+        private static float FindMotherboardCpuTemp(IEnumerable<IHardware> hardware)
+        {
+            return FindMotherboardCpuTempSensor(hardware)?.Value ?? 0f;
+        }
+
+        private static ISensor FindMotherboardCpuTempSensor(IEnumerable<IHardware> hardware)
+        {
+            foreach (var hw in hardware)
+            {
+                if (hw.HardwareType != HardwareType.Motherboard) continue;
+
+                var allSensors = GetAllSensorsRecursive(hw).ToList();
+                var sensor = FindBestTempSensor(allSensors, "CPU", "Socket");
+                if ((sensor?.Value ?? 0f) > 0f) return sensor;
+            }
+            return null;
+        }
+    }
+}
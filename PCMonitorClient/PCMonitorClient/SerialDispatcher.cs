@@ -0,0 +1,290 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO.Ports;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// The only reader of a connection's serial port. One thread reads it
+    /// line by line: "@&lt;id&gt;:" lines go to DeviceRpc, every other line to
+    /// whoever holds the port (PortLease - handshake, upload, benchmark,
+    /// background staging). Lines nobody waits for are ESP log output and
+    /// are dropped.
+    ///
+    /// Holding the port is exclusive: AcquireAsync waits until the previous
+    /// holder disposes its lease. Writes are not affected - they still go
+    /// through the shared port lock and may come from any thread.
+    /// </summary>
+    public sealed class SerialDispatcher : IDisposable
+    {
+        private const int MAX_LINE = 8192;      // Garbage without newlines is cut here
+
+        private readonly SerialPort _port;
+        private readonly SemaphoreSlim _ownership = new SemaphoreSlim(1, 1);
+        private readonly Thread _reader;
+        private volatile PortLease _owner;
+        private volatile DeviceRpc _rpc;
+        private volatile bool _stop;
+
+        public SerialDispatcher(SerialPort port)
+        {
+            _port = port ?? throw new ArgumentNullException(nameof(port));
+            if (_port.ReadTimeout == SerialPort.InfiniteTimeout) _port.ReadTimeout = 500;    // Dispose must get through
+            _reader = new Thread(ReadLoop) { IsBackground = true, Name = "SerialDispatcher " + port.PortName };
+            _reader.Start();
+        }
+
+        /// <summary>True while the port is open and being read.</summary>
+        public bool IsOpen => !_stop && _reader.IsAlive && _port.IsOpen;
+
+        /// <summary>Receives the "@&lt;id&gt;:" lines (null = dropped).</summary>
+        public DeviceRpc Rpc
+        {
+            get => _rpc;
+            set => _rpc = value;
+        }
+
+        /// <summary>
+        /// Takes the port: untagged lines go to the returned lease until it is
+        /// disposed. Waits for the current holder.
+        /// </summary>
+        /// <param name="owner">Name for logs ("IMG", "FW_STAGE", ...)</param>
+        /// <param name="onRelease">Runs after the lease is given back (may be null)</param>
+        public async Task<PortLease> AcquireAsync(string owner, CancellationToken ct = default, Action onRelease = null)
+        {
+            await _ownership.WaitAsync(ct);
+            return Grant(owner, onRelease);
+        }
+
+        /// <summary>
+        /// Blocking variant for the connect thread. Null if the port stays
+        /// taken for timeoutMs.
+        /// </summary>
+        public PortLease Acquire(string owner, int timeoutMs)
+        {
+            return _ownership.Wait(timeoutMs) ? Grant(owner, null) : null;
+        }
+
+        private PortLease Grant(string owner, Action onRelease)
+        {
+            var lease = new PortLease(this, owner, onRelease);
+            _owner = lease;
+            return lease;
+        }
+
+        internal void Release(PortLease lease)
+        {
+            if (_owner != lease) return;
+            _owner = null;
+            _ownership.Release();
+        }
+
+        internal void Write(string text)
+        {
+            _port.Write(text);
+            _port.BaseStream.Flush();
+        }
+
+        internal void Write(byte[] buffer, int offset, int count)
+        {
+            _port.Write(buffer, offset, count);
+            _port.BaseStream.Flush();
+        }
+
+        /// <summary>Stops reading (the port itself is closed by its owner).</summary>
+        public void Dispose()
+        {
+            _stop = true;
+            if (Thread.CurrentThread != _reader) _reader.Join(1000);
+            _owner?.Close();
+        }
+
+        // ====================================================================
+        //  READER
+        // ====================================================================
+
+        private void ReadLoop()
+        {
+            var buffer = new byte[512];
+            var line = new StringBuilder();
+
+            while (!_stop)
+            {
+                int n;
+                try
+                {
+                    n = _port.Read(buffer, 0, buffer.Length);
+                }
+                catch (TimeoutException)
+                {
+                    continue;       // ReadTimeout - check _stop
+                }
+                catch (Exception ex)
+                {
+                    if (!_stop && _port.IsOpen) Debug.WriteLine("[SerialDispatcher] Read failed: " + ex.Message);
+                    break;          // Port closed or gone
+                }
+
+                for (int i = 0; i < n; i++)
+                {
+                    char c = (char)buffer[i];
+                    if (c != '\n' && c != '\r')
+                    {
+                        if (line.Length < MAX_LINE) line.Append(c);
+                        continue;
+                    }
+                    if (line.Length == 0) continue;
+
+                    Route(line.ToString());
+                    line.Clear();
+                }
+            }
+
+            _stop = true;
+            _owner?.Close();
+        }
+
+        private void Route(string line)
+        {
+            if (line.StartsWith(ProtocolCommands.RPC_TAG, StringComparison.Ordinal))
+            {
+                _rpc?.HandleLine(line);
+                return;
+            }
+            _owner?.Post(line);
+        }
+    }
+
+    /// <summary>
+    /// The port while it is held (SerialDispatcher.AcquireAsync): the
+    /// untagged lines routed to this holder, whole (ReadLine) or byte by
+    /// byte, newline-terminated, as if read from the port itself - so
+    /// ChunkedSerialUploader runs unchanged on it. Dispose gives the port
+    /// back.
+    /// </summary>
+    public sealed class PortLease : ISerialLink, IDisposable
+    {
+        private readonly SerialDispatcher _dispatcher;
+        private readonly Action _onRelease;
+        private readonly object _sync = new object();
+        private readonly Queue<string> _lines = new Queue<string>();
+        private string _current;        // Line being read byte by byte, incl. '\n'
+        private int _pos;
+        private int _available;         // Bytes left in _current and _lines
+        private bool _closed;
+        private int _disposed;
+
+        internal PortLease(SerialDispatcher dispatcher, string owner, Action onRelease)
+        {
+            _dispatcher = dispatcher;
+            _onRelease = onRelease;
+            Owner = owner;
+        }
+
+        public string Owner { get; }
+
+        public bool IsOpen
+        {
+            get { lock (_sync) { return !_closed && _dispatcher.IsOpen; } }
+        }
+
+        public int BytesToRead
+        {
+            get { lock (_sync) { return _available; } }
+        }
+
+        public void Write(string text) => _dispatcher.Write(text);
+
+        public void Write(byte[] buffer, int offset, int count) => _dispatcher.Write(buffer, offset, count);
+
+        public int ReadByte()
+        {
+            lock (_sync)
+            {
+                if (_current == null || _pos >= _current.Length)
+                {
+                    if (_lines.Count == 0) throw new TimeoutException("No line from the device");
+                    _current = _lines.Dequeue() + "\n";
+                    _pos = 0;
+                }
+                _available--;
+                return _current[_pos++];
+            }
+        }
+
+        /// <summary>Drops the lines received so far (log output before a command).</summary>
+        public void DiscardInBuffer()
+        {
+            lock (_sync)
+            {
+                _lines.Clear();
+                _current = null;
+                _available = 0;
+            }
+        }
+
+        /// <summary>
+        /// Next whole line (without newline), or null after timeoutMs or once
+        /// the port is gone.
+        /// </summary>
+        public string ReadLine(int timeoutMs)
+        {
+            var clock = Stopwatch.StartNew();
+            lock (_sync)
+            {
+                while (_lines.Count == 0 && (_current == null || _pos >= _current.Length))
+                {
+                    int left = timeoutMs - (int)clock.ElapsedMilliseconds;
+                    if (_closed || left <= 0) return null;
+                    Monitor.Wait(_sync, left);
+                }
+
+                string line;
+                if (_current != null && _pos < _current.Length)
+                {
+                    line = _current.Substring(_pos, _current.Length - _pos - 1);
+                    _current = null;
+                }
+                else
+                {
+                    line = _lines.Dequeue();
+                }
+                _available -= line.Length + 1;
+                return line;
+            }
+        }
+
+        internal void Post(string line)
+        {
+            lock (_sync)
+            {
+                if (_closed) return;
+                _lines.Enqueue(line);
+                _available += line.Length + 1;
+                Monitor.PulseAll(_sync);
+            }
+        }
+
+        internal void Close()
+        {
+            lock (_sync)
+            {
+                _closed = true;
+                Monitor.PulseAll(_sync);
+            }
+        }
+
+        public void Dispose()
+        {
+            if (Interlocked.Exchange(ref _disposed, 1) != 0) return;
+
+            Close();
+            _dispatcher.Release(this);
+            _onRelease?.Invoke();
+        }
+    }
+}
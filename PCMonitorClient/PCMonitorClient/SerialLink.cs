@@ -0,0 +1,56 @@
+using System;
+using System.IO.Ports;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// The byte-level operations the protocol code needs from the serial
+    /// port. SerialPortLink wraps the real port; benchmarks plug in an
+    /// in-memory device emulator.
+    /// </summary>
+    public interface ISerialLink
+    {
+        bool IsOpen { get; }
+        int BytesToRead { get; }
+
+        /// <summary>Writes the text and flushes it to the device.</summary>
+        void Write(string text);
+
+        /// <summary>Writes raw bytes (pre-encoded ASCII lines) and flushes.</summary>
+        void Write(byte[] buffer, int offset, int count);
+
+        int ReadByte();
+        void DiscardInBuffer();
+    }
+
+    /// <summary>
+    /// ISerialLink over a System.IO.Ports.SerialPort.
+    /// </summary>
+    public sealed class SerialPortLink : ISerialLink
+    {
+        private readonly SerialPort _port;
+
+        public SerialPortLink(SerialPort port)
+        {
+            _port = port ?? throw new ArgumentNullException(nameof(port));
+        }
+
+        public bool IsOpen => _port.IsOpen;
+        public int BytesToRead => _port.BytesToRead;
+
+        public void Write(string text)
+        {
+            _port.Write(text);
+            _port.BaseStream.Flush();
+        }
+
+        public void Write(byte[] buffer, int offset, int count)
+        {
+            _port.Write(buffer, offset, count);
+            _port.BaseStream.Flush();
+        }
+
+        public int ReadByte() => _port.ReadByte();
+        public void DiscardInBuffer() => _port.DiscardInBuffer();
+    }
+}
@@ -32,10 +32,14 @@ namespace PCMonitorClient
 
         // Callbacks
         public Action<string> SendCommand { get; set; }
+        public Func<string, Task<DeviceRpc.Reply>> CallDevice { get; set; }
         public Func<bool> IsConnected { get; set; }
-        public Func<System.IO.Ports.SerialPort> GetSerialPort { get; set; }
         public Func<object> GetPortWriteLock { get; set; }
-        public Action<bool> SetUploadMode { get; set; }
+        public Func<DeviceCaps> GetDeviceCaps { get; set; }
+        public Func<PortUse, Task<PortLease>> AcquirePort { get; set; }
+        public Func<string, string> StageFirmware { get; set; }
+        public Action CancelFirmwareStaging { get; set; }
+        public Func<bool> HasFirmwareStagingJob { get; set; }
         public Action<bool> SetPaused { get; set; }
         public Func<bool> IsPaused { get; set; }
         public Func<string[]> GetAvailablePorts { get; set; }
@@ -56,10 +60,15 @@ namespace PCMonitorClient
         private TextBox _txtFwPath;
         private Button _btnFwBrowse;
         private Button _btnFwFlash;
+        private Button _btnFwStage;
         private ProgressBar _progressFw;
         private Label _lblFwStatus;
+        private Label _lblFwStaging;
         private string _espFwVersion = "";
         private bool _isFlashingFirmware;
+        private Button _btnBench;
+        private Label _lblBenchStatus;
+        private bool _isBenchmarking;
 
         // Device status bar
         private Panel _panelDeviceStatus;
@@ -93,6 +102,11 @@ namespace PCMonitorClient
         // Profile system
         private TextBox _txtProfileName;
         private ListBox _lstProfiles;
+        private NumericUpDown _numDeviceSlot;
+        private ComboBox _cboProfileDisplay;
+        private NumericUpDown _numProfileImage;
+        private NumericUpDown _numLibrarySlot;
+        private ListBox _lstDeviceProfiles;
 
         // Upload state
         private ProgressBar _progressUpload;
@@ -698,7 +712,7 @@ namespace PCMonitorClient
 
                     if (result == DialogResult.Yes)
                     {
-                        await UploadImageAsync(filePath, (ImageSlot)panel.SlotIndex);
+                        await UploadImageAsync(filePath, panel.SlotIndex);
                     }
                 }
             }
@@ -717,7 +731,7 @@ namespace PCMonitorClient
                 case 1: return "GPU";
                 case 2: return "RAM";
                 case 3: return "NET";
-                default: return $"Slot {slot}";
+                default: return $"library image {slot + 1}";
             }
         }
 
@@ -809,7 +823,7 @@ namespace PCMonitorClient
             var settingsPanel = new Panel
             {
                 Location = new Point(rightX, y),
-                Size = new Size(380, 140),
+                Size = new Size(380, 230),
                 BackColor = ThemeBgLight
             };
 
@@ -891,6 +905,68 @@ namespace PCMonitorClient
                 SendCommandSafe($"SET_ROTATION:{(int)numRotation.Value}");
             };
             settingsPanel.Controls.Add(btnSetRotation);
+            sY += 45;
+
+            // CPU display view (runtime only on the ESP, resets on reboot)
+            var lblCpuView = new Label
+            {
+                Text = "CPU Display View:",
+                Location = new Point(15, sY + 3),
+                AutoSize = true,
+                ForeColor = ThemeTextSecondary
+            };
+            settingsPanel.Controls.Add(lblCpuView);
+
+            var cboCpuView = new ComboBox
+            {
+                Location = new Point(150, sY),
+                Size = new Size(130, 25),
+                DropDownStyle = ComboBoxStyle.DropDownList,
+                BackColor = ThemeBgDark,
+                ForeColor = ThemeTextPrimary,
+                FlatStyle = FlatStyle.Flat
+            };
+            cboCpuView.Items.AddRange(new object[] { "Gauge", "Process List", "Alternate" });
+            cboCpuView.SelectedIndex = 0;
+            settingsPanel.Controls.Add(cboCpuView);
+
+            var btnSetCpuView = CreateStyledButton("Apply", 300, sY, 60, 25);
+            btnSetCpuView.Click += (s, e) =>
+            {
+                SendCommandSafe($"SET_VIEW:0:{cboCpuView.SelectedIndex}");
+            };
+            settingsPanel.Controls.Add(btnSetCpuView);
+            sY += 45;
+
+            // RAM display view: bar, disk I/O sparklines, or alternating
+            var lblRamView = new Label
+            {
+                Text = "RAM Display View:",
+                Location = new Point(15, sY + 3),
+                AutoSize = true,
+                ForeColor = ThemeTextSecondary
+            };
+            settingsPanel.Controls.Add(lblRamView);
+
+            var cboRamView = new ComboBox
+            {
+                Location = new Point(150, sY),
+                Size = new Size(130, 25),
+                DropDownStyle = ComboBoxStyle.DropDownList,
+                BackColor = ThemeBgDark,
+                ForeColor = ThemeTextPrimary,
+                FlatStyle = FlatStyle.Flat
+            };
+            cboRamView.Items.AddRange(new object[] { "Bar", "Storage", "Alternate" });
+            cboRamView.SelectedIndex = 0;
+            settingsPanel.Controls.Add(cboRamView);
+
+            var btnSetRamView = CreateStyledButton("Apply", 300, sY, 60, 25);
+            btnSetRamView.Click += (s, e) =>
+            {
+                SendCommandSafe($"SET_VIEW:2:{cboRamView.SelectedIndex}");
+            };
+            settingsPanel.Controls.Add(btnSetRamView);
 
             _tabDashboard.Controls.Add(settingsPanel);
         }
@@ -984,7 +1060,7 @@ namespace PCMonitorClient
             {
                 if (_displayPanels[i].HasImage && !string.IsNullOrEmpty(_displayPanels[i].ImagePath))
                 {
-                    await UploadImageAsync(_displayPanels[i].ImagePath, (ImageSlot)i);
+                    await UploadImageAsync(_displayPanels[i].ImagePath, i);
                 }
             }
         }
@@ -1250,6 +1326,101 @@ namespace PCMonitorClient
             btnSave.Click += BtnSaveProfile_Click;
             _tabProfiles.Controls.Add(btnSave);
 
+            y += 45;
+
+            // Profile slots in the device's flash (FEAT:PROF)
+            AddSectionLabel(_tabProfiles, "On Device", btnX, y);
+            y += 28;
+
+            var lblSlot = new Label
+            {
+                Text = "Slot:",
+                Location = new Point(btnX, y + 3),
+                AutoSize = true,
+                ForeColor = ThemeTextSecondary
+            };
+            _tabProfiles.Controls.Add(lblSlot);
+
+            _numDeviceSlot = new NumericUpDown
+            {
+                Location = new Point(btnX + 40, y),
+                Size = new Size(50, 25),
+                Minimum = 1,
+                Maximum = ProtocolConstants.PROFILE_SLOTS,
+                Value = 1,
+                BackColor = ThemeBgDark,
+                ForeColor = ThemeTextPrimary
+            };
+            _tabProfiles.Controls.Add(_numDeviceSlot);
+            y += 35;
+
+            var btnStore = CreateStyledButton("Store on Device", btnX, y, 130, 30);
+            btnStore.Click += BtnStoreOnDevice_Click;
+            _tabProfiles.Controls.Add(btnStore);
+
+            var btnSwitch = CreateStyledButton("Switch", btnX + 140, y, 70, 30);
+            btnSwitch.Click += BtnSwitchOnDevice_Click;
+            _tabProfiles.Controls.Add(btnSwitch);
+            y += 45;
+
+            // Image a display shows in the stored profile (PROFILE_IMG)
+            _cboProfileDisplay = new ComboBox
+            {
+                Location = new Point(btnX, y),
+                Size = new Size(60, 25),
+                DropDownStyle = ComboBoxStyle.DropDownList,
+                BackColor = ThemeBgDark,
+                ForeColor = ThemeTextPrimary,
+                FlatStyle = FlatStyle.Flat
+            };
+            _cboProfileDisplay.Items.AddRange(new object[] { "CPU", "GPU", "RAM", "NET" });
+            _cboProfileDisplay.SelectedIndex = 0;
+            _tabProfiles.Controls.Add(_cboProfileDisplay);
+
+            // 0 = compiled icon, 1..SS_IMG_LIBRARY = library image
+            _numProfileImage = new NumericUpDown
+            {
+                Location = new Point(btnX + 70, y),
+                Size = new Size(50, 25),
+                Minimum = 0,
+                Maximum = ProtocolConstants.SS_IMG_LIBRARY,
+                Value = 1,
+                BackColor = ThemeBgDark,
+                ForeColor = ThemeTextPrimary
+            };
+            _tabProfiles.Controls.Add(_numProfileImage);
+
+            var btnSetImage = CreateStyledButton("Set Image", btnX + 130, y, 80, 25);
+            btnSetImage.Click += BtnSetProfileImage_Click;
+            _tabProfiles.Controls.Add(btnSetImage);
+            y += 35;
+
+            // Image library upload (IMG_BEGIN beyond the four display slots)
+            var lblLibrary = new Label
+            {
+                Text = "Library:",
+                Location = new Point(btnX, y + 3),
+                AutoSize = true,
+                ForeColor = ThemeTextSecondary
+            };
+            _tabProfiles.Controls.Add(lblLibrary);
+
+            _numLibrarySlot = new NumericUpDown
+            {
+                Location = new Point(btnX + 70, y),
+                Size = new Size(50, 25),
+                Minimum = 1,
+                Maximum = ProtocolConstants.SS_IMG_LIBRARY,
+                Value = 5,
+                BackColor = ThemeBgDark,
+                ForeColor = ThemeTextPrimary
+            };
+            _tabProfiles.Controls.Add(_numLibrarySlot);
+
+            var btnUploadLibrary = CreateStyledButton("Upload...", btnX + 130, y, 80, 25);
+            btnUploadLibrary.Click += BtnUploadLibraryImage_Click;
+            _tabProfiles.Controls.Add(btnUploadLibrary);
+
             // Right side - Profile info
             int rightX = 450;
             y = 15;
@@ -1263,13 +1434,41 @@ namespace PCMonitorClient
                        "quickly applied to any connected Scarab device.\n\n" +
                        "When a new device is detected, you'll be\n" +
                        "prompted to apply a saved profile.\n\n" +
+                       "Store on Device keeps the selected profile\n" +
+                       "(with the current screensaver images) in a\n" +
+                       "device slot; Switch changes to it instantly.\n" +
+                       "Set Image picks the image a display shows in\n" +
+                       "that slot: 0 = icon, 1-4 = the display images,\n" +
+                       "5-16 = images uploaded to the library.\n\n" +
                        "Profile storage location:\n" +
                        ProfilesDir,
                 Location = new Point(rightX, y),
-                Size = new Size(350, 150),
+                Size = new Size(350, 230),
                 ForeColor = ThemeTextSecondary
             };
             _tabProfiles.Controls.Add(lblInfo);
+            y += 240;
+
+            // Slots in the device's flash (PROFILE_LIST)
+            AddSectionLabel(_tabProfiles, "Device Slots", rightX, y);
+            var btnRefreshDevice = CreateStyledButton("Refresh", rightX + 270, y - 3, 80, 25);
+            btnRefreshDevice.Click += async (s, e) =>
+            {
+                if (CheckDeviceProfiles()) await RefreshDeviceProfilesAsync();
+            };
+            _tabProfiles.Controls.Add(btnRefreshDevice);
+            y += 28;
+
+            _lstDeviceProfiles = new ListBox
+            {
+                Location = new Point(rightX, y),
+                Size = new Size(350, 80),
+                BackColor = ThemeBgDark,
+                ForeColor = ThemeTextPrimary,
+                BorderStyle = BorderStyle.FixedSingle,
+                SelectionMode = SelectionMode.None
+            };
+            _tabProfiles.Controls.Add(_lstDeviceProfiles);
 
             // Load profile list
             RefreshProfileList();
@@ -1381,22 +1580,219 @@ namespace PCMonitorClient
             // Send all colors to ESP if connected
             if (IsConnected?.Invoke() ?? false)
             {
-                SendCommandSafe($"SET_CLR_ARC_CPU:{ColorToHex(profile.CpuArcColor)}");
-                SendCommandSafe($"SET_CLR_ARC_GPU:{ColorToHex(profile.GpuArcColor)}");
-                SendCommandSafe($"SET_CLR_ARC_BG:{ColorToHex(profile.ArcBgColor)}");
-                SendCommandSafe($"SET_CLR_BAR_RAM:{ColorToHex(profile.RamBarColor)}");
-                SendCommandSafe($"SET_CLR_NET_DN:{ColorToHex(profile.NetDownColor)}");
-                SendCommandSafe($"SET_CLR_NET_UP:{ColorToHex(profile.NetUpColor)}");
-                SendCommandSafe($"SET_CLR_BG_NORM:0:{ColorToHex(profile.BgCpuColor)}");
-                SendCommandSafe($"SET_CLR_BG_NORM:1:{ColorToHex(profile.BgGpuColor)}");
-                SendCommandSafe($"SET_CLR_BG_NORM:2:{ColorToHex(profile.BgRamColor)}");
-                SendCommandSafe($"SET_CLR_BG_NORM:3:{ColorToHex(profile.BgNetColor)}");
+                SendProfileColors(profile);
             }
 
             MessageBox.Show($"Profile '{name}' loaded!", "Success",
                 MessageBoxButtons.OK, MessageBoxIcon.Information);
         }
 
+        private void SendProfileColors(ThemeProfile profile)
+        {
+            foreach (string command in ProfileColorCommands(profile))
+                SendCommandSafe(command);
+        }
+
+        private IEnumerable<string> ProfileColorCommands(ThemeProfile profile)
+        {
+            yield return $"SET_CLR_ARC_CPU:{ColorToHex(profile.CpuArcColor)}";
+            yield return $"SET_CLR_ARC_GPU:{ColorToHex(profile.GpuArcColor)}";
+            yield return $"SET_CLR_ARC_BG:{ColorToHex(profile.ArcBgColor)}";
+            yield return $"SET_CLR_BAR_RAM:{ColorToHex(profile.RamBarColor)}";
+            yield return $"SET_CLR_NET_DN:{ColorToHex(profile.NetDownColor)}";
+            yield return $"SET_CLR_NET_UP:{ColorToHex(profile.NetUpColor)}";
+            yield return $"SET_CLR_BG_NORM:0:{ColorToHex(profile.BgCpuColor)}";
+            yield return $"SET_CLR_BG_NORM:1:{ColorToHex(profile.BgGpuColor)}";
+            yield return $"SET_CLR_BG_NORM:2:{ColorToHex(profile.BgRamColor)}";
+            yield return $"SET_CLR_BG_NORM:3:{ColorToHex(profile.BgNetColor)}";
+        }
+
+        /// <summary>
+        /// True if a device with FEAT:PROF is connected, otherwise tells the user why not.
+        /// </summary>
+        private bool CheckDeviceProfiles()
+        {
+            if (!(IsConnected?.Invoke() ?? false))
+            {
+                MessageBox.Show("No device connected.", "Not Connected",
+                    MessageBoxButtons.OK, MessageBoxIcon.Warning);
+                return false;
+            }
+            // Replies (PROFILE_OK/PROFILE_ERR) are only matched to their command over RPC
+            var caps = GetDeviceCaps?.Invoke();
+            if (caps == null || !caps.HasFeature(DeviceCaps.FEATURE_PROFILES) || !caps.HasFeature(DeviceCaps.FEATURE_RPC))
+            {
+                MessageBox.Show("The connected firmware cannot store profiles.\nUpdate it on the Firmware tab.",
+                    "Not Supported", MessageBoxButtons.OK, MessageBoxIcon.Information);
+                return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Sends a PROFILE_* command and waits for the device's verdict.
+        /// Returns null on PROFILE_OK, otherwise the reason (PROFILE_ERR code,
+        /// timeout, ...).
+        /// </summary>
+        private async Task<string> CallProfileAsync(string command)
+        {
+            if (CallDevice == null) return "not connected";
+
+            var reply = await CallDevice(command);
+            if (!reply.Ok) return reply.Status == DeviceRpc.ReplyStatus.Unknown ? "not supported" : reply.Status.ToString();
+
+            foreach (string line in reply.Lines)
+            {
+                if (line.StartsWith(ProtocolCommands.PROFILE_OK, StringComparison.Ordinal)) return null;
+                if (line.StartsWith(ProtocolCommands.PROFILE_ERR, StringComparison.Ordinal))
+                    return line.Substring(ProtocolCommands.PROFILE_ERR.Length);
+            }
+            return "no reply";
+        }
+
+        /// <summary>Lists the device's profile slots (PROFILE_LIST).</summary>
+        private async Task RefreshDeviceProfilesAsync()
+        {
+            var reply = CallDevice == null ? null : await CallDevice(ProtocolCommands.PROFILE_LIST);
+
+            _lstDeviceProfiles.Items.Clear();
+            if (reply == null || !reply.Ok)
+            {
+                _lstDeviceProfiles.Items.Add("(no reply from the device)");
+                return;
+            }
+
+            int active = -1;
+            var names = new string[ProtocolConstants.PROFILE_SLOTS];
+            foreach (string line in reply.Lines)
+            {
+                if (line.StartsWith(ProtocolCommands.PROFILE_END, StringComparison.Ordinal))
+                {
+                    int.TryParse(line.Substring(ProtocolCommands.PROFILE_END.Length), out active);
+                    continue;
+                }
+                if (!line.StartsWith(ProtocolCommands.PROFILE, StringComparison.Ordinal)) continue;
+
+                // PROFILE:<n>:<name>:<ref>,<ref>,<ref>,<ref>
+                string[] parts = line.Substring(ProtocolCommands.PROFILE.Length).Split(new[] { ':' }, 3);
+                if (parts.Length != 3 || !int.TryParse(parts[0], out int n) || n < 0 || n >= names.Length) continue;
+
+                var images = parts[2].Split(',').Select(r => int.TryParse(r, out int v) && v >= 0 ? (v + 1).ToString() : "icon");
+                names[n] = $"{parts[1]}  [{string.Join(", ", images)}]";
+            }
+
+            for (int n = 0; n < names.Length; n++)
+            {
+                _lstDeviceProfiles.Items.Add($"{n + 1}: {names[n] ?? "(empty)"}{(n == active ? "  - active" : "")}");
+            }
+        }
+
+        /// <summary>
+        /// Applies the selected profile (the device's colour set is the live one)
+        /// and snapshots it, with the screensaver images now on the displays,
+        /// into the chosen device slot.
+        /// </summary>
+        private async void BtnStoreOnDevice_Click(object sender, EventArgs e)
+        {
+            if (_lstProfiles.SelectedItem == null)
+            {
+                MessageBox.Show("Please select a profile.", "No Selection",
+                    MessageBoxButtons.OK, MessageBoxIcon.Warning);
+                return;
+            }
+            if (!CheckDeviceProfiles()) return;
+
+            string name = _lstProfiles.SelectedItem.ToString();
+            var profile = ThemeProfile.Load(Path.Combine(ProfilesDir, name + ".profile"));
+            if (profile == null) return;
+
+            // The device keeps short names without ':' (PROFILE_NAME_MAX)
+            string deviceName = name.Replace(':', '_');
+            if (deviceName.Length > ProtocolConstants.PROFILE_NAME_MAX)
+                deviceName = deviceName.Substring(0, ProtocolConstants.PROFILE_NAME_MAX);
+
+            int slot = (int)_numDeviceSlot.Value - 1;
+
+            // The snapshot must see every colour applied
+            if (CallDevice == null) return;
+            foreach (string command in ProfileColorCommands(profile))
+                await CallDevice(command);
+
+            string error = await CallProfileAsync($"{ProtocolCommands.PROFILE_SAVE}{slot}:{deviceName}");
+            if (error != null)
+            {
+                AppendDebugLog($"Storing profile '{name}' in device slot {slot + 1} failed: {error}");
+                MessageBox.Show($"The device did not store the profile ({error}).", "Store Failed",
+                    MessageBoxButtons.OK, MessageBoxIcon.Error);
+                return;
+            }
+
+            AppendDebugLog($"Profile '{name}' stored in device slot {slot + 1}");
+            await RefreshDeviceProfilesAsync();
+        }
+
+        private async void BtnSwitchOnDevice_Click(object sender, EventArgs e)
+        {
+            if (!CheckDeviceProfiles()) return;
+
+            int slot = (int)_numDeviceSlot.Value - 1;
+            string error = await CallProfileAsync($"{ProtocolCommands.PROFILE_ACTIVATE}{slot}");
+            if (error != null)
+            {
+                AppendDebugLog($"Switching to device profile slot {slot + 1} failed: {error}");
+                return;
+            }
+
+            AppendDebugLog($"Switched to device profile slot {slot + 1}");
+            await RefreshDeviceProfilesAsync();
+        }
+
+        /// <summary>
+        /// Points one display of the stored profile in the chosen device slot
+        /// at a library image (0 = compiled icon).
+        /// </summary>
+        private async void BtnSetProfileImage_Click(object sender, EventArgs e)
+        {
+            if (!CheckDeviceProfiles()) return;
+
+            int slot = (int)_numDeviceSlot.Value - 1;
+            int display = _cboProfileDisplay.SelectedIndex;
+            int image = (int)_numProfileImage.Value - 1;        // -1 = icon
+
+            string error = await CallProfileAsync($"{ProtocolCommands.PROFILE_IMG}{slot}:{display}:{image}");
+            if (error != null)
+            {
+                AppendDebugLog($"Setting the {GetSlotName(display)} image of device slot {slot + 1} failed: {error}");
+                if (error == "EMPTY")
+                    MessageBox.Show($"Device slot {slot + 1} is empty - store a profile first.", "Empty Slot",
+                        MessageBoxButtons.OK, MessageBoxIcon.Information);
+                return;
+            }
+
+            AppendDebugLog($"Device slot {slot + 1}: {GetSlotName(display)} shows " +
+                           (image < 0 ? "its icon" : GetSlotName(image)));
+            await RefreshDeviceProfilesAsync();
+        }
+
+        /// <summary>
+        /// Uploads an image to a library slot, for profiles to reference with
+        /// Set Image. Slots 1-4 are the four display images.
+        /// </summary>
+        private async void BtnUploadLibraryImage_Click(object sender, EventArgs e)
+        {
+            if (_isUploading || !CheckDeviceProfiles()) return;
+
+            int slot = (int)_numLibrarySlot.Value - 1;
+            using (var dlg = new OpenFileDialog())
+            {
+                dlg.Title = $"Select Image for {GetSlotName(slot)}";
+                dlg.Filter = "Image Files|*.png;*.jpg;*.jpeg;*.gif;*.bmp;*.webp|All Files|*.*";
+                if (dlg.ShowDialog() != DialogResult.OK) return;
+
+                await UploadImageAsync(dlg.FileName, slot);
+            }
+        }
+
         private void BtnDeleteProfile_Click(object sender, EventArgs e)
         {
             if (_lstProfiles.SelectedItem == null)
@@ -1496,13 +1892,15 @@ namespace PCMonitorClient
                 Text = "Pushes a new firmware image to the connected device over the USB serial link.\n" +
                        "The device verifies the image (CRC32 + ESP-IDF validation), switches to the new\n" +
                        "firmware and reboots. It reconnects automatically after ~10 seconds.\n" +
+                       "'Update in Background' keeps the monitor running: the image is trickled in and the\n" +
+                       "device only restarts once it is idle (screensaver). Survives reconnects and restarts.\n" +
                        "Select the app image from 'idf.py build' (pc-monitor-poc.bin).",
                 Location = new Point(x, y),
-                Size = new Size(800, 70),
+                Size = new Size(800, 100),
                 ForeColor = ThemeTextSecondary
             };
             _tabFirmware.Controls.Add(lblInfo);
-            y += 80;
+            y += 110;
 
             _lblFwCurrentVersion = new Label
             {
@@ -1556,6 +1954,11 @@ namespace PCMonitorClient
             _btnFwFlash.FlatAppearance.BorderColor = ThemeWarning;
             _btnFwFlash.Click += async (s, e) => await FlashFirmwareAsync();
             _tabFirmware.Controls.Add(_btnFwFlash);
+
+            _btnFwStage = CreateStyledButton("Update in Background", x + 190, y, 220, 34);
+            _btnFwStage.Enabled = false;
+            _btnFwStage.Click += (s, e) => ToggleBackgroundFirmware();
+            _tabFirmware.Controls.Add(_btnFwStage);
             y += 50;
 
             _progressFw = new ProgressBar
@@ -1575,6 +1978,53 @@ namespace PCMonitorClient
                 ForeColor = ThemeTextSecondary
             };
             _tabFirmware.Controls.Add(_lblFwStatus);
+            y += 24;
+
+            _lblFwStaging = new Label
+            {
+                Text = "",
+                Location = new Point(x, y),
+                Size = new Size(800, 20),
+                ForeColor = ThemeTextSecondary
+            };
+            _tabFirmware.Controls.Add(_lblFwStaging);
+            y += 50;
+
+            var lblBenchTitle = new Label
+            {
+                Text = "DEVICE BENCHMARK",
+                Location = new Point(x, y),
+                Size = new Size(400, 22),
+                ForeColor = ThemeAccent,
+                Font = new Font("Segoe UI", 10F, FontStyle.Bold)
+            };
+            _tabFirmware.Controls.Add(lblBenchTitle);
+            y += 30;
+
+            var lblBenchInfo = new Label
+            {
+                Text = "Runs the self-benchmark on the device (render, SPI flush, CRC32, parsing, LittleFS).\n" +
+                       "Results are kept per firmware version and compared with the previous one.",
+                Location = new Point(x, y),
+                Size = new Size(800, 36),
+                ForeColor = ThemeTextSecondary
+            };
+            _tabFirmware.Controls.Add(lblBenchInfo);
+            y += 42;
+
+            _btnBench = CreateStyledButton("Run Benchmark", x, y, 180, 30);
+            _btnBench.Enabled = false;
+            _btnBench.Click += async (s, e) => await RunDeviceBenchmarkAsync();
+            _tabFirmware.Controls.Add(_btnBench);
+
+            _lblBenchStatus = new Label
+            {
+                Text = "",
+                Location = new Point(x + 190, y + 6),
+                Size = new Size(610, 20),
+                ForeColor = ThemeTextSecondary
+            };
+            _tabFirmware.Controls.Add(_lblBenchStatus);
         }
 
         private void BrowseFirmwareFile()
@@ -1608,8 +2058,60 @@ namespace PCMonitorClient
             bool connected = IsConnected?.Invoke() ?? false;
             _btnFwFlash.Enabled = connected
                 && !_isFlashingFirmware
+                && !_isBenchmarking
                 && !_isUploading
                 && !string.IsNullOrEmpty(_txtFwPath.Text);
+
+            // Background staging: start (device must offer FEAT:STAGE) or cancel the queued job
+            bool hasJob = HasFirmwareStagingJob?.Invoke() ?? false;
+            bool canStage = GetDeviceCaps?.Invoke()?.HasFeature(DeviceCaps.FEATURE_STAGED_OTA) ?? false;
+            _btnFwStage.Text = hasJob ? "Cancel Background Update" : "Update in Background";
+            _btnFwStage.Enabled = !_isFlashingFirmware && (hasJob
+                || (connected && canStage && !_isUploading && !string.IsNullOrEmpty(_txtFwPath.Text)));
+
+            bool canBench = GetDeviceCaps?.Invoke()?.HasFeature(DeviceCaps.FEATURE_BENCH) ?? false;
+            _btnBench.Enabled = connected && canBench && !_isBenchmarking && !_isFlashingFirmware && !_isUploading;
+        }
+
+        private void ToggleBackgroundFirmware()
+        {
+            if (HasFirmwareStagingJob?.Invoke() ?? false)
+            {
+                CancelFirmwareStaging?.Invoke();
+                AppendDebugLog("=== Background firmware update cancelled ===");
+                UpdateFirmwareButtonState();
+                return;
+            }
+
+            string path = _txtFwPath.Text;
+            if (string.IsNullOrEmpty(path)) return;
+
+            string error = StageFirmware?.Invoke(path) ?? "Background update not available.";
+            if (error != null)
+            {
+                SetFwStatus("Cannot start background update: " + error, false);
+                return;
+            }
+
+            AppendDebugLog($"=== Background firmware update queued: {Path.GetFileName(path)} ===");
+            SetFwStatus("Background update running - the monitor keeps working meanwhile.", true);
+            UpdateFirmwareButtonState();
+        }
+
+        /// <summary>
+        /// Shows the background staging state (FirmwareStager.StatusChanged). Thread-safe.
+        /// </summary>
+        public void SetFwStagingStatus(string status)
+        {
+            if (InvokeRequired)
+            {
+                BeginInvoke((MethodInvoker)delegate { SetFwStagingStatus(status); });
+                return;
+            }
+            if (_lblFwStaging == null) return;
+
+            _lblFwStaging.Text = status;
+            UpdateFirmwareButtonState();
         }
 
         private async Task FlashFirmwareAsync()
@@ -1642,24 +2144,21 @@ namespace PCMonitorClient
 
             if (confirm != DialogResult.Yes) return;
 
-            var port = GetSerialPort?.Invoke();
-            if (port == null || !port.IsOpen)
-            {
-                SetFwStatus("Error: Port not open", false);
-                return;
-            }
-
             _isFlashingFirmware = true;
             UpdateFirmwareButtonState();
             _btnFwBrowse.Enabled = false;
-            SetUploadMode?.Invoke(true);
-
-            // Wait for the data loop to finish any in-flight transmission
-            await Task.Delay(300);
+            PortLease lease = null;
 
             try
             {
-                var uploader = new FirmwareUploader(port, GetPortWriteLock?.Invoke());
+                lease = AcquirePort == null ? null : await AcquirePort(PortUse.FirmwareFlash);
+                if (lease == null)
+                {
+                    SetFwStatus("Error: Port not open", false);
+                    return;
+                }
+
+                var uploader = new FirmwareUploader(lease, GetPortWriteLock?.Invoke(), GetDeviceCaps?.Invoke());
                 uploader.LogMessage += (s, msg) => AppendDebugLog($"[FW] {msg}");
                 uploader.ProgressChanged += (s, p) =>
                 {
@@ -1694,7 +2193,7 @@ namespace PCMonitorClient
             finally
             {
                 _isFlashingFirmware = false;
-                SetUploadMode?.Invoke(false);
+                lease?.Dispose();
                 BeginInvoke((MethodInvoker)delegate
                 {
                     _btnFwBrowse.Enabled = true;
@@ -1703,6 +2202,78 @@ namespace PCMonitorClient
             }
         }
 
+        private async Task RunDeviceBenchmarkAsync()
+        {
+            _isBenchmarking = true;
+            UpdateFirmwareButtonState();
+            PortLease lease = null;
+
+            try
+            {
+                lease = AcquirePort == null ? null : await AcquirePort(PortUse.Benchmark);
+                if (lease == null)
+                {
+                    SetBenchStatus("Error: Port not open", false);
+                    return;
+                }
+
+                SetBenchStatus("Running on the device...", true);
+                var bench = new DeviceBenchmark(lease, GetPortWriteLock?.Invoke());
+                bench.LogMessage += (s, msg) => AppendDebugLog($"[Bench] {msg}");
+
+                var report = await bench.RunAsync();
+                if (report == null)
+                {
+                    SetBenchStatus("Benchmark failed - see debug log.", false);
+                    return;
+                }
+
+                AppendDebugLog($"=== Device benchmark, firmware {report.FirmwareVersion} ({report.TotalMs} ms) ===");
+                foreach (string line in report.Lines)
+                    AppendDebugLog(line);
+
+                var previous = DeviceBenchmark.LoadPrevious(report.FirmwareVersion);
+                DeviceBenchmark.Save(report);
+
+                if (previous == null)
+                {
+                    SetBenchStatus($"{report.Cases.Count} cases in {report.TotalMs} ms - saved as baseline for v{report.FirmwareVersion}.", true);
+                    return;
+                }
+
+                var regressions = DeviceBenchmark.FindRegressions(previous, report);
+                foreach (string r in regressions)
+                    AppendDebugLog($"[Bench] Slower than v{previous.FirmwareVersion}: {r}");
+
+                SetBenchStatus(regressions.Count == 0
+                    ? $"{report.Cases.Count} cases in {report.TotalMs} ms - no regressions vs v{previous.FirmwareVersion}."
+                    : $"{regressions.Count} case(s) slower than v{previous.FirmwareVersion} - see debug log.",
+                    regressions.Count == 0);
+            }
+            catch (Exception ex)
+            {
+                AppendDebugLog($"=== BENCH EXCEPTION: {ex.Message} ===");
+                SetBenchStatus("Error: " + ex.Message, false);
+            }
+            finally
+            {
+                _isBenchmarking = false;
+                lease?.Dispose();
+                BeginInvoke((MethodInvoker)UpdateFirmwareButtonState);
+            }
+        }
+
+        private void SetBenchStatus(string message, bool ok)
+        {
+            if (InvokeRequired)
+            {
+                BeginInvoke((MethodInvoker)delegate { SetBenchStatus(message, ok); });
+                return;
+            }
+            _lblBenchStatus.Text = message;
+            _lblBenchStatus.ForeColor = ok ? ThemeTextSecondary : ThemeError;
+        }
+
         private void SetFwStatus(string message, bool ok)
         {
             if (InvokeRequired)
@@ -1718,7 +2289,7 @@ namespace PCMonitorClient
 
         #region Image Upload
 
-        private async Task UploadImageAsync(string filePath, ImageSlot slot)
+        private async Task UploadImageAsync(string filePath, int slot)
         {
             if (_isFlashingFirmware)
             {
@@ -1729,33 +2300,31 @@ namespace PCMonitorClient
             // Immediate debug output
             AppendDebugLog($"UploadImageAsync called: file={Path.GetFileName(filePath)}, slot={slot}");
 
-            if (GetSerialPort == null)
+            if (AcquirePort == null)
             {
-                AppendDebugLog("ERROR: GetSerialPort delegate is null");
+                AppendDebugLog("ERROR: AcquirePort delegate is null");
                 UpdateUploadStatus("Error: No serial port", false);
                 return;
             }
 
-            var port = GetSerialPort();
-            if (port == null || !port.IsOpen)
-            {
-                AppendDebugLog($"ERROR: Port is null={port == null} or not open");
-                UpdateUploadStatus("Error: Port not open", false);
-                return;
-            }
-
-            AppendDebugLog($"Port {port.PortName} is open, starting upload process...");
-
             _isUploading = true;
             _uploadCts = new CancellationTokenSource();
-            SetUploadMode?.Invoke(true);
-
-            // Wait for data loop to pause (avoid race condition with PC stats transmission)
-            await Task.Delay(200);
+            PortLease lease = null;
 
             try
             {
-                var uploader = new ImageUploader(port, GetPortWriteLock?.Invoke());
+                // Pauses the data loop and waits for any stats line in flight
+                lease = await AcquirePort(PortUse.ImageUpload);
+                if (lease == null)
+                {
+                    AppendDebugLog("ERROR: Port not open");
+                    UpdateUploadStatus("Error: Port not open", false);
+                    return;
+                }
+
+                AppendDebugLog("Port held, starting upload process...");
+
+                var uploader = new ImageUploader(lease, GetPortWriteLock?.Invoke(), GetDeviceCaps?.Invoke());
                 AppendDebugLog("ImageUploader instance created, subscribing to events...");
 
                 // Subscribe to LogMessage for debug output
@@ -1766,12 +2335,12 @@ namespace PCMonitorClient
                     BeginInvoke((MethodInvoker)delegate
                     {
                         _progressUpload.Value = (int)p.PercentComplete;
-                        _lblUploadStatus.Text = $"Uploading {GetSlotName((int)slot)}: {p.BytesSent:N0}/{p.TotalBytes:N0} ({p.PercentComplete:F0}%)";
+                        _lblUploadStatus.Text = $"Uploading {GetSlotName(slot)}: {p.BytesSent:N0}/{p.TotalBytes:N0} ({p.PercentComplete:F0}%)";
                     });
                 };
 
                 AppendDebugLog($"=== Starting upload: {Path.GetFileName(filePath)} -> Slot {slot} ===");
-                UpdateUploadStatus($"Converting image for {GetSlotName((int)slot)}...", true);
+                UpdateUploadStatus($"Converting image for {GetSlotName(slot)}...", true);
                 _progressUpload.Value = 0;
 
                 bool success = await uploader.UploadImageAsync(filePath, slot, _uploadCts.Token);
@@ -1787,7 +2356,7 @@ namespace PCMonitorClient
             finally
             {
                 _isUploading = false;
-                SetUploadMode?.Invoke(false);
+                lease?.Dispose();
 
                 await Task.Delay(3000);
                 if (!_isUploading)
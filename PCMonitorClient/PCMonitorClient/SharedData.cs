@@ -0,0 +1,87 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Security.AccessControl;
+using System.Security.Principal;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// %ProgramData%\ScarabMonitor\shared: passive caches that describe the
+    /// machine and the device rather than the user - sensor map, device
+    /// capabilities. The tray app and the service (LocalSystem, whose
+    /// %AppData% is a different folder) share them, so whichever starts
+    /// first does the discovery for both. A tampered file costs at most a
+    /// rediscovery or a caps query.
+    ///
+    /// Nothing the service acts on belongs here. User settings (profiles,
+    /// alert_rules.txt, metrics.txt, benchmark results) and the queued
+    /// firmware update stay in the user's %AppData%; headless.ini stays one
+    /// level up, writable by admins only - the service runs what they say.
+    /// </summary>
+    internal static class SharedData
+    {
+        public static readonly string Dir = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.CommonApplicationData), "ScarabMonitor", "shared");
+
+        private static readonly string LegacyDir = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData), "ScarabMonitor");
+
+        /// <summary>
+        /// Path of a shared file. A copy the same user's earlier version left
+        /// in %AppData% is carried over the first time, so the cache survives
+        /// the move.
+        /// </summary>
+        public static string PathOf(string fileName)
+        {
+            string path = Path.Combine(Dir, fileName);
+            try
+            {
+                string legacy = Path.Combine(LegacyDir, fileName);
+                if (!File.Exists(path) && File.Exists(legacy))
+                {
+                    WriteAllLines(path, File.ReadAllLines(legacy));     // Not File.Move: that keeps the profile's ACL
+                    File.Delete(legacy);
+                }
+            }
+            catch { /* read-only or taken - the file is rebuilt */ }
+            return path;
+        }
+
+        /// <summary>Creates the folder (inherits the %ProgramData% defaults).</summary>
+        public static void EnsureDirectory()
+        {
+            Directory.CreateDirectory(Dir);
+        }
+
+        /// <summary>
+        /// Writes a shared cache. Files in %ProgramData% belong to the process
+        /// that created them, so a new file grants Users modify rights on
+        /// itself - the service's cache can be refreshed by a tray app without
+        /// admin, and back. Nothing is inherited from the folder: a file the
+        /// process did not write through here stays as it was.
+        /// </summary>
+        public static void WriteAllLines(string path, IEnumerable<string> lines)
+        {
+            EnsureDirectory();
+            bool created = !File.Exists(path);
+            File.WriteAllLines(path, lines);
+            if (!created) return;
+
+            try
+            {
+                var info = new FileInfo(path);
+                var acl = info.GetAccessControl();
+                acl.AddAccessRule(new FileSystemAccessRule(
+                    new SecurityIdentifier(WellKnownSidType.BuiltinUsersSid, null),
+                    FileSystemRights.Modify,
+                    AccessControlType.Allow));
+                info.SetAccessControl(acl);
+            }
+            catch (Exception ex)
+            {
+                Console.WriteLine("  [Data]     Could not open " + path + " to all users: " + ex.Message);
+            }
+        }
+    }
+}
@@ -1,4 +1,5 @@
 using System;
+using System.Text;
 
 namespace PCMonitorClient
 {
@@ -21,5 +22,34 @@ namespace PCMonitorClient
         // Network (MB/s) - 0 is valid (idle), -1 = error
         public float NetDown { get; set; } = 0f;
         public float NetUp { get; set; } = 0f;
+
+        // Primary interface link info, refreshed on network change events
+        public string NetType { get; set; } = "LAN";
+        public string NetSpeed { get; set; } = "1000 Mbps";
+
+        // Disk I/O, sum over all physical disks (-1 = no disk counters)
+        public float DiskReadMBps { get; set; } = -1f;
+        public float DiskWriteMBps { get; set; } = -1f;
+        public float DiskReadIops { get; set; } = -1f;
+        public float DiskWriteIops { get; set; } = -1f;
+        public float DiskQueue { get; set; } = -1f;
+        public float DiskLatencyMs { get; set; } = -1f;
+
+        /// <summary>
+        /// Writes the stats line (incl. '\n') sent to the ESP32 every cycle.
+        /// dst must hold StatsFrame.MAX_LENGTH bytes. Returns the byte count.
+        /// Layout comes from protocol/scarab_protocol.def, like the ESP parser.
+        /// </summary>
+        public int EncodeTelemetry(Span<byte> dst) => StatsFrame.Encode(this, dst);
+
+        /// <summary>
+        /// Stats line as a string (status display, logs).
+        /// </summary>
+        public string ToTelemetryLine()
+        {
+            var buf = new byte[StatsFrame.MAX_LENGTH];
+            int len = StatsFrame.Encode(this, buf);
+            return Encoding.ASCII.GetString(buf, 0, len);
+        }
     }
 }
@@ -0,0 +1,231 @@
+using System;
+using System.Collections.Concurrent;
+using System.IO;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace PCMonitorClient
+{
+    /// <summary>
+    /// Read and encode stages of a chunked upload, running ahead of the
+    /// sender (ChunkedSerialUploader) on a background task:
+    ///
+    ///   source stream -> read chunk -> CRC32 of the whole payload
+    ///                 -> DATA line (hex [+ chunk CRC]) -> bounded queue -> sender
+    ///
+    /// The queue holds at most Depth encoded lines, so memory stays flat
+    /// whatever the payload size, and the first chunk is ready as soon as it
+    /// has been read. The payload CRC is computed on the way through; every
+    /// byte is hashed exactly once, in order, so resends and resyncs do not
+    /// disturb it.
+    ///
+    /// Resends after a NAK or an offset resync call RestartAsync, which drops
+    /// the queued lines and seeks the source - it must be seekable.
+    ///
+    /// The device only takes hex (GET_CAPS ENC:HEX), so encoding is the
+    /// only transform between read and send.
+    /// </summary>
+    internal sealed class UploadPipeline
+    {
+        /// <summary>Encoded lines kept ready ahead of the sender.</summary>
+        public const int DEFAULT_DEPTH = 4;
+
+        private const int HASH_BLOCK = 64 * 1024;
+
+        private readonly Stream _source;
+        private readonly int _length;
+        private readonly string _prefix;
+        private readonly int _chunkSize;
+        private readonly bool _chunkCrc;
+        private readonly int _depth;
+
+        // Payload CRC: bytes [0, _hashedTo) are in _crc (producer only)
+        private uint _crc = ImageConverter.CRC32_INIT;
+        private int _hashedTo;
+
+        // Current producer run
+        private CancellationTokenSource _cts;
+        private Task _producer;
+        private ConcurrentQueue<Chunk> _queue;
+        private SemaphoreSlim _items;
+        private SemaphoreSlim _space;
+
+        /// <summary>One encoded DATA line.</summary>
+        public sealed class Chunk
+        {
+            public int Offset;
+            public int Size;
+            public string Line;         // Incl. newline, null if Error is set
+            public string Error;        // Read failed or the source ended early
+        }
+
+        /// <param name="source">Seekable payload stream, read from position 0</param>
+        /// <param name="length">Payload bytes (taken from the source from offset 0)</param>
+        /// <param name="prefix">"IMG" or "FW"</param>
+        /// <param name="chunkSize">Payload bytes per DATA line</param>
+        /// <param name="chunkCrc">Append the chunk CRC (FEAT:CRC)</param>
+        /// <param name="depth">Lines encoded ahead of the sender</param>
+        public UploadPipeline(Stream source, int length, string prefix, int chunkSize, bool chunkCrc,
+                              int depth = DEFAULT_DEPTH)
+        {
+            _source = source ?? throw new ArgumentNullException(nameof(source));
+            if (!source.CanSeek) throw new ArgumentException("Upload source must be seekable", nameof(source));
+            _length = length;
+            _prefix = prefix;
+            _chunkSize = chunkSize;
+            _chunkCrc = chunkCrc;
+            _depth = Math.Max(1, depth);
+        }
+
+        /// <summary>
+        /// (Re)starts reading at offset; lines queued for other offsets are
+        /// dropped. Bytes before offset that were never hashed are read and
+        /// hashed first (resume, forward resync).
+        /// </summary>
+        public async Task RestartAsync(int offset)
+        {
+            await StopAsync();
+
+            _cts = new CancellationTokenSource();
+            _queue = new ConcurrentQueue<Chunk>();
+            _items = new SemaphoreSlim(0);
+            _space = new SemaphoreSlim(_depth);
+
+            var token = _cts.Token;
+            _producer = Task.Run(() => Produce(offset, token));
+        }
+
+        /// <summary>Next line in offset order, starting at the last restart offset.</summary>
+        public async Task<Chunk> NextAsync(CancellationToken ct)
+        {
+            await _items.WaitAsync(ct);
+            _queue.TryDequeue(out Chunk chunk);
+            _space.Release();
+            return chunk;
+        }
+
+        /// <summary>
+        /// Waits until every payload byte has been hashed and returns the
+        /// CRC32, or null if the source ended early or could not be read.
+        /// </summary>
+        public async Task<uint?> FinishAsync()
+        {
+            // The producer stops on its own after the last chunk; it may
+            // still be hashing a gap after a forward resync to the end
+            if (_producer != null)
+            {
+                try { await _producer; } catch (OperationCanceledException) { }
+            }
+            return _hashedTo == _length ? ~_crc : (uint?)null;
+        }
+
+        /// <summary>
+        /// Stops the producer. Call before the source is closed.
+        /// </summary>
+        public async Task StopAsync()
+        {
+            if (_producer == null) return;
+
+            _cts.Cancel();
+            try { await _producer; } catch (OperationCanceledException) { }
+            _cts.Dispose();
+            _producer = null;
+        }
+
+        // ====================================================================
+        //  PRODUCER (background task)
+        // ====================================================================
+
+        private async Task Produce(int offset, CancellationToken ct)
+        {
+            try
+            {
+                if (offset > _hashedTo) HashGap(offset, ct);
+
+                _source.Seek(offset, SeekOrigin.Begin);
+                while (offset < _length)
+                {
+                    await _space.WaitAsync(ct);
+
+                    int size = Math.Min(_chunkSize, _length - offset);
+                    var data = new byte[size];
+                    if (ReadFully(data, size) != size)
+                    {
+                        Emit(new Chunk { Offset = offset, Error = $"source ended at {offset} of {_length} bytes" });
+                        return;
+                    }
+
+                    // Only bytes not hashed before (resends re-read old ones)
+                    if (offset <= _hashedTo && offset + size > _hashedTo)
+                    {
+                        int skip = _hashedTo - offset;
+                        _crc = ImageConverter.UpdateCrc32(_crc, data, skip, size - skip);
+                        _hashedTo = offset + size;
+                    }
+
+                    Emit(new Chunk { Offset = offset, Size = size, Line = Encode(offset, data) });
+                    offset += size;
+                }
+            }
+            catch (OperationCanceledException)
+            {
+                throw;
+            }
+            catch (Exception ex)
+            {
+                Emit(new Chunk { Offset = offset, Error = "read failed: " + ex.Message });
+            }
+        }
+
+        /// <summary>Hashes [_hashedTo, offset) without encoding it.</summary>
+        private void HashGap(int offset, CancellationToken ct)
+        {
+            _source.Seek(_hashedTo, SeekOrigin.Begin);
+            var block = new byte[Math.Min(HASH_BLOCK, offset - _hashedTo)];
+
+            while (_hashedTo < offset)
+            {
+                ct.ThrowIfCancellationRequested();
+                int n = ReadFully(block, Math.Min(block.Length, offset - _hashedTo));
+                if (n == 0) throw new EndOfStreamException($"source ended at {_hashedTo} of {_length} bytes");
+                _crc = ImageConverter.UpdateCrc32(_crc, block, 0, n);
+                _hashedTo += n;
+            }
+        }
+
+        private int ReadFully(byte[] buffer, int count)
+        {
+            int total = 0;
+            int n;
+            while (total < count && (n = _source.Read(buffer, total, count - total)) > 0)
+            {
+                total += n;
+            }
+            return total;
+        }
+
+        private void Emit(Chunk chunk)
+        {
+            _queue.Enqueue(chunk);
+            _items.Release();
+        }
+
+        private string Encode(int offset, byte[] data)
+        {
+            var sb = new StringBuilder(_prefix.Length + 24 + data.Length * 2);
+            sb.Append(_prefix).Append("_DATA:").Append(offset).Append(':');
+            foreach (byte b in data)
+            {
+                sb.Append(HexDigits[b >> 4]).Append(HexDigits[b & 0xF]);
+            }
+            if (_chunkCrc)
+            {
+                sb.Append(':').Append(ImageConverter.ComputeCrc32(data, 0, data.Length).ToString("X8"));
+            }
+            return sb.Append('\n').ToString();
+        }
+
+        private const string HexDigits = "0123456789ABCDEF";
+    }
+}
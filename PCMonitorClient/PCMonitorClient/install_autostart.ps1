@@ -3,6 +3,7 @@
 
 $exeName = "PCMonitorClient.exe"
 $taskName = "ScarabMonitor_Autostart"
+$serviceName = "ScarabMonitor"
 $scriptPath = $PSScriptRoot
 $exePath = "$scriptPath\$exeName"
 
@@ -22,6 +23,7 @@ Write-Host ""
 Write-Host "[1] Install Full Mode (Admin Task)"
 Write-Host "[2] Install Lite Mode (Registry Run)"
 Write-Host "[3] Uninstall All"
+Write-Host "[4] Install Headless Service (no tray, config: %ProgramData%\ScarabMonitor\headless.ini)"
 Write-Host "[Q] Quit"
 Write-Host ""
 
@@ -30,6 +32,10 @@ $choice = Read-Host "Select option"
 # Cleanup
 Unregister-ScheduledTask -TaskName $taskName -Confirm:$false -ErrorAction SilentlyContinue
 Remove-ItemProperty -Path "HKCU:\Software\Microsoft\Windows\CurrentVersion\Run" -Name "ScarabMonitor" -ErrorAction SilentlyContinue
+if (Get-Service -Name $serviceName -ErrorAction SilentlyContinue) {
+    Stop-Service -Name $serviceName -Force -ErrorAction SilentlyContinue
+    Start-Process "sc.exe" -ArgumentList "delete $serviceName" -Wait -NoNewWindow
+}
 
 if ($choice -eq "1") {
     Write-Host "Installing Full Mode..." -ForegroundColor Yellow
@@ -75,6 +81,24 @@ elseif ($choice -eq "2") {
         Write-Host "ERROR: Registry Write Failed." -ForegroundColor Red
     }
 }
+elseif ($choice -eq "4") {
+    Write-Host "Installing Headless Service..." -ForegroundColor Yellow
+
+    # LocalSystem = Full Mode sensors, starts before logon, no UI
+    $binPath = """$exePath"" --service"
+    New-Service -Name $serviceName -BinaryPathName $binPath -DisplayName "Scarab Monitor" `
+        -Description "Streams PC stats to the Scarab display (headless)" -StartupType Automatic -ErrorAction SilentlyContinue | Out-Null
+
+    if (Get-Service -Name $serviceName -ErrorAction SilentlyContinue) {
+        Start-Service -Name $serviceName -ErrorAction SilentlyContinue
+        Write-Host ""
+        Write-Host "SUCCESS: Headless service installed! Log: $env:ProgramData\ScarabMonitor\headless.log" -ForegroundColor Green
+    }
+    else {
+        Write-Host ""
+        Write-Host "ERROR: Service could not be created." -ForegroundColor Red
+    }
+}
 elseif ($choice -eq "3") {
     Write-Host "Uninstalled successfully." -ForegroundColor Green
 }
@@ -0,0 +1,312 @@
+/**
+ * @file alert_rules.c
+ * @brief Threshold rules engine - compile, evaluate, persist
+ */
+
+#include "alert_rules.h"
+#include "metric_vm.h"
+#include "drivers/usb_serial_comm.h"
+#include "ui/ui_manager.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "esp_log.h"
+
+static const char *TAG = "ALERTS";
+
+/* Uploaded table, stored verbatim (the built-in table is never stored) */
+#define ALERT_RULES_PATH        "/storage/alert_rules.txt"
+#define ALERT_TABLE_TEXT_MAX    1024
+
+/* Compiled rule. Hysteresis is folded into two levels so evaluation is one
+ * compare: a rule fires past on_level and releases back past off_level. */
+typedef struct {
+    uint8_t metric;             /* alert_metric_t */
+    uint8_t action;             /* alert_action_t */
+    uint8_t target;             /* alert_target_t, display index for VIEW */
+    bool below;                 /* '<' rule */
+    float on_level;
+    float off_level;
+    uint32_t hold_ms;
+    uint32_t arg;
+
+    /* Runtime state */
+    bool active;
+    bool pending;               /* Condition met, hold time running */
+    uint32_t since_ms;
+} alert_rule_t;
+
+static alert_rule_t s_rules[ALERT_MAX_RULES];
+static int s_rule_count = 0;
+
+/* Text of the table in use - lets a client re-send its table on every
+ * connect without rewriting flash. "" is a valid (empty) table. */
+#define ALERT_TABLE_DEFAULT     "DEFAULT"
+static char s_table_text[ALERT_TABLE_TEXT_MAX] = ALERT_TABLE_DEFAULT;
+
+/* Built-in table: the former fixed temperature colours */
+static const char DEFAULT_TABLE[] =
+    "1,>,60,0,0,0,0,1000001;"   /* CPU > 60C -> theme warm */
+    "1,>,70,0,0,0,0,1000002;"   /* CPU > 70C -> theme hot */
+    "3,>,65,0,0,0,1,1000001;"   /* GPU > 65C -> theme warm */
+    "3,>,75,0,0,0,1,1000002";   /* GPU > 75C -> theme hot */
+
+/* =============================================================================
+ * COMPILER
+ * ========================================================================== */
+
+/* Parses one "m,op,thr,hyst,hold,action,target,arg" rule ending at '\0' or ';' */
+static bool compile_rule(const char *p, alert_rule_t *r)
+{
+    char *end;
+    memset(r, 0, sizeof(*r));
+
+    long metric = strtol(p, &end, 10);
+    if (end == p || *end != ',' || metric < 0) return false;
+    if (metric > ALERT_METRIC_DISK_LATENCY &&
+        (metric < ALERT_METRIC_CUSTOM || metric >= ALERT_METRIC_CUSTOM + METRIC_MAX_SLOTS)) return false;
+    p = end + 1;
+
+    if (*p != '>' && *p != '<') return false;
+    r->below = (*p == '<');
+    if (p[1] != ',') return false;
+    p += 2;
+
+    float threshold = strtof(p, &end);
+    if (end == p || *end != ',') return false;
+    p = end + 1;
+
+    float hysteresis = strtof(p, &end);
+    if (end == p || *end != ',' || hysteresis < 0.0f) return false;
+    p = end + 1;
+
+    unsigned long hold = strtoul(p, &end, 10);
+    if (end == p || *end != ',') return false;
+    p = end + 1;
+
+    long action = strtol(p, &end, 10);
+    if (end == p || *end != ',' || action < 0 || action > ALERT_ACTION_VIEW) return false;
+    p = end + 1;
+
+    long target = strtol(p, &end, 10);
+    if (end == p || *end != ',' || target < 0) return false;
+    if (action == ALERT_ACTION_VIEW ? target >= SCREEN_COUNT : target >= ALERT_TARGET_COUNT) return false;
+    p = end + 1;
+
+    unsigned long arg = strtoul(p, &end, 16);
+    if (end == p || (*end != '\0' && *end != ';')) return false;
+    if (action == ALERT_ACTION_VIEW && arg != UI_VIEW_NORMAL && arg != UI_VIEW_ALT) return false;
+
+    r->metric = (uint8_t)metric;
+    r->action = (uint8_t)action;
+    r->target = (uint8_t)target;
+    r->on_level = threshold;
+    r->off_level = r->below ? threshold + hysteresis : threshold - hysteresis;
+    r->hold_ms = (uint32_t)hold;
+    r->arg = (uint32_t)arg;
+    return true;
+}
+
+/* Compiles a whole table into s_rules. Leaves the current table untouched
+ * and returns the index of the bad rule (>= 0) on error, -1 on success. */
+static int compile_table(const char *text)
+{
+    static alert_rule_t compiled[ALERT_MAX_RULES];
+    int count = 0;
+
+    for (const char *p = text; *p; ) {
+        if (count == ALERT_MAX_RULES || !compile_rule(p, &compiled[count])) {
+            return count;
+        }
+        count++;
+
+        const char *next = strchr(p, ';');
+        if (!next) break;
+        p = next + 1;
+    }
+
+    memcpy(s_rules, compiled, sizeof(compiled[0]) * count);
+    s_rule_count = count;
+    return -1;
+}
+
+/* =============================================================================
+ * PERSISTENCE
+ * ========================================================================== */
+
+void alert_rules_init(void)
+{
+    FILE *f = fopen(ALERT_RULES_PATH, "r");
+    if (f != NULL) {
+        if (fgets(s_table_text, sizeof(s_table_text), f) == NULL) {
+            s_table_text[0] = '\0';
+        }
+        fclose(f);
+
+        char *nl = strchr(s_table_text, '\n');
+        if (nl) *nl = '\0';
+
+        if (compile_table(s_table_text) < 0) {
+            ESP_LOGI(TAG, "Loaded %d alert rules", s_rule_count);
+            return;
+        }
+        ESP_LOGW(TAG, "Stored alert rules invalid, using built-in");
+        strcpy(s_table_text, ALERT_TABLE_DEFAULT);
+    }
+
+    compile_table(DEFAULT_TABLE);
+    ESP_LOGI(TAG, "Using %d built-in alert rules", s_rule_count);
+}
+
+static void save_table(void)
+{
+    if (strcmp(s_table_text, ALERT_TABLE_DEFAULT) == 0) {
+        remove(ALERT_RULES_PATH);
+        return;
+    }
+
+    FILE *f = fopen(ALERT_RULES_PATH, "w");
+    if (f != NULL) {
+        fprintf(f, "%s\n", s_table_text);
+        fclose(f);
+    } else {
+        ESP_LOGE(TAG, "Failed to save alert_rules.txt");
+    }
+}
+
+/* =============================================================================
+ * EVALUATION
+ * ========================================================================== */
+
+/* Sensor value, NAN when N/A (stats use negative values for that) */
+static inline float sensor(float v)
+{
+    return v < 0.0f ? NAN : v;
+}
+
+/* Metric value, NAN when N/A. Custom metrics may be negative. */
+static float metric_value(const pc_stats_t *s, uint8_t metric)
+{
+    switch (metric) {
+        case ALERT_METRIC_CPU_LOAD:     return sensor(s->cpu_percent);
+        case ALERT_METRIC_CPU_TEMP:     return sensor(s->cpu_temp);
+        case ALERT_METRIC_GPU_LOAD:     return sensor(s->gpu_percent);
+        case ALERT_METRIC_GPU_TEMP:     return sensor(s->gpu_temp);
+        case ALERT_METRIC_RAM_PCT:
+            return (s->ram_total_gb > 0.0f && s->ram_used_gb >= 0.0f)
+                   ? s->ram_used_gb * 100.0f / s->ram_total_gb : NAN;
+        case ALERT_METRIC_VRAM_PCT:
+            return (s->gpu_vram_total > 0.0f && s->gpu_vram_used >= 0.0f)
+                   ? s->gpu_vram_used * 100.0f / s->gpu_vram_total : NAN;
+        case ALERT_METRIC_NET_DOWN:     return sensor(s->net_down_mbps);
+        case ALERT_METRIC_NET_UP:       return sensor(s->net_up_mbps);
+        case ALERT_METRIC_DISK_QUEUE:   return sensor(s->disk_queue);
+        case ALERT_METRIC_DISK_LATENCY: return sensor(s->disk_latency_ms);
+        default:
+            return metric >= ALERT_METRIC_CUSTOM ? metric_vm_value(metric - ALERT_METRIC_CUSTOM) : NAN;
+    }
+}
+
+static bool same_outputs(const alert_state_t *a, const alert_state_t *b)
+{
+    return a->color_mask == b->color_mask && a->blink_mask == b->blink_mask &&
+           memcmp(a->color, b->color, sizeof(a->color)) == 0 &&
+           memcmp(a->force_view, b->force_view, sizeof(a->force_view)) == 0;
+}
+
+void alert_rules_evaluate(const pc_stats_t *stats, uint32_t now_ms, alert_state_t *out)
+{
+    alert_state_t next;
+    memset(&next, 0, sizeof(next));
+    memset(next.force_view, ALERT_NO_VIEW, sizeof(next.force_view));
+
+    for (int i = 0; i < s_rule_count; i++) {
+        alert_rule_t *r = &s_rules[i];
+        float v = metric_value(stats, r->metric);
+        float level = r->active ? r->off_level : r->on_level;
+        bool met = !isnan(v) && (r->below ? v < level : v > level);
+
+        if (!met) {
+            r->active = false;
+            r->pending = false;
+            continue;
+        }
+        if (!r->active) {
+            if (!r->pending) {
+                r->pending = true;
+                r->since_ms = now_ms;
+            }
+            if (now_ms - r->since_ms < r->hold_ms) continue;
+            r->active = true;
+        }
+
+        /* Later rules override earlier ones on the same target */
+        switch (r->action) {
+            case ALERT_ACTION_COLOR:
+                next.color_mask |= (uint8_t)(1u << r->target);
+                next.color[r->target] = r->arg;
+                break;
+            case ALERT_ACTION_BLINK:
+                next.blink_mask |= (uint8_t)(1u << r->target);
+                break;
+            case ALERT_ACTION_VIEW:
+                next.force_view[r->target] = (int8_t)r->arg;
+                break;
+        }
+    }
+
+    if (!same_outputs(&next, out)) {
+        next.seq = out->seq + 1;
+        *out = next;
+    }
+}
+
+uint32_t alert_rules_resolve_color(uint32_t color)
+{
+    if (color & ALERT_COLOR_THEME) {
+        switch (color & 0xFF) {
+            case 1:  return gui_settings.temp_warm;
+            case 2:  return gui_settings.temp_hot;
+            default: return gui_settings.temp_cold;
+        }
+    }
+    return color & 0xFFFFFF;
+}
+
+/* =============================================================================
+ * COMMAND HANDLER
+ * ========================================================================== */
+
+bool alert_rules_handle_command(const char *line)
+{
+    if (strncmp(line, PROTO_CMD_ALERT_RULES, 12) != 0) return false;
+
+    const char *text = line + 12;
+    bool use_default = (strcmp(text, ALERT_TABLE_DEFAULT) == 0);
+
+    if (strlen(text) >= sizeof(s_table_text)) {
+        usb_serial_sendf(PROTO_CMD_ALERT_ERR "%d\n", ALERT_MAX_RULES);
+        return true;
+    }
+
+    /* Same table again (client reconnect) - keep rules, state and flash */
+    if (strcmp(text, s_table_text) == 0) {
+        usb_serial_sendf(PROTO_CMD_ALERT_OK "%d\n", s_rule_count);
+        return true;
+    }
+
+    int bad = compile_table(use_default ? DEFAULT_TABLE : text);
+    if (bad >= 0) {
+        ESP_LOGW(TAG, "Rule %d invalid - table rejected", bad);
+        usb_serial_sendf(PROTO_CMD_ALERT_ERR "%d\n", bad);
+        return true;
+    }
+
+    strcpy(s_table_text, text);
+    save_table();
+
+    ESP_LOGI(TAG, "Alert table: %d rules%s", s_rule_count, use_default ? " (built-in)" : "");
+    usb_serial_sendf(PROTO_CMD_ALERT_OK "%d\n", s_rule_count);
+    return true;
+}
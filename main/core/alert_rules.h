@@ -0,0 +1,74 @@
+/**
+ * @file alert_rules.h
+ * @brief Threshold rules evaluated on every accepted stats line
+ *
+ * Rules (metric, comparison, hysteresis, hold time, action) arrive as one
+ * ALERT_RULES: line and are compiled into a flat array. The USB RX task
+ * evaluates them right after committing a stats line, so the display task
+ * picks up the resulting alert state together with the sample that caused it.
+ *
+ * Without an uploaded table the built-in rules reproduce the old fixed
+ * temperature colours (CPU >60/>70, GPU >65/>75 -> theme warm/hot).
+ */
+
+#ifndef ALERT_RULES_H
+#define ALERT_RULES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/system_types.h"
+#include "protocol_gen.h"
+#include "gui_settings.h"
+
+#define ALERT_TARGET_COUNT  4       /* alert_target_t values */
+#define ALERT_NO_VIEW       (-1)    /* force_view: display not forced */
+
+/**
+ * @brief Combined output of all active rules
+ *
+ * Written by the RX task under the stats mutex, copied by the display task.
+ */
+typedef struct {
+    uint32_t seq;                           /**< Incremented when any output changes */
+    uint8_t color_mask;                     /**< Bit per alert_target_t with a colour override */
+    uint8_t blink_mask;                     /**< Bit per alert_target_t that blinks */
+    uint32_t color[ALERT_TARGET_COUNT];     /**< RRGGBB, or ALERT_COLOR_THEME | 0..2 */
+    int8_t force_view[SCREEN_COUNT];        /**< UI_VIEW_* per display, ALERT_NO_VIEW = none */
+} alert_state_t;
+
+/**
+ * @brief Load the stored rule table (built-in rules if there is none)
+ *
+ * Call once at boot, before the USB RX task starts.
+ */
+void alert_rules_init(void);
+
+/**
+ * @brief Evaluate all rules against a freshly accepted stats line
+ *
+ * O(rules). Must be called from the USB RX task (the only writer of the
+ * rule table) with the stats mutex held.
+ *
+ * @param stats  Committed stats
+ * @param now_ms Arrival time (ms since boot), for the hold times
+ * @param out    Alert state; seq is bumped only if the outputs changed
+ */
+void alert_rules_evaluate(const pc_stats_t *stats, uint32_t now_ms, alert_state_t *out);
+
+/**
+ * @brief Resolve a rule colour (theme references included) to RRGGBB
+ */
+uint32_t alert_rules_resolve_color(uint32_t color);
+
+/**
+ * @brief Handle ALERT_RULES: command
+ * @param line Command line
+ * @return true if command was handled
+ *
+ * Format: ALERT_RULES:<rule>;<rule>;...   (see scarab_protocol.def)
+ * - empty list clears all rules, DEFAULT restores the built-in table
+ * - the whole table is rejected if one rule is malformed
+ */
+bool alert_rules_handle_command(const char *line);
+
+#endif /* ALERT_RULES_H */
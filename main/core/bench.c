@@ -0,0 +1,487 @@
+/**
+ * @file bench.c
+ * @brief On-device self-benchmark - fixed suite, one result line per case
+ */
+
+#include "bench.h"
+#include "codec.h"
+#include "metric_vm.h"
+#include "protocol_gen.h"
+#include "drivers/usb_serial_comm.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_app_desc.h"
+
+static const char *TAG = "BENCH";
+
+#define BENCH_STACK_SIZE        8192    /* Renders LVGL frames (= lv_timer stack) */
+#define BENCH_PRIO              2       /* Below USB RX and the LVGL timer */
+#define BENCH_CORE              1       /* LVGL renders on core 1 */
+#define BENCH_LVGL_TIMEOUT_MS   200
+
+/* Runs per case - sized so the whole suite takes a few seconds */
+#define RENDER_RUNS             3
+#define SWAP_RUNS               50
+#define CRC_RUNS                2
+#define PARSE_RUNS              500
+#define HEX_RUNS                100
+#define EXPR_RUNS               500
+#define FS_RUNS                 1
+
+#define BAND_PIXELS             (240 * 40)      /* One draw buffer (driver band) */
+#define CRC_BYTES               (1024 * 1024)
+#define CRC_BLOCK               4096
+#define HEX_BYTES               USB_MAX_CHUNK_BYTES
+#define EXPR_COUNT              50              /* Custom metrics evaluated per stats line */
+#define FS_BYTES                (64 * 1024)
+#define FS_BLOCK                4096
+#define FS_PATH                 "/storage/bench.tmp"
+
+static lvgl_gc9a01_handle_t *s_displays[LVGL_GC9A01_MAX_DISPLAYS];
+static int s_display_count = 0;
+static SemaphoreHandle_t s_lvgl_mutex = NULL;
+static volatile bool s_running = false;
+
+/* Per-case accumulator */
+typedef struct {
+    uint32_t runs;
+    uint64_t total_us;
+    uint32_t max_us;
+} bench_acc_t;
+
+static void acc_add(bench_acc_t *a, int64_t us)
+{
+    a->runs++;
+    a->total_us += (uint64_t)us;
+    if ((uint32_t)us > a->max_us) {
+        a->max_us = (uint32_t)us;
+    }
+}
+
+/* One BENCH: line; bytes_per_run > 0 adds the throughput */
+static void report(const char *name, const bench_acc_t *a, uint32_t bytes_per_run)
+{
+    if (a->runs == 0 || a->total_us == 0) {
+        usb_serial_sendf(PROTO_CMD_BENCH_RESULT "%s|ERR:NORUN\n", name);
+        return;
+    }
+
+    uint32_t avg = (uint32_t)(a->total_us / a->runs);
+    if (bytes_per_run == 0) {
+        usb_serial_sendf(PROTO_CMD_BENCH_RESULT "%s|N:%" PRIu32 "|AVG:%" PRIu32 "|MAX:%" PRIu32 "\n",
+                         name, a->runs, avg, a->max_us);
+        return;
+    }
+
+    uint32_t kbs = (uint32_t)((uint64_t)bytes_per_run * a->runs * 1000000 / 1024 / a->total_us);
+    usb_serial_sendf(PROTO_CMD_BENCH_RESULT "%s|N:%" PRIu32 "|AVG:%" PRIu32 "|MAX:%" PRIu32 "|KBS:%" PRIu32 "\n",
+                     name, a->runs, avg, a->max_us, kbs);
+}
+
+static void report_err(const char *name, const char *reason)
+{
+    usb_serial_sendf(PROTO_CMD_BENCH_RESULT "%s|ERR:%s\n", name, reason);
+}
+
+/* =============================================================================
+ * DISPLAY CASES
+ * ========================================================================== */
+
+/* Full-frame render of display d (incl. the flush of the last band), then
+ * the SPI time per band the scheduler measured during those frames */
+static void bench_display(int d)
+{
+    char render_name[12], flush_name[12];
+    snprintf(render_name, sizeof(render_name), "RENDER%d", d);
+    snprintf(flush_name, sizeof(flush_name), "FLUSH%d", d);
+
+    if (d >= s_display_count || !s_lvgl_mutex) {
+        report_err(render_name, "NODISP");
+        report_err(flush_name, "NODISP");
+        return;
+    }
+
+    lvgl_gc9a01_handle_t *h = s_displays[d];
+    lv_display_t *disp = lvgl_gc9a01_get_display(h);
+    lvgl_gc9a01_flush_stats_t before, after;
+    bench_acc_t frame = {0};
+    bool direct = false;
+
+    lvgl_gc9a01_get_flush_stats(h, &before, true);
+
+    for (int i = 0; i < RENDER_RUNS; i++) {
+        if (xSemaphoreTake(s_lvgl_mutex, pdMS_TO_TICKS(BENCH_LVGL_TIMEOUT_MS)) != pdTRUE) {
+            break;
+        }
+        if (lvgl_gc9a01_blit_active(h)) {
+            /* Screensaver pixels are in panel order - LVGL must not draw */
+            xSemaphoreGive(s_lvgl_mutex);
+            direct = true;
+            break;
+        }
+        lv_obj_invalidate(lv_display_get_screen_active(disp));
+
+        int64_t t0 = esp_timer_get_time();
+        lv_refr_now(disp);
+        lvgl_gc9a01_wait_flush(h);
+        acc_add(&frame, esp_timer_get_time() - t0);
+
+        xSemaphoreGive(s_lvgl_mutex);
+        vTaskDelay(1);
+    }
+
+    lvgl_gc9a01_get_flush_stats(h, &after, false);
+
+    if (frame.runs == 0) {
+        report_err(render_name, direct ? "DIRECT" : "LOCK");
+        report_err(flush_name, direct ? "DIRECT" : "LOCK");
+        return;
+    }
+    report(render_name, &frame, 0);
+
+    /* Deltas are wrap-safe in uint32_t */
+    uint32_t bands = after.bands - before.bands;
+    uint32_t bytes = after.bytes - before.bytes;
+    uint32_t transfer_us = after.transfer_us - before.transfer_us;
+    if (bands == 0 || transfer_us == 0) {
+        report_err(flush_name, "NOBANDS");
+        return;
+    }
+
+    usb_serial_sendf(PROTO_CMD_BENCH_RESULT "%s|N:%" PRIu32 "|AVG:%" PRIu32 "|MAX:%" PRIu32 "|KBS:%" PRIu32 "\n",
+                     flush_name, bands, transfer_us / bands, after.transfer_max_us,
+                     (uint32_t)((uint64_t)bytes * 1000000 / 1024 / transfer_us));
+}
+
+/* =============================================================================
+ * CPU / MEMORY CASES
+ * ========================================================================== */
+
+/* RGB565 byte swap of one band in PSRAM, as in the flush callback */
+static void bench_swap(void)
+{
+    uint16_t *band = heap_caps_malloc(BAND_PIXELS * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    if (!band) {
+        report_err("SWAP", "NOMEM");
+        return;
+    }
+    memset(band, 0x5A, BAND_PIXELS * sizeof(uint16_t));
+
+    bench_acc_t acc = {0};
+    for (int i = 0; i < SWAP_RUNS; i++) {
+        int64_t t0 = esp_timer_get_time();
+        lv_draw_sw_rgb565_swap(band, BAND_PIXELS);
+        acc_add(&acc, esp_timer_get_time() - t0);
+    }
+
+    heap_caps_free(band);
+    report("SWAP", &acc, BAND_PIXELS * sizeof(uint16_t));
+}
+
+/* CRC32 over 1 MB in upload-sized blocks (internal RAM, like the FW chunks) */
+static void bench_crc32(void)
+{
+    uint8_t *block = malloc(CRC_BLOCK);
+    if (!block) {
+        report_err("CRC32", "NOMEM");
+        return;
+    }
+    for (int i = 0; i < CRC_BLOCK; i++) {
+        block[i] = (uint8_t)(i * 31);
+    }
+
+    bench_acc_t acc = {0};
+    volatile uint32_t sink = 0;
+    for (int r = 0; r < CRC_RUNS; r++) {
+        int64_t t0 = esp_timer_get_time();
+        uint32_t crc = CODEC_CRC32_INIT;
+        for (int off = 0; off < CRC_BYTES; off += CRC_BLOCK) {
+            crc = codec_crc32_update(crc, block, CRC_BLOCK);
+        }
+        acc_add(&acc, esp_timer_get_time() - t0);
+        sink = ~crc;
+        vTaskDelay(1);
+    }
+    (void)sink;
+
+    free(block);
+    report("CRC32", &acc, CRC_BYTES);
+}
+
+/* A typical full stats line */
+static const pc_stats_t s_sample = {
+    .cpu_percent = 37, .cpu_temp = 61.5f,
+    .gpu_percent = 82, .gpu_temp = 68.0f, .gpu_vram_used = 6.4f, .gpu_vram_total = 12.0f,
+    .ram_used_gb = 17.3f, .ram_total_gb = 31.9f,
+    .net_type = "LAN", .net_speed = "1000 Mbps", .net_down_mbps = 142.7f, .net_up_mbps = 12.3f,
+    .disk_read_mbs = 85.2f, .disk_write_mbs = 12.9f, .disk_read_iops = 1450.0f,
+    .disk_write_iops = 320.0f, .disk_queue = 1.25f, .disk_latency_ms = 0.8f,
+};
+
+/* Decode of a typical full stats line */
+static void bench_parse(void)
+{
+    char line[PROTO_STATS_MAX_LEN];
+    if (proto_stats_encode(&s_sample, line, sizeof(line)) < 0) {
+        report_err("PARSE", "ENCODE");
+        return;
+    }
+    char *nl = strchr(line, '\n');
+    if (nl) *nl = '\0';     /* The RX task hands over lines without newline */
+
+    bench_acc_t acc = {0};
+    pc_stats_t out;
+    for (int i = 0; i < PARSE_RUNS; i++) {
+        int64_t t0 = esp_timer_get_time();
+        proto_stats_decode(line, &out);
+        acc_add(&acc, esp_timer_get_time() - t0);
+    }
+
+    report("PARSE", &acc, 0);
+}
+
+/* Hex decode of one maximum-size upload chunk */
+static void bench_hex(void)
+{
+    char *hex = malloc(HEX_BYTES * 2 + 1);
+    uint8_t *out = malloc(HEX_BYTES);
+    if (!hex || !out) {
+        free(hex);
+        free(out);
+        report_err("HEX", "NOMEM");
+        return;
+    }
+
+    static const char digits[] = "0123456789ABCDEF";
+    for (int i = 0; i < HEX_BYTES * 2; i++) {
+        hex[i] = digits[(i * 7) & 0xF];
+    }
+    hex[HEX_BYTES * 2] = '\0';
+
+    bench_acc_t acc = {0};
+    for (int i = 0; i < HEX_RUNS; i++) {
+        int64_t t0 = esp_timer_get_time();
+        codec_hex_decode(hex, out, HEX_BYTES);
+        acc_add(&acc, esp_timer_get_time() - t0);
+    }
+
+    free(hex);
+    free(out);
+    report("HEX", &acc, HEX_BYTES);
+}
+
+/* Custom metrics table: EXPR_COUNT programs, alternating
+ * "vram_used / vram_total * 100" (6 ops) and an EMA of the CPU temperature
+ * with alpha 0.2 (8 ops) - what a client typically uploads */
+static int build_expr_table(uint8_t *buf)
+{
+    static const float consts[] = { 100.0f, 0.2f };
+    uint8_t *p = buf;
+
+    metric_table_header_t h = {
+        .version = METRIC_TABLE_VERSION, .slot_count = EXPR_COUNT,
+        .const_count = sizeof(consts) / sizeof(consts[0]),
+        .op_count = (EXPR_COUNT / 2) * 6 + (EXPR_COUNT - EXPR_COUNT / 2) * 8,
+    };
+    memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+    memcpy(p, consts, sizeof(consts));
+    p += sizeof(consts);
+
+    uint8_t *ends = p;
+    uint8_t *code = p + EXPR_COUNT * 2;
+    int n = 0;
+#define OP(o, d, a, b) do { code[n * 4] = (o); code[n * 4 + 1] = (d); \
+                            code[n * 4 + 2] = (a); code[n * 4 + 3] = (b); n++; } while (0)
+    for (int s = 0; s < EXPR_COUNT; s++) {
+        if (s % 2 == 0) {
+            OP(METRIC_OP_LDF, 0, METRIC_IN_VRAM_USED, 0);
+            OP(METRIC_OP_LDF, 1, METRIC_IN_VRAM_TOTAL, 0);
+            OP(METRIC_OP_DIV, 0, 0, 1);
+            OP(METRIC_OP_LDC, 1, 0, 0);
+            OP(METRIC_OP_MUL, 0, 0, 1);
+            OP(METRIC_OP_RET, 0, 0, 0);
+        } else {
+            OP(METRIC_OP_LDF, 0, METRIC_IN_CPU_TEMP, 0);
+            OP(METRIC_OP_LDM, 1, s, 0);         /* Previous value */
+            OP(METRIC_OP_DEF, 1, 1, 0);         /* First line: start at x */
+            OP(METRIC_OP_SUB, 2, 0, 1);
+            OP(METRIC_OP_LDC, 3, 1, 0);
+            OP(METRIC_OP_MUL, 2, 2, 3);
+            OP(METRIC_OP_ADD, 0, 1, 2);
+            OP(METRIC_OP_RET, 0, 0, 0);
+        }
+        ends[s * 2] = (uint8_t)n;
+        ends[s * 2 + 1] = (uint8_t)(n >> 8);
+    }
+#undef OP
+    p = code + n * 4;
+
+    uint32_t crc = ~codec_crc32_update(CODEC_CRC32_INIT, buf, p - buf);
+    memcpy(p, &crc, sizeof(crc));
+    return (int)(p - buf) + 4;
+}
+
+/* All custom metrics of one stats line */
+static void bench_expr(void)
+{
+    size_t size = sizeof(metric_table_header_t) + 2 * 4 + EXPR_COUNT * 2 + EXPR_COUNT * 8 * 4 + 4;
+    uint8_t *table = malloc(size);
+    metric_vm_t *vm = metric_vm_create();
+    if (!table || !vm) {
+        free(table);
+        metric_vm_free(vm);
+        report_err("EXPR", "NOMEM");
+        return;
+    }
+
+    int bad_slot;
+    if (metric_vm_load(vm, table, build_expr_table(table), &bad_slot) != EXPR_COUNT) {
+        free(table);
+        metric_vm_free(vm);
+        report_err("EXPR", "LOAD");
+        return;
+    }
+
+    bench_acc_t acc = {0};
+    uint32_t now_ms = 0;
+    for (int i = 0; i < EXPR_RUNS; i++) {
+        int64_t t0 = esp_timer_get_time();
+        metric_vm_run(vm, &s_sample, now_ms);
+        acc_add(&acc, esp_timer_get_time() - t0);
+        now_ms += 1000;
+    }
+
+    free(table);
+    metric_vm_free(vm);
+    report("EXPR", &acc, 0);
+}
+
+/* =============================================================================
+ * LITTLEFS CASES
+ * ========================================================================== */
+
+static void bench_fs(void)
+{
+    uint8_t *block = malloc(FS_BLOCK);
+    if (!block) {
+        report_err("FS_WRITE", "NOMEM");
+        report_err("FS_READ", "NOMEM");
+        return;
+    }
+    memset(block, 0xA5, FS_BLOCK);
+
+    bench_acc_t wr = {0}, rd = {0};
+    bool ok = true;
+
+    for (int r = 0; r < FS_RUNS && ok; r++) {
+        int64_t t0 = esp_timer_get_time();
+        FILE *f = fopen(FS_PATH, "wb");
+        ok = (f != NULL);
+        for (int off = 0; ok && off < FS_BYTES; off += FS_BLOCK) {
+            ok = (fwrite(block, 1, FS_BLOCK, f) == FS_BLOCK);
+        }
+        if (f) fclose(f);
+        if (!ok) break;
+        acc_add(&wr, esp_timer_get_time() - t0);
+        vTaskDelay(1);
+
+        t0 = esp_timer_get_time();
+        f = fopen(FS_PATH, "rb");
+        ok = (f != NULL);
+        for (int off = 0; ok && off < FS_BYTES; off += FS_BLOCK) {
+            ok = (fread(block, 1, FS_BLOCK, f) == FS_BLOCK);
+        }
+        if (f) fclose(f);
+        if (!ok) break;
+        acc_add(&rd, esp_timer_get_time() - t0);
+        vTaskDelay(1);
+    }
+
+    remove(FS_PATH);
+    free(block);
+
+    if (wr.runs == 0) {
+        report_err("FS_WRITE", "IO");
+    } else {
+        report("FS_WRITE", &wr, FS_BYTES);
+    }
+    if (rd.runs == 0) {
+        report_err("FS_READ", "IO");
+    } else {
+        report("FS_READ", &rd, FS_BYTES);
+    }
+}
+
+/* =============================================================================
+ * SUITE TASK
+ * ========================================================================== */
+
+static void bench_task(void *arg)
+{
+    int64_t start = esp_timer_get_time();
+    ESP_LOGI(TAG, "Self-benchmark started");
+
+    usb_serial_sendf(PROTO_CMD_BENCH_BEGIN "%s|CASES:%d\n",
+                     esp_app_get_description()->version, BENCH_CASES);
+
+    /* CPU cases first, while the displays show normal content */
+    bench_swap();
+    bench_crc32();
+    bench_parse();
+    bench_hex();
+    bench_expr();
+    bench_fs();
+
+    for (int d = 0; d < LVGL_GC9A01_MAX_DISPLAYS; d++) {
+        bench_display(d);
+    }
+
+    uint32_t total_ms = (uint32_t)((esp_timer_get_time() - start) / 1000);
+    usb_serial_sendf(PROTO_CMD_BENCH_END "%" PRIu32 "\n", total_ms);
+    ESP_LOGI(TAG, "Self-benchmark done in %" PRIu32 " ms", total_ms);
+
+    s_running = false;
+    vTaskDelete(NULL);
+}
+
+/* =============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void bench_init(lvgl_gc9a01_handle_t *const *displays, int count, SemaphoreHandle_t lvgl_mutex)
+{
+    if (count > LVGL_GC9A01_MAX_DISPLAYS) {
+        count = LVGL_GC9A01_MAX_DISPLAYS;
+    }
+    for (int i = 0; i < count; i++) {
+        s_displays[i] = displays[i];
+    }
+    s_display_count = count;
+    s_lvgl_mutex = lvgl_mutex;
+}
+
+bool bench_handle_command(const char *line)
+{
+    if (strcmp(line, PROTO_CMD_BENCH) != 0) return false;
+
+    if (s_running) {
+        usb_serial_sendf(PROTO_CMD_BENCH_ERR "BUSY\n");
+        return true;
+    }
+
+    s_running = true;
+    if (xTaskCreatePinnedToCore(bench_task, "bench", BENCH_STACK_SIZE, NULL,
+                                BENCH_PRIO, NULL, BENCH_CORE) != pdPASS) {
+        s_running = false;
+        ESP_LOGE(TAG, "Failed to start benchmark task");
+        usb_serial_sendf(PROTO_CMD_BENCH_ERR "NOMEM\n");
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file bench.h
+ * @brief On-device self-benchmark (BENCH command)
+ *
+ * Runs a fixed suite on the real hardware - PSRAM, flash cache and SPI
+ * timing that host benchmarks cannot see - and reports one line per case,
+ * so the client can keep results per firmware version and spot regressions
+ * between OTA builds. Wire format: see scarab_protocol.def.
+ *
+ * The suite runs in its own short-lived task; the USB RX task keeps
+ * serving commands and telemetry meanwhile. Render cases take the LVGL
+ * mutex per frame, so the UI only pauses for one frame at a time.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "lvgl_gc9a01_driver.h"
+
+/**
+ * @brief Hand over the displays for the render/flush cases
+ *
+ * Call once after the displays are initialized. Without it those cases
+ * report ERR:NODISP.
+ *
+ * @param displays   Display handles, in GET_CAPS display order
+ * @param count      Number of handles (max LVGL_GC9A01_MAX_DISPLAYS)
+ * @param lvgl_mutex LVGL mutex
+ */
+void bench_init(lvgl_gc9a01_handle_t *const *displays, int count, SemaphoreHandle_t lvgl_mutex);
+
+/**
+ * @brief Handle BENCH command
+ * @param line Command line
+ * @return true if command was handled
+ */
+bool bench_handle_command(const char *line);
+
+#endif /* BENCH_H */
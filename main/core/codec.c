@@ -0,0 +1,68 @@
+/**
+ * @file codec.c
+ * @brief CRC32 and hex decoding shared by the upload paths
+ */
+
+#include "codec.h"
+#include <string.h>
+
+uint32_t codec_crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & ~((crc & 1) - 1));
+        }
+    }
+    return crc;
+}
+
+static int hex_nibble(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static int hex_decode_n(const char *hex, size_t hex_len, uint8_t *buf, size_t buf_size)
+{
+    if (hex_len % 2 != 0 || hex_len / 2 > buf_size) return -1;
+
+    for (size_t i = 0; i < hex_len / 2; i++) {
+        int hi = hex_nibble(hex[i * 2]);
+        int lo = hex_nibble(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        buf[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return (int)(hex_len / 2);
+}
+
+int codec_hex_decode(const char *hex, uint8_t *buf, size_t buf_size)
+{
+    return hex_decode_n(hex, strlen(hex), buf, buf_size);
+}
+
+int codec_chunk_decode(const char *payload, uint8_t *buf, size_t buf_size, bool *has_crc)
+{
+    const char *sep = strchr(payload, ':');
+    *has_crc = (sep != NULL);
+
+    if (!sep) {
+        int len = hex_decode_n(payload, strlen(payload), buf, buf_size);
+        return len <= 0 ? CODEC_CHUNK_BAD : len;
+    }
+
+    uint8_t crc_bytes[4];
+    if (hex_decode_n(sep + 1, strlen(sep + 1), crc_bytes, sizeof(crc_bytes)) != 4) {
+        return CODEC_CHUNK_BAD;
+    }
+
+    int len = hex_decode_n(payload, (size_t)(sep - payload), buf, buf_size);
+    if (len <= 0) return CODEC_CHUNK_BAD;
+
+    uint32_t expected = ((uint32_t)crc_bytes[0] << 24) | ((uint32_t)crc_bytes[1] << 16) |
+                        ((uint32_t)crc_bytes[2] << 8) | crc_bytes[3];
+    uint32_t crc = ~codec_crc32_update(CODEC_CRC32_INIT, buf, (size_t)len);
+    return crc == expected ? len : CODEC_CHUNK_CRC;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file codec.h
+ * @brief CRC32 and hex decoding shared by the upload paths
+ *
+ * One implementation for image upload, firmware update and the self-benchmark,
+ * so BENCH measures exactly the code the transfers run.
+ */
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CODEC_CRC32_INIT    0xFFFFFFFF
+
+/**
+ * @brief Feed bytes into a running CRC32 (IEEE, same as the C# client)
+ *
+ * Start with CODEC_CRC32_INIT; the final CRC is the bitwise NOT of the
+ * running value.
+ */
+uint32_t codec_crc32_update(uint32_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief Decode a hex string (upper or lower case) into buf
+ * @return Decoded byte count, -1 on odd length, bad digit or overflow
+ */
+int codec_hex_decode(const char *hex, uint8_t *buf, size_t buf_size);
+
+#define CODEC_CHUNK_BAD     (-1)    /* Odd length, bad digit or overflow */
+#define CODEC_CHUNK_CRC     (-2)    /* Decoded, but the chunk CRC does not match */
+
+/**
+ * @brief Decode the payload of an IMG_DATA / FW_DATA line
+ *
+ * Payload is "<hex>" or "<hex>:<crc32>", the CRC32 of the decoded bytes as
+ * 8 hex digits (FEAT:CRC clients). has_crc tells the caller which form came
+ * in, so a damaged chunk can be NAKed instead of failing the upload.
+ * @return Decoded byte count, CODEC_CHUNK_BAD or CODEC_CHUNK_CRC
+ */
+int codec_chunk_decode(const char *payload, uint8_t *buf, size_t buf_size, bool *has_crc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CODEC_H */
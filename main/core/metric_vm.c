@@ -0,0 +1,368 @@
+/**
+ * @file metric_vm.c
+ * @brief Custom metrics VM - verify, interpret, persist
+ */
+
+#include "metric_vm.h"
+#include "codec.h"
+#include "drivers/usb_serial_comm.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "esp_log.h"
+
+static const char *TAG = "METRICS";
+
+/* Uploaded table, stored as received (binary, CRC included) */
+#define METRIC_TABLE_PATH       "/storage/metrics.bin"
+#define METRIC_TABLE_MAX        (sizeof(metric_table_header_t) + METRIC_MAX_CONSTS * 4 + \
+                                 METRIC_MAX_SLOTS * 2 + METRIC_MAX_OPS * 4 + 4)
+#define METRIC_INPUT_COUNT      (METRIC_IN_DT + 1)
+#define METRIC_VALUES_PER_LINE  16      /* GET_METRICS: keeps a reply line short */
+
+typedef struct {
+    uint8_t op;                 /* metric_op_t */
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+} metric_insn_t;
+
+struct metric_vm {
+    uint8_t slot_count;
+    uint16_t op_count;
+    uint32_t crc;               /* Of the loaded table, 0 = none */
+    bool has_last;              /* last_ms valid (DT input) */
+    uint32_t last_ms;
+    float consts[METRIC_MAX_CONSTS];
+    uint16_t end[METRIC_MAX_SLOTS];
+    metric_insn_t code[METRIC_MAX_OPS];
+    float value[METRIC_MAX_SLOTS];
+};
+
+static metric_vm_t s_live;
+
+/* =============================================================================
+ * LOADER
+ * ========================================================================== */
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* One program: valid operands, every register written before it is read,
+ * exactly one RET and it comes last */
+static bool verify_program(const metric_insn_t *code, int start, int end,
+                           int const_count, int slot_count)
+{
+    uint16_t written = 0;
+
+    for (int i = start; i < end; i++) {
+        const metric_insn_t *in = &code[i];
+        uint16_t reads = 0;
+
+        if (in->dst >= METRIC_REGS) return false;
+
+        switch (in->op) {
+            case METRIC_OP_LDC:
+                if (in->a >= const_count) return false;
+                break;
+            case METRIC_OP_LDF:
+                if (in->a >= METRIC_INPUT_COUNT) return false;
+                break;
+            case METRIC_OP_LDM:
+                if (in->a >= slot_count) return false;
+                break;
+            case METRIC_OP_MOV:
+            case METRIC_OP_NEG:
+            case METRIC_OP_ABS:
+            case METRIC_OP_RET:
+                if (in->a >= METRIC_REGS) return false;
+                reads = (uint16_t)(1u << in->a);
+                break;
+            case METRIC_OP_ADD:
+            case METRIC_OP_SUB:
+            case METRIC_OP_MUL:
+            case METRIC_OP_DIV:
+            case METRIC_OP_MIN:
+            case METRIC_OP_MAX:
+            case METRIC_OP_DEF:
+                if (in->a >= METRIC_REGS || in->b >= METRIC_REGS) return false;
+                reads = (uint16_t)((1u << in->a) | (1u << in->b));
+                break;
+            default:
+                return false;
+        }
+
+        if (reads & ~written) return false;
+        if (in->op == METRIC_OP_RET) return i == end - 1;
+        written |= (uint16_t)(1u << in->dst);
+    }
+    return false;   /* No RET */
+}
+
+int metric_vm_load(metric_vm_t *vm, const uint8_t *table, size_t len, int *bad_slot)
+{
+    *bad_slot = -1;
+
+    if (len < sizeof(metric_table_header_t) + 4) return METRIC_VM_BAD_TABLE;
+    if (~codec_crc32_update(CODEC_CRC32_INIT, table, len - 4) != get_u32(table + len - 4)) {
+        return METRIC_VM_BAD_TABLE;
+    }
+
+    metric_table_header_t h;
+    memcpy(&h, table, sizeof(h));
+    if (h.version != METRIC_TABLE_VERSION || h.reserved != 0 || h.reserved2 != 0 ||
+        h.slot_count > METRIC_MAX_SLOTS || h.const_count > METRIC_MAX_CONSTS ||
+        h.op_count > METRIC_MAX_OPS) {
+        return METRIC_VM_BAD_TABLE;
+    }
+    if (len != sizeof(h) + h.const_count * 4u + h.slot_count * 2u + h.op_count * 4u + 4u) {
+        return METRIC_VM_BAD_TABLE;
+    }
+
+    const uint8_t *consts = table + sizeof(h);
+    const uint8_t *ends = consts + h.const_count * 4;
+    const metric_insn_t *code = (const metric_insn_t *)(ends + h.slot_count * 2);
+
+    /* Verify everything before touching the VM - on error it keeps running
+     * the old programs */
+    int start = 0;
+    for (int s = 0; s < h.slot_count; s++) {
+        int end = get_u16(ends + s * 2);
+        if (end <= start || end > h.op_count ||
+            !verify_program(code, start, end, h.const_count, h.slot_count)) {
+            *bad_slot = s;
+            return METRIC_VM_BAD_TABLE;
+        }
+        start = end;
+    }
+    if (start != h.op_count) return METRIC_VM_BAD_TABLE;
+
+    vm->slot_count = h.slot_count;
+    vm->op_count = h.op_count;
+    for (int i = 0; i < h.const_count; i++) {
+        uint32_t bits = get_u32(consts + i * 4);
+        memcpy(&vm->consts[i], &bits, sizeof(float));
+    }
+    for (int s = 0; s < h.slot_count; s++) {
+        vm->end[s] = get_u16(ends + s * 2);
+        vm->value[s] = NAN;
+    }
+    memcpy(vm->code, code, h.op_count * sizeof(metric_insn_t));
+    vm->crc = get_u32(table + len - 4);
+    vm->has_last = false;
+    return h.slot_count;
+}
+
+/* =============================================================================
+ * INTERPRETER
+ * ========================================================================== */
+
+/* Stats use negative values for N/A */
+static inline float input(float v)
+{
+    return v < 0.0f ? NAN : v;
+}
+
+void metric_vm_run(metric_vm_t *vm, const pc_stats_t *s, uint32_t now_ms)
+{
+    float in[METRIC_INPUT_COUNT] = {
+        [METRIC_IN_CPU_LOAD]        = input(s->cpu_percent),
+        [METRIC_IN_CPU_TEMP]        = input(s->cpu_temp),
+        [METRIC_IN_GPU_LOAD]        = input(s->gpu_percent),
+        [METRIC_IN_GPU_TEMP]        = input(s->gpu_temp),
+        [METRIC_IN_VRAM_USED]       = input(s->gpu_vram_used),
+        [METRIC_IN_VRAM_TOTAL]      = input(s->gpu_vram_total),
+        [METRIC_IN_RAM_USED]        = input(s->ram_used_gb),
+        [METRIC_IN_RAM_TOTAL]       = input(s->ram_total_gb),
+        [METRIC_IN_NET_DOWN]        = input(s->net_down_mbps),
+        [METRIC_IN_NET_UP]          = input(s->net_up_mbps),
+        [METRIC_IN_DISK_READ]       = input(s->disk_read_mbs),
+        [METRIC_IN_DISK_WRITE]      = input(s->disk_write_mbs),
+        [METRIC_IN_DISK_READ_IOPS]  = input(s->disk_read_iops),
+        [METRIC_IN_DISK_WRITE_IOPS] = input(s->disk_write_iops),
+        [METRIC_IN_DISK_QUEUE]      = input(s->disk_queue),
+        [METRIC_IN_DISK_LATENCY]    = input(s->disk_latency_ms),
+        [METRIC_IN_DT]              = vm->has_last ? (float)(now_ms - vm->last_ms) / 1000.0f : NAN,
+    };
+    vm->has_last = true;
+    vm->last_ms = now_ms;
+
+    /* Verified at load: no operand checks here */
+    float r[METRIC_REGS];
+    const metric_insn_t *op = vm->code;
+
+    for (int slot = 0; slot < vm->slot_count; slot++) {
+        const metric_insn_t *end = vm->code + vm->end[slot];
+        for (; op < end; op++) {
+            /* a is a const / input / slot index for the loads, so registers
+             * are only read by the ops that take them */
+#define RA  r[op->a]
+#define RB  r[op->b]
+            switch (op->op) {
+                case METRIC_OP_LDC: r[op->dst] = vm->consts[op->a]; break;
+                case METRIC_OP_LDF: r[op->dst] = in[op->a]; break;
+                case METRIC_OP_LDM: r[op->dst] = vm->value[op->a]; break;
+                case METRIC_OP_MOV: r[op->dst] = RA; break;
+                case METRIC_OP_ADD: r[op->dst] = RA + RB; break;
+                case METRIC_OP_SUB: r[op->dst] = RA - RB; break;
+                case METRIC_OP_MUL: r[op->dst] = RA * RB; break;
+                case METRIC_OP_DIV: r[op->dst] = (RB == 0.0f) ? NAN : RA / RB; break;
+                case METRIC_OP_MIN: r[op->dst] = (isnan(RA) || isnan(RB)) ? NAN : fminf(RA, RB); break;
+                case METRIC_OP_MAX: r[op->dst] = (isnan(RA) || isnan(RB)) ? NAN : fmaxf(RA, RB); break;
+                case METRIC_OP_NEG: r[op->dst] = -RA; break;
+                case METRIC_OP_ABS: r[op->dst] = fabsf(RA); break;
+                case METRIC_OP_DEF: r[op->dst] = isnan(RA) ? RB : RA; break;
+                case METRIC_OP_RET: vm->value[slot] = isinf(RA) ? NAN : RA; break;
+            }
+#undef RA
+#undef RB
+        }
+    }
+}
+
+float metric_vm_get(const metric_vm_t *vm, int slot)
+{
+    return (slot >= 0 && slot < vm->slot_count) ? vm->value[slot] : NAN;
+}
+
+metric_vm_t *metric_vm_create(void)
+{
+    return calloc(1, sizeof(metric_vm_t));
+}
+
+void metric_vm_free(metric_vm_t *vm)
+{
+    free(vm);
+}
+
+/* =============================================================================
+ * LIVE TABLE
+ * ========================================================================== */
+
+void metric_vm_init(void)
+{
+    static uint8_t table[METRIC_TABLE_MAX];
+
+    FILE *f = fopen(METRIC_TABLE_PATH, "rb");
+    if (f == NULL) return;
+
+    size_t len = fread(table, 1, sizeof(table), f);
+    fclose(f);
+
+    int bad_slot;
+    int slots = metric_vm_load(&s_live, table, len, &bad_slot);
+    if (slots < 0) {
+        ESP_LOGW(TAG, "Stored metric table invalid - no custom metrics");
+        return;
+    }
+    ESP_LOGI(TAG, "Loaded %d custom metrics (%u ops)", slots, (unsigned)s_live.op_count);
+}
+
+void metric_vm_evaluate(const pc_stats_t *stats, uint32_t now_ms)
+{
+    if (s_live.slot_count > 0) {
+        metric_vm_run(&s_live, stats, now_ms);
+    }
+}
+
+float metric_vm_value(int slot)
+{
+    return metric_vm_get(&s_live, slot);
+}
+
+static void save_table(const uint8_t *table, size_t len)
+{
+    if (len == 0) {
+        remove(METRIC_TABLE_PATH);
+        return;
+    }
+
+    FILE *f = fopen(METRIC_TABLE_PATH, "wb");
+    if (f != NULL) {
+        fwrite(table, 1, len, f);
+        fclose(f);
+    } else {
+        ESP_LOGE(TAG, "Failed to save metrics.bin");
+    }
+}
+
+/* =============================================================================
+ * COMMAND HANDLER
+ * ========================================================================== */
+
+/* METRIC_VAL:<first slot>:<v>,<v>,...  per METRIC_VALUES_PER_LINE slots */
+static void send_values(void)
+{
+    char line[METRIC_VALUES_PER_LINE * 14 + 32];
+
+    for (int first = 0; first < s_live.slot_count || first == 0; first += METRIC_VALUES_PER_LINE) {
+        int len = snprintf(line, sizeof(line), PROTO_CMD_METRIC_VALUES "%d:", first);
+        for (int s = first; s < s_live.slot_count && s < first + METRIC_VALUES_PER_LINE; s++) {
+            float v = s_live.value[s];
+            len += snprintf(line + len, sizeof(line) - len, isnan(v) ? "%s-" : "%s%.4g",
+                            s > first ? "," : "", isnan(v) ? 0.0 : (double)v);
+        }
+        usb_serial_sendf("%s\n", line);
+    }
+}
+
+bool metric_vm_handle_command(const char *line)
+{
+    if (strcmp(line, PROTO_CMD_GET_METRICS) == 0) {
+        send_values();
+        return true;
+    }
+    if (strncmp(line, PROTO_CMD_METRICS, strlen(PROTO_CMD_METRICS)) != 0) return false;
+
+    static uint8_t table[METRIC_TABLE_MAX];
+    const char *hex = line + strlen(PROTO_CMD_METRICS);
+
+    /* Empty list: no custom metrics */
+    if (*hex == '\0') {
+        s_live.slot_count = 0;
+        s_live.op_count = 0;
+        s_live.crc = 0;
+        save_table(NULL, 0);
+        ESP_LOGI(TAG, "Custom metrics cleared");
+        usb_serial_sendf(PROTO_CMD_METRICS_OK "0\n");
+        return true;
+    }
+
+    int len = codec_hex_decode(hex, table, sizeof(table));
+    if (len < 4) {
+        usb_serial_sendf(PROTO_CMD_METRICS_ERR "TABLE\n");
+        return true;
+    }
+
+    /* Same table again (client reconnect) - keep programs, EMA state and flash */
+    if (s_live.crc != 0 && get_u32(table + len - 4) == s_live.crc) {
+        usb_serial_sendf(PROTO_CMD_METRICS_OK "%d\n", s_live.slot_count);
+        return true;
+    }
+
+    int bad_slot;
+    int slots = metric_vm_load(&s_live, table, (size_t)len, &bad_slot);
+    if (slots < 0) {
+        if (bad_slot >= 0) {
+            ESP_LOGW(TAG, "Metric %d invalid - table rejected", bad_slot);
+            usb_serial_sendf(PROTO_CMD_METRICS_ERR "%d\n", bad_slot);
+        } else {
+            ESP_LOGW(TAG, "Metric table rejected");
+            usb_serial_sendf(PROTO_CMD_METRICS_ERR "TABLE\n");
+        }
+        return true;
+    }
+
+    save_table(table, (size_t)len);
+    ESP_LOGI(TAG, "Custom metrics: %d (%u ops)", slots, (unsigned)s_live.op_count);
+    usb_serial_sendf(PROTO_CMD_METRICS_OK "%d\n", slots);
+    return true;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file metric_vm.h
+ * @brief Custom metrics - bytecode VM evaluated on every accepted stats line
+ *
+ * The client compiles expressions ("vram_used / vram_total * 100", an EMA
+ * of the CPU temperature, ...) into a table of straight-line programs for
+ * a 16-register float VM and uploads it as one METRICS: line. The USB RX
+ * task runs all programs right after committing a stats line, before the
+ * alert rules, which can then read slot n as metric ALERT_METRIC_CUSTOM + n.
+ *
+ * The loader verifies every instruction (opcodes, register / const / slot
+ * indices, registers written before read, one RET per program), so the
+ * interpreter runs without checks. Without jumps the work per line is
+ * bounded by the op count (METRIC_MAX_OPS). Wire format: scarab_protocol.def.
+ */
+
+#ifndef METRIC_VM_H
+#define METRIC_VM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "core/system_types.h"
+#include "protocol_gen.h"
+
+#define METRIC_VM_BAD_TABLE     (-1)    /* metric_vm_load: header, size, CRC or limits */
+
+typedef struct metric_vm metric_vm_t;
+
+/* =============================================================================
+ * VM INSTANCES
+ * ========================================================================== */
+
+/**
+ * @brief Allocate an empty VM (no programs)
+ * @return NULL if out of memory
+ */
+metric_vm_t *metric_vm_create(void);
+
+void metric_vm_free(metric_vm_t *vm);
+
+/**
+ * @brief Verify a compiled table and make it the VM's program set
+ *
+ * On error the VM keeps its current programs. Slot values restart as N/A.
+ * @param vm       VM
+ * @param table    Table incl. trailing CRC32
+ * @param len      Table size in bytes
+ * @param bad_slot Set to the first program with a bad instruction, or -1
+ * @return Slot count, METRIC_VM_BAD_TABLE if the table is unusable
+ */
+int metric_vm_load(metric_vm_t *vm, const uint8_t *table, size_t len, int *bad_slot);
+
+/**
+ * @brief Run all programs on one stats line
+ * @param now_ms Arrival time (ms since boot), for the DT input
+ */
+void metric_vm_run(metric_vm_t *vm, const pc_stats_t *stats, uint32_t now_ms);
+
+/**
+ * @brief Value of a slot after the last run, NAN if N/A or no such slot
+ */
+float metric_vm_get(const metric_vm_t *vm, int slot);
+
+/* =============================================================================
+ * LIVE TABLE (USB RX task)
+ * ========================================================================== */
+
+/**
+ * @brief Load the stored table
+ *
+ * Call once at boot, before the USB RX task starts.
+ */
+void metric_vm_init(void);
+
+/**
+ * @brief Run the live table on a freshly accepted stats line
+ *
+ * Must be called from the USB RX task (the only writer of the table) with
+ * the stats mutex held, before alert_rules_evaluate().
+ */
+void metric_vm_evaluate(const pc_stats_t *stats, uint32_t now_ms);
+
+/**
+ * @brief Live slot value, NAN if N/A or no such slot (USB RX task)
+ */
+float metric_vm_value(int slot);
+
+/**
+ * @brief Handle METRICS: and GET_METRICS commands
+ * @param line Command line
+ * @return true if command was handled
+ */
+bool metric_vm_handle_command(const char *line);
+
+#endif /* METRIC_VM_H */
@@ -0,0 +1,438 @@
+/**
+ * @file postmortem.c
+ * @brief RTC no-init counter block, TWDT post-mortem and GET_POSTMORTEM
+ */
+
+#include "postmortem.h"
+#include "codec.h"
+#include "protocol_gen.h"
+#include "drivers/usb_serial_comm.h"
+#include "storage/storage_mgr.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+
+static const char *TAG = "POSTMORTEM";
+
+#define PM_MAGIC                0x504D5254      /* "PMRT" - bump on layout change */
+#define PM_FILE_PATH            STORAGE_MOUNT_POINT "/postmortem.bin"
+#define PM_SAVE_INTERVAL_MS     (5 * 60 * 1000) /* Flash copy at most every 5 min */
+#define PM_MAX_TASKS            8               /* Tasks calling postmortem_feed */
+#define PM_NAME_LEN             16              /* configMAX_TASK_NAME_LEN */
+#define PM_CORES                2
+
+typedef struct {
+    uint32_t t_ms;              /* Since boot */
+    uint32_t arg;
+    uint32_t id;                /* postmortem_event_t */
+} pm_event_t;
+
+/* Counters of one run (boot to reset) */
+typedef struct {
+    uint32_t uptime_s;
+    uint32_t lock_wait_max_us[POSTMORTEM_LOCK_COUNT];
+    uint32_t lock_timeouts[POSTMORTEM_LOCK_COUNT];
+    uint32_t flush_max_us;
+} pm_run_t;
+
+/* Snapshot taken in the TWDT interrupt, kept until the next timeout */
+typedef struct {
+    uint32_t boot;              /* Boot number of the run that hung, 0 = none yet */
+    uint32_t uptime_s;
+    char hung[PM_NAME_LEN];                             /* Fed the TWDT longest ago */
+    char running[PM_CORES][PM_NAME_LEN];                /* Current task per core */
+    char holder[POSTMORTEM_LOCK_COUNT][PM_NAME_LEN];    /* "" = lock was free */
+} pm_wdt_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boots;
+    uint32_t wdt_resets;
+    uint8_t resets[POSTMORTEM_RESET_LEN];       /* esp_reset_reason_t, newest first */
+    pm_run_t cur;
+    pm_run_t prev;
+    pm_wdt_t wdt;
+    uint32_t trace_count;                       /* Events ever; next slot = count % LEN */
+    pm_event_t trace[POSTMORTEM_TRACE_LEN];
+    uint32_t crc;                               /* CRC32 of everything above */
+} pm_block_t;
+
+/* Survives panics and software resets; garbage after power-on (CRC fails) */
+static RTC_NOINIT_ATTR pm_block_t s_pm;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_ready = false;
+static bool s_dirty = false;                    /* Changed since the flash copy */
+static uint32_t s_saved_ms = 0;
+
+static struct {
+    TaskHandle_t task;
+    int64_t fed_us;
+} s_tasks[PM_MAX_TASKS];
+static int s_task_count = 0;
+static SemaphoreHandle_t s_mutexes[POSTMORTEM_LOCK_COUNT];
+
+/* =============================================================================
+ * BLOCK (callers hold s_lock)
+ * ========================================================================== */
+
+static uint32_t block_crc(const pm_block_t *b)
+{
+    return ~codec_crc32_update(CODEC_CRC32_INIT, (const uint8_t *)b, offsetof(pm_block_t, crc));
+}
+
+static bool block_valid(const pm_block_t *b)
+{
+    return b->magic == PM_MAGIC && b->crc == block_crc(b);
+}
+
+static void seal(bool dirty)
+{
+    s_pm.crc = block_crc(&s_pm);
+    if (dirty) {
+        s_dirty = true;
+    }
+}
+
+static void trace_add(postmortem_event_t event, uint32_t arg)
+{
+    pm_event_t *e = &s_pm.trace[s_pm.trace_count % POSTMORTEM_TRACE_LEN];
+    e->t_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    e->arg = arg;
+    e->id = (uint32_t)event;
+    s_pm.trace_count++;
+}
+
+static void copy_task_name(char *dst, TaskHandle_t task)
+{
+    const char *name = task ? pcTaskGetName(task) : "";
+    strncpy(dst, name ? name : "", PM_NAME_LEN - 1);
+    dst[PM_NAME_LEN - 1] = '\0';
+}
+
+/* =============================================================================
+ * FLASH COPY
+ * ========================================================================== */
+
+static bool load_file(pm_block_t *b)
+{
+    FILE *f = fopen(PM_FILE_PATH, "rb");
+    if (f == NULL) return false;
+
+    bool ok = (fread(b, sizeof(*b), 1, f) == 1) && block_valid(b);
+    fclose(f);
+    return ok;
+}
+
+static void save_file(void)
+{
+    pm_block_t copy;
+    portENTER_CRITICAL(&s_lock);
+    copy = s_pm;
+    s_dirty = false;
+    portEXIT_CRITICAL(&s_lock);
+
+    FILE *f = fopen(PM_FILE_PATH, "wb");
+    if (f == NULL) {
+        ESP_LOGW(TAG, "Cannot write %s", PM_FILE_PATH);
+        return;
+    }
+    fwrite(&copy, sizeof(copy), 1, f);
+    fclose(f);
+    s_saved_ms = (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/* =============================================================================
+ * WATCHDOG HOOK
+ *
+ * Called by the TWDT interrupt just before the panic it is configured for.
+ * Interrupt context: no logging, no blocking - names are copied into the
+ * no-init block, which the reset leaves alone.
+ * esp_task_wdt.h declares this hook weak; it is not included here so this
+ * definition stays strong and replaces the empty default.
+ * ========================================================================== */
+
+void esp_task_wdt_isr_user_handler(void)
+{
+    if (!s_ready) return;
+
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&s_lock);
+    pm_wdt_t *w = &s_pm.wdt;
+    memset(w, 0, sizeof(*w));
+    w->boot = s_pm.boots;
+    w->uptime_s = (uint32_t)(now / 1000000);
+
+    int64_t oldest = INT64_MAX;
+    for (int i = 0; i < s_task_count; i++) {
+        if (s_tasks[i].fed_us < oldest) {
+            oldest = s_tasks[i].fed_us;
+            copy_task_name(w->hung, s_tasks[i].task);
+        }
+    }
+    for (int c = 0; c < PM_CORES && c < portNUM_PROCESSORS; c++) {
+        copy_task_name(w->running[c], xTaskGetCurrentTaskHandleForCore(c));
+    }
+    for (int l = 0; l < POSTMORTEM_LOCK_COUNT; l++) {
+        if (s_mutexes[l]) {
+            copy_task_name(w->holder[l], xSemaphoreGetMutexHolderFromISR(s_mutexes[l]));
+        }
+    }
+
+    s_pm.wdt_resets++;
+    s_pm.cur.uptime_s = w->uptime_s;
+    trace_add(POSTMORTEM_EV_WDT, 0);
+    seal(true);
+    portEXIT_CRITICAL_ISR(&s_lock);
+}
+
+/* esp_restart(): the reset reason says SW, the trace says who was up when */
+static void on_restart(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_pm.cur.uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    trace_add(POSTMORTEM_EV_RESTART, 0);
+    seal(true);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/* =============================================================================
+ * RECORDING
+ * ========================================================================== */
+
+void postmortem_feed(void)
+{
+    if (!s_ready) return;
+
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    int i = 0;
+    while (i < s_task_count && s_tasks[i].task != self) {
+        i++;
+    }
+    if (i < PM_MAX_TASKS) {
+        s_tasks[i].task = self;
+        s_tasks[i].fed_us = now;
+        if (i == s_task_count) {
+            s_task_count++;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool postmortem_take(postmortem_lock_t lock, SemaphoreHandle_t mutex, TickType_t timeout)
+{
+    int64_t start = esp_timer_get_time();
+    bool taken = (xSemaphoreTake(mutex, timeout) == pdTRUE);
+
+    if (!s_ready || lock >= POSTMORTEM_LOCK_COUNT) {
+        return taken;
+    }
+
+    uint32_t wait = (uint32_t)(esp_timer_get_time() - start);
+    s_mutexes[lock] = mutex;
+
+    /* Nothing to store for the common case: no timeout, no new maximum */
+    if (taken && wait <= s_pm.cur.lock_wait_max_us[lock]) {
+        return taken;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    if (wait > s_pm.cur.lock_wait_max_us[lock]) {
+        s_pm.cur.lock_wait_max_us[lock] = wait;
+    }
+    if (!taken) {
+        s_pm.cur.lock_timeouts[lock]++;
+        trace_add(POSTMORTEM_EV_LOCK_TIMEOUT, (uint32_t)lock);
+    }
+    seal(true);
+    portEXIT_CRITICAL(&s_lock);
+    return taken;
+}
+
+void postmortem_flush_time(uint32_t us)
+{
+    if (!s_ready || us <= s_pm.cur.flush_max_us) return;
+
+    portENTER_CRITICAL(&s_lock);
+    if (us > s_pm.cur.flush_max_us) {
+        s_pm.cur.flush_max_us = us;
+        seal(true);
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void postmortem_trace(postmortem_event_t event, uint32_t arg)
+{
+    if (!s_ready) return;
+
+    portENTER_CRITICAL(&s_lock);
+    trace_add(event, arg);
+    seal(true);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void postmortem_save_if_due(void)
+{
+    if (!s_ready) return;
+
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+    /* Uptime alone does not make the flash copy stale */
+    if (now_ms / 1000 != s_pm.cur.uptime_s) {
+        portENTER_CRITICAL(&s_lock);
+        s_pm.cur.uptime_s = now_ms / 1000;
+        seal(false);
+        portEXIT_CRITICAL(&s_lock);
+    }
+
+    if (s_dirty && storage_is_mounted() && now_ms - s_saved_ms >= PM_SAVE_INTERVAL_MS) {
+        save_file();
+    }
+}
+
+/* =============================================================================
+ * INIT
+ * ========================================================================== */
+
+void postmortem_init(void)
+{
+    esp_reset_reason_t reason = esp_reset_reason();
+    const char *source = "RTC";
+
+    if (!block_valid(&s_pm)) {
+        /* Power-on or new layout: the last flash copy, else start over */
+        if (storage_is_mounted() && load_file(&s_pm)) {
+            source = "flash";
+        } else {
+            memset(&s_pm, 0, sizeof(s_pm));
+            s_pm.magic = PM_MAGIC;
+            source = "new";
+        }
+    }
+
+    s_pm.boots++;
+    memmove(&s_pm.resets[1], &s_pm.resets[0], POSTMORTEM_RESET_LEN - 1);
+    s_pm.resets[0] = (uint8_t)reason;
+    s_pm.prev = s_pm.cur;
+    memset(&s_pm.cur, 0, sizeof(s_pm.cur));
+    trace_add(POSTMORTEM_EV_BOOT, (uint32_t)reason);
+    seal(true);
+    s_ready = true;
+
+    ESP_LOGI(TAG, "Boot %" PRIu32 " (reset reason %d, counters from %s)",
+             s_pm.boots, (int)reason, source);
+    if (s_pm.wdt.boot != 0 && s_pm.wdt.boot == s_pm.boots - 1) {
+        ESP_LOGW(TAG, "Previous run hit the task watchdog after %" PRIu32 " s: hung=%s, cpu0=%s, cpu1=%s",
+                 s_pm.wdt.uptime_s, s_pm.wdt.hung, s_pm.wdt.running[0], s_pm.wdt.running[1]);
+    }
+
+    if (esp_register_shutdown_handler(on_restart) != ESP_OK) {
+        ESP_LOGW(TAG, "Shutdown handler not registered");
+    }
+    if (storage_is_mounted()) {
+        save_file();
+    }
+}
+
+/* =============================================================================
+ * COMMAND HANDLER
+ *
+ * GET_POSTMORTEM -> PM: lines, then PM_END:<number of PM: lines>
+ * ========================================================================== */
+
+static const char *reset_name(uint8_t reason)
+{
+    switch ((esp_reset_reason_t)reason) {
+        case ESP_RST_POWERON:   return "PWR";
+        case ESP_RST_EXT:       return "EXT";
+        case ESP_RST_SW:        return "SW";
+        case ESP_RST_PANIC:     return "PANIC";
+        case ESP_RST_INT_WDT:   return "INT_WDT";
+        case ESP_RST_TASK_WDT:  return "TASK_WDT";
+        case ESP_RST_WDT:       return "WDT";
+        case ESP_RST_DEEPSLEEP: return "SLEEP";
+        case ESP_RST_BROWNOUT:  return "BROWN";
+        case ESP_RST_USB:       return "USB";
+        case ESP_RST_JTAG:      return "JTAG";
+        default:                return "OTHER";
+    }
+}
+
+static const char *event_name(uint32_t id)
+{
+    switch ((postmortem_event_t)id) {
+        case POSTMORTEM_EV_BOOT:          return "BOOT";
+        case POSTMORTEM_EV_LOCK_TIMEOUT:  return "LOCK_TO";
+        case POSTMORTEM_EV_FLUSH_TIMEOUT: return "FLUSH_TO";
+        case POSTMORTEM_EV_SCREENSAVER:   return "SSAVER";
+        case POSTMORTEM_EV_HOST:          return "HOST";
+        case POSTMORTEM_EV_RESTART:       return "RESTART";
+        case POSTMORTEM_EV_WDT:           return "WDT";
+        default:                          return "?";
+    }
+}
+
+static void send_run(const char *which, const pm_run_t *r)
+{
+    usb_serial_sendf(PROTO_CMD_POSTMORTEM "RUN|%s|UP:%" PRIu32 "|LOCK:%" PRIu32 ",%" PRIu32
+                     "|LTO:%" PRIu32 ",%" PRIu32 "|FLUSH:%" PRIu32 "\n",
+                     which, r->uptime_s,
+                     r->lock_wait_max_us[POSTMORTEM_LOCK_LVGL], r->lock_wait_max_us[POSTMORTEM_LOCK_STATS],
+                     r->lock_timeouts[POSTMORTEM_LOCK_LVGL], r->lock_timeouts[POSTMORTEM_LOCK_STATS],
+                     r->flush_max_us);
+}
+
+bool postmortem_handle_command(const char *line)
+{
+    if (strcmp(line, PROTO_CMD_GET_POSTMORTEM) != 0) {
+        return false;
+    }
+
+    /* Report from a copy - the block keeps changing meanwhile */
+    pm_block_t b;
+    portENTER_CRITICAL(&s_lock);
+    b = s_pm;
+    portEXIT_CRITICAL(&s_lock);
+
+    int lines = 0;
+
+    usb_serial_sendf(PROTO_CMD_POSTMORTEM "BOOT|N:%" PRIu32 "|WDT:%" PRIu32 "|RST:%s,%s,%s,%s\n",
+                     b.boots, b.wdt_resets, reset_name(b.resets[0]), reset_name(b.resets[1]),
+                     reset_name(b.resets[2]), reset_name(b.resets[3]));
+    lines++;
+
+    send_run("CUR", &b.cur);
+    send_run("PREV", &b.prev);
+    lines += 2;
+
+    if (b.wdt.boot != 0) {
+        usb_serial_sendf(PROTO_CMD_POSTMORTEM "WDT|BOOT:%" PRIu32 "|UP:%" PRIu32
+                         "|HUNG:%s|CPU:%s,%s|HELD:%s,%s\n",
+                         b.wdt.boot, b.wdt.uptime_s, b.wdt.hung,
+                         b.wdt.running[0], b.wdt.running[1],
+                         b.wdt.holder[POSTMORTEM_LOCK_LVGL], b.wdt.holder[POSTMORTEM_LOCK_STATS]);
+        lines++;
+    }
+
+    /* Oldest first */
+    uint32_t count = b.trace_count < POSTMORTEM_TRACE_LEN ? b.trace_count : POSTMORTEM_TRACE_LEN;
+    for (uint32_t i = b.trace_count - count; i < b.trace_count; i++) {
+        const pm_event_t *e = &b.trace[i % POSTMORTEM_TRACE_LEN];
+        usb_serial_sendf(PROTO_CMD_POSTMORTEM "EV|T:%" PRIu32 "|%s:%" PRIu32 "\n",
+                         e->t_ms, event_name(e->id), e->arg);
+        lines++;
+    }
+
+    usb_serial_sendf(PROTO_CMD_POSTMORTEM_END "%d\n", lines);
+    return true;
+}
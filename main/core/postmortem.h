@@ -0,0 +1,104 @@
+/**
+ * @file postmortem.h
+ * @brief Performance counters and watchdog post-mortems that survive resets
+ *
+ * A TWDT timeout panics and resets the device (trigger_panic = true), which
+ * wipes the log that would explain it. This module keeps a small counter
+ * block in RTC no-init memory, guarded by a CRC32:
+ * - boot count and the last reset reasons
+ * - max lock wait / lock timeouts and max SPI flush time, per run
+ * - the last POSTMORTEM_TRACE_LEN trace events
+ * - at a watchdog timeout: the task that stopped feeding it, the tasks
+ *   running on both cores and the holders of the watched locks
+ *
+ * The block survives panics and software resets; a copy is written to
+ * LittleFS now and then, so a power cycle keeps the history too.
+ * GET_POSTMORTEM reports it (wire format: see scarab_protocol.def).
+ *
+ * All recording calls are cheap and safe from any task; the block is only
+ * re-checksummed when something changed.
+ */
+
+#ifndef POSTMORTEM_H
+#define POSTMORTEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define POSTMORTEM_TRACE_LEN    16      /* Trace events kept */
+#define POSTMORTEM_RESET_LEN    4       /* Reset reasons kept, newest first */
+
+/* Locks whose wait times and holders are tracked */
+typedef enum {
+    POSTMORTEM_LOCK_LVGL = 0,
+    POSTMORTEM_LOCK_STATS,
+    POSTMORTEM_LOCK_COUNT
+} postmortem_lock_t;
+
+/* Trace event ids (arg in brackets) */
+typedef enum {
+    POSTMORTEM_EV_BOOT = 1,         /* esp_reset_reason_t */
+    POSTMORTEM_EV_LOCK_TIMEOUT,     /* postmortem_lock_t */
+    POSTMORTEM_EV_FLUSH_TIMEOUT,    /* CS pin */
+    POSTMORTEM_EV_SCREENSAVER,      /* 1 = on, 0 = off */
+    POSTMORTEM_EV_HOST,             /* 1 = attached, 0 = detached */
+    POSTMORTEM_EV_RESTART,          /* - (esp_restart) */
+    POSTMORTEM_EV_WDT,              /* - (watchdog timeout) */
+} postmortem_event_t;
+
+/**
+ * @brief Validate the block, count this boot and restore from flash if needed
+ *
+ * Call once, right after storage_init(). Moves the counters of the previous
+ * run to "previous" and logs a warning if that run ended in a watchdog reset.
+ */
+void postmortem_init(void);
+
+/**
+ * @brief Note that the calling task is alive
+ *
+ * Call next to each esp_task_wdt_reset(). At a watchdog timeout the task
+ * that fed longest ago is recorded as the hung one.
+ */
+void postmortem_feed(void);
+
+/**
+ * @brief xSemaphoreTake that records the wait time
+ *
+ * Keeps the longest wait per lock; a timeout is counted and traced. The
+ * mutex is remembered, so a watchdog post-mortem can name its holder.
+ * @param lock    Which lock
+ * @param mutex   Its FreeRTOS mutex
+ * @param timeout Ticks to wait (never portMAX_DELAY)
+ * @return true if the mutex was taken
+ */
+bool postmortem_take(postmortem_lock_t lock, SemaphoreHandle_t mutex, TickType_t timeout);
+
+/**
+ * @brief Record the SPI transfer time of one flushed band
+ */
+void postmortem_flush_time(uint32_t us);
+
+/**
+ * @brief Append an event to the trace
+ */
+void postmortem_trace(postmortem_event_t event, uint32_t arg);
+
+/**
+ * @brief Write the block to LittleFS if it changed and the interval passed
+ *
+ * Call periodically from a task that may touch the filesystem (not under
+ * the LVGL mutex).
+ */
+void postmortem_save_if_due(void);
+
+/**
+ * @brief Handle GET_POSTMORTEM command
+ * @param line Command line
+ * @return true if command was handled
+ */
+bool postmortem_handle_command(const char *line);
+
+#endif /* POSTMORTEM_H */
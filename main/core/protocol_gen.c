@@ -0,0 +1,324 @@
+/**
+ * @file protocol_gen.c
+ * @brief Wire protocol codecs
+ *
+ * GENERATED by tools/protogen.py from protocol/scarab_protocol.def - DO NOT EDIT
+ */
+
+#include "protocol_gen.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define SEP_CHAR   ','
+#define NUM_LIMIT  999999999.0f
+
+/* =============================================================================
+ * SCANNERS
+ * Work on [p, end) of the original line - no strtok copy, no locale.
+ * Return the position after the number, or NULL if there are no digits.
+ * ========================================================================== */
+
+static const char *scan_int(const char *p, const char *end, int32_t *out)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+    const char *digits = p;
+    int32_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (v < 100000000) {
+            v = v * 10 + (*p - '0');
+        }
+        p++;
+    }
+    if (p == digits) return NULL;
+    *out = neg ? -v : v;
+    return p;
+}
+
+static const char *scan_num(const char *p, const char *end, float *out)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+    const char *digits = p;
+    uint32_t ip = 0, frac = 0, div = 1;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (ip < 1000000000u) {
+            ip = ip * 10 + (uint32_t)(*p - '0');
+        }
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (div < 100000000u) {
+                frac = frac * 10 + (uint32_t)(*p - '0');
+                div *= 10;
+            }
+            p++;
+        }
+    }
+    if (p == digits || (p == digits + 1 && *digits == '.')) return NULL;
+    float v = (float)ip + (float)frac / (float)div;
+    *out = neg ? -v : v;
+    return p;
+}
+
+/* n numbers separated by '/', filling exactly [p, end) */
+static bool scan_list(const char *p, const char *end, float *out, int n)
+{
+    for (int i = 0; i < n; i++) {
+        p = scan_num(p, end, &out[i]);
+        if (!p) return false;
+        if (i < n - 1) {
+            if (p >= end || *p != '/') return false;
+            p++;
+        }
+    }
+    return p == end;
+}
+
+static void copy_text(char *dst, size_t size, const char *p, const char *end)
+{
+    size_t len = (size_t)(end - p);
+    if (len >= size) len = size - 1;
+    memcpy(dst, p, len);
+    dst[len] = '\0';
+}
+
+/* =============================================================================
+ * WRITERS (caller guarantees space - see PROTO_*_MAX_LEN)
+ * ========================================================================== */
+
+static char *put_text(char *p, const char *s, size_t max)
+{
+    for (size_t i = 0; i < max && s[i]; i++) {
+        char c = s[i];
+        *p++ = (c == SEP_CHAR || c == '\n' || c == '\r') ? ' ' : c;
+    }
+    return p;
+}
+
+static char *put_uint(char *p, uint64_t v)
+{
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+static char *put_int(char *p, int32_t v)
+{
+    if (v < 0) {
+        *p++ = '-';
+        return put_uint(p, (uint64_t)(-(int64_t)v));
+    }
+    return put_uint(p, (uint64_t)v);
+}
+
+/* Fixed-point with 'decimals' digits, rounded half away from zero.
+ * NaN is sent as -1 (N/A); magnitude is clamped to NUM_LIMIT. */
+static char *put_fixed(char *p, float v, int decimals)
+{
+    static const uint32_t scales[] = { 1, 10, 100, 1000, 10000 };
+    if (v != v) v = -1.0f;
+    if (v > NUM_LIMIT) v = NUM_LIMIT;
+    if (v < -NUM_LIMIT) v = -NUM_LIMIT;
+
+    uint32_t scale = scales[decimals];
+    bool neg = v < 0;
+    uint64_t s = (uint64_t)((neg ? -v : v) * (float)scale + 0.5f);
+    if (neg && s) *p++ = '-';
+    p = put_uint(p, s / scale);
+    if (decimals) {
+        *p++ = '.';
+        uint32_t frac = (uint32_t)(s % scale);
+        for (uint32_t d = scale / 10; d; d /= 10) {
+            *p++ = (char)('0' + (frac / d) % 10);
+        }
+    }
+    return p;
+}
+
+/* =============================================================================
+ * STATS FRAME
+ * ========================================================================== */
+
+int proto_stats_decode(const char *line, pc_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->disk_read_mbs = -1.0f;
+    out->disk_write_mbs = -1.0f;
+    out->disk_read_iops = -1.0f;
+    out->disk_write_iops = -1.0f;
+    out->disk_queue = -1.0f;
+    out->disk_latency_ms = -1.0f;
+
+    int fields = 0;
+    const char *p = line;
+    while (*p) {
+        const char *end = strchr(p, SEP_CHAR);
+        if (!end) end = p + strlen(p);
+        const char *colon = memchr(p, ':', (size_t)(end - p));
+
+        if (colon) {
+            const char *val = colon + 1;
+            switch (colon - p) {
+            case 2:
+                if (memcmp(p, "UP", 2) == 0) {
+                    float f = 0.0f;
+                    scan_num(val, end, &f);
+                    out->net_up_mbps = f;
+                    fields++;
+                }
+                break;
+            case 3:
+                if (memcmp(p, "CPU", 3) == 0) {
+                    int32_t i = 0;
+                    scan_int(val, end, &i);
+                    out->cpu_percent = (int16_t)i;
+                    fields++;
+                }
+                else if (memcmp(p, "GPU", 3) == 0) {
+                    int32_t i = 0;
+                    scan_int(val, end, &i);
+                    out->gpu_percent = (int16_t)i;
+                    fields++;
+                }
+                else if (memcmp(p, "RAM", 3) == 0) {
+                    float v[2];
+                    if (scan_list(val, end, v, 2)) {
+                        out->ram_used_gb = v[0];
+                        out->ram_total_gb = v[1];
+                        fields++;
+                    } else {
+                        out->ram_used_gb = -1.0f;
+                        out->ram_total_gb = -1.0f;
+                    }
+                }
+                else if (memcmp(p, "NET", 3) == 0) {
+                    copy_text(out->net_type, sizeof(out->net_type), val, end);
+                    fields++;
+                }
+                else if (memcmp(p, "DSK", 3) == 0) {
+                    float v[6];
+                    if (scan_list(val, end, v, 6)) {
+                        out->disk_read_mbs = v[0];
+                        out->disk_write_mbs = v[1];
+                        out->disk_read_iops = v[2];
+                        out->disk_write_iops = v[3];
+                        out->disk_queue = v[4];
+                        out->disk_latency_ms = v[5];
+                        fields++;
+                    } else {
+                        out->disk_read_mbs = -1.0f;
+                        out->disk_write_mbs = -1.0f;
+                        out->disk_read_iops = -1.0f;
+                        out->disk_write_iops = -1.0f;
+                        out->disk_queue = -1.0f;
+                        out->disk_latency_ms = -1.0f;
+                    }
+                }
+                break;
+            case 4:
+                if (memcmp(p, "CPUT", 4) == 0) {
+                    float f = 0.0f;
+                    scan_num(val, end, &f);
+                    out->cpu_temp = f;
+                    fields++;
+                }
+                else if (memcmp(p, "GPUT", 4) == 0) {
+                    float f = 0.0f;
+                    scan_num(val, end, &f);
+                    out->gpu_temp = f;
+                    fields++;
+                }
+                else if (memcmp(p, "VRAM", 4) == 0) {
+                    float v[2];
+                    if (scan_list(val, end, v, 2)) {
+                        out->gpu_vram_used = v[0];
+                        out->gpu_vram_total = v[1];
+                        fields++;
+                    } else {
+                        out->gpu_vram_used = -1.0f;
+                        out->gpu_vram_total = -1.0f;
+                    }
+                }
+                else if (memcmp(p, "DOWN", 4) == 0) {
+                    float f = 0.0f;
+                    scan_num(val, end, &f);
+                    out->net_down_mbps = f;
+                    fields++;
+                }
+                break;
+            case 5:
+                if (memcmp(p, "SPEED", 5) == 0) {
+                    copy_text(out->net_speed, sizeof(out->net_speed), val, end);
+                    fields++;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (!*end) break;
+        p = end + 1;
+    }
+    return fields;
+}
+
+int proto_stats_encode(const pc_stats_t *in, char *buf, size_t size)
+{
+    if (size < PROTO_STATS_MAX_LEN) return -1;
+
+    char *p = buf;
+    memcpy(p, "CPU:", 4); p += 4;
+    p = put_int(p, in->cpu_percent);
+    memcpy(p, ",CPUT:", 6); p += 6;
+    p = put_fixed(p, in->cpu_temp, 1);
+    memcpy(p, ",GPU:", 5); p += 5;
+    p = put_int(p, in->gpu_percent);
+    memcpy(p, ",GPUT:", 6); p += 6;
+    p = put_fixed(p, in->gpu_temp, 1);
+    memcpy(p, ",VRAM:", 6); p += 6;
+    p = put_fixed(p, in->gpu_vram_used, 1);
+    *p++ = '/';
+    p = put_fixed(p, in->gpu_vram_total, 1);
+    memcpy(p, ",RAM:", 5); p += 5;
+    p = put_fixed(p, in->ram_used_gb, 1);
+    *p++ = '/';
+    p = put_fixed(p, in->ram_total_gb, 1);
+    memcpy(p, ",NET:", 5); p += 5;
+    p = put_text(p, in->net_type, sizeof(in->net_type) - 1);
+    memcpy(p, ",SPEED:", 7); p += 7;
+    p = put_text(p, in->net_speed, sizeof(in->net_speed) - 1);
+    memcpy(p, ",DOWN:", 6); p += 6;
+    p = put_fixed(p, in->net_down_mbps, 1);
+    memcpy(p, ",UP:", 4); p += 4;
+    p = put_fixed(p, in->net_up_mbps, 1);
+    memcpy(p, ",DSK:", 5); p += 5;
+    p = put_fixed(p, in->disk_read_mbs, 1);
+    *p++ = '/';
+    p = put_fixed(p, in->disk_write_mbs, 1);
+    *p++ = '/';
+    p = put_fixed(p, in->disk_read_iops, 0);
+    *p++ = '/';
+    p = put_fixed(p, in->disk_write_iops, 0);
+    *p++ = '/';
+    p = put_fixed(p, in->disk_queue, 1);
+    *p++ = '/';
+    p = put_fixed(p, in->disk_latency_ms, 1);
+    *p++ = '\n';
+    *p = '\0';
+    return (int)(p - buf);
+}
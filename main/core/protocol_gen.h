@@ -0,0 +1,205 @@
+/**
+ * @file protocol_gen.h
+ * @brief Wire protocol codecs and formats
+ *
+ * GENERATED by tools/protogen.py from protocol/scarab_protocol.def - DO NOT EDIT
+ */
+
+#ifndef PROTOCOL_GEN_H
+#define PROTOCOL_GEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "system_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Commands / line tokens */
+#define PROTO_CMD_HANDSHAKE_QUERY  "WHO_ARE_YOU?"
+#define PROTO_CMD_HANDSHAKE_OK     "SCARAB_CLIENT_OK"
+#define PROTO_CMD_GET_CAPS         "GET_CAPS"
+#define PROTO_CMD_CAPS             "CAPS:"
+#define PROTO_CMD_PROC_TOP         "TOP:"
+#define PROTO_CMD_HISTORY          "HIST:"
+#define PROTO_CMD_SET_VIEW         "SET_VIEW:"
+#define PROTO_CMD_GET_FW_VER       "GET_FW_VER"
+#define PROTO_CMD_IMG_STATUS       "IMG_STATUS"
+#define PROTO_CMD_GET_USB_STATS    "GET_USB_STATS"
+#define PROTO_CMD_USB_STATS        "USB_STATS:"
+#define PROTO_CMD_ALERT_RULES      "ALERT_RULES:"
+#define PROTO_CMD_ALERT_OK         "ALERT_OK:"
+#define PROTO_CMD_ALERT_ERR        "ALERT_ERR:"
+#define PROTO_CMD_BENCH            "BENCH"
+#define PROTO_CMD_BENCH_BEGIN      "BENCH_BEGIN:"
+#define PROTO_CMD_BENCH_RESULT     "BENCH:"
+#define PROTO_CMD_BENCH_END        "BENCH_END:"
+#define PROTO_CMD_BENCH_ERR        "BENCH_ERR:"
+#define PROTO_CMD_RPC_TAG          "@"
+#define PROTO_CMD_RPC_END          "RPC_END:"
+#define PROTO_CMD_GET_POSTMORTEM   "GET_POSTMORTEM"
+#define PROTO_CMD_POSTMORTEM       "PM:"
+#define PROTO_CMD_POSTMORTEM_END   "PM_END:"
+#define PROTO_CMD_METRICS          "METRICS:"
+#define PROTO_CMD_METRICS_OK       "METRICS_OK:"
+#define PROTO_CMD_METRICS_ERR      "METRICS_ERR:"
+#define PROTO_CMD_GET_METRICS      "GET_METRICS"
+#define PROTO_CMD_METRIC_VALUES    "METRIC_VAL:"
+#define PROTO_CMD_PROFILE_SAVE     "PROFILE_SAVE:"
+#define PROTO_CMD_PROFILE_IMG      "PROFILE_IMG:"
+#define PROTO_CMD_PROFILE_ACTIVATE "PROFILE_ACTIVATE:"
+#define PROTO_CMD_PROFILE_DELETE   "PROFILE_DELETE:"
+#define PROTO_CMD_PROFILE_LIST     "PROFILE_LIST"
+#define PROTO_CMD_PROFILE          "PROFILE:"
+#define PROTO_CMD_PROFILE_END      "PROFILE_END:"
+#define PROTO_CMD_PROFILE_OK       "PROFILE_OK:"
+#define PROTO_CMD_PROFILE_ERR      "PROFILE_ERR:"
+
+#define SCARAB_IMG_MAGIC          0x53434152  /* "SCAR" in little-endian */
+#define SCARAB_IMG_VERSION        2
+#define SCARAB_IMG_HEADER_V1_SIZE 16
+#define ALERT_MAX_RULES           16
+#define ALERT_COLOR_THEME         0x01000000  /* arg flag: theme temperature colour */
+#define ALERT_METRIC_CUSTOM       32  /* metric 32 + n = custom metric slot n */
+#define BENCH_CASES               15
+#define RPC_ID_MAX                65535
+#define METRIC_TABLE_VERSION      1
+#define METRIC_MAX_SLOTS          64
+#define METRIC_MAX_CONSTS         64
+#define METRIC_MAX_OPS            400  /* Instruction budget per stats line */
+#define METRIC_REGS               16
+#define PROFILE_SLOTS             4
+#define PROFILE_NAME_MAX          15
+#define PROFILE_IMG_NONE          255
+#define SS_IMG_LIBRARY            16
+
+typedef enum {
+    SCARAB_FMT_RGB565 = 0,      /* 16-bit color, no alpha (2 bytes/pixel) */
+    SCARAB_FMT_RGB565A8 = 1,    /* 16-bit color + 8-bit alpha (3 bytes/pixel) */
+} scarab_img_format_t;
+
+typedef enum {
+    SCARAB_ALIGN_CENTER = 0,    /* v1 files (reserved byte was 0) */
+    SCARAB_ALIGN_TOP_LEFT = 1,
+    SCARAB_ALIGN_TOP_MID = 2,
+    SCARAB_ALIGN_TOP_RIGHT = 3,
+    SCARAB_ALIGN_LEFT_MID = 4,
+    SCARAB_ALIGN_RIGHT_MID = 5,
+    SCARAB_ALIGN_BOTTOM_LEFT = 6,
+    SCARAB_ALIGN_BOTTOM_MID = 7,
+    SCARAB_ALIGN_BOTTOM_RIGHT = 8,
+} scarab_img_align_t;
+
+typedef enum {
+    ALERT_METRIC_CPU_LOAD = 0,  /* % */
+    ALERT_METRIC_CPU_TEMP = 1,  /* C */
+    ALERT_METRIC_GPU_LOAD = 2,  /* % */
+    ALERT_METRIC_GPU_TEMP = 3,  /* C */
+    ALERT_METRIC_RAM_PCT = 4,   /* % of total */
+    ALERT_METRIC_VRAM_PCT = 5,  /* % of total */
+    ALERT_METRIC_NET_DOWN = 6,  /* Mbps */
+    ALERT_METRIC_NET_UP = 7,    /* Mbps */
+    ALERT_METRIC_DISK_QUEUE = 8, /* average queue depth */
+    ALERT_METRIC_DISK_LATENCY = 9, /* ms per I/O */
+} alert_metric_t;
+
+typedef enum {
+    ALERT_ACTION_COLOR = 0,     /* recolour the target */
+    ALERT_ACTION_BLINK = 1,     /* blink the target */
+    ALERT_ACTION_VIEW = 2,      /* force a display to a view */
+} alert_action_t;
+
+typedef enum {
+    ALERT_TARGET_CPU_TEMP = 0,  /* CPU temperature label */
+    ALERT_TARGET_GPU_TEMP = 1,  /* GPU temperature label */
+    ALERT_TARGET_CPU_ARC = 2,   /* CPU load arc */
+    ALERT_TARGET_GPU_ARC = 3,   /* GPU load arc */
+} alert_target_t;
+
+typedef enum {
+    METRIC_OP_LDC = 0,          /* dst = const[a] */
+    METRIC_OP_LDF = 1,          /* dst = input a (metric_input) */
+    METRIC_OP_LDM = 2,          /* dst = slot a (this line if already run, else the previous one) */
+    METRIC_OP_MOV = 3,          /* dst = Ra */
+    METRIC_OP_ADD = 4,          /* dst = Ra + Rb */
+    METRIC_OP_SUB = 5,          /* dst = Ra - Rb */
+    METRIC_OP_MUL = 6,          /* dst = Ra * Rb */
+    METRIC_OP_DIV = 7,          /* dst = Ra / Rb (N/A if Rb is 0) */
+    METRIC_OP_MIN = 8,          /* dst = min(Ra, Rb) */
+    METRIC_OP_MAX = 9,          /* dst = max(Ra, Rb) */
+    METRIC_OP_NEG = 10,         /* dst = -Ra */
+    METRIC_OP_ABS = 11,         /* dst = |Ra| */
+    METRIC_OP_DEF = 12,         /* dst = Ra, or Rb if Ra is N/A */
+    METRIC_OP_RET = 13,         /* slot value = Ra, end of program */
+} metric_op_t;
+
+typedef enum {
+    METRIC_IN_CPU_LOAD = 0,     /* % */
+    METRIC_IN_CPU_TEMP = 1,     /* C */
+    METRIC_IN_GPU_LOAD = 2,     /* % */
+    METRIC_IN_GPU_TEMP = 3,     /* C */
+    METRIC_IN_VRAM_USED = 4,    /* GB */
+    METRIC_IN_VRAM_TOTAL = 5,   /* GB */
+    METRIC_IN_RAM_USED = 6,     /* GB */
+    METRIC_IN_RAM_TOTAL = 7,    /* GB */
+    METRIC_IN_NET_DOWN = 8,     /* Mbps */
+    METRIC_IN_NET_UP = 9,       /* Mbps */
+    METRIC_IN_DISK_READ = 10,   /* MB/s */
+    METRIC_IN_DISK_WRITE = 11,  /* MB/s */
+    METRIC_IN_DISK_READ_IOPS = 12,
+    METRIC_IN_DISK_WRITE_IOPS = 13,
+    METRIC_IN_DISK_QUEUE = 14,  /* average queue depth */
+    METRIC_IN_DISK_LATENCY = 15, /* ms per I/O */
+    METRIC_IN_DT = 16,          /* s since the previous stats line (N/A on the first) */
+} metric_input_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;             /* Must be SCARAB_IMG_MAGIC */
+    uint16_t width;             /* Image width (1..240) */
+    uint16_t height;            /* Image height (1..240) */
+    uint8_t  format;            /* scarab_img_format_t */
+    uint8_t  version;           /* Header version */
+    uint8_t  align;             /* scarab_img_align_t (v2+) */
+    uint8_t  reserved;          /* Must be 0 */
+    uint32_t data_size;         /* Size of pixel data in bytes */
+    int16_t  offset_x;          /* v2+: shift from the aligned position */
+    int16_t  offset_y;          /* v2+: shift from the aligned position */
+} scarab_img_header_t;
+
+_Static_assert(sizeof(scarab_img_header_t) == 20, "scarab_img_header layout");
+
+typedef struct __attribute__((packed)) {
+    uint8_t  version;           /* METRIC_TABLE_VERSION */
+    uint8_t  slot_count;        /* Programs / slots (0..METRIC_MAX_SLOTS) */
+    uint8_t  const_count;       /* 0..METRIC_MAX_CONSTS */
+    uint8_t  reserved;          /* Must be 0 */
+    uint16_t op_count;          /* All programs (0..METRIC_MAX_OPS) */
+    uint16_t reserved2;         /* Must be 0 */
+} metric_table_header_t;
+
+_Static_assert(sizeof(metric_table_header_t) == 8, "metric_table_header layout");
+
+/* stats line: CPU:..,CPUT:..,GPU:..,GPUT:..,VRAM:..,RAM:..,NET:..,SPEED:..,DOWN:..,UP:..,DSK:.. */
+#define PROTO_STATS_MIN_FIELDS  5
+#define PROTO_STATS_MAX_LEN     288   /**< incl. newline and terminator */
+
+/**
+ * @brief Decode a stats line into @p out (no copy, no allocation)
+ *
+ * @p out is reset first; absent keys get their schema default.
+ * @return Number of fields parsed (commit only if >= PROTO_STATS_MIN_FIELDS)
+ */
+int proto_stats_decode(const char *line, pc_stats_t *out);
+
+/**
+ * @brief Encode @p in as a stats line incl. '\n'
+ * @return Length written (without terminator), -1 if size < PROTO_STATS_MAX_LEN
+ */
+int proto_stats_encode(const pc_stats_t *in, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROTOCOL_GEN_H */
@@ -10,11 +10,26 @@
 #define SYSTEM_TYPES_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Field groups of pc_stats_t, set in pc_stats_t.dirty when any field of the
+ * group differs from the previous accepted line. Computed once at ingest so
+ * the UI dispatches on bits instead of re-comparing values every frame. */
+#define STATS_DIRTY_CPU_LOAD    (1u << 0)   /**< cpu_percent */
+#define STATS_DIRTY_CPU_TEMP    (1u << 1)   /**< cpu_temp */
+#define STATS_DIRTY_GPU_LOAD    (1u << 2)   /**< gpu_percent */
+#define STATS_DIRTY_GPU_TEMP    (1u << 3)   /**< gpu_temp */
+#define STATS_DIRTY_VRAM        (1u << 4)   /**< gpu_vram_used, gpu_vram_total */
+#define STATS_DIRTY_RAM         (1u << 5)   /**< ram_used_gb, ram_total_gb */
+#define STATS_DIRTY_NET_RATE    (1u << 6)   /**< net_down_mbps, net_up_mbps */
+#define STATS_DIRTY_NET_LINK    (1u << 7)   /**< net_type, net_speed */
+#define STATS_DIRTY_DISK        (1u << 8)   /**< disk_* */
+#define STATS_DIRTY_ALL         0x1FFu
+
 /**
  * @brief PC Stats data structure
  *
@@ -41,8 +56,63 @@ typedef struct {
     char net_speed[16];         /**< Link speed: "1000 Mbps" etc */
     float net_down_mbps;        /**< Download speed in Mbps, -1 = error */
     float net_up_mbps;          /**< Upload speed in Mbps, -1 = error */
+
+    /* Disk I/O (sum over all physical disks, -1 = N/A / old client) */
+    float disk_read_mbs;        /**< Read throughput in MB/s */
+    float disk_write_mbs;       /**< Write throughput in MB/s */
+    float disk_read_iops;       /**< Read operations per second */
+    float disk_write_iops;      /**< Write operations per second */
+    float disk_queue;           /**< Average queue depth */
+    float disk_latency_ms;      /**< Mean service time per I/O in ms */
+
+    uint32_t seq;               /**< Incremented per accepted stats line */
+    uint32_t dirty;             /**< STATS_DIRTY_* groups changed vs. line seq - 1 */
 } pc_stats_t;
 
+/* Top-N process list (TOP: line from the PC client) */
+#define PROC_TOP_COUNT      5       /**< Rows in the process list */
+#define PROC_NAME_LEN       16      /**< Incl. terminator, client truncates to 15 */
+
+/**
+ * @brief One row of the top-N process list
+ */
+typedef struct {
+    char name[PROC_NAME_LEN];   /**< Process name, "" = empty row */
+    float cpu_percent;          /**< Share of all cores 0-100 */
+    uint32_t mem_mb;            /**< Resident memory in MB */
+} proc_entry_t;
+
+/**
+ * @brief Top-N process list, ordered by CPU share (highest first)
+ *
+ * The client only sends a new list when the ranking changes, so seq lets
+ * the UI skip the compare when nothing arrived.
+ */
+typedef struct {
+    uint8_t count;                          /**< Valid rows (0..PROC_TOP_COUNT) */
+    uint32_t seq;                           /**< Incremented per accepted TOP: line */
+    proc_entry_t entries[PROC_TOP_COUNT];
+} proc_top_t;
+
+/* History backfill (HIST: line, sent once after the handshake) */
+#define HISTORY_POINTS      60      /**< Chart width: one point per stats packet */
+
+/**
+ * @brief Recent rates from the client's history ring, oldest first
+ *
+ * Rates are in 0.1 MB/s. Lets the charts resume with real history after a
+ * reboot or USB hiccup instead of 60 zeros.
+ */
+typedef struct {
+    uint8_t count;                          /**< Points per series (0..HISTORY_POINTS) */
+    bool has_disk;                          /**< DSKR/DSKW lists were present */
+    uint32_t seq;                           /**< Incremented per accepted HIST: line */
+    int32_t net_down[HISTORY_POINTS];
+    int32_t net_up[HISTORY_POINTS];
+    int32_t disk_read[HISTORY_POINTS];
+    int32_t disk_write[HISTORY_POINTS];
+} history_backfill_t;
+
 #ifdef __cplusplus
 }
 #endif
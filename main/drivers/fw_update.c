@@ -5,10 +5,17 @@
  * Runs entirely in the USB RX task. Uses OTA_WITH_SEQUENTIAL_WRITES so flash
  * sectors are erased lazily during writes - no long blocking erase that would
  * trip the 5s Task Watchdog.
+ *
+ * Background staging (FW_STAGE) bypasses the OTA handle: esp_ota_begin cannot
+ * reopen a partly written slot, so chunks go straight to the partition with
+ * esp_partition_write (same lazy per-sector erase) and progress + running CRC
+ * are checkpointed to LittleFS. esp_ota_set_boot_partition runs the full
+ * ESP-IDF image validation before it switches slots.
  */
 
 #include "fw_update.h"
 #include "usb_serial_comm.h"
+#include "core/codec.h"
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
@@ -16,21 +23,32 @@
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_ota_ops.h"
+#include "esp_partition.h"
 #include "esp_app_desc.h"
 #include "esp_system.h"
 
 static const char *TAG = "FW-UPDATE";
 
-/* Chunk payload limit: FW_DATA line = "FW_DATA:<offset>:" + 2*N hex chars.
- * With N=1024 the line is ~2065 chars, well inside USB_LINE_BUFFER_SIZE (4096). */
-#define FW_CHUNK_MAX        1024
+/* Chunk payload limit: FW_DATA line = "FW_DATA:<offset>:" + 2*N hex chars
+ * (+ ":<crc32>" from FEAT:CRC clients).
+ * Same limit the client learns from GET_CAPS, so any chunk that fits the
+ * USB line buffer also fits here. */
+#define FW_CHUNK_MAX        USB_MAX_CHUNK_BYTES
 
 /* Minimum plausible app image size (real builds are ~1MB+) */
 #define FW_MIN_SIZE         0x10000
 
+/* Background staging */
+#define FW_STAGE_FILE_PATH  "/storage/fw_stage.bin"
+#define FW_STAGE_MAGIC      0x46575354      /* "FWST" */
+#define FW_STAGE_CHECKPOINT 0x10000         /* Persist progress every 64 KB */
+#define FW_SECTOR_SIZE      0x1000
+#define FW_APPLY_DELAY_MS   200             /* Let the log/notice drain before restart */
+
 typedef enum {
     FW_STATE_IDLE = 0,
-    FW_STATE_RECEIVING
+    FW_STATE_RECEIVING,
+    FW_STATE_STAGING
 } fw_state_t;
 
 typedef struct {
@@ -40,51 +58,92 @@ typedef struct {
     uint32_t expected_size;
     uint32_t received_size;
     uint32_t crc32;
+    /* FW_STAGING only */
+    uint32_t image_crc;         /* Final CRC announced by FW_STAGE */
+    uint32_t erased_to;         /* Partition offset erased so far */
+    uint32_t checkpoint;        /* received_size at the last persisted record */
 } fw_ctx_t;
 
+/* Persisted staging progress (LittleFS). crc_state is the running CRC at
+ * 'received', so a resume continues the checksum without re-reading flash. */
+typedef struct {
+    uint32_t magic;
+    uint32_t image_size;
+    uint32_t image_crc;
+    uint32_t target_addr;
+    uint32_t received;
+    uint32_t crc_state;
+} fw_stage_record_t;
+
 static fw_ctx_t s_ctx = {0};
+static volatile bool s_staged_pending = false;  /* Boot partition already switched */
 
 /* =============================================================================
- * CRC32 (same polynomial/convention as image upload and C# client)
+ * BACKGROUND STAGING
  * ========================================================================== */
-#define CRC32_INIT 0xFFFFFFFF
 
-static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+static void stage_record_save(void)
 {
-    while (len--) {
-        crc ^= *data++;
-        for (int i = 0; i < 8; i++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & ~((crc & 1) - 1));
-        }
+    fw_stage_record_t rec = {
+        .magic = FW_STAGE_MAGIC,
+        .image_size = s_ctx.expected_size,
+        .image_crc = s_ctx.image_crc,
+        .target_addr = s_ctx.target->address,
+        .received = s_ctx.received_size,
+        .crc_state = s_ctx.crc32,
+    };
+
+    FILE *f = fopen(FW_STAGE_FILE_PATH, "wb");
+    if (f == NULL) {
+        ESP_LOGW(TAG, "Cannot write %s - staging will restart from 0 after reboot",
+                 FW_STAGE_FILE_PATH);
+        return;
     }
-    return crc;
+    fwrite(&rec, sizeof(rec), 1, f);
+    fclose(f);
+    s_ctx.checkpoint = s_ctx.received_size;
 }
 
-/* =============================================================================
- * HELPERS
- * ========================================================================== */
+static bool stage_record_load(fw_stage_record_t *rec)
+{
+    FILE *f = fopen(FW_STAGE_FILE_PATH, "rb");
+    if (f == NULL) return false;
 
-static int hex_nibble(char c)
+    bool ok = (fread(rec, sizeof(*rec), 1, f) == 1) && rec->magic == FW_STAGE_MAGIC;
+    fclose(f);
+    return ok;
+}
+
+static void stage_record_clear(void)
 {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    return -1;
+    remove(FW_STAGE_FILE_PATH);
 }
 
-/* Decode hex string into buf. Returns decoded byte count, or -1 on bad input. */
-static int hex_decode(const char *hex, uint8_t *buf, size_t buf_size)
+/* Undo a finished-but-not-yet-applied staging: keep booting the running app */
+static void stage_revert_boot(void)
 {
-    size_t hex_len = strlen(hex);
-    if (hex_len % 2 != 0 || hex_len / 2 > buf_size) return -1;
+    if (!s_staged_pending) return;
 
-    for (size_t i = 0; i < hex_len / 2; i++) {
-        int hi = hex_nibble(hex[i * 2]);
-        int lo = hex_nibble(hex[i * 2 + 1]);
-        if (hi < 0 || lo < 0) return -1;
-        buf[i] = (uint8_t)((hi << 4) | lo);
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (running && esp_ota_set_boot_partition(running) != ESP_OK) {
+        ESP_LOGE(TAG, "Could not switch boot partition back to %s", running->label);
     }
-    return (int)(hex_len / 2);
+    s_staged_pending = false;
+}
+
+/* Raw partition write with lazy per-sector erase (watchdog-safe like
+ * OTA_WITH_SEQUENTIAL_WRITES). After a resume the sector holding 'received'
+ * may already contain bytes past the checkpoint; they are rewritten with
+ * identical data, which NOR flash accepts without an erase. */
+static esp_err_t stage_write(const uint8_t *data, size_t len)
+{
+    uint32_t end = s_ctx.received_size + (uint32_t)len;
+    while (s_ctx.erased_to < end) {
+        esp_err_t err = esp_partition_erase_range(s_ctx.target, s_ctx.erased_to, FW_SECTOR_SIZE);
+        if (err != ESP_OK) return err;
+        s_ctx.erased_to += FW_SECTOR_SIZE;
+    }
+    return esp_partition_write(s_ctx.target, s_ctx.received_size, data, len);
 }
 
 static void fw_abort_upload(void)
@@ -92,6 +151,10 @@ static void fw_abort_upload(void)
     if (s_ctx.state == FW_STATE_RECEIVING) {
         esp_ota_abort(s_ctx.ota_handle);
     }
+    if (s_ctx.state == FW_STATE_STAGING || s_staged_pending) {
+        stage_record_clear();
+    }
+    stage_revert_boot();
     memset(&s_ctx, 0, sizeof(s_ctx));
 }
 
@@ -137,16 +200,85 @@ static bool handle_fw_begin(const char *line)
     s_ctx.target = target;
     s_ctx.expected_size = (uint32_t)size;
     s_ctx.received_size = 0;
-    s_ctx.crc32 = CRC32_INIT;
+    s_ctx.crc32 = CODEC_CRC32_INIT;
 
     ESP_LOGI(TAG, "FW update started: %lu bytes -> partition %s", size, target->label);
     usb_serial_send("FW_OK:BEGIN\n");
     return true;
 }
 
+static bool handle_fw_stage(const char *line)
+{
+    unsigned long size;
+    unsigned int image_crc;
+    if (sscanf(line, "FW_STAGE:%lu:%x", &size, &image_crc) != 2) {
+        usb_serial_send("FW_ERR:PARSE\n");
+        return true;
+    }
+
+    const esp_partition_t *target = esp_ota_get_next_update_partition(NULL);
+    if (!target) {
+        ESP_LOGE(TAG, "No OTA update partition found (partition table has no ota_0/ota_1?)");
+        usb_serial_send("FW_ERR:NOPART\n");
+        return true;
+    }
+
+    if (size < FW_MIN_SIZE || size > target->size) {
+        ESP_LOGE(TAG, "Invalid size %lu (partition %s is %" PRIu32 " bytes)",
+                 size, target->label, target->size);
+        usb_serial_send("FW_ERR:SIZE\n");
+        return true;
+    }
+
+    /* Same image as the session still open in RAM (client reconnected) */
+    if (s_ctx.state == FW_STATE_STAGING && s_ctx.target == target &&
+        s_ctx.expected_size == (uint32_t)size && s_ctx.image_crc == (uint32_t)image_crc) {
+        ESP_LOGI(TAG, "FW staging resumed at %" PRIu32 " / %lu bytes", s_ctx.received_size, size);
+        usb_serial_sendf("FW_OK:BEGIN:%" PRIu32 "\n", s_ctx.received_size);
+        return true;
+    }
+
+    /* Same image as the last persisted checkpoint (earlier boot) */
+    fw_stage_record_t rec;
+    bool resume = stage_record_load(&rec) &&
+                  rec.target_addr == target->address &&
+                  rec.image_size == (uint32_t)size &&
+                  rec.image_crc == (uint32_t)image_crc &&
+                  rec.received <= rec.image_size;
+
+    if (!resume) {
+        /* Different image (or none): drop whatever was staged before */
+        fw_abort_upload();
+    } else if (s_ctx.state == FW_STATE_RECEIVING) {
+        esp_ota_abort(s_ctx.ota_handle);
+    }
+
+    memset(&s_ctx, 0, sizeof(s_ctx));
+    s_ctx.state = FW_STATE_STAGING;
+    s_ctx.target = target;
+    s_ctx.expected_size = (uint32_t)size;
+    s_ctx.image_crc = (uint32_t)image_crc;
+
+    if (resume) {
+        s_ctx.received_size = rec.received;
+        s_ctx.crc32 = rec.crc_state;
+        s_ctx.checkpoint = rec.received;
+        s_ctx.erased_to = (rec.received + FW_SECTOR_SIZE - 1) & ~(uint32_t)(FW_SECTOR_SIZE - 1);
+        ESP_LOGI(TAG, "FW staging resumed from checkpoint: %" PRIu32 " / %lu bytes -> %s",
+                 rec.received, size, target->label);
+    } else {
+        s_ctx.crc32 = CODEC_CRC32_INIT;
+        stage_record_save();
+        ESP_LOGI(TAG, "FW staging started: %lu bytes -> partition %s", size, target->label);
+    }
+
+    usb_serial_sendf("FW_OK:BEGIN:%" PRIu32 "\n", s_ctx.received_size);
+    return true;
+}
+
 static bool handle_fw_data(const char *line)
 {
-    if (s_ctx.state != FW_STATE_RECEIVING) {
+    if (s_ctx.state != FW_STATE_RECEIVING && s_ctx.state != FW_STATE_STAGING) {
         usb_serial_send("FW_ERR:NOBEGIN\n");
         return true;
     }
@@ -171,10 +303,19 @@ static bool handle_fw_data(const char *line)
         return true;
     }
 
+    /* A chunk with a CRC that fails to decode or verify was damaged on the
+     * wire: NAK it so the client resends just this chunk. Nothing is written
+     * and received_size stays, so the resend lands at the same offset. */
     static uint8_t chunk_buf[FW_CHUNK_MAX];
-    int data_len = hex_decode(hex_start, chunk_buf, sizeof(chunk_buf));
+    bool has_crc;
+    int data_len = codec_chunk_decode(hex_start, chunk_buf, sizeof(chunk_buf), &has_crc);
     if (data_len <= 0) {
-        usb_serial_send("FW_ERR:HEX\n");
+        if (has_crc) {
+            ESP_LOGW(TAG, "Chunk at %" PRIu32 " damaged - NAK", s_ctx.received_size);
+            usb_serial_sendf("FW_NAK:%" PRIu32 "\n", s_ctx.received_size);
+        } else {
+            usb_serial_send("FW_ERR:HEX\n");
+        }
         return true;
     }
 
@@ -183,7 +324,9 @@ static bool handle_fw_data(const char *line)
         return true;
     }
 
-    esp_err_t err = esp_ota_write(s_ctx.ota_handle, chunk_buf, (size_t)data_len);
+    esp_err_t err = (s_ctx.state == FW_STATE_STAGING)
+                  ? stage_write(chunk_buf, (size_t)data_len)
+                  : esp_ota_write(s_ctx.ota_handle, chunk_buf, (size_t)data_len);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "esp_ota_write failed at %" PRIu32 ": %s",
                  s_ctx.received_size, esp_err_to_name(err));
@@ -192,9 +335,14 @@ static bool handle_fw_data(const char *line)
         return true;
     }
 
-    s_ctx.crc32 = crc32_update(s_ctx.crc32, chunk_buf, (size_t)data_len);
+    s_ctx.crc32 = codec_crc32_update(s_ctx.crc32, chunk_buf, (size_t)data_len);
     s_ctx.received_size += (uint32_t)data_len;
 
+    if (s_ctx.state == FW_STATE_STAGING &&
+        s_ctx.received_size - s_ctx.checkpoint >= FW_STAGE_CHECKPOINT) {
+        stage_record_save();
+    }
+
     if (s_ctx.received_size % 65536 < (uint32_t)data_len) {
         ESP_LOGI(TAG, "FW progress: %" PRIu32 " / %" PRIu32 " bytes",
                  s_ctx.received_size, s_ctx.expected_size);
@@ -204,9 +352,39 @@ static bool handle_fw_data(const char *line)
     return true;
 }
 
+/* FW_END of a background staging: verify and switch slots, restart later */
+static bool finish_staging(uint32_t final_crc, uint32_t expected_crc)
+{
+    if (final_crc != expected_crc || final_crc != s_ctx.image_crc) {
+        ESP_LOGE(TAG, "Staged FW CRC mismatch: got 0x%08" PRIX32 ", expected 0x%08" PRIX32,
+                 final_crc, expected_crc);
+        fw_abort_upload();
+        usb_serial_sendf("FW_ERR:CRC:%08" PRIX32 "\n", final_crc);
+        return true;
+    }
+
+    /* Validates the image (magic byte, SHA256, segments) before switching */
+    esp_err_t err = esp_ota_set_boot_partition(s_ctx.target);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Staged image rejected: %s", esp_err_to_name(err));
+        fw_abort_upload();
+        usb_serial_send("FW_ERR:VALIDATE\n");
+        return true;
+    }
+
+    /* Keep the (complete) record: re-staging the same image answers at once */
+    stage_record_save();
+    s_staged_pending = true;
+
+    ESP_LOGI(TAG, "FW staged in %s - restarting when idle", s_ctx.target->label);
+    memset(&s_ctx, 0, sizeof(s_ctx));
+    usb_serial_send("FW_OK:STAGED\n");
+    return true;
+}
+
 static bool handle_fw_end(const char *line)
 {
-    if (s_ctx.state != FW_STATE_RECEIVING) {
+    if (s_ctx.state != FW_STATE_RECEIVING && s_ctx.state != FW_STATE_STAGING) {
         usb_serial_send("FW_ERR:NOBEGIN\n");
         return true;
     }
@@ -223,6 +401,10 @@ static bool handle_fw_end(const char *line)
     }
 
     uint32_t final_crc = ~s_ctx.crc32;
+    if (s_ctx.state == FW_STATE_STAGING) {
+        return finish_staging(final_crc, (uint32_t)expected_crc);
+    }
+
     if (final_crc != (uint32_t)expected_crc) {
         ESP_LOGE(TAG, "FW CRC mismatch: got 0x%08" PRIX32 ", expected 0x%08X",
                  final_crc, expected_crc);
@@ -284,6 +466,9 @@ bool fw_update_handle_command(const char *line)
     if (strncmp(line, "FW_BEGIN:", 9) == 0) {
         return handle_fw_begin(line);
     }
+    else if (strncmp(line, "FW_STAGE:", 9) == 0) {
+        return handle_fw_stage(line);
+    }
     else if (strncmp(line, "FW_DATA:", 8) == 0) {
         return handle_fw_data(line);
     }
@@ -299,3 +484,17 @@ bool fw_update_handle_command(const char *line)
 
     return false;
 }
+
+void fw_update_apply_staged_if_idle(bool idle)
+{
+    if (!s_staged_pending || !idle || s_ctx.state != FW_STATE_IDLE) {
+        return;
+    }
+
+    const esp_partition_t *boot = esp_ota_get_boot_partition();
+    ESP_LOGW(TAG, "Device idle - restarting into staged firmware (%s)",
+             boot ? boot->label : "?");
+    usb_serial_send("FW_OK:RESTART\n");
+    vTaskDelay(pdMS_TO_TICKS(FW_APPLY_DELAY_MS));
+    esp_restart();
+}
@@ -17,6 +17,16 @@
  *   PC  -> ESP: FW_ABORT                   (cancel at any time)
  *   PC  -> ESP: GET_FW_VER
  *   ESP -> PC:  FW_VER:<version>:<running-partition>
+ *
+ * Background staging (trickled alongside normal telemetry, resumable):
+ *   PC  -> ESP: FW_STAGE:<size>:<crc32-hex>
+ *   ESP -> PC:  FW_OK:BEGIN:<resume-offset>   (0 for a new image)
+ *   ... FW_DATA / FW_END as above ...
+ *   ESP -> PC:  FW_OK:STAGED               image verified, boot partition switched,
+ *                                           device restarts once it is idle
+ * Staging progress is checkpointed to LittleFS, so a later FW_STAGE for the
+ * same image (size + CRC) continues where the last session stopped - also
+ * across device reboots. FW_BEGIN or FW_ABORT discards a staged image.
  */
 
 #ifndef FW_UPDATE_H
@@ -31,4 +41,15 @@
  */
 bool fw_update_handle_command(const char *line);
 
+/**
+ * @brief Restart into a staged image once the device is idle
+ *
+ * Call periodically from the display task. Does nothing unless FW_STAGE
+ * completed and no firmware transfer is running.
+ *
+ * @param idle true if nothing is on screen that the user is watching
+ *             (screensaver active, no upload in progress)
+ */
+void fw_update_apply_staged_if_idle(bool idle);
+
 #endif /* FW_UPDATE_H */
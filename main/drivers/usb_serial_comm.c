@@ -4,9 +4,14 @@
  */
 
 #include "usb_serial_comm.h"
+#include "protocol_gen.h"
 #include "../storage/hw_identity.h"
+#include "../core/alert_rules.h"
+#include "../core/metric_vm.h"
+#include "../core/postmortem.h"
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <stdarg.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -31,6 +36,9 @@ static const char *TAG = "USB-COMM";
 
 /* Global state */
 static pc_stats_t s_pc_stats = {0};
+static proc_top_t s_proc_top = {0};
+static history_backfill_t s_history = {0};
+static alert_state_t s_alerts = {0};
 static volatile uint32_t s_last_data_ms = 0;
 static SemaphoreHandle_t s_stats_mutex = NULL;
 static uint32_t s_stats_mutex_timeouts = 0;
@@ -53,11 +61,32 @@ static struct {
     }                                                 \
 } while (0)
 
-/* Command handlers (max 8) */
-#define MAX_CMD_HANDLERS 8
+/* Command handlers (max 12) */
+#define MAX_CMD_HANDLERS 12
 static usb_cmd_handler_t s_handlers[MAX_CMD_HANDLERS] = {0};
 static int s_handler_count = 0;
 
+/* GET_CAPS: FEAT: tokens of the registered modules and the display geometry */
+#define MAX_CAPS_FEATURES 12
+#define CAPS_FEATURE_MAX_LEN 8          /* Longer tokens are rejected at registration */
+static const char *s_features[MAX_CAPS_FEATURES] = {0};
+static int s_feature_count = 0;
+static int s_disp_count = 0, s_disp_width = 0, s_disp_height = 0;
+
+/* Host presence and TX state.
+ * s_tx_stalled: a write timed out although SOF is present - the port is
+ * enumerated but nobody reads it (client closed). Further writes are
+ * dropped until the host sends a byte, so no task waits on a full FIFO. */
+static volatile bool s_host_connected = false;
+static volatile bool s_tx_stalled = false;
+static volatile uint32_t s_host_change_ms = 0;
+static usb_tx_stats_t s_tx_stats = {0};
+
+/* Request ID of the line being handled (0 = none). Set and read by the RX
+ * task only; its sends while the ID is set are the replies to that request. */
+static TaskHandle_t s_rx_task = NULL;
+static uint16_t s_rpc_id = 0;
+
 /* =============================================================================
  * INITIALIZATION
  * ========================================================================== */
@@ -69,9 +98,14 @@ esp_err_t usb_serial_init(void)
         .tx_buffer_size = USB_TX_BUFFER_SIZE
     };
 
+    memset(s_alerts.force_view, ALERT_NO_VIEW, sizeof(s_alerts.force_view));
+
     esp_err_t ret = usb_serial_jtag_driver_install(&usb_cfg);
     if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "USB Serial JTAG initialized");
+        s_host_connected = usb_serial_jtag_is_connected();
+        s_host_change_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        ESP_LOGI(TAG, "USB Serial JTAG initialized (host %s)",
+                 s_host_connected ? "present" : "absent");
     } else {
         ESP_LOGE(TAG, "USB Serial JTAG init failed: %s", esp_err_to_name(ret));
     }
@@ -88,11 +122,43 @@ pc_stats_t *usb_serial_get_stats(void)
     return &s_pc_stats;
 }
 
+proc_top_t *usb_serial_get_proc_top(void)
+{
+    return &s_proc_top;
+}
+
+history_backfill_t *usb_serial_get_history(void)
+{
+    return &s_history;
+}
+
+alert_state_t *usb_serial_get_alerts(void)
+{
+    return &s_alerts;
+}
+
 uint32_t usb_serial_get_last_data_time(void)
 {
     return s_last_data_ms;
 }
 
+bool usb_serial_host_connected(void)
+{
+    return s_host_connected;
+}
+
+uint32_t usb_serial_get_host_change_time(void)
+{
+    return s_host_change_ms;
+}
+
+void usb_serial_get_tx_stats(usb_tx_stats_t *out)
+{
+    if (out) {
+        *out = s_tx_stats;
+    }
+}
+
 void usb_serial_register_handler(usb_cmd_handler_t handler)
 {
     if (s_handler_count < MAX_CMD_HANDLERS && handler != NULL) {
@@ -100,108 +166,151 @@ void usb_serial_register_handler(usb_cmd_handler_t handler)
     }
 }
 
+void usb_serial_register_feature(const char *token)
+{
+    if (token == NULL) {
+        return;
+    }
+    if (s_feature_count >= MAX_CAPS_FEATURES || strlen(token) > CAPS_FEATURE_MAX_LEN) {
+        ESP_LOGE(TAG, "Feature %s not announced (max %d tokens of %d chars)",
+                 token, MAX_CAPS_FEATURES, CAPS_FEATURE_MAX_LEN);
+        return;
+    }
+    s_features[s_feature_count++] = token;
+}
+
+void usb_serial_set_displays(int count, int width, int height)
+{
+    s_disp_count = count;
+    s_disp_width = width;
+    s_disp_height = height;
+}
+
 /* =============================================================================
  * SEND FUNCTIONS
  * ========================================================================== */
 
+static void usb_tx(const char *data, size_t len)
+{
+    if (!s_host_connected || s_tx_stalled) {
+        s_tx_stats.tx_dropped++;
+        return;
+    }
+
+    int written = usb_serial_jtag_write_bytes((const uint8_t *)data, len,
+                                              pdMS_TO_TICKS(USB_TX_TIMEOUT_MS));
+    if (written > 0) {
+        s_tx_stats.tx_bytes += (uint32_t)written;
+    }
+    if (written < (int)len) {
+        s_tx_stats.tx_short++;
+        if (!s_tx_stalled) {
+            s_tx_stalled = true;
+            ESP_LOGW(TAG, "TX stalled (%d/%u bytes) - muting until host sends",
+                     written, (unsigned)len);
+        }
+    }
+}
+
+static bool in_rpc_reply(void)
+{
+    return s_rpc_id != 0 && xTaskGetCurrentTaskHandle() == s_rx_task;
+}
+
 void usb_serial_send(const char *response)
 {
-    if (response) {
-        size_t len = strlen(response);
-        usb_serial_jtag_write_bytes((const uint8_t *)response, len, pdMS_TO_TICKS(100));
+    if (!response) return;
+
+    if (in_rpc_reply()) {
+        usb_serial_sendf("%s", response);   /* Needs the ID tag in front */
+    } else {
+        usb_tx(response, strlen(response));
     }
 }
 
+/* Formats one line into buf, with the RPC tag in front while answering a
+ * tagged request, and sends it. A line that does not fit is logged and cut,
+ * still ending in '\n' so the host sees where it ends. */
+static void send_linev(char *buf, size_t size, const char *fmt, va_list args)
+{
+    int tag = in_rpc_reply() ? snprintf(buf, size, PROTO_CMD_RPC_TAG "%u:", s_rpc_id) : 0;
+    int len = vsnprintf(buf + tag, size - tag, fmt, args);
+    if (len <= 0) {
+        return;
+    }
+
+    len += tag;
+    if (len >= (int)size) {
+        ESP_LOGE(TAG, "Reply truncated (%d > %u bytes): %.24s...", len, (unsigned)size - 1, buf);
+        len = (int)size - 1;
+        buf[len - 1] = '\n';
+    }
+    usb_tx(buf, (size_t)len);
+}
+
+static void send_line(char *buf, size_t size, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    send_linev(buf, size, fmt, args);
+    va_end(args);
+}
+
 void usb_serial_sendf(const char *fmt, ...)
 {
     char buf[256];
+
     va_list args;
     va_start(args, fmt);
-    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    send_linev(buf, sizeof(buf), fmt, args);
     va_end(args);
-
-    if (len > 0) {
-        usb_serial_jtag_write_bytes((const uint8_t *)buf, len, pdMS_TO_TICKS(100));
-    }
 }
 
 /* =============================================================================
  * DATA PARSER
  * ========================================================================== */
 
+/* Field groups that differ between two accepted lines (STATS_DIRTY_*).
+ * Exact compares: a value is dirty whenever its displayed text could change. */
+static uint32_t stats_dirty_mask(const pc_stats_t *prev, const pc_stats_t *next)
+{
+    uint32_t dirty = 0;
+
+    if (next->cpu_percent != prev->cpu_percent) dirty |= STATS_DIRTY_CPU_LOAD;
+    if (next->cpu_temp != prev->cpu_temp)       dirty |= STATS_DIRTY_CPU_TEMP;
+    if (next->gpu_percent != prev->gpu_percent) dirty |= STATS_DIRTY_GPU_LOAD;
+    if (next->gpu_temp != prev->gpu_temp)       dirty |= STATS_DIRTY_GPU_TEMP;
+    if (next->gpu_vram_used != prev->gpu_vram_used ||
+        next->gpu_vram_total != prev->gpu_vram_total) dirty |= STATS_DIRTY_VRAM;
+    if (next->ram_used_gb != prev->ram_used_gb ||
+        next->ram_total_gb != prev->ram_total_gb)     dirty |= STATS_DIRTY_RAM;
+    if (next->net_down_mbps != prev->net_down_mbps ||
+        next->net_up_mbps != prev->net_up_mbps)       dirty |= STATS_DIRTY_NET_RATE;
+    if (strcmp(next->net_type, prev->net_type) != 0 ||
+        strcmp(next->net_speed, prev->net_speed) != 0) dirty |= STATS_DIRTY_NET_LINK;
+    if (next->disk_read_mbs != prev->disk_read_mbs ||
+        next->disk_write_mbs != prev->disk_write_mbs ||
+        next->disk_read_iops != prev->disk_read_iops ||
+        next->disk_write_iops != prev->disk_write_iops ||
+        next->disk_queue != prev->disk_queue ||
+        next->disk_latency_ms != prev->disk_latency_ms) dirty |= STATS_DIRTY_DISK;
+
+    return dirty;
+}
+
 static void parse_pc_data(const char *line)
 {
     if (!line || strlen(line) < 5) return;
 
-    /* Make a mutable copy for strtok */
-    char buffer[USB_LINE_BUFFER_SIZE];
-    strncpy(buffer, line, sizeof(buffer) - 1);
-    buffer[sizeof(buffer) - 1] = '\0';
-
-    /* Parse into temporary struct first to avoid partial updates */
-    pc_stats_t temp_stats = {0};
-    int fields_parsed = 0;
-    char *token = strtok(buffer, ",");
-
-    while (token != NULL) {
-        if (strncmp(token, "CPU:", 4) == 0) {
-            temp_stats.cpu_percent = (int16_t)atoi(token + 4);
-            fields_parsed++;
-        }
-        else if (strncmp(token, "CPUT:", 5) == 0) {
-            temp_stats.cpu_temp = atof(token + 5);
-            fields_parsed++;
-        }
-        else if (strncmp(token, "GPU:", 4) == 0) {
-            temp_stats.gpu_percent = (int16_t)atoi(token + 4);
-            fields_parsed++;
-        }
-        else if (strncmp(token, "GPUT:", 5) == 0) {
-            temp_stats.gpu_temp = atof(token + 5);
-            fields_parsed++;
-        }
-        else if (strncmp(token, "VRAM:", 5) == 0) {
-            if (sscanf(token + 5, "%f/%f", &temp_stats.gpu_vram_used, &temp_stats.gpu_vram_total) == 2) {
-                fields_parsed++;
-            } else {
-                temp_stats.gpu_vram_used = -1.0f;   /* N/A - do not invent values */
-                temp_stats.gpu_vram_total = -1.0f;
-            }
-        }
-        else if (strncmp(token, "RAM:", 4) == 0) {
-            if (sscanf(token + 4, "%f/%f", &temp_stats.ram_used_gb, &temp_stats.ram_total_gb) == 2) {
-                fields_parsed++;
-            } else {
-                temp_stats.ram_used_gb = -1.0f;     /* N/A - do not invent values */
-                temp_stats.ram_total_gb = -1.0f;
-            }
-        }
-        else if (strncmp(token, "NET:", 4) == 0) {
-            strncpy(temp_stats.net_type, token + 4, sizeof(temp_stats.net_type) - 1);
-            temp_stats.net_type[sizeof(temp_stats.net_type) - 1] = '\0';
-            fields_parsed++;
-        }
-        else if (strncmp(token, "SPEED:", 6) == 0) {
-            strncpy(temp_stats.net_speed, token + 6, sizeof(temp_stats.net_speed) - 1);
-            temp_stats.net_speed[sizeof(temp_stats.net_speed) - 1] = '\0';
-            fields_parsed++;
-        }
-        else if (strncmp(token, "DOWN:", 5) == 0) {
-            temp_stats.net_down_mbps = atof(token + 5);
-            fields_parsed++;
-        }
-        else if (strncmp(token, "UP:", 3) == 0) {
-            temp_stats.net_up_mbps = atof(token + 3);
-            fields_parsed++;
-        }
-
-        token = strtok(NULL, ",");
-    }
+    /* Parse into temporary struct first to avoid partial updates.
+     * Field layout, defaults and N/A rules come from the protocol schema. */
+    pc_stats_t temp_stats;
+    int fields_parsed = proto_stats_decode(line, &temp_stats);
 
     /* Only commit if we got enough fields (avoid partial/corrupt updates) */
-    if (fields_parsed >= 5) {
+    if (fields_parsed >= PROTO_STATS_MIN_FIELDS) {
         /* Thread-safe write with timeout - NEVER use portMAX_DELAY! */
-        if (xSemaphoreTake(s_stats_mutex, pdMS_TO_TICKS(STATS_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+        if (postmortem_take(POSTMORTEM_LOCK_STATS, s_stats_mutex, pdMS_TO_TICKS(STATS_MUTEX_TIMEOUT_MS))) {
             /* Absorb single-sample sensor glitches: replace freshly-arrived
              * N/A fields with the last valid value for a few packets. */
             HOLD_FIELD(temp_stats.cpu_percent, s_pc_stats.cpu_percent, s_hold.cpu_pct);
@@ -231,8 +340,20 @@ static void parse_pc_data(const char *line)
                 s_hold.ram = 0;
             }
 
+            /* seq is the generation counter: lets screens with history
+             * (sparklines) advance once per packet even when consecutive
+             * values are identical. dirty tells the UI which field groups
+             * this generation changed, so it never re-compares values. */
+            temp_stats.seq = s_pc_stats.seq + 1;
+            temp_stats.dirty = stats_dirty_mask(&s_pc_stats, &temp_stats);
+
             s_pc_stats = temp_stats;
             s_last_data_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+            /* Custom metrics and alerts are decided here, so the display
+             * task gets them with the sample that triggered them */
+            metric_vm_evaluate(&s_pc_stats, s_last_data_ms);
+            alert_rules_evaluate(&s_pc_stats, s_last_data_ms, &s_alerts);
             xSemaphoreGive(s_stats_mutex);
             ESP_LOGD(TAG, "Parsed %d fields, timestamp updated", fields_parsed);
         } else {
@@ -246,20 +367,165 @@ static void parse_pc_data(const char *line)
     }
 }
 
+/* =============================================================================
+ * PROCESS LIST PARSER (built-in)
+ *
+ * TOP:name|cpu|memMB;name|cpu|memMB;...   (max PROC_TOP_COUNT entries)
+ * Not a heartbeat: it does not touch s_last_data_ms, only stats lines do.
+ * ========================================================================== */
+
+static bool handle_proc_top(const char *line)
+{
+    if (strncmp(line, PROTO_CMD_PROC_TOP, 4) != 0) return false;
+
+    proc_top_t temp = {0};
+    const char *p = line + 4;
+
+    while (*p && temp.count < PROC_TOP_COUNT) {
+        const char *end = strchr(p, ';');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        char entry[64];
+        if (len >= sizeof(entry)) len = sizeof(entry) - 1;
+        memcpy(entry, p, len);
+        entry[len] = '\0';
+
+        /* name|cpu|mem - name is everything before the first '|' */
+        char *sep1 = strchr(entry, '|');
+        char *sep2 = sep1 ? strchr(sep1 + 1, '|') : NULL;
+        if (sep1 && sep2) {
+            *sep1 = '\0';
+            proc_entry_t *e = &temp.entries[temp.count++];
+            strncpy(e->name, entry, sizeof(e->name) - 1);
+            e->name[sizeof(e->name) - 1] = '\0';
+            e->cpu_percent = atof(sep1 + 1);
+            e->mem_mb = (uint32_t)strtoul(sep2 + 1, NULL, 10);
+        }
+
+        if (!end) break;
+        p = end + 1;
+    }
+
+    if (postmortem_take(POSTMORTEM_LOCK_STATS, s_stats_mutex, pdMS_TO_TICKS(STATS_MUTEX_TIMEOUT_MS))) {
+        temp.seq = s_proc_top.seq + 1;
+        s_proc_top = temp;
+        xSemaphoreGive(s_stats_mutex);
+        ESP_LOGD(TAG, "Process list: %d entries", temp.count);
+    } else {
+        s_stats_mutex_timeouts++;
+        ESP_LOGW(TAG, "Stats mutex timeout! Skipping process list. [timeouts: %lu]",
+                 (unsigned long)s_stats_mutex_timeouts);
+    }
+    return true;
+}
+
+/* =============================================================================
+ * HISTORY BACKFILL PARSER (built-in)
+ *
+ * HIST:<n>[|GAP:g]|DOWN:v,v,...|UP:v,...[|DSKR:v,...|DSKW:v,...]
+ * n points per list, oldest first, values in 0.1 MB/s. Sent once after the
+ * handshake; like TOP: it is not a heartbeat. GAP is the number of packets
+ * the client missed since its newest point: the charts get that many zeros
+ * after the points, and points pushed off the chart by them are dropped.
+ * ========================================================================== */
+
+/* Parses "v,v,..." up to the next '|' into out[]. Returns the value count. */
+static int parse_history_list(const char *p, int32_t *out, int max)
+{
+    int n = 0;
+    while (n < max && *p && *p != '|') {
+        char *end;
+        long v = strtol(p, &end, 10);
+        if (end == p) break;
+        out[n++] = (v > 0) ? (int32_t)v : 0;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return n;
+}
+
+/* Drops the oldest 'drop' of 'count' points; the freed tail reads as zero */
+static void history_drop_oldest(int32_t *list, int count, int drop)
+{
+    memmove(list, list + drop, (size_t)(count - drop) * sizeof(list[0]));
+    memset(list + count - drop, 0, (size_t)drop * sizeof(list[0]));
+}
+
+static bool handle_history(const char *line)
+{
+    if (strncmp(line, PROTO_CMD_HISTORY, 5) != 0) return false;
+
+    /* ~1 KB - static instead of on the RX task stack (single reader) */
+    static history_backfill_t temp;
+    memset(&temp, 0, sizeof(temp));
+
+    int count = atoi(line + 5);
+    if (count <= 0 || count > HISTORY_POINTS) {
+        ESP_LOGW(TAG, "HIST: bad point count %d", count);
+        return true;
+    }
+
+    int down = 0, up = 0, rd = 0, wr = 0, gap = 0;
+    for (const char *p = strchr(line, '|'); p; p = strchr(p + 1, '|')) {
+        if (strncmp(p, "|GAP:", 5) == 0)       gap = atoi(p + 5);
+        else if (strncmp(p, "|DOWN:", 6) == 0) down = parse_history_list(p + 6, temp.net_down, count);
+        else if (strncmp(p, "|UP:", 4) == 0)   up = parse_history_list(p + 4, temp.net_up, count);
+        else if (strncmp(p, "|DSKR:", 6) == 0) rd = parse_history_list(p + 6, temp.disk_read, count);
+        else if (strncmp(p, "|DSKW:", 6) == 0) wr = parse_history_list(p + 6, temp.disk_write, count);
+    }
+
+    /* All lists must be complete - a truncated line would misalign the charts */
+    if (down != count || up != count) {
+        ESP_LOGW(TAG, "HIST: incomplete network lists (%d/%d of %d)", down, up, count);
+        return true;
+    }
+    if (gap < 0 || gap >= HISTORY_POINTS) {
+        ESP_LOGW(TAG, "HIST: gap %d leaves nothing on the chart", gap);
+        return true;
+    }
+    temp.has_disk = (rd == count && wr == count);
+
+    /* Keep the chart's time axis: zeros for the missed packets */
+    int drop = count + gap - HISTORY_POINTS;
+    if (drop > 0) {
+        history_drop_oldest(temp.net_down, count, drop);
+        history_drop_oldest(temp.net_up, count, drop);
+        history_drop_oldest(temp.disk_read, count, drop);
+        history_drop_oldest(temp.disk_write, count, drop);
+        count -= drop;
+    }
+    temp.count = (uint8_t)(count + gap);
+
+    if (postmortem_take(POSTMORTEM_LOCK_STATS, s_stats_mutex, pdMS_TO_TICKS(STATS_MUTEX_TIMEOUT_MS))) {
+        temp.seq = s_history.seq + 1;
+        s_history = temp;
+        xSemaphoreGive(s_stats_mutex);
+        ESP_LOGI(TAG, "History backfill: %d points, gap %d%s", count, gap, temp.has_disk ? " (+disk)" : "");
+    } else {
+        s_stats_mutex_timeouts++;
+        ESP_LOGW(TAG, "Stats mutex timeout! Skipping history backfill. [timeouts: %lu]",
+                 (unsigned long)s_stats_mutex_timeouts);
+    }
+    return true;
+}
+
 /* =============================================================================
  * HANDSHAKE HANDLER (built-in)
  * ========================================================================== */
 
 static bool handle_handshake(const char *line)
 {
-    if (strcmp(line, "WHO_ARE_YOU?") == 0) {
+    if (strcmp(line, PROTO_CMD_HANDSHAKE_QUERY) == 0) {
         hw_identity_t *id = hw_identity_get();
         const esp_app_desc_t *app = esp_app_get_description();
+        char build[9];
         char response[128];
         /* |V:<version> and |N:<device name> appended in v2.4 -
-         * client tolerates their absence (old FW). |N: may be empty. */
-        snprintf(response, sizeof(response), "SCARAB_CLIENT_OK|H:%s|V:%s|N:%s\n",
-                 id->identity_hash, app->version, id->device_name);
+         * client tolerates their absence (old FW). |N: may be empty.
+         * |B:<build> (ELF SHA-256 prefix) changes with every build, unlike
+         * PROJECT_VER - the client keys its GET_CAPS cache on it. */
+        esp_app_get_elf_sha256(build, sizeof(build));
+        snprintf(response, sizeof(response), PROTO_CMD_HANDSHAKE_OK "|H:%s|V:%s|N:%s|B:%s\n",
+                 id->identity_hash, app->version, id->device_name, build);
         usb_serial_send(response);
         ESP_LOGI(TAG, "Handshake: WHO_ARE_YOU? -> %s", response);
         return true;
@@ -267,10 +533,160 @@ static bool handle_handshake(const char *line)
     return false;
 }
 
+/* =============================================================================
+ * CAPABILITY DESCRIPTOR (built-in)
+ *
+ * GET_CAPS -> CAPS:<ver>|LINE:<n>|CHUNK:<n>|ENC:<list>|TELE:<list>|WIN:<n>
+ *             |DISP:<count>x<w>x<h>|FEAT:<list>|DIAG:<list>
+ *
+ * LINE   max line length incl. terminator (USB_LINE_BUFFER_SIZE)
+ * CHUNK  max binary payload per IMG_DATA/FW_DATA line
+ * ENC    payload encodings accepted in *_DATA lines
+ * TELE   stats line versions understood by parse_pc_data
+ * WIN    chunks the client may send before waiting for an ACK
+ * FEAT   optional line types. Built in: TOP: process list, DSK: disk
+ *        field, HIST: HIST: backfill, RPC: @<id>: request IDs echoed on
+ *        replies. Then the tokens registered with
+ *        usb_serial_register_feature(), e.g. VIEW: SET_VIEW command,
+ *        SPR: v2 image header with size/offset, STAGE: FW_STAGE background
+ *        firmware staging, ALRT: ALERT_RULES: threshold table, BENCH:
+ *        on-device self-benchmark, CRC: per-chunk CRC on *_DATA lines,
+ *        damaged chunks get *_NAK, EXPR: METRICS: custom metrics bytecode
+ *        table, PROF: PROFILE_* on-device theme profiles
+ * DIAG   read-only diagnostic commands
+ *
+ * Older firmware stays silent; the client then falls back to the
+ * limits it used to hard-code (1024 byte chunks, HEX, window 1).
+ * ========================================================================== */
+
+#define CAPS_FEATURES_BUILTIN "TOP,DSK,HIST,RPC"
+#define CAPS_FORMAT PROTO_CMD_CAPS "%d|LINE:%d|CHUNK:%d|ENC:HEX|TELE:1|WIN:1" \
+                    "|DISP:%dx%dx%d|FEAT:%s" \
+                    "|DIAG:GET_CAPS,GET_FW_VER,IMG_STATUS,GET_USB_STATS,GET_POSTMORTEM,GET_METRICS\n"
+
+/* Worst case: every token registered at full length, every %d at 11
+ * chars, the longest RPC tag. Too big for usb_serial_sendf's buffer. */
+#define CAPS_FEAT_SIZE  (sizeof(CAPS_FEATURES_BUILTIN) + MAX_CAPS_FEATURES * (1 + CAPS_FEATURE_MAX_LEN))
+#define CAPS_REPLY_SIZE (sizeof(PROTO_CMD_RPC_TAG "65535:") + sizeof(CAPS_FORMAT) + 6 * 11 + CAPS_FEAT_SIZE)
+
+static bool handle_caps(const char *line)
+{
+    if (strcmp(line, PROTO_CMD_GET_CAPS) != 0) {
+        return false;
+    }
+
+    char feat[CAPS_FEAT_SIZE] = CAPS_FEATURES_BUILTIN;
+    size_t len = strlen(feat);
+    for (int i = 0; i < s_feature_count; i++) {
+        int n = snprintf(feat + len, sizeof(feat) - len, ",%s", s_features[i]);
+        if (n < 0 || (size_t)n >= sizeof(feat) - len) {
+            ESP_LOGE(TAG, "GET_CAPS: FEAT list full at %s", s_features[i]);    /* Not expected - see register */
+            feat[len] = '\0';
+            break;
+        }
+        len += (size_t)n;
+    }
+
+    char reply[CAPS_REPLY_SIZE];
+    send_line(reply, sizeof(reply), CAPS_FORMAT, USB_CAPS_VERSION, USB_LINE_BUFFER_SIZE, USB_MAX_CHUNK_BYTES,
+              s_disp_count, s_disp_width, s_disp_height, feat);
+    ESP_LOGI(TAG, "GET_CAPS answered");
+    return true;
+}
+
+/* =============================================================================
+ * TRANSPORT DIAGNOSTICS (built-in)
+ *
+ * GET_USB_STATS -> USB_STATS:HOST:<0|1>|TX:<bytes>|DROP:<n>|SHORT:<n>
+ *                  |CONN:<n>|DISC:<n>
+ * ========================================================================== */
+
+static bool handle_usb_stats(const char *line)
+{
+    if (strcmp(line, PROTO_CMD_GET_USB_STATS) != 0) {
+        return false;
+    }
+
+    usb_tx_stats_t st = s_tx_stats;
+    usb_serial_sendf(PROTO_CMD_USB_STATS "HOST:%d|TX:%lu|DROP:%lu|SHORT:%lu|CONN:%lu|DISC:%lu\n",
+                     s_host_connected ? 1 : 0,
+                     (unsigned long)st.tx_bytes, (unsigned long)st.tx_dropped,
+                     (unsigned long)st.tx_short, (unsigned long)st.host_connects,
+                     (unsigned long)st.host_disconnects);
+    return true;
+}
+
+/* =============================================================================
+ * HOST PRESENCE
+ *
+ * Polled from the RX task. A detach also clears the stall flag so the
+ * next host starts with a working TX path.
+ * ========================================================================== */
+
+static void poll_host_state(void)
+{
+    bool connected = usb_serial_jtag_is_connected();
+    if (connected == s_host_connected) {
+        return;
+    }
+
+    s_host_connected = connected;
+    s_tx_stalled = false;
+    s_host_change_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+    if (connected) {
+        s_tx_stats.host_connects++;
+        postmortem_trace(POSTMORTEM_EV_HOST, 1);
+        ESP_LOGI(TAG, "USB host attached");
+    } else {
+        s_tx_stats.host_disconnects++;
+        postmortem_trace(POSTMORTEM_EV_HOST, 0);
+        ESP_LOGW(TAG, "USB host detached - TX muted");
+    }
+}
+
 /* =============================================================================
  * RX TASK
  * ========================================================================== */
 
+/* Built-ins (handshake, caps, diagnostics, process list, history) first,
+ * then the registered handlers. False if nobody took the line. */
+static bool dispatch_command(const char *line)
+{
+    if (handle_handshake(line) || handle_caps(line) || handle_usb_stats(line) ||
+        handle_proc_top(line) || handle_history(line)) {
+        return true;
+    }
+
+    for (int h = 0; h < s_handler_count; h++) {
+        if (s_handlers[h](line)) return true;
+    }
+    return false;
+}
+
+/* "@<id>:<command>" - handle the command with its replies tagged, then close
+ * with RPC_END so the client can complete the request (FEAT:RPC). A tagged
+ * line is never stats data. */
+static bool handle_rpc(const char *line)
+{
+    if (line[0] != PROTO_CMD_RPC_TAG[0]) {
+        return false;
+    }
+
+    char *end;
+    unsigned long id = strtoul(line + 1, &end, 10);
+    if (end == line + 1 || *end != ':' || id == 0 || id > RPC_ID_MAX) {
+        ESP_LOGW(TAG, "Malformed request ID, line ignored");
+        return true;
+    }
+
+    s_rpc_id = (uint16_t)id;
+    bool handled = dispatch_command(end + 1);
+    usb_serial_sendf(PROTO_CMD_RPC_END "%s\n", handled ? "OK" : "UNKNOWN");
+    s_rpc_id = 0;
+    return true;
+}
+
 static void usb_rx_task(void *arg)
 {
     static uint8_t rx_buf[256];
@@ -286,10 +702,16 @@ static void usb_rx_task(void *arg)
     while (1) {
         /* Feed the watchdog at start of each iteration */
         esp_task_wdt_reset();
+        postmortem_feed();
+        poll_host_state();
+
         /* Read with timeout so other tasks can run */
         int len = usb_serial_jtag_read_bytes(rx_buf, sizeof(rx_buf), pdMS_TO_TICKS(10));
 
         if (len > 0) {
+            /* Host is sending, so it has the port open again */
+            s_tx_stalled = false;
+
             for (int i = 0; i < len; i++) {
                 uint8_t c = rx_buf[i];
 
@@ -301,18 +723,9 @@ static void usb_rx_task(void *arg)
                     } else if (line_pos > 0) {
                         line_buf[line_pos] = '\0';
 
-                        /* Try built-in handshake first */
-                        if (!handle_handshake(line_buf)) {
-                            /* Try registered handlers */
-                            bool handled = false;
-                            for (int h = 0; h < s_handler_count && !handled; h++) {
-                                handled = s_handlers[h](line_buf);
-                            }
-
-                            /* If no handler matched, try to parse as PC data */
-                            if (!handled) {
-                                parse_pc_data(line_buf);
-                            }
+                        /* Commands (with or without request ID), else PC data */
+                        if (!handle_rpc(line_buf) && !dispatch_command(line_buf)) {
+                            parse_pc_data(line_buf);
                         }
 
                         line_pos = 0;
@@ -355,6 +768,6 @@ void usb_serial_start_rx_task(SemaphoreHandle_t stats_mutex)
     s_last_data_ms = (uint32_t)(esp_timer_get_time() / 1000);
 
     /* Create USB RX task with hardened configuration */
-    xTaskCreate(usb_rx_task, "usb_rx", STACK_SIZE_USB_RX, NULL, PRIO_USB_RX, NULL);
+    xTaskCreate(usb_rx_task, "usb_rx", STACK_SIZE_USB_RX, NULL, PRIO_USB_RX, &s_rx_task);
     ESP_LOGI(TAG, "USB RX Task created (stack: %d, prio: %d)", STACK_SIZE_USB_RX, PRIO_USB_RX);
 }
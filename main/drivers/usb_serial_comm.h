@@ -13,12 +13,35 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "core/system_types.h"
+#include "core/alert_rules.h"
 
 /* Configuration */
 #define USB_LINE_BUFFER_SIZE    4096    /* Max line length (larger for IMG_DATA chunks) */
 #define USB_RX_BUFFER_SIZE      4096    /* Must be >= max line length to prevent data loss */
 #define USB_TX_BUFFER_SIZE      1024
 
+/* Largest binary payload per *_DATA line (hex-encoded, so 2 chars/byte).
+ * 32 chars headroom for "FW_DATA:<offset>:", the ":<crc32>" of FEAT:CRC
+ * clients and the terminator.
+ * Reported to the client via GET_CAPS (CHUNK:). */
+#define USB_MAX_CHUNK_BYTES     ((USB_LINE_BUFFER_SIZE - 32) / 2)
+
+/* GET_CAPS descriptor format version (CAPS:<n>) */
+#define USB_CAPS_VERSION        1
+
+/* TX timeout while a host is attached. Short on purpose: a host that
+ * enumerates but has no terminal open never drains the FIFO. */
+#define USB_TX_TIMEOUT_MS       10
+
+/* Transport counters (GET_USB_STATS) */
+typedef struct {
+    uint32_t tx_bytes;          /* Bytes accepted by the driver */
+    uint32_t tx_dropped;        /* Writes dropped: no host or host not reading */
+    uint32_t tx_short;          /* Writes that hit USB_TX_TIMEOUT_MS */
+    uint32_t host_connects;     /* Host attach events (SOF resumed) */
+    uint32_t host_disconnects;  /* Host detach events (SOF stopped) */
+} usb_tx_stats_t;
+
 /* Command handler callback type */
 typedef bool (*usb_cmd_handler_t)(const char *line);
 
@@ -40,12 +63,60 @@ void usb_serial_start_rx_task(SemaphoreHandle_t stats_mutex);
  */
 pc_stats_t *usb_serial_get_stats(void);
 
+/**
+ * @brief Get pointer to current top-N process list
+ *
+ * Protected by the same stats mutex as usb_serial_get_stats().
+ * @return Pointer to proc_top_t structure
+ */
+proc_top_t *usb_serial_get_proc_top(void);
+
+/**
+ * @brief Get pointer to the last history backfill (HIST: line)
+ *
+ * Protected by the same stats mutex as usb_serial_get_stats(). Check seq
+ * before copying - a backfill arrives once per connection.
+ * @return Pointer to history_backfill_t structure
+ */
+history_backfill_t *usb_serial_get_history(void);
+
+/**
+ * @brief Get pointer to the alert state of the last stats line
+ *
+ * Protected by the same stats mutex as usb_serial_get_stats(). seq changes
+ * only when an alert starts, ends or changes its action.
+ * @return Pointer to alert_state_t structure
+ */
+alert_state_t *usb_serial_get_alerts(void);
+
 /**
  * @brief Get timestamp of last received data (ms since boot)
  * @return Timestamp in milliseconds
  */
 uint32_t usb_serial_get_last_data_time(void);
 
+/**
+ * @brief Whether a USB host is attached
+ *
+ * Based on start-of-frame activity (usb_serial_jtag_is_connected), polled
+ * by the RX task every ~10 ms. Goes false when the PC sleeps or the cable
+ * is pulled; it cannot tell whether a program has the port open.
+ * @return true if SOF packets are arriving
+ */
+bool usb_serial_host_connected(void);
+
+/**
+ * @brief Get timestamp of the last host attach/detach (ms since boot)
+ * @return Timestamp in milliseconds
+ */
+uint32_t usb_serial_get_host_change_time(void);
+
+/**
+ * @brief Copy the transport counters
+ * @param out Destination
+ */
+void usb_serial_get_tx_stats(usb_tx_stats_t *out);
+
 /**
  * @brief Register a command handler
  *
@@ -55,8 +126,31 @@ uint32_t usb_serial_get_last_data_time(void);
  */
 void usb_serial_register_handler(usb_cmd_handler_t handler);
 
+/**
+ * @brief Announce an optional feature in GET_CAPS (FEAT:)
+ *
+ * Registered by whoever wires up the handler that implements it; the
+ * transport's own features (TOP, DSK, HIST, RPC) are always listed.
+ *
+ * @param token Feature token, must stay valid (string literal); at most 8
+ *              chars and 12 tokens, others are rejected with an error log
+ */
+void usb_serial_register_feature(const char *token);
+
+/**
+ * @brief Set the display geometry reported in GET_CAPS (DISP:)
+ *
+ * @param count Number of displays
+ * @param width Display width in pixels
+ * @param height Display height in pixels
+ */
+void usb_serial_set_displays(int count, int width, int height);
+
 /**
  * @brief Send response string via USB Serial
+ *
+ * Never blocks for long: dropped while no host is attached, and after a
+ * timed-out write until the host sends something again.
  * @param response String to send (will be sent as-is)
  */
 void usb_serial_send(const char *response);
@@ -4,12 +4,16 @@
  *
  * Key Features:
  * - 20 MHz SPI clock for signal stability with 4 displays
- * - BLOCKING mode (trans_queue_depth=1) - no async issues
+ * - One transfer on the bus at a time (trans_queue_depth=1)
  * - PSRAM buffers for full-frame double buffering
+ * - Flush scheduler: bands from all displays are queued and sent by one
+ *   task in class/deadline order, with a per-class bandwidth share
+ * - Direct full-frame blit for static images, LVGL paused meanwhile
  * - Simple, crash-resistant design
  */
 
 #include "lvgl_gc9a01_driver.h"
+#include "core/postmortem.h"
 #include <string.h>
 #include "esp_log.h"
 #include "esp_lcd_panel_io.h"
@@ -21,37 +25,385 @@
 #include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_task_wdt.h"
 
 static const char *TAG = "LVGL_GC9A01";
 
+/* =============================================================================
+ * FLUSH SCHEDULER CONFIGURATION
+ * ========================================================================== */
+#define SPI_PCLK_HZ              (20 * 1000 * 1000)
+
+#define FLUSH_WINDOW_MS          100     /* Bandwidth accounting window */
+#define FLUSH_WINDOW_BYTES       (SPI_PCLK_HZ / 8 / 1000 * FLUSH_WINDOW_MS)
+#define FLUSH_TRANS_TIMEOUT_MS   100     /* 40-line band ~8 ms, full frame ~46 ms */
+#define FLUSH_TRANS_STUCK_MS     2000    /* Late transfer: watchdog fed this long */
+#define FLUSH_WAIT_TIMEOUT_MS    250     /* LVGL waiting for its buffer: log interval */
+#define FLUSH_LOST_MS            2000    /* Band never picked up: drop it */
+#define FLUSH_IDLE_WAIT_MS       100     /* Scheduler wake-up for the watchdog */
+#define FLUSH_STATS_LOG_MS       30000
+
+#define STACK_SIZE_FLUSH_SCHED   3072
+#define PRIO_FLUSH_SCHED         3       /* = LVGL timer; runs on the other core */
+#define CORE_FLUSH_SCHED         0       /* LVGL renders on core 1 */
+
+/* Deadline after queueing and max share of FLUSH_WINDOW_BYTES per class.
+ * The share only applies while another display has a band waiting -
+ * an idle bus is never left unused. */
+static const struct {
+    uint32_t deadline_ms;
+    uint8_t share_pct;
+} s_class_cfg[LVGL_GC9A01_FLUSH_CLASS_COUNT] = {
+    [LVGL_GC9A01_FLUSH_LIVE]        = {  20, 100 },
+    [LVGL_GC9A01_FLUSH_NORMAL]      = {  60,  50 },
+    [LVGL_GC9A01_FLUSH_SCREENSAVER] = { 250,  25 },
+};
+
+/* One queued band per display: LVGL waits for the previous flush before
+ * handing over the next buffer, so a display never has two bands queued. */
+typedef struct {
+    lvgl_gc9a01_handle_t *handle;
+    volatile bool pending;
+    lv_area_t area;
+    uint8_t *px_map;
+    bool direct;                /* Frame from lvgl_gc9a01_blit(), not an LVGL band */
+    bool in_flight;             /* Picked by the scheduler - DMA may be reading px_map */
+    int64_t queued_us;
+    int64_t deadline_us;
+    uint32_t window_bytes;
+    lvgl_gc9a01_flush_stats_t stats;
+} flush_slot_t;
+
+static flush_slot_t s_slots[LVGL_GC9A01_MAX_DISPLAYS];
+static int s_slot_count = 0;
+static portMUX_TYPE s_sched_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_sched_task = NULL;
+static SemaphoreHandle_t s_trans_done = NULL;
+static int64_t s_window_start_us = 0;
+
+/* =============================================================================
+ * FLUSH SCHEDULER
+ * ========================================================================== */
+
+/**
+ * @brief SPI color transfer finished (ISR context)
+ */
+static bool IRAM_ATTR on_color_trans_done(esp_lcd_panel_io_handle_t io,
+                                          esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(s_trans_done, &woken);
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief Choose the next band to send (call with s_sched_lock held)
+ *
+ * Overdue bands first, then by class, then by deadline. Displays over
+ * their bandwidth share are skipped unless nothing else is waiting.
+ */
+static flush_slot_t *pick_next(int64_t now)
+{
+    if (now - s_window_start_us >= (int64_t)FLUSH_WINDOW_MS * 1000) {
+        s_window_start_us = now;
+        for (int i = 0; i < s_slot_count; i++) {
+            s_slots[i].window_bytes = 0;
+        }
+    }
+
+    flush_slot_t *best = NULL, *best_over = NULL;
+    int best_rank = 0, best_over_rank = 0;
+
+    for (int i = 0; i < s_slot_count; i++) {
+        flush_slot_t *slot = &s_slots[i];
+        if (!slot->pending) {
+            continue;
+        }
+
+        lvgl_gc9a01_flush_class_t cls = slot->handle->flush_class;
+        bool overdue = (now >= slot->deadline_us);
+        int rank = overdue ? -1 : (int)cls;
+        uint32_t budget = (uint32_t)FLUSH_WINDOW_BYTES / 100 * s_class_cfg[cls].share_pct;
+
+        if (!overdue && slot->window_bytes >= budget) {
+            if (!best_over || rank < best_over_rank ||
+                (rank == best_over_rank && slot->deadline_us < best_over->deadline_us)) {
+                best_over = slot;
+                best_over_rank = rank;
+            }
+            continue;
+        }
+
+        if (!best || rank < best_rank ||
+            (rank == best_rank && slot->deadline_us < best->deadline_us)) {
+            best = slot;
+            best_rank = rank;
+        }
+    }
+
+    if (best && best_over) {
+        best_over->stats.throttled++;
+    }
+    return best ? best : best_over;
+}
+
+/**
+ * @brief Wait out a transfer that missed FLUSH_TRANS_TIMEOUT_MS
+ *
+ * The DMA may still be reading px_map, so the slot stays in flight until
+ * on_color_trans_done fires - LVGL and direct-frame owners only get the
+ * buffer back after that. A transfer that never completes means a wedged
+ * SPI host: the watchdog is no longer fed after FLUSH_TRANS_STUCK_MS and
+ * resets the device with this task recorded as the hung one.
+ */
+static void wait_late_trans(lvgl_gc9a01_handle_t *handle, int64_t start)
+{
+    bool stuck = false;
+
+    while (xSemaphoreTake(s_trans_done, pdMS_TO_TICKS(FLUSH_IDLE_WAIT_MS)) != pdTRUE) {
+        if (esp_timer_get_time() - start < (int64_t)FLUSH_TRANS_STUCK_MS * 1000) {
+            esp_task_wdt_reset();
+            postmortem_feed();
+        } else if (!stuck) {
+            ESP_LOGE(TAG, "SPI transfer stuck (CS=%d) - buffer held until watchdog reset", handle->pin_cs);
+            stuck = true;
+        }
+    }
+
+    ESP_LOGW(TAG, "SPI transfer done late (CS=%d, %lu ms)", handle->pin_cs,
+             (unsigned long)((esp_timer_get_time() - start) / 1000));
+}
+
+/**
+ * @brief Send one band and wait for the DMA to finish
+ */
+static void send_band(flush_slot_t *slot)
+{
+    lvgl_gc9a01_handle_t *handle = slot->handle;
+    const lv_area_t *a = &slot->area;
+    uint32_t bytes = (uint32_t)lv_area_get_size(a) * sizeof(uint16_t);
+
+    xSemaphoreTake(s_trans_done, 0);    /* Clear a stale completion */
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = esp_lcd_panel_draw_bitmap(handle->panel_handle, a->x1, a->y1, a->x2 + 1, a->y2 + 1,
+                                              slot->px_map);
+    if (err != ESP_OK) {
+        /* Not queued - no completion to wait for */
+        ESP_LOGW(TAG, "SPI transfer rejected (CS=%d): %s", handle->pin_cs, esp_err_to_name(err));
+    } else if (xSemaphoreTake(s_trans_done, pdMS_TO_TICKS(FLUSH_TRANS_TIMEOUT_MS)) != pdTRUE) {
+        ESP_LOGW(TAG, "SPI transfer timeout (CS=%d)", handle->pin_cs);
+        postmortem_trace(POSTMORTEM_EV_FLUSH_TIMEOUT, (uint32_t)handle->pin_cs);
+        err = ESP_ERR_TIMEOUT;
+        wait_late_trans(handle, start);
+    }
+
+    int64_t done = esp_timer_get_time();
+    uint32_t latency = (uint32_t)(done - slot->queued_us);
+    uint32_t transfer = (uint32_t)(done - start);
+    postmortem_flush_time(transfer);
+
+    portENTER_CRITICAL(&s_sched_lock);
+    lvgl_gc9a01_flush_stats_t *st = &slot->stats;
+    st->bands++;
+    st->bytes += bytes;
+    st->latency_avg_us = (st->bands == 1) ? latency
+                       : st->latency_avg_us - st->latency_avg_us / 8 + latency / 8;
+    if (latency > st->latency_max_us) {
+        st->latency_max_us = latency;
+    }
+    st->transfer_us += transfer;
+    if (transfer > st->transfer_max_us) {
+        st->transfer_max_us = transfer;
+    }
+    if (done > slot->deadline_us) {
+        st->deadline_misses++;
+    }
+    bool direct = slot->direct;
+    if (direct) {
+        st->blits++;
+        handle->blit_err = err;
+    }
+    slot->window_bytes += bytes;
+    slot->in_flight = false;
+    slot->pending = false;
+    portEXIT_CRITICAL(&s_sched_lock);
+
+    /* LVGL is paused during a direct frame and has nothing in flight */
+    if (!direct) {
+        lv_display_flush_ready(handle->lv_disp);
+    }
+    xSemaphoreGive(handle->flush_done);
+}
+
+static void log_flush_stats(void)
+{
+    for (int i = 0; i < s_slot_count; i++) {
+        lvgl_gc9a01_flush_stats_t st;
+        lvgl_gc9a01_get_flush_stats(s_slots[i].handle, &st, true);
+        ESP_LOGI(TAG, "Flush CS=%d: %lu bands (%lu direct), avg %lu us, max %lu us, %lu late, %lu throttled",
+                 s_slots[i].handle->pin_cs, (unsigned long)st.bands, (unsigned long)st.blits,
+                 (unsigned long)st.latency_avg_us, (unsigned long)st.latency_max_us,
+                 (unsigned long)st.deadline_misses, (unsigned long)st.throttled);
+    }
+}
+
+static void flush_sched_task(void *arg)
+{
+    int64_t last_log = esp_timer_get_time();
+
+    esp_task_wdt_add(NULL);
+
+    while (1) {
+        esp_task_wdt_reset();
+        postmortem_feed();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLUSH_IDLE_WAIT_MS));
+
+        while (1) {
+            int64_t now = esp_timer_get_time();
+            portENTER_CRITICAL(&s_sched_lock);
+            flush_slot_t *slot = pick_next(now);
+            if (slot) {
+                slot->in_flight = true;
+            }
+            portEXIT_CRITICAL(&s_sched_lock);
+
+            if (!slot) {
+                break;
+            }
+            send_band(slot);
+            esp_task_wdt_reset();
+            postmortem_feed();
+        }
+
+        if (esp_timer_get_time() - last_log >= (int64_t)FLUSH_STATS_LOG_MS * 1000) {
+            last_log = esp_timer_get_time();
+            log_flush_stats();
+        }
+    }
+}
+
+static esp_err_t flush_sched_register(lvgl_gc9a01_handle_t *handle)
+{
+    if (!s_sched_task) {
+        s_trans_done = xSemaphoreCreateBinary();
+        if (!s_trans_done ||
+            xTaskCreatePinnedToCore(flush_sched_task, "lv_flush", STACK_SIZE_FLUSH_SCHED, NULL,
+                                    PRIO_FLUSH_SCHED, &s_sched_task, CORE_FLUSH_SCHED) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to start flush scheduler");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (s_slot_count >= LVGL_GC9A01_MAX_DISPLAYS) {
+        ESP_LOGE(TAG, "Too many displays (max %d)", LVGL_GC9A01_MAX_DISPLAYS);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    handle->flush_done = xSemaphoreCreateBinary();
+    if (!handle->flush_done) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    handle->sched_slot = s_slot_count;
+    s_slots[s_slot_count].handle = handle;
+    s_slot_count++;
+    return ESP_OK;
+}
+
+/* =============================================================================
+ * LVGL CALLBACKS
+ * ========================================================================== */
+
 /**
- * @brief LVGL Flush Callback - TRUE BLOCKING MODE
+ * @brief LVGL Flush Callback - queue the band for the scheduler
  *
- * With trans_queue_depth=1, esp_lcd_panel_draw_bitmap blocks
- * until the SPI transfer is complete. Safe for 4 displays.
+ * Returns immediately; LVGL renders the next band into the other buffer
+ * while this one waits for the bus. lv_display_flush_ready() is called
+ * by the scheduler once the transfer is done.
  */
 static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
 {
     lvgl_gc9a01_handle_t *handle = (lvgl_gc9a01_handle_t *)lv_display_get_user_data(disp);
 
-    if (!handle || !handle->panel_handle) {
+    if (!handle || !handle->panel_handle || handle->sched_slot < 0) {
         lv_display_flush_ready(disp);
         return;
     }
 
-    int x1 = area->x1;
-    int x2 = area->x2;
-    int y1 = area->y1;
-    int y2 = area->y2;
-
     // SPI LCD is big-endian, swap RGB565 byte order before sending
-    lv_draw_sw_rgb565_swap(px_map, (x2 + 1 - x1) * (y2 + 1 - y1));
+    lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+
+    flush_slot_t *slot = &s_slots[handle->sched_slot];
+    int64_t now = esp_timer_get_time();
 
-    // BLOCKING: With queue_depth=1, this waits until SPI transfer is done
-    esp_lcd_panel_draw_bitmap(handle->panel_handle, x1, y1, x2 + 1, y2 + 1, px_map);
+    portENTER_CRITICAL(&s_sched_lock);
+    bool busy = slot->pending;
+    if (!busy) {
+        slot->area = *area;
+        slot->px_map = px_map;
+        slot->direct = false;
+        slot->queued_us = now;
+        slot->deadline_us = now + (int64_t)s_class_cfg[handle->flush_class].deadline_ms * 1000;
+        slot->pending = true;
+    }
+    portEXIT_CRITICAL(&s_sched_lock);
+
+    if (busy) {
+        /* Not expected - the wait callback only returns once the slot is free */
+        ESP_LOGW(TAG, "Previous band still queued (CS=%d) - dropping", handle->pin_cs);
+        lv_display_flush_ready(disp);
+        return;
+    }
 
-    // Now it's safe to signal completion
-    lv_display_flush_ready(disp);
+    xTaskNotifyGive(s_sched_task);
+}
+
+/**
+ * @brief LVGL Flush Wait Callback - block until the queued band is sent
+ *
+ * Replaces LVGL's busy-wait on the flushing flag. Never returns while the
+ * DMA may still read the buffer: a band being sent is only released once
+ * its transfer completed, however late (see wait_late_trans). One the
+ * scheduler never picked up is dropped after FLUSH_LOST_MS instead.
+ */
+static void lvgl_flush_wait_cb(lv_display_t *disp)
+{
+    lvgl_gc9a01_handle_t *handle = (lvgl_gc9a01_handle_t *)lv_display_get_user_data(disp);
+
+    if (!handle || handle->sched_slot < 0) {
+        return;
+    }
+
+    flush_slot_t *slot = &s_slots[handle->sched_slot];
+    int64_t start = esp_timer_get_time();
+
+    while (slot->pending) {
+        if (xSemaphoreTake(handle->flush_done, pdMS_TO_TICKS(FLUSH_WAIT_TIMEOUT_MS)) == pdTRUE) {
+            continue;
+        }
+
+        ESP_LOGW(TAG, "Flush wait timeout (CS=%d)", handle->pin_cs);
+        if (esp_task_wdt_status(NULL) == ESP_OK) {
+            esp_task_wdt_reset();
+            postmortem_feed();
+        }
+
+        if (esp_timer_get_time() - start >= (int64_t)FLUSH_LOST_MS * 1000) {
+            portENTER_CRITICAL(&s_sched_lock);
+            bool dropped = slot->pending && !slot->in_flight;
+            if (dropped) {
+                slot->pending = false;
+            }
+            portEXIT_CRITICAL(&s_sched_lock);
+
+            if (dropped) {
+                ESP_LOGE(TAG, "Band never sent (CS=%d) - dropped", handle->pin_cs);
+                postmortem_trace(POSTMORTEM_EV_FLUSH_TIMEOUT, (uint32_t)handle->pin_cs);
+                break;
+            }
+        }
+    }
 }
 
 /**
@@ -63,19 +415,24 @@ esp_err_t lvgl_gc9a01_init(const lvgl_gc9a01_config_t *config, lvgl_gc9a01_handl
              config->pin_cs, config->pin_dc, config->pin_rst);
 
     memset(handle, 0, sizeof(lvgl_gc9a01_handle_t));
+    handle->pin_cs = config->pin_cs;
+    handle->sched_slot = -1;
+    handle->flush_class = LVGL_GC9A01_FLUSH_NORMAL;
 
     // =========================================================================
-    // 1. SPI Panel IO - BLOCKING MODE (queue_depth=1)
+    // 1. SPI Panel IO - one transaction at a time (queue_depth=1)
     // =========================================================================
     esp_lcd_panel_io_handle_t io_handle = NULL;
     esp_lcd_panel_io_spi_config_t io_config = {
         .dc_gpio_num = config->pin_dc,
         .cs_gpio_num = config->pin_cs,
-        .pclk_hz = 20 * 1000 * 1000,    // 20 MHz
+        .pclk_hz = SPI_PCLK_HZ,         // 20 MHz
         .lcd_cmd_bits = 8,
         .lcd_param_bits = 8,
         .spi_mode = 0,
-        .trans_queue_depth = 1,         // BLOCKING: Only 1 transaction at a time
+        .trans_queue_depth = 1,         // Only 1 transaction at a time
+        .on_color_trans_done = on_color_trans_done,
+        .user_ctx = handle,
     };
 
     esp_err_t ret = esp_lcd_new_panel_io_spi(
@@ -121,8 +478,14 @@ esp_err_t lvgl_gc9a01_init(const lvgl_gc9a01_config_t *config, lvgl_gc9a01_handl
         return ESP_ERR_NO_MEM;
     }
 
+    ret = flush_sched_register(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
     lv_display_set_user_data(handle->lv_disp, handle);
     lv_display_set_flush_cb(handle->lv_disp, lvgl_flush_cb);
+    lv_display_set_flush_wait_cb(handle->lv_disp, lvgl_flush_wait_cb);
 
     // =========================================================================
     // 4. PSRAM Frame Buffers - Use PARTIAL mode for less blocking time
@@ -153,7 +516,7 @@ esp_err_t lvgl_gc9a01_init(const lvgl_gc9a01_config_t *config, lvgl_gc9a01_handl
         LV_DISPLAY_RENDER_MODE_PARTIAL  // Partial updates = less blocking
     );
 
-    ESP_LOGI(TAG, "GC9A01 ready (CS=%d, 20MHz, BLOCKING)", config->pin_cs);
+    ESP_LOGI(TAG, "GC9A01 ready (CS=%d, 20MHz, flush slot %d)", config->pin_cs, handle->sched_slot);
     return ESP_OK;
 }
 
@@ -164,3 +527,116 @@ lv_display_t *lvgl_gc9a01_get_display(lvgl_gc9a01_handle_t *handle)
 {
     return handle ? handle->lv_disp : NULL;
 }
+
+/**
+ * @brief Set the flush scheduling class of a display
+ */
+void lvgl_gc9a01_set_flush_class(lvgl_gc9a01_handle_t *handle, lvgl_gc9a01_flush_class_t flush_class)
+{
+    if (handle && flush_class < LVGL_GC9A01_FLUSH_CLASS_COUNT) {
+        handle->flush_class = flush_class;
+    }
+}
+
+/**
+ * @brief Copy a display's flush statistics
+ */
+void lvgl_gc9a01_get_flush_stats(lvgl_gc9a01_handle_t *handle, lvgl_gc9a01_flush_stats_t *out,
+                                 bool reset_max)
+{
+    if (!handle || !out) {
+        return;
+    }
+    if (handle->sched_slot < 0) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+
+    portENTER_CRITICAL(&s_sched_lock);
+    *out = s_slots[handle->sched_slot].stats;
+    if (reset_max) {
+        s_slots[handle->sched_slot].stats.latency_max_us = 0;
+        s_slots[handle->sched_slot].stats.transfer_max_us = 0;
+    }
+    portEXIT_CRITICAL(&s_sched_lock);
+}
+
+/**
+ * @brief Block until the display's queued band has been sent
+ */
+void lvgl_gc9a01_wait_flush(lvgl_gc9a01_handle_t *handle)
+{
+    if (handle && handle->lv_disp) {
+        lvgl_flush_wait_cb(handle->lv_disp);
+    }
+}
+
+/* =============================================================================
+ * DIRECT BLIT
+ * ========================================================================== */
+
+/**
+ * @brief Show a full-screen frame directly, bypassing LVGL rendering
+ */
+esp_err_t lvgl_gc9a01_blit(lvgl_gc9a01_handle_t *handle, const uint16_t *frame)
+{
+    if (!handle || !frame || !handle->panel_handle || handle->sched_slot < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* LVGL's last band or the previous direct frame must be off the bus */
+    flush_slot_t *slot = &s_slots[handle->sched_slot];
+    lvgl_flush_wait_cb(handle->lv_disp);
+
+    if (handle->blit_active && handle->blit_err != ESP_OK) {
+        esp_err_t err = handle->blit_err;
+        ESP_LOGW(TAG, "Direct frame failed (CS=%d): %s - back to LVGL", handle->pin_cs, esp_err_to_name(err));
+        lvgl_gc9a01_blit_stop(handle);
+        return err;
+    }
+
+    if (!handle->blit_active) {
+        lv_timer_pause(lv_display_get_refr_timer(handle->lv_disp));
+        handle->blit_active = true;
+    }
+
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_sched_lock);
+    slot->area = (lv_area_t){ .x1 = 0, .y1 = 0, .x2 = 239, .y2 = 239 };
+    slot->px_map = (uint8_t *)frame;
+    slot->direct = true;
+    slot->queued_us = now;
+    slot->deadline_us = now + (int64_t)s_class_cfg[handle->flush_class].deadline_ms * 1000;
+    handle->blit_err = ESP_OK;
+    slot->pending = true;
+    portEXIT_CRITICAL(&s_sched_lock);
+
+    xTaskNotifyGive(s_sched_task);
+    return ESP_OK;
+}
+
+/**
+ * @brief Hand the panel back to LVGL after lvgl_gc9a01_blit()
+ */
+void lvgl_gc9a01_blit_stop(lvgl_gc9a01_handle_t *handle)
+{
+    if (!handle || !handle->blit_active) {
+        return;
+    }
+
+    lvgl_flush_wait_cb(handle->lv_disp);
+    handle->blit_err = ESP_OK;
+    handle->blit_active = false;
+
+    lv_timer_resume(lv_display_get_refr_timer(handle->lv_disp));
+    lv_obj_invalidate(lv_display_get_screen_active(handle->lv_disp));
+}
+
+/**
+ * @brief Check if a direct frame is on the panel
+ */
+bool lvgl_gc9a01_blit_active(const lvgl_gc9a01_handle_t *handle)
+{
+    return handle && handle->blit_active && handle->blit_err == ESP_OK;
+}
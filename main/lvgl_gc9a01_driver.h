@@ -4,6 +4,14 @@
  *
  * Connects the GC9A01 hardware driver with LVGL display interface.
  * Supports multiple display instances with PSRAM frame buffers.
+ *
+ * All displays share one SPI bus. Flushes are queued to a scheduler task
+ * that serves them by class and deadline and caps each display's share
+ * of the bus, so a screensaver redraw cannot hold up live data.
+ *
+ * A full-screen opaque frame can bypass LVGL entirely: lvgl_gc9a01_blit()
+ * sends it to the panel as one transaction and pauses the display's LVGL
+ * refresh until lvgl_gc9a01_blit_stop().
  */
 
 #ifndef LVGL_GC9A01_DRIVER_H
@@ -14,11 +22,46 @@
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_panel_ops.h"
 #include "driver/spi_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define LVGL_GC9A01_MAX_DISPLAYS  4
+
+/**
+ * @brief Flush scheduling class (lower value is served first)
+ *
+ * A band that has waited past its class deadline is served before any
+ * class, so lower classes are delayed but never starved.
+ */
+typedef enum {
+    LVGL_GC9A01_FLUSH_LIVE = 0,         /* Continuously changing data (charts) */
+    LVGL_GC9A01_FLUSH_NORMAL,           /* Data screens updated ~1/s */
+    LVGL_GC9A01_FLUSH_SCREENSAVER,      /* Screensaver art */
+    LVGL_GC9A01_FLUSH_CLASS_COUNT
+} lvgl_gc9a01_flush_class_t;
+
+/**
+ * @brief Per-display flush statistics
+ *
+ * Latency is measured from the LVGL flush callback to the end of the
+ * SPI transfer (queueing + transfer time).
+ */
+typedef struct {
+    uint32_t bands;             /* Bands sent */
+    uint32_t bytes;             /* Pixel bytes sent */
+    uint32_t latency_avg_us;    /* Moving average (1/8 weight) */
+    uint32_t latency_max_us;    /* Worst case since last reset */
+    uint32_t transfer_us;       /* Total SPI transfer time (wraps; use deltas) */
+    uint32_t transfer_max_us;   /* Longest single band transfer since last reset */
+    uint32_t deadline_misses;   /* Bands served after their class deadline */
+    uint32_t throttled;         /* Times passed over for exceeding the bandwidth share */
+    uint32_t blits;             /* Direct full frames (also counted in bands/bytes) */
+} lvgl_gc9a01_flush_stats_t;
+
 /**
  * @brief Display configuration structure
  */
@@ -40,6 +83,12 @@ typedef struct {
     void *draw_buf1;
     void *draw_buf2;
     void *swap_buf;  /* Temporary buffer for RGB565 byte swapping */
+    int pin_cs;      /* For log messages */
+    int sched_slot;  /* Index into the flush scheduler table, -1 if none */
+    lvgl_gc9a01_flush_class_t flush_class;
+    SemaphoreHandle_t flush_done;   /* Given by the scheduler when a band is sent */
+    bool blit_active;               /* LVGL refresh paused for a direct frame */
+    volatile esp_err_t blit_err;    /* Result of the last direct frame transfer */
 } lvgl_gc9a01_handle_t;
 
 /**
@@ -59,6 +108,74 @@ esp_err_t lvgl_gc9a01_init(const lvgl_gc9a01_config_t *config, lvgl_gc9a01_handl
  */
 lv_display_t *lvgl_gc9a01_get_display(lvgl_gc9a01_handle_t *handle);
 
+/**
+ * @brief Set the flush scheduling class of a display
+ *
+ * Takes effect for the next band. Default is LVGL_GC9A01_FLUSH_NORMAL.
+ *
+ * @param handle Display handle
+ * @param flush_class Scheduling class
+ */
+void lvgl_gc9a01_set_flush_class(lvgl_gc9a01_handle_t *handle, lvgl_gc9a01_flush_class_t flush_class);
+
+/**
+ * @brief Copy a display's flush statistics
+ *
+ * @param handle Display handle
+ * @param out Destination
+ * @param reset_max Clear latency_max_us / transfer_max_us after reading
+ */
+void lvgl_gc9a01_get_flush_stats(lvgl_gc9a01_handle_t *handle, lvgl_gc9a01_flush_stats_t *out,
+                                 bool reset_max);
+
+/**
+ * @brief Block until the display's queued band has been sent
+ *
+ * For callers that drive a refresh themselves (lv_refr_now) and need the
+ * frame on the panel before they continue. Call with the LVGL mutex held.
+ *
+ * @param handle Display handle
+ */
+void lvgl_gc9a01_wait_flush(lvgl_gc9a01_handle_t *handle);
+
+/**
+ * @brief Show a full-screen frame directly, bypassing LVGL rendering
+ *
+ * The frame (240x240 RGB565, already in panel byte order, fully opaque)
+ * is sent from the caller's buffer as one full-frame transfer - no copy.
+ * The buffer must stay valid and unchanged until lvgl_gc9a01_blit_stop()
+ * or the next lvgl_gc9a01_blit() returns. The display's LVGL refresh is
+ * paused so no band overwrites it. Call with the LVGL mutex held.
+ *
+ * If the previous direct frame failed to send, LVGL is resumed and that
+ * error is returned without sending - the caller should let LVGL draw.
+ *
+ * @param handle Display handle
+ * @param frame 240 * 240 pixels in panel byte order
+ * @return ESP_OK, or the previous transfer's error
+ */
+esp_err_t lvgl_gc9a01_blit(lvgl_gc9a01_handle_t *handle, const uint16_t *frame);
+
+/**
+ * @brief Hand the panel back to LVGL after lvgl_gc9a01_blit()
+ *
+ * Waits until the direct frame is off the bus (the caller may then reuse
+ * or free it), resumes the refresh and invalidates the active screen.
+ * No-op if no direct frame is shown. Call with the LVGL mutex held.
+ *
+ * @param handle Display handle
+ */
+void lvgl_gc9a01_blit_stop(lvgl_gc9a01_handle_t *handle);
+
+/**
+ * @brief Check if a direct frame is on the panel
+ *
+ * false once its transfer failed; the next lvgl_gc9a01_blit() reports it.
+ *
+ * @param handle Display handle
+ */
+bool lvgl_gc9a01_blit_active(const lvgl_gc9a01_handle_t *handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,8 @@
  * - Proper task priority ordering
  *
  * Modular architecture:
+ * - core/      : shared types, protocol codecs, alert rules, self-benchmark,
+ *                post-mortem counters
  * - storage/   : LittleFS, hw_identity, gui_settings
  * - drivers/   : usb_serial_comm
  * - ui/        : ui_manager, screensaver_mgr
@@ -35,6 +37,7 @@
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_task_wdt.h"
+#include "esp_heap_caps.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
 
@@ -43,6 +46,10 @@
 
 /* Modular includes */
 #include "core/system_types.h"
+#include "core/alert_rules.h"
+#include "core/metric_vm.h"
+#include "core/bench.h"
+#include "core/postmortem.h"
 #include "storage/storage_mgr.h"
 #include "storage/hw_identity.h"
 #include "gui_settings.h"
@@ -50,6 +57,7 @@
 #include "drivers/fw_update.h"
 #include "ui/ui_manager.h"
 #include "ui/screensaver_mgr.h"
+#include "ui/profile_mgr.h"
 #include "screens/screens_lvgl.h"
 
 static const char *TAG = "MAIN";
@@ -65,6 +73,11 @@ static const char *TAG = "MAIN";
                                           * stops the red dot from flickering
                                           * during normal operation. */
 #define DISPLAY_UPDATE_MS        100     /* 10 FPS - Watchdog friendly */
+#define HOST_GONE_SCREENSAVER_MS 1500    /* USB host detached (PC asleep/off,
+                                          * cable pulled) -> screensaver without
+                                          * waiting for the data timeout. Short
+                                          * grace rides out SOF gaps during
+                                          * USB resets. */
 
 /* =============================================================================
  * DESERT-SPEC: THREAD-SAFETY CONFIGURATION
@@ -109,6 +122,8 @@ static lvgl_gc9a01_handle_t display_cpu, display_gpu, display_ram, display_netwo
 /* Screen Handles */
 static ui_screens_t s_screens = {0};
 static ui_screensavers_t s_screensavers = {0};
+static history_backfill_t s_history = {0};   /* Display task copy of the last HIST: */
+static uint32_t s_alerts_seq = 0;            /* Alert state last handed to the UI */
 static ui_status_dots_t s_dots = {0};
 
 /* SPI Pin Configurations */
@@ -145,7 +160,7 @@ static const lvgl_gc9a01_config_t config_net = {
  * ========================================================================== */
 static void theme_update_callback(void)
 {
-    if (s_lvgl_mutex && xSemaphoreTake(s_lvgl_mutex, pdMS_TO_TICKS(LVGL_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+    if (s_lvgl_mutex && postmortem_take(POSTMORTEM_LOCK_LVGL, s_lvgl_mutex, pdMS_TO_TICKS(LVGL_MUTEX_TIMEOUT_MS))) {
         ui_manager_apply_theme();
         xSemaphoreGive(s_lvgl_mutex);
         ESP_LOGI(TAG, "Theme updated via SET_SS_BG command");
@@ -154,6 +169,103 @@ static void theme_update_callback(void)
     }
 }
 
+/* =============================================================================
+ * SPI FLUSH CLASSES
+ * The network chart scrolls every second and is the most latency-visible
+ * content, so it is served first; the other data screens follow. In
+ * screensaver mode all panels drop to the lowest class.
+ * ========================================================================== */
+static void apply_flush_classes(bool screensaver)
+{
+    lvgl_gc9a01_flush_class_t data_class = screensaver ? LVGL_GC9A01_FLUSH_SCREENSAVER
+                                                       : LVGL_GC9A01_FLUSH_NORMAL;
+
+    lvgl_gc9a01_set_flush_class(&display_cpu, data_class);
+    lvgl_gc9a01_set_flush_class(&display_gpu, data_class);
+    lvgl_gc9a01_set_flush_class(&display_ram, data_class);
+    lvgl_gc9a01_set_flush_class(&display_network,
+                                screensaver ? LVGL_GC9A01_FLUSH_SCREENSAVER : LVGL_GC9A01_FLUSH_LIVE);
+}
+
+/* =============================================================================
+ * DIRECT SCREENSAVER FRAMES
+ * A screensaver image that is opaque RGB565 and covers the whole panel is
+ * sent as one transfer (lvgl_gc9a01_blit) instead of being rendered band
+ * by band; LVGL leaves that display alone until the overlay goes away.
+ * Anything else - icons, crops, alpha - is drawn by LVGL as before.
+ * ========================================================================== */
+static bool s_blit_dirty[SS_IMG_COUNT];             /* Image reloaded since last blit */
+static bool s_blit_failed[SS_IMG_COUNT];            /* LVGL draws it until the next image */
+
+static lvgl_gc9a01_handle_t *ss_display(int slot)
+{
+    switch (slot) {
+        case SS_IMG_CPU: return &display_cpu;
+        case SS_IMG_GPU: return &display_gpu;
+        case SS_IMG_RAM: return &display_ram;
+        default:         return &display_network;
+    }
+}
+
+static void on_ss_image_reload(ss_image_slot_t slot, const lv_image_dsc_t *new_dsc)
+{
+    ui_manager_on_image_reload((int)slot, new_dsc);
+    if (slot < SS_IMG_COUNT) {
+        s_blit_dirty[slot] = true;
+        s_blit_failed[slot] = false;
+    }
+}
+
+/* The image's own pixels are on the DMA - take them off before the free */
+static void on_ss_image_unload(ss_image_slot_t slot)
+{
+    lvgl_gc9a01_blit_stop(ss_display((int)slot));
+}
+
+/* Call with the LVGL mutex held, after ss_process_updates() */
+static void update_direct_blits(bool screensaver)
+{
+    for (int i = 0; i < SS_IMG_COUNT; i++) {
+        lvgl_gc9a01_handle_t *h = ss_display(i);
+        const uint16_t *frame = NULL;
+
+        if (!screensaver) {
+            s_blit_failed[i] = false;
+        } else if (!s_blit_failed[i]) {
+            frame = ss_image_get_fullscreen((ss_image_slot_t)i);
+        }
+
+        if (frame) {
+            if ((s_blit_dirty[i] || !lvgl_gc9a01_blit_active(h)) &&
+                lvgl_gc9a01_blit(h, frame) != ESP_OK) {
+                /* LVGL draws it instead - back to its byte order */
+                s_blit_failed[i] = true;
+                lvgl_gc9a01_blit_stop(h);
+                ss_image_release_fullscreen((ss_image_slot_t)i);
+            }
+        } else {
+            lvgl_gc9a01_blit_stop(h);
+        }
+        s_blit_dirty[i] = false;
+    }
+}
+
+/* =============================================================================
+ * SCREEN FOOTPRINT
+ * Memory taken by a screen's object tree, logged at boot so the widget and
+ * the immediate-mode gauges (CONFIG_PCMON_IMMEDIATE_GAUGES) can be compared.
+ * LVGL's own pool if it has one, the system heap otherwise.
+ * ========================================================================== */
+static size_t ui_mem_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    if (mon.total_size > 0) {
+        return mon.total_size - mon.free_size;
+    }
+    return heap_caps_get_total_size(MALLOC_CAP_8BIT) - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
+
 /* =============================================================================
  * TASK: Display Update - 10 FPS with Screensaver Logic
  * ========================================================================== */
@@ -167,16 +279,23 @@ static void display_update_task(void *arg)
     while (1) {
         /* Feed the watchdog at start of each iteration */
         esp_task_wdt_reset();
+        postmortem_feed();
 
         uint32_t now = (uint32_t)(esp_timer_get_time() / 1000);
         uint32_t last_data = usb_serial_get_last_data_time();
         uint32_t time_since_data = now - last_data;
 
+        uint32_t host_change = usb_serial_get_host_change_time();
+        bool host_gone = !usb_serial_host_connected() &&
+                         (now - host_change > HOST_GONE_SCREENSAVER_MS);
+        /* After a re-attach, leave the screensaver only once the client talks */
+        bool data_since_attach = ((int32_t)(last_data - host_change) >= 0);
+
         bool data_is_stale = (time_since_data > STALE_DATA_THRESHOLD_MS);
-        bool should_screensave = (time_since_data > SCREENSAVER_TIMEOUT_MS);
+        bool should_screensave = host_gone || (time_since_data > SCREENSAVER_TIMEOUT_MS);
 
         /* Acquire LVGL mutex with timeout - NEVER use portMAX_DELAY! */
-        if (xSemaphoreTake(s_lvgl_mutex, pdMS_TO_TICKS(LVGL_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+        if (postmortem_take(POSTMORTEM_LOCK_LVGL, s_lvgl_mutex, pdMS_TO_TICKS(LVGL_MUTEX_TIMEOUT_MS))) {
 
             /* Process pending image reloads from USB task (Thread-Safety Fix)
              * This MUST be done in the UI thread to avoid race conditions */
@@ -187,18 +306,37 @@ static void display_update_task(void *arg)
                 ui_manager_apply_hardware_names();
             }
 
+            /* History backfill (HIST: after a reconnect) - copied only when a
+             * new one arrived; seq is a single word, safe to peek unlocked */
+            if (usb_serial_get_history()->seq != s_history.seq &&
+                postmortem_take(POSTMORTEM_LOCK_STATS, s_stats_mutex, pdMS_TO_TICKS(STATS_MUTEX_TIMEOUT_MS))) {
+                s_history = *usb_serial_get_history();
+                xSemaphoreGive(s_stats_mutex);
+                ui_manager_load_history(&s_history);
+            }
+
             /* Screensaver logic */
             if (should_screensave && !ui_manager_is_screensaver_active()) {
                 ui_manager_set_screensaver_active(true);
                 ui_manager_show_screensavers(true);
-                ESP_LOGW(TAG, "Screensaver ON (no data for %lu ms)", (unsigned long)time_since_data);
+                apply_flush_classes(true);
+                postmortem_trace(POSTMORTEM_EV_SCREENSAVER, 1);
+                if (host_gone) {
+                    ESP_LOGW(TAG, "Screensaver ON (USB host detached)");
+                } else {
+                    ESP_LOGW(TAG, "Screensaver ON (no data for %lu ms)", (unsigned long)time_since_data);
+                }
             }
-            else if (!should_screensave && ui_manager_is_screensaver_active()) {
+            else if (!should_screensave && data_since_attach && ui_manager_is_screensaver_active()) {
                 ui_manager_set_screensaver_active(false);
                 ui_manager_show_screensavers(false);
+                apply_flush_classes(false);
+                postmortem_trace(POSTMORTEM_EV_SCREENSAVER, 0);
                 ESP_LOGI(TAG, "Screensaver OFF (data received)");
             }
 
+            update_direct_blits(ui_manager_is_screensaver_active());
+
             /* Red dot logic */
             if (data_is_stale && !ui_manager_is_screensaver_active()) {
                 ui_manager_show_status_dots(true);
@@ -208,12 +346,25 @@ static void display_update_task(void *arg)
 
             /* Update screens (only if not in screensaver) */
             if (!ui_manager_is_screensaver_active()) {
+                ui_manager_tick_views();
+                ui_manager_tick_alerts();
+
                 /* Acquire stats mutex with timeout - NEVER use portMAX_DELAY! */
-                if (xSemaphoreTake(s_stats_mutex, pdMS_TO_TICKS(STATS_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+                if (postmortem_take(POSTMORTEM_LOCK_STATS, s_stats_mutex, pdMS_TO_TICKS(STATS_MUTEX_TIMEOUT_MS))) {
                     pc_stats_t local_stats = *usb_serial_get_stats();
+                    proc_top_t local_top = *usb_serial_get_proc_top();
+                    alert_state_t local_alerts = *usb_serial_get_alerts();
                     xSemaphoreGive(s_stats_mutex);
 
+                    /* Alerts were evaluated with this sample - apply them
+                     * first so it is drawn in the alert colours */
+                    if (local_alerts.seq != s_alerts_seq) {
+                        s_alerts_seq = local_alerts.seq;
+                        ui_manager_apply_alerts(&local_alerts);
+                    }
+
                     ui_manager_update_screens(&local_stats);
+                    ui_manager_update_proc_list(&local_top);
                 } else {
                     /* Fail-safe: Skip this frame, don't freeze! */
                     ESP_LOGW(TAG, "Stats mutex timeout in display task - skipping frame");
@@ -226,6 +377,14 @@ static void display_update_task(void *arg)
             ESP_LOGW(TAG, "LVGL mutex timeout in display task - skipping frame");
         }
 
+        /* A background-staged firmware only restarts the device while nobody
+         * is looking at live data (screensaver) and no image upload runs */
+        fw_update_apply_staged_if_idle(ui_manager_is_screensaver_active() &&
+                                       !ss_image_upload_active());
+
+        /* Counter block -> LittleFS now and then, outside the LVGL mutex */
+        postmortem_save_if_due();
+
         vTaskDelay(pdMS_TO_TICKS(DISPLAY_UPDATE_MS));
     }
 }
@@ -254,8 +413,9 @@ static void lvgl_timer_task(void *arg)
     while (1) {
         /* Feed the watchdog */
         esp_task_wdt_reset();
+        postmortem_feed();
 
-        if (xSemaphoreTake(s_lvgl_mutex, pdMS_TO_TICKS(LVGL_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+        if (postmortem_take(POSTMORTEM_LOCK_LVGL, s_lvgl_mutex, pdMS_TO_TICKS(LVGL_MUTEX_TIMEOUT_MS))) {
             uint32_t time_till_next = lv_timer_handler();
             xSemaphoreGive(s_lvgl_mutex);
 
@@ -298,6 +458,12 @@ void app_main(void)
     } else {
         gui_settings_init_defaults(&gui_settings);
     }
+    alert_rules_init();
+    metric_vm_init();
+    profile_mgr_init();
+
+    /* Counters of the previous run (post-mortem after a watchdog reset) */
+    postmortem_init();
 
     /* Create mutexes */
     s_stats_mutex = xSemaphoreCreateMutex();
@@ -317,6 +483,23 @@ void app_main(void)
     usb_serial_register_handler(ss_image_handle_command);
     usb_serial_register_handler(gui_settings_handle_command);
     usb_serial_register_handler(fw_update_handle_command);
+    usb_serial_register_handler(ui_manager_handle_view_command);
+    usb_serial_register_handler(alert_rules_handle_command);
+    usb_serial_register_handler(metric_vm_handle_command);
+    usb_serial_register_handler(bench_handle_command);
+    usb_serial_register_handler(postmortem_handle_command);
+    usb_serial_register_handler(profile_mgr_handle_command);
+
+    /* Optional features of those handlers, reported in GET_CAPS */
+    usb_serial_register_feature("VIEW");
+    usb_serial_register_feature("SPR");
+    usb_serial_register_feature("STAGE");
+    usb_serial_register_feature("ALRT");
+    usb_serial_register_feature("BENCH");
+    usb_serial_register_feature("CRC");
+    usb_serial_register_feature("EXPR");
+    usb_serial_register_feature("PROF");
+    usb_serial_set_displays(SCREEN_COUNT, SCARAB_IMG_WIDTH, SCARAB_IMG_HEIGHT);
 
     /* Set theme callback for gui_settings (SET_SS_BG command) */
     gui_settings_set_theme_callback(theme_update_callback);
@@ -355,11 +538,19 @@ void app_main(void)
     /* Display 1: CPU */
     ESP_LOGI(TAG, "Initializing CPU display...");
     lvgl_gc9a01_init(&config_cpu, &display_cpu);
+    size_t mem_before = ui_mem_used();
     s_screens.cpu = screen_cpu_create(lvgl_gc9a01_get_display(&display_cpu));
+    ESP_LOGI(TAG, "CPU screen: %u bytes (%s)", (unsigned)(ui_mem_used() - mem_before),
+             (s_screens.cpu && s_screens.cpu->gauge) ? "immediate" : "widgets");
     if (s_screens.cpu && s_screens.cpu->screen) {
         if (s_screens.cpu->label_title) {
             lv_label_set_text(s_screens.cpu->label_title, hw_id->cpu_name);
         }
+        if (s_screens.cpu->gauge) {
+            screen_gauge_set_text(s_screens.cpu->gauge, SCREEN_GAUGE_TITLE, hw_id->cpu_name, SCREEN_BAND_NORMAL);
+        }
+        /* Process list view sits below the status dot and screensaver */
+        s_screens.proc = screen_proc_create(s_screens.cpu->screen);
         s_dots.cpu = ui_manager_create_status_dot(s_screens.cpu->screen);
         s_screensavers.cpu = ui_manager_create_screensaver_ex(
             s_screens.cpu->screen, COLOR_SONIC_BG, ss_image_get_dsc(SS_IMG_CPU), SS_IMG_CPU);
@@ -368,11 +559,17 @@ void app_main(void)
     /* Display 2: GPU */
     ESP_LOGI(TAG, "Initializing GPU display...");
     lvgl_gc9a01_init(&config_gpu, &display_gpu);
+    mem_before = ui_mem_used();
     s_screens.gpu = screen_gpu_create(lvgl_gc9a01_get_display(&display_gpu));
+    ESP_LOGI(TAG, "GPU screen: %u bytes (%s)", (unsigned)(ui_mem_used() - mem_before),
+             (s_screens.gpu && s_screens.gpu->gauge) ? "immediate" : "widgets");
     if (s_screens.gpu && s_screens.gpu->screen) {
         if (s_screens.gpu->label_title) {
             lv_label_set_text(s_screens.gpu->label_title, hw_id->gpu_name);
         }
+        if (s_screens.gpu->gauge) {
+            screen_gauge_set_text(s_screens.gpu->gauge, SCREEN_GAUGE_TITLE, hw_id->gpu_name, SCREEN_BAND_NORMAL);
+        }
         s_dots.gpu = ui_manager_create_status_dot(s_screens.gpu->screen);
         s_screensavers.gpu = ui_manager_create_screensaver_ex(
             s_screens.gpu->screen, COLOR_ART_BG, ss_image_get_dsc(SS_IMG_GPU), SS_IMG_GPU);
@@ -383,6 +580,8 @@ void app_main(void)
     lvgl_gc9a01_init(&config_ram, &display_ram);
     s_screens.ram = screen_ram_create(lvgl_gc9a01_get_display(&display_ram));
     if (s_screens.ram && s_screens.ram->screen) {
+        /* Storage view sits below the status dot and screensaver */
+        s_screens.storage = screen_storage_create(s_screens.ram->screen);
         s_dots.ram = ui_manager_create_status_dot(s_screens.ram->screen);
         s_screensavers.ram = ui_manager_create_screensaver_ex(
             s_screens.ram->screen, COLOR_DK_BG, ss_image_get_dsc(SS_IMG_RAM), SS_IMG_RAM);
@@ -398,13 +597,22 @@ void app_main(void)
             s_screens.network->screen, COLOR_PACMAN_BG, ss_image_get_dsc(SS_IMG_NET), SS_IMG_NET);
     }
 
+    apply_flush_classes(false);
+
     /* Register UI handles with manager */
     ui_manager_set_screens(&s_screens);
     ui_manager_set_screensavers(&s_screensavers);
     ui_manager_set_status_dots(&s_dots);
 
     /* Register callback for screensaver image hot-swap (Thread-Safety Fix) */
-    ss_set_reload_callback((ss_image_reload_cb_t)ui_manager_on_image_reload);
+    ss_set_reload_callback(on_ss_image_reload);
+    ss_set_unload_callback(on_ss_image_unload);
+
+    /* Displays for the BENCH render cases, in GET_CAPS order */
+    lvgl_gc9a01_handle_t *const bench_displays[] = {
+        &display_cpu, &display_gpu, &display_ram, &display_network
+    };
+    bench_init(bench_displays, (int)(sizeof(bench_displays) / sizeof(bench_displays[0])), s_lvgl_mutex);
 
     xSemaphoreGive(s_lvgl_mutex);
     ESP_LOGI(TAG, "All displays initialized");
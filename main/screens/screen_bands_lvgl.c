@@ -0,0 +1,80 @@
+/**
+ * @file screen_bands_lvgl.c
+ * @brief Shared warning / critical / N/A styles bound to LVGL user states
+ */
+
+#include "screens_lvgl.h"
+
+#define BAND_COLOR_WARN     0xFFA500    /* Orange */
+#define BAND_COLOR_CRIT     0xFF4444    /* Red */
+#define BAND_COLOR_NA       0xFF4444    /* Red */
+
+static lv_style_t s_text_warn, s_text_crit, s_text_na;
+static lv_style_t s_bar_warn, s_bar_crit, s_bar_na;
+static bool s_styles_ready = false;
+
+/* Styles are shared by all displays - initialized on first use (LVGL mutex held) */
+static void init_styles(void)
+{
+    if (s_styles_ready) return;
+
+    lv_style_init(&s_text_warn);
+    lv_style_set_text_color(&s_text_warn, lv_color_hex(BAND_COLOR_WARN));
+    lv_style_init(&s_text_crit);
+    lv_style_set_text_color(&s_text_crit, lv_color_hex(BAND_COLOR_CRIT));
+    lv_style_init(&s_text_na);
+    lv_style_set_text_color(&s_text_na, lv_color_hex(BAND_COLOR_NA));
+
+    lv_style_init(&s_bar_warn);
+    lv_style_set_bg_color(&s_bar_warn, lv_color_hex(BAND_COLOR_WARN));
+    lv_style_init(&s_bar_crit);
+    lv_style_set_bg_color(&s_bar_crit, lv_color_hex(BAND_COLOR_CRIT));
+    lv_style_init(&s_bar_na);
+    lv_style_set_bg_color(&s_bar_na, lv_color_hex(BAND_COLOR_NA));
+
+    s_styles_ready = true;
+}
+
+void screen_band_add_text_styles(lv_obj_t *label)
+{
+    init_styles();
+    lv_obj_add_style(label, &s_text_warn, LV_PART_MAIN | SCREEN_STATE_WARN);
+    lv_obj_add_style(label, &s_text_crit, LV_PART_MAIN | SCREEN_STATE_CRIT);
+    lv_obj_add_style(label, &s_text_na, LV_PART_MAIN | SCREEN_STATE_NA);
+}
+
+void screen_band_add_bar_styles(lv_obj_t *bar)
+{
+    init_styles();
+    lv_obj_add_style(bar, &s_bar_warn, LV_PART_INDICATOR | SCREEN_STATE_WARN);
+    lv_obj_add_style(bar, &s_bar_crit, LV_PART_INDICATOR | SCREEN_STATE_CRIT);
+    lv_obj_add_style(bar, &s_bar_na, LV_PART_INDICATOR | SCREEN_STATE_NA);
+}
+
+void screen_band_set(lv_obj_t *obj, screen_band_t band)
+{
+    static const lv_state_t band_state[] = {
+        [SCREEN_BAND_NORMAL] = 0,
+        [SCREEN_BAND_WARN]   = SCREEN_STATE_WARN,
+        [SCREEN_BAND_CRIT]   = SCREEN_STATE_CRIT,
+        [SCREEN_BAND_NA]     = SCREEN_STATE_NA,
+    };
+    const lv_state_t all = SCREEN_STATE_WARN | SCREEN_STATE_CRIT | SCREEN_STATE_NA;
+
+    lv_state_t have = lv_obj_get_state(obj) & all;
+    lv_state_t want = band_state[band];
+    if (have == want) return;
+
+    if (have) lv_obj_remove_state(obj, have);
+    if (want) lv_obj_add_state(obj, want);
+}
+
+uint32_t screen_band_color(screen_band_t band, uint32_t normal)
+{
+    switch (band) {
+        case SCREEN_BAND_WARN: return BAND_COLOR_WARN;
+        case SCREEN_BAND_CRIT: return BAND_COLOR_CRIT;
+        case SCREEN_BAND_NA:   return BAND_COLOR_NA;
+        default:               return normal;
+    }
+}
@@ -6,34 +6,19 @@
  * - Ring gauge (Arc widget) showing CPU percentage (0-100 range)
  * - Green arc (#40FF64) on dark gray background (#55555C)
  * - Center text: "CPU" (top), percentage value (center), temperature (bottom)
- * - Temperature changes color based on value
+ * - Temperature color comes from the alert rules (temp_color)
+ * - N/A look via the shared value-band styles (state toggled on change only)
  * - No rounded arc ends (sharp edges)
  */
 
 #include "screens_lvgl.h"
 #include <stdio.h>
+#include "sdkconfig.h"
 
 /* Widget handles defined in screens_lvgl.h */
 
-/**
- * @brief Create CPU gauge screen
- */
-screen_cpu_t *screen_cpu_create(lv_display_t *disp)
+static void create_widgets(screen_cpu_t *s)
 {
-    screen_cpu_t *s = malloc(sizeof(screen_cpu_t));
-    if (!s) return NULL;
-
-    s->last_percent = SCREEN_VALUE_SENTINEL;
-    s->last_temp = SCREEN_VALUE_SENTINEL;
-
-    /* Set this display as default temporarily to create screen on it */
-    lv_display_t *old_default = lv_display_get_default();
-    lv_display_set_default(disp);
-
-    /* Create screen (will be created on the default display) */
-    s->screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(s->screen, lv_color_black(), 0);
-
     /* ========================================================================
      * ARC WIDGET (Ring Gauge) - SquareLine Studio Design
      * ====================================================================== */
@@ -95,6 +80,7 @@ screen_cpu_t *screen_cpu_create(lv_display_t *disp)
     lv_obj_set_style_text_opa(s->label_percent, 255, LV_PART_MAIN);
     lv_obj_set_style_text_align(s->label_percent, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
     lv_obj_set_style_text_font(s->label_percent, &lv_font_montserrat_42, LV_PART_MAIN);
+    screen_band_add_text_styles(s->label_percent);
 
     /* Temperature - Bottom (Y offset +70) */
     s->label_temp = lv_label_create(s->screen);
@@ -103,10 +89,59 @@ screen_cpu_t *screen_cpu_create(lv_display_t *disp)
     lv_obj_set_align(s->label_temp, LV_ALIGN_CENTER);
     lv_obj_set_pos(s->label_temp, 0, 70);
     lv_label_set_text(s->label_temp, "XX°C");
-    lv_obj_set_style_text_color(s->label_temp, lv_color_hex(0xF40B0B), LV_PART_MAIN);  /* Red default */
+    lv_obj_set_style_text_color(s->label_temp, lv_color_hex(s->temp_color), LV_PART_MAIN);
     lv_obj_set_style_text_opa(s->label_temp, 255, LV_PART_MAIN);
     lv_obj_set_style_text_align(s->label_temp, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
     lv_obj_set_style_text_font(s->label_temp, &lv_font_montserrat_34, LV_PART_MAIN);
+    screen_band_add_text_styles(s->label_temp);
+}
+
+#if CONFIG_PCMON_IMMEDIATE_GAUGES
+/* Immediate-mode variant: same look, one object */
+static void create_gauge(screen_cpu_t *s)
+{
+    s->gauge = screen_gauge_create(s->screen);
+    if (!s->gauge) return;
+    screen_gauge_set_color(s->gauge, SCREEN_GAUGE_ARC, 0x0071C5);     /* Intel Blue */
+    screen_gauge_set_color(s->gauge, SCREEN_GAUGE_TITLE, 0x0071C5);
+    screen_gauge_set_color(s->gauge, SCREEN_GAUGE_TEMP, s->temp_color);
+    screen_gauge_set_text(s->gauge, SCREEN_GAUGE_TITLE, "i9-7980XE", SCREEN_BAND_NORMAL);
+    screen_gauge_set_text(s->gauge, SCREEN_GAUGE_VALUE, "XX%", SCREEN_BAND_NORMAL);
+    screen_gauge_set_text(s->gauge, SCREEN_GAUGE_TEMP, "XX°C", SCREEN_BAND_NORMAL);
+}
+#endif
+
+/**
+ * @brief Create CPU gauge screen
+ */
+screen_cpu_t *screen_cpu_create(lv_display_t *disp)
+{
+    screen_cpu_t *s = malloc(sizeof(screen_cpu_t));
+    if (!s) return NULL;
+
+    s->temp_color = 0x4CAF50;   /* Green until the UI manager applies the theme */
+
+    /* Set this display as default temporarily to create screen on it */
+    lv_display_t *old_default = lv_display_get_default();
+    lv_display_set_default(disp);
+
+    /* Create screen (will be created on the default display) */
+    s->screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(s->screen, lv_color_black(), 0);
+
+    s->arc = NULL;
+    s->label_title = NULL;
+    s->label_percent = NULL;
+    s->label_temp = NULL;
+    s->gauge = NULL;
+#if CONFIG_PCMON_IMMEDIATE_GAUGES
+    create_gauge(s);
+    if (!s->gauge) {
+        create_widgets(s);      /* No memory for the gauge - the widgets still work */
+    }
+#else
+    create_widgets(s);
+#endif
 
     /* Load screen to this display */
     lv_screen_load(s->screen);
@@ -133,52 +168,57 @@ lv_obj_t *screen_cpu_get_screen(screen_cpu_t *s)
     return s ? s->screen : NULL;
 }
 
-void screen_cpu_update(screen_cpu_t *s, const pc_stats_t *stats)
+/* Load and temperature go to the widgets or the immediate-mode gauge */
+static void show_load(screen_cpu_t *s, int arc_value, const char *text, screen_band_t band)
 {
-    if (!s) return;
+    if (s->gauge) {
+        screen_gauge_set_arc(s->gauge, arc_value);
+        screen_gauge_set_text(s->gauge, SCREEN_GAUGE_VALUE, text, band);
+        return;
+    }
+    lv_arc_set_value(s->arc, arc_value);
+    lv_label_set_text(s->label_percent, text);
+    screen_band_set(s->label_percent, band);
+}
 
-    /* Skip redraw if nothing changed (display task runs faster than data arrives) */
-    if (stats->cpu_percent == s->last_percent && stats->cpu_temp == s->last_temp) {
+static void show_temp(screen_cpu_t *s, const char *text, screen_band_t band)
+{
+    if (s->gauge) {
+        screen_gauge_set_text(s->gauge, SCREEN_GAUGE_TEMP, text, band);
         return;
     }
-    s->last_percent = stats->cpu_percent;
-    s->last_temp = stats->cpu_temp;
+    lv_label_set_text(s->label_temp, text);
+    screen_band_set(s->label_temp, band);
+}
+
+void screen_cpu_update(screen_cpu_t *s, const pc_stats_t *stats, uint32_t dirty)
+{
+    if (!s) return;
 
     /* ---- Load ---- */
-    if (stats->cpu_percent < 0) {
-        /* Sensor error */
-        lv_arc_set_value(s->arc, 0);
-        lv_label_set_text(s->label_percent, "N/A");
-        lv_obj_set_style_text_color(s->label_percent, lv_color_hex(0xFF4444), LV_PART_MAIN);
-    } else {
-        int arc_value = stats->cpu_percent;
-        if (arc_value > 100) arc_value = 100;
-        lv_arc_set_value(s->arc, arc_value);
-
-        char buf[8];
-        snprintf(buf, sizeof(buf), "%d%%", stats->cpu_percent);
-        lv_label_set_text(s->label_percent, buf);
-        lv_obj_set_style_text_color(s->label_percent, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+    if (dirty & STATS_DIRTY_CPU_LOAD) {
+        if (stats->cpu_percent < 0) {
+            /* Sensor error */
+            show_load(s, 0, "N/A", SCREEN_BAND_NA);
+        } else {
+            int arc_value = stats->cpu_percent;
+            if (arc_value > 100) arc_value = 100;
+
+            char buf[8];
+            snprintf(buf, sizeof(buf), "%d%%", stats->cpu_percent);
+            show_load(s, arc_value, buf, SCREEN_BAND_NORMAL);
+        }
     }
 
     /* ---- Temperature ---- */
-    if (stats->cpu_temp < 0.0f) {
-        /* Sensor error */
-        lv_label_set_text(s->label_temp, "N/A");
-        lv_obj_set_style_text_color(s->label_temp, lv_color_hex(0xFF4444), LV_PART_MAIN);
-    } else {
-        char temp_buf[16];
-        snprintf(temp_buf, sizeof(temp_buf), "%d°C", (int)stats->cpu_temp);
-        lv_label_set_text(s->label_temp, temp_buf);
-
-        lv_color_t temp_color;
-        if (stats->cpu_temp > 70.0f) {
-            temp_color = lv_color_hex(0xFF4444); /* Bright Red */
-        } else if (stats->cpu_temp > 60.0f) {
-            temp_color = lv_color_hex(0xFF6B6B); /* Orange-Red */
+    if (dirty & STATS_DIRTY_CPU_TEMP) {
+        if (stats->cpu_temp < 0.0f) {
+            /* Sensor error */
+            show_temp(s, "N/A", SCREEN_BAND_NA);
         } else {
-            temp_color = lv_color_hex(0x4CAF50); /* Green */
+            char temp_buf[16];
+            snprintf(temp_buf, sizeof(temp_buf), "%d°C", (int)stats->cpu_temp);
+            show_temp(s, temp_buf, SCREEN_BAND_NORMAL);
         }
-        lv_obj_set_style_text_color(s->label_temp, temp_color, LV_PART_MAIN);
     }
 }
@@ -0,0 +1,237 @@
+/**
+ * @file screen_gauge_im_lvgl.c
+ * @brief Immediate-mode ring gauge (CPU/GPU displays, CONFIG_PCMON_IMMEDIATE_GAUGES)
+ *
+ * One plain LVGL object replaces the arc and the four labels. Its draw
+ * callback paints the ring and the texts from the state below; the setters
+ * compare with what is shown and invalidate only:
+ * - the arc span between the old and the new value (load change)
+ * - the old and the new box of a text (text / band change)
+ * Same geometry as the widget screens: 200 px ring, 20 px wide, 135..45 deg.
+ */
+
+#include "screens_lvgl.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define GAUGE_SIZE          240     /* Whole display */
+#define GAUGE_CENTER        (GAUGE_SIZE / 2)
+#define GAUGE_RADIUS        100     /* Outer radius (200 px arc widget) */
+#define GAUGE_ARC_WIDTH     20
+#define GAUGE_START_ANGLE   135     /* Bottom-left */
+#define GAUGE_SWEEP         270     /* ... clockwise to bottom-right (45) */
+#define GAUGE_TEXT_LEN      32      /* hw_identity names are 31 chars max */
+
+#define GAUGE_TEXT_PARTS    SCREEN_GAUGE_ARC    /* Parts before ARC carry text */
+
+/* Font and vertical offset from the centre, as in the widget screens */
+static const struct {
+    const lv_font_t *font;
+    int32_t y;
+} s_text_layout[GAUGE_TEXT_PARTS] = {
+    [SCREEN_GAUGE_TITLE]  = { &lv_font_montserrat_16, -45 },
+    [SCREEN_GAUGE_VALUE]  = { &lv_font_montserrat_42,   0 },
+    [SCREEN_GAUGE_DETAIL] = { &lv_font_montserrat_22,  38 },
+    [SCREEN_GAUGE_TEMP]   = { &lv_font_montserrat_34,  70 },
+};
+
+struct screen_gauge_t {
+    lv_obj_t *obj;
+    int16_t value;                                  /* Arc 0-100 */
+    uint32_t arc_bg;
+    uint32_t color[SCREEN_GAUGE_PART_COUNT];        /* Normal-band RRGGBB */
+    lv_opa_t opa[SCREEN_GAUGE_PART_COUNT];
+    uint8_t band[GAUGE_TEXT_PARTS];                 /* screen_band_t */
+    char text[GAUGE_TEXT_PARTS][GAUGE_TEXT_LEN];    /* "" = not drawn */
+    lv_area_t text_area[GAUGE_TEXT_PARTS];          /* Relative to obj */
+};
+
+/* =============================================================================
+ * GEOMETRY
+ * ========================================================================== */
+
+static int32_t value_angle(int value)
+{
+    return (GAUGE_START_ANGLE + GAUGE_SWEEP * value / 100) % 360;
+}
+
+/* Invalidate an area given relative to the gauge object */
+static void invalidate_rel(screen_gauge_t *g, const lv_area_t *rel)
+{
+    if (rel->x2 < rel->x1) return;
+
+    lv_area_t coords, area = *rel;
+    lv_obj_get_coords(g->obj, &coords);
+    lv_area_move(&area, coords.x1, coords.y1);
+    lv_obj_invalidate_area(g->obj, &area);
+}
+
+/* Ring section from value lo to value hi (lo == 0, hi == 100: whole ring) */
+static void invalidate_arc(screen_gauge_t *g, int lo, int hi)
+{
+    if (lo == hi) return;
+
+    lv_area_t area;
+    lv_draw_arc_get_area(GAUGE_CENTER, GAUGE_CENTER, GAUGE_RADIUS,
+                         value_angle(lo), value_angle(hi), GAUGE_ARC_WIDTH, false, &area);
+    invalidate_rel(g, &area);
+}
+
+static void measure_text(screen_gauge_t *g, int part)
+{
+    lv_area_t *a = &g->text_area[part];
+
+    if (g->text[part][0] == '\0') {
+        lv_area_set(a, 0, 0, -1, -1);
+        return;
+    }
+
+    lv_point_t size;
+    lv_text_get_size(&size, g->text[part], s_text_layout[part].font, 0, 0,
+                     LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+    a->x1 = GAUGE_CENTER - size.x / 2;
+    a->y1 = GAUGE_CENTER + s_text_layout[part].y - size.y / 2;
+    a->x2 = a->x1 + size.x - 1;
+    a->y2 = a->y1 + size.y - 1;
+}
+
+/* =============================================================================
+ * DRAWING
+ * ========================================================================== */
+
+static void gauge_draw_cb(lv_event_t *e)
+{
+    screen_gauge_t *g = lv_event_get_user_data(e);
+    lv_layer_t *layer = lv_event_get_layer(e);
+    lv_area_t coords;
+    lv_obj_get_coords(g->obj, &coords);
+
+    /* Ring: background, then the indicator up to the value. Dimming the
+     * arc (blink) covers both, like opacity on the arc widget. */
+    lv_draw_arc_dsc_t arc;
+    lv_draw_arc_dsc_init(&arc);
+    arc.center.x = coords.x1 + GAUGE_CENTER;
+    arc.center.y = coords.y1 + GAUGE_CENTER;
+    arc.radius = GAUGE_RADIUS;
+    arc.width = GAUGE_ARC_WIDTH;
+    arc.rounded = 0;
+    arc.opa = g->opa[SCREEN_GAUGE_ARC];
+    arc.start_angle = GAUGE_START_ANGLE;
+    arc.end_angle = value_angle(100);
+    arc.color = lv_color_hex(g->arc_bg);
+    lv_draw_arc(layer, &arc);
+
+    if (g->value > 0) {
+        arc.end_angle = value_angle(g->value);
+        arc.color = lv_color_hex(g->color[SCREEN_GAUGE_ARC]);
+        lv_draw_arc(layer, &arc);
+    }
+
+    for (int i = 0; i < GAUGE_TEXT_PARTS; i++) {
+        if (g->text[i][0] == '\0') continue;
+
+        lv_draw_label_dsc_t label;
+        lv_draw_label_dsc_init(&label);
+        label.text = g->text[i];
+        label.font = s_text_layout[i].font;
+        label.color = lv_color_hex(screen_band_color((screen_band_t)g->band[i], g->color[i]));
+        label.opa = g->opa[i];
+        label.align = LV_TEXT_ALIGN_CENTER;
+
+        lv_area_t area = g->text_area[i];
+        lv_area_move(&area, coords.x1, coords.y1);
+        lv_draw_label(layer, &label, &area);
+    }
+}
+
+/* =============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+screen_gauge_t *screen_gauge_create(lv_obj_t *parent)
+{
+    screen_gauge_t *g = calloc(1, sizeof(screen_gauge_t));
+    if (!g) return NULL;
+
+    /* A bare object: no styles, so LVGL draws nothing of its own */
+    g->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(g->obj);
+    lv_obj_remove_flag(g->obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(g->obj, GAUGE_SIZE, GAUGE_SIZE);
+    lv_obj_center(g->obj);
+    lv_obj_add_event_cb(g->obj, gauge_draw_cb, LV_EVENT_DRAW_MAIN, g);
+
+    g->arc_bg = 0x55555C;
+    for (int i = 0; i < SCREEN_GAUGE_PART_COUNT; i++) {
+        g->color[i] = 0xFFFFFF;
+        g->opa[i] = LV_OPA_COVER;
+    }
+    for (int i = 0; i < GAUGE_TEXT_PARTS; i++) {
+        measure_text(g, i);
+    }
+
+    return g;
+}
+
+void screen_gauge_set_arc(screen_gauge_t *g, int value)
+{
+    if (!g) return;
+    if (value < 0) value = 0;
+    if (value > 100) value = 100;
+    if (value == g->value) return;
+
+    /* Only the span that changed colour */
+    if (value > g->value) {
+        invalidate_arc(g, g->value, value);
+    } else {
+        invalidate_arc(g, value, g->value);
+    }
+    g->value = (int16_t)value;
+}
+
+void screen_gauge_set_text(screen_gauge_t *g, screen_gauge_part_t part,
+                           const char *text, screen_band_t band)
+{
+    if (!g || part >= GAUGE_TEXT_PARTS) return;
+    if (g->band[part] == band && strcmp(g->text[part], text) == 0) return;
+
+    /* Old box, then the new one - a shorter text leaves nothing behind */
+    invalidate_rel(g, &g->text_area[part]);
+    strncpy(g->text[part], text, GAUGE_TEXT_LEN - 1);
+    g->text[part][GAUGE_TEXT_LEN - 1] = '\0';
+    g->band[part] = (uint8_t)band;
+    measure_text(g, part);
+    invalidate_rel(g, &g->text_area[part]);
+}
+
+void screen_gauge_set_color(screen_gauge_t *g, screen_gauge_part_t part, uint32_t rgb)
+{
+    if (!g || part >= SCREEN_GAUGE_PART_COUNT || g->color[part] == rgb) return;
+
+    g->color[part] = rgb;
+    if (part == SCREEN_GAUGE_ARC) {
+        invalidate_arc(g, 0, g->value);
+    } else {
+        invalidate_rel(g, &g->text_area[part]);
+    }
+}
+
+void screen_gauge_set_arc_bg(screen_gauge_t *g, uint32_t rgb)
+{
+    if (!g || g->arc_bg == rgb) return;
+
+    g->arc_bg = rgb;
+    invalidate_arc(g, g->value, 100);
+}
+
+void screen_gauge_set_opa(screen_gauge_t *g, screen_gauge_part_t part, lv_opa_t opa)
+{
+    if (!g || part >= SCREEN_GAUGE_PART_COUNT || g->opa[part] == opa) return;
+
+    g->opa[part] = opa;
+    if (part == SCREEN_GAUGE_ARC) {
+        invalidate_arc(g, 0, 100);
+    } else {
+        invalidate_rel(g, &g->text_area[part]);
+    }
+}
@@ -10,27 +10,12 @@
 
 #include "screens_lvgl.h"
 #include <stdio.h>
+#include "sdkconfig.h"
 
 /* Widget handles defined in screens_lvgl.h */
 
-screen_gpu_t *screen_gpu_create(lv_display_t *disp)
+static void create_widgets(screen_gpu_t *s)
 {
-    screen_gpu_t *s = malloc(sizeof(screen_gpu_t));
-    if (!s) return NULL;
-
-    s->last_percent = SCREEN_VALUE_SENTINEL;
-    s->last_temp = SCREEN_VALUE_SENTINEL;
-    s->last_vram_used = SCREEN_VALUE_SENTINEL;
-    s->last_vram_total = SCREEN_VALUE_SENTINEL;
-
-    /* Set this display as default temporarily */
-    lv_display_t *old_default = lv_display_get_default();
-    lv_display_set_default(disp);
-
-    /* Create screen */
-    s->screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(s->screen, lv_color_black(), 0);
-
     /* ========================================================================
      * ARC WIDGET (Ring Gauge)
      * ====================================================================== */
@@ -79,6 +64,7 @@ screen_gpu_t *screen_gpu_create(lv_display_t *disp)
     lv_obj_set_style_text_opa(s->label_percent, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_align(s->label_percent, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_font(s->label_percent, &lv_font_montserrat_42, LV_PART_MAIN | LV_STATE_DEFAULT);
+    screen_band_add_text_styles(s->label_percent);
 
     /* VRAM - Center (matching SquareLine: Y=38, Font=22) */
     s->label_vram = lv_label_create(s->screen);
@@ -91,6 +77,7 @@ screen_gpu_t *screen_gpu_create(lv_display_t *disp)
     lv_obj_set_style_text_color(s->label_vram, lv_color_hex(0x4CAF50), LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_opa(s->label_vram, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_font(s->label_vram, &lv_font_montserrat_22, LV_PART_MAIN | LV_STATE_DEFAULT);
+    screen_band_add_text_styles(s->label_vram);
 
     /* Temperature - Bottom (matching SquareLine: Y=70) */
     s->label_temp = lv_label_create(s->screen);
@@ -100,10 +87,59 @@ screen_gpu_t *screen_gpu_create(lv_display_t *disp)
     lv_obj_set_y(s->label_temp, 70);
     lv_obj_set_align(s->label_temp, LV_ALIGN_CENTER);
     lv_label_set_text(s->label_temp, "XX°C");
-    lv_obj_set_style_text_color(s->label_temp, lv_color_hex(0xF40B0B), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(s->label_temp, lv_color_hex(s->temp_color), LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_opa(s->label_temp, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_align(s->label_temp, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_font(s->label_temp, &lv_font_montserrat_34, LV_PART_MAIN | LV_STATE_DEFAULT);
+    screen_band_add_text_styles(s->label_temp);
+}
+
+#if CONFIG_PCMON_IMMEDIATE_GAUGES
+/* Immediate-mode variant: same look, one object */
+static void create_gauge(screen_gpu_t *s)
+{
+    s->gauge = screen_gauge_create(s->screen);
+    if (!s->gauge) return;
+    screen_gauge_set_color(s->gauge, SCREEN_GAUGE_ARC, 0x76B900);     /* NVIDIA Green */
+    screen_gauge_set_color(s->gauge, SCREEN_GAUGE_TITLE, 0x76B900);
+    screen_gauge_set_color(s->gauge, SCREEN_GAUGE_DETAIL, 0x4CAF50);
+    screen_gauge_set_color(s->gauge, SCREEN_GAUGE_TEMP, s->temp_color);
+    screen_gauge_set_text(s->gauge, SCREEN_GAUGE_TITLE, "3080 Ti", SCREEN_BAND_NORMAL);
+    screen_gauge_set_text(s->gauge, SCREEN_GAUGE_VALUE, "XX%", SCREEN_BAND_NORMAL);
+    screen_gauge_set_text(s->gauge, SCREEN_GAUGE_DETAIL, "12 / 12 GB", SCREEN_BAND_NORMAL);
+    screen_gauge_set_text(s->gauge, SCREEN_GAUGE_TEMP, "XX°C", SCREEN_BAND_NORMAL);
+}
+#endif
+
+screen_gpu_t *screen_gpu_create(lv_display_t *disp)
+{
+    screen_gpu_t *s = malloc(sizeof(screen_gpu_t));
+    if (!s) return NULL;
+
+    s->temp_color = 0x4CAF50;   /* Green until the UI manager applies the theme */
+
+    /* Set this display as default temporarily */
+    lv_display_t *old_default = lv_display_get_default();
+    lv_display_set_default(disp);
+
+    /* Create screen */
+    s->screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(s->screen, lv_color_black(), 0);
+
+    s->arc = NULL;
+    s->label_title = NULL;
+    s->label_percent = NULL;
+    s->label_temp = NULL;
+    s->label_vram = NULL;
+    s->gauge = NULL;
+#if CONFIG_PCMON_IMMEDIATE_GAUGES
+    create_gauge(s);
+    if (!s->gauge) {
+        create_widgets(s);      /* No memory for the gauge - the widgets still work */
+    }
+#else
+    create_widgets(s);
+#endif
 
     /* Load screen to this display */
     lv_screen_load(s->screen);
@@ -124,66 +160,69 @@ lv_obj_t *screen_gpu_get_screen(screen_gpu_t *s)
     return s ? s->screen : NULL;
 }
 
-void screen_gpu_update(screen_gpu_t *s, const pc_stats_t *stats)
+/* Values go to the widgets or the immediate-mode gauge */
+static void show_load(screen_gpu_t *s, int arc_value, const char *text, screen_band_t band)
 {
-    if (!s) return;
+    if (s->gauge) {
+        screen_gauge_set_arc(s->gauge, arc_value);
+        screen_gauge_set_text(s->gauge, SCREEN_GAUGE_VALUE, text, band);
+        return;
+    }
+    lv_arc_set_value(s->arc, arc_value);
+    lv_label_set_text(s->label_percent, text);
+    screen_band_set(s->label_percent, band);
+}
 
-    /* Skip redraw if nothing changed (display task runs faster than data arrives) */
-    if (stats->gpu_percent == s->last_percent && stats->gpu_temp == s->last_temp &&
-        stats->gpu_vram_used == s->last_vram_used && stats->gpu_vram_total == s->last_vram_total) {
+static void show_text(screen_gpu_t *s, lv_obj_t *label, screen_gauge_part_t part,
+                      const char *text, screen_band_t band)
+{
+    if (s->gauge) {
+        screen_gauge_set_text(s->gauge, part, text, band);
         return;
     }
-    s->last_percent = stats->gpu_percent;
-    s->last_temp = stats->gpu_temp;
-    s->last_vram_used = stats->gpu_vram_used;
-    s->last_vram_total = stats->gpu_vram_total;
+    lv_label_set_text(label, text);
+    screen_band_set(label, band);
+}
+
+void screen_gpu_update(screen_gpu_t *s, const pc_stats_t *stats, uint32_t dirty)
+{
+    if (!s) return;
 
     /* ---- Load ---- */
-    if (stats->gpu_percent < 0) {
-        lv_arc_set_value(s->arc, 0);
-        lv_label_set_text(s->label_percent, "N/A");
-        lv_obj_set_style_text_color(s->label_percent, lv_color_hex(0xFF4444), LV_PART_MAIN);
-    } else {
-        int gpu_val = stats->gpu_percent;
-        if (gpu_val > 100) gpu_val = 100;
-        lv_arc_set_value(s->arc, gpu_val);
-
-        char buf[8];
-        snprintf(buf, sizeof(buf), "%d%%", stats->gpu_percent);
-        lv_label_set_text(s->label_percent, buf);
-        lv_obj_set_style_text_color(s->label_percent, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+    if (dirty & STATS_DIRTY_GPU_LOAD) {
+        if (stats->gpu_percent < 0) {
+            show_load(s, 0, "N/A", SCREEN_BAND_NA);
+        } else {
+            int gpu_val = stats->gpu_percent;
+            if (gpu_val > 100) gpu_val = 100;
+
+            char buf[8];
+            snprintf(buf, sizeof(buf), "%d%%", stats->gpu_percent);
+            show_load(s, gpu_val, buf, SCREEN_BAND_NORMAL);
+        }
     }
 
     /* ---- Temperature ---- */
-    if (stats->gpu_temp < 0.0f) {
-        lv_label_set_text(s->label_temp, "N/A");
-        lv_obj_set_style_text_color(s->label_temp, lv_color_hex(0xFF4444), 0);
-    } else {
-        char temp_buf[8];
-        snprintf(temp_buf, sizeof(temp_buf), "%.0f°C", stats->gpu_temp);
-        lv_label_set_text(s->label_temp, temp_buf);
-
-        lv_color_t temp_color;
-        if (stats->gpu_temp > 75.0f) {
-            temp_color = lv_color_hex(0xFF4444);
-        } else if (stats->gpu_temp > 65.0f) {
-            temp_color = lv_color_hex(0xFF6B6B);
+    if (dirty & STATS_DIRTY_GPU_TEMP) {
+        if (stats->gpu_temp < 0.0f) {
+            show_text(s, s->label_temp, SCREEN_GAUGE_TEMP, "N/A", SCREEN_BAND_NA);
         } else {
-            temp_color = lv_color_hex(0x4CAF50);
+            char temp_buf[8];
+            snprintf(temp_buf, sizeof(temp_buf), "%.0f°C", stats->gpu_temp);
+            show_text(s, s->label_temp, SCREEN_GAUGE_TEMP, temp_buf, SCREEN_BAND_NORMAL);
         }
-        lv_obj_set_style_text_color(s->label_temp, temp_color, 0);
     }
 
     /* ---- VRAM ---- */
-    if (stats->gpu_vram_total < 0.0f || stats->gpu_vram_used < 0.0f) {
-        lv_label_set_text(s->label_vram, "N/A");
-        lv_obj_set_style_text_color(s->label_vram, lv_color_hex(0xFF4444), 0);
-    } else {
-        char vram_buf[32];
-        float total_vram = (stats->gpu_vram_total > 0.1f) ? stats->gpu_vram_total : 1.0f;
-        snprintf(vram_buf, sizeof(vram_buf), "%.1f / %.0f GB",
-                 stats->gpu_vram_used, total_vram);
-        lv_label_set_text(s->label_vram, vram_buf);
-        lv_obj_set_style_text_color(s->label_vram, lv_color_hex(0x4CAF50), 0);
+    if (dirty & STATS_DIRTY_VRAM) {
+        if (stats->gpu_vram_total < 0.0f || stats->gpu_vram_used < 0.0f) {
+            show_text(s, s->label_vram, SCREEN_GAUGE_DETAIL, "N/A", SCREEN_BAND_NA);
+        } else {
+            char vram_buf[32];
+            float total_vram = (stats->gpu_vram_total > 0.1f) ? stats->gpu_vram_total : 1.0f;
+            snprintf(vram_buf, sizeof(vram_buf), "%.1f / %.0f GB",
+                     stats->gpu_vram_used, total_vram);
+            show_text(s, s->label_vram, SCREEN_GAUGE_DETAIL, vram_buf, SCREEN_BAND_NORMAL);
+        }
     }
 }
@@ -11,20 +11,49 @@
 
 #include "screens_lvgl.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* Widget handles and NETWORK_HISTORY_SIZE defined in screens_lvgl.h */
 
+/* Chart range limits in MB/s (client rates are MiB/s: 1 Gbps = 119 MiB/s) */
+#define NET_RANGE_DEFAULT_MBS   125.0f      /* Unknown link speed: old fixed scale */
+#define NET_RANGE_MAX_MBS       1193.0f     /* 10 GbE line rate */
+
+/**
+ * @brief Link speed string ("1000 Mbps", "2.5 Gbps", "10 Gbps") -> MB/s
+ * @return Line rate in MiB/s, or NET_RANGE_DEFAULT_MBS if unparsable
+ */
+static float link_speed_to_mbs(const char *speed)
+{
+    char *end = NULL;
+    float v = strtof(speed, &end);
+    if (!end || end == speed || v <= 0.0f) return NET_RANGE_DEFAULT_MBS;
+
+    while (*end == ' ') end++;
+    float bits = (*end == 'G') ? v * 1e9f : v * 1e6f;   /* "Mbps" otherwise */
+    float mbs = bits / 8.0f / (1024.0f * 1024.0f);
+
+    if (mbs > NET_RANGE_MAX_MBS) mbs = NET_RANGE_MAX_MBS;
+    return mbs;
+}
+
+static void format_rate(char *buf, size_t size, const char *prefix, float mbs)
+{
+    if (mbs >= 1000.0f) {
+        snprintf(buf, size, "%s %.2f GB/s", prefix, mbs / 1024.0f);
+    } else {
+        snprintf(buf, size, "%s %.1f MB/s", prefix, mbs);
+    }
+}
+
 screen_network_t *screen_network_create(lv_display_t *disp)
 {
     screen_network_t *s = malloc(sizeof(screen_network_t));
     if (!s) return NULL;
 
     s->history_index = 0;
-    s->last_down = SCREEN_VALUE_SENTINEL;
-    s->last_up = SCREEN_VALUE_SENTINEL;
-    s->last_type[0] = '\0';
-    s->last_speed[0] = '\0';
+    s->chart_max = (int32_t)(NET_RANGE_DEFAULT_MBS * NETWORK_CHART_UNITS_PER_MB);
 
     /* Set this display as default temporarily */
     lv_display_t *old_default = lv_display_get_default();
@@ -68,7 +97,7 @@ screen_network_t *screen_network_create(lv_display_t *disp)
 
     lv_chart_set_type(s->chart, LV_CHART_TYPE_LINE);
     lv_chart_set_point_count(s->chart, NETWORK_HISTORY_SIZE);
-    lv_chart_set_range(s->chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+    lv_chart_set_range(s->chart, LV_CHART_AXIS_PRIMARY_Y, 0, s->chart_max);
     lv_chart_set_update_mode(s->chart, LV_CHART_UPDATE_MODE_SHIFT);
 
     /* Styling */
@@ -96,6 +125,7 @@ screen_network_t *screen_network_create(lv_display_t *disp)
     lv_obj_set_style_text_font(s->label_down, &lv_font_montserrat_14, 0);
     lv_obj_set_style_text_color(s->label_down, lv_color_make(0x00, 0xff, 0xff), 0);
     lv_obj_set_style_text_align(s->label_down, LV_TEXT_ALIGN_CENTER, 0);
+    screen_band_add_text_styles(s->label_down);
     lv_obj_align(s->label_down, LV_ALIGN_BOTTOM_MID, 0, -35);
 
     /* Upload Speed - Center Bottom (second line) */
@@ -104,6 +134,7 @@ screen_network_t *screen_network_create(lv_display_t *disp)
     lv_obj_set_style_text_font(s->label_up, &lv_font_montserrat_14, 0);
     lv_obj_set_style_text_color(s->label_up, lv_color_make(0xff, 0x00, 0xff), 0);
     lv_obj_set_style_text_align(s->label_up, LV_TEXT_ALIGN_CENTER, 0);
+    screen_band_add_text_styles(s->label_up);
     lv_obj_align(s->label_up, LV_ALIGN_BOTTOM_MID, 0, -15);
 
     /* Load screen to this display */
@@ -117,6 +148,38 @@ screen_network_t *screen_network_create(lv_display_t *disp)
     return s;
 }
 
+/**
+ * @brief Replace the chart contents with a history backfill
+ *
+ * Writes the series arrays directly and redraws once - 60 set_next_value
+ * calls would shift (and invalidate) the whole chart 60 times. Fewer points
+ * than the chart width are right-aligned behind zeros.
+ */
+void screen_network_load_history(screen_network_t *s, const history_backfill_t *history)
+{
+    if (!s || !history || history->count == 0) return;
+
+    int32_t *down = lv_chart_get_series_y_array(s->chart, s->ser_down);
+    int32_t *up = lv_chart_get_series_y_array(s->chart, s->ser_up);
+    int pad = NETWORK_HISTORY_SIZE - history->count;
+
+    for (int i = 0; i < NETWORK_HISTORY_SIZE; i++) {
+        int32_t d = 0, u = 0;
+        if (i >= pad) {
+            /* Backfill is in 0.1 MB/s, chart in NETWORK_CHART_UNITS_PER_MB */
+            d = history->net_down[i - pad] * NETWORK_CHART_UNITS_PER_MB / 10;
+            u = history->net_up[i - pad] * NETWORK_CHART_UNITS_PER_MB / 10;
+        }
+        down[i] = (d > s->chart_max) ? s->chart_max : d;
+        up[i] = (u > s->chart_max) ? s->chart_max : u;
+    }
+
+    /* Shift mode draws from start_point (oldest): index 0 is the oldest now */
+    lv_chart_set_x_start_point(s->chart, s->ser_down, 0);
+    lv_chart_set_x_start_point(s->chart, s->ser_up, 0);
+    lv_chart_refresh(s->chart);
+}
+
 /**
  * @brief Get the screen object (for screensaver restore)
  */
@@ -125,69 +188,64 @@ lv_obj_t *screen_network_get_screen(screen_network_t *s)
     return s ? s->screen : NULL;
 }
 
-void screen_network_update(screen_network_t *s, const pc_stats_t *stats)
+void screen_network_update(screen_network_t *s, const pc_stats_t *stats, uint32_t dirty)
 {
     if (!s) return;
 
-    /* Skip redraw if nothing changed. Critical here: without this the chart
-     * shifts at the 10 FPS display rate instead of once per real data packet,
-     * making the traffic graph scroll ~10x too fast. */
-    if (stats->net_down_mbps == s->last_down && stats->net_up_mbps == s->last_up &&
-        strcmp(stats->net_type, s->last_type) == 0 &&
-        strcmp(stats->net_speed, s->last_speed) == 0) {
-        return;
-    }
-    s->last_down = stats->net_down_mbps;
-    s->last_up = stats->net_up_mbps;
-    strncpy(s->last_type, stats->net_type, sizeof(s->last_type) - 1);
-    s->last_type[sizeof(s->last_type) - 1] = '\0';
-    strncpy(s->last_speed, stats->net_speed, sizeof(s->last_speed) - 1);
-    s->last_speed[sizeof(s->last_speed) - 1] = '\0';
+    /* Link info only changes on adapter switches - don't re-set labels
+     * (and invalidate them) on every data packet */
+    if (dirty & STATS_DIRTY_NET_LINK) {
+        lv_label_set_text(s->label_conn_type, stats->net_type);
+        lv_label_set_text(s->label_speed, stats->net_speed);
 
-    /* Update connection type */
-    lv_label_set_text(s->label_conn_type, stats->net_type);
+        /* Follow the link speed (up to 10 GbE). Points are in absolute
+         * units, so the existing history rescales with the range. */
+        s->chart_max = (int32_t)(link_speed_to_mbs(stats->net_speed) * NETWORK_CHART_UNITS_PER_MB);
+        lv_chart_set_range(s->chart, LV_CHART_AXIS_PRIMARY_Y, 0, s->chart_max);
+    }
 
-    /* Update speed */
-    lv_label_set_text(s->label_speed, stats->net_speed);
+    /* Rates and chart only move when a rate changed. Critical here: the
+     * chart must shift once per real data packet, not at the 10 FPS
+     * display rate, or the traffic graph scrolls ~10x too fast. */
+    if (!(dirty & STATS_DIRTY_NET_RATE)) return;
 
     /* ---- Download speed ---- */
     if (stats->net_down_mbps < 0.0f) {
         /* Counter error - show N/A in red */
         lv_label_set_text(s->label_down, "DN: N/A");
-        lv_obj_set_style_text_color(s->label_down, lv_color_hex(0xFF4444), 0);
+        screen_band_set(s->label_down, SCREEN_BAND_NA);
     } else {
-        char down_buf[16];
-        snprintf(down_buf, sizeof(down_buf), "DN: %.1f MB/s", stats->net_down_mbps);
+        char down_buf[24];
+        format_rate(down_buf, sizeof(down_buf), "DN:", stats->net_down_mbps);
         lv_label_set_text(s->label_down, down_buf);
-        lv_obj_set_style_text_color(s->label_down, lv_color_make(0x00, 0xff, 0xff), 0); /* Cyan */
+        screen_band_set(s->label_down, SCREEN_BAND_NORMAL);
     }
 
     /* ---- Upload speed ---- */
     if (stats->net_up_mbps < 0.0f) {
         /* Counter error - show N/A in red */
         lv_label_set_text(s->label_up, "UP: N/A");
-        lv_obj_set_style_text_color(s->label_up, lv_color_hex(0xFF4444), 0);
+        screen_band_set(s->label_up, SCREEN_BAND_NA);
     } else {
-        char up_buf[16];
-        snprintf(up_buf, sizeof(up_buf), "UP: %.1f MB/s", stats->net_up_mbps);
+        char up_buf[24];
+        format_rate(up_buf, sizeof(up_buf), "UP:", stats->net_up_mbps);
         lv_label_set_text(s->label_up, up_buf);
-        lv_obj_set_style_text_color(s->label_up, lv_color_make(0xff, 0x00, 0xff), 0); /* Magenta */
+        screen_band_set(s->label_up, SCREEN_BAND_NORMAL);
     }
 
-    /* Add new data point to chart (scale to 0-100 range) */
-    /* Assuming max 125 MB/s for scaling */
+    /* Add new data point to chart (0.1 MB/s units, clipped to the range) */
     /* Use 0 for chart if value is negative (error state) */
     float down_val = (stats->net_down_mbps >= 0.0f) ? stats->net_down_mbps : 0.0f;
     float up_val = (stats->net_up_mbps >= 0.0f) ? stats->net_up_mbps : 0.0f;
 
-    int down_scaled = (int)((down_val / 125.0f) * 100.0f);
-    int up_scaled = (int)((up_val / 125.0f) * 100.0f);
+    int32_t down_pt = (int32_t)(down_val * NETWORK_CHART_UNITS_PER_MB);
+    int32_t up_pt = (int32_t)(up_val * NETWORK_CHART_UNITS_PER_MB);
 
-    if (down_scaled > 100) down_scaled = 100;
-    if (up_scaled > 100) up_scaled = 100;
+    if (down_pt > s->chart_max) down_pt = s->chart_max;
+    if (up_pt > s->chart_max) up_pt = s->chart_max;
 
-    lv_chart_set_next_value(s->chart, s->ser_down, down_scaled);
-    lv_chart_set_next_value(s->chart, s->ser_up, up_scaled);
+    lv_chart_set_next_value(s->chart, s->ser_down, down_pt);
+    lv_chart_set_next_value(s->chart, s->ser_up, up_pt);
 
     lv_chart_refresh(s->chart);
 }
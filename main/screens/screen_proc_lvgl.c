@@ -0,0 +1,126 @@
+/**
+ * @file screen_proc_lvgl.c
+ * @brief Process List View (Display 1 alternate) - LVGL Implementation
+ *
+ * Top-N processes by CPU share, fed by the client's TOP: line:
+ * - Fullscreen overlay on the CPU screen (hidden unless the view is active)
+ * - One row per process: name (left), CPU % and resident MB (right)
+ * - Each row remembers what it shows; only rows whose name or displayed
+ *   value changed get new label text (= only those rows are invalidated)
+ */
+
+#include "screens_lvgl.h"
+#include "../gui_settings.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROC_ROW_Y0         (-52)   /* First row, relative to center */
+#define PROC_ROW_PITCH      28      /* Fits 5 rows inside the round panel */
+
+screen_proc_t *screen_proc_create(lv_obj_t *parent)
+{
+    if (!parent) return NULL;
+
+    screen_proc_t *s = malloc(sizeof(screen_proc_t));
+    if (!s) return NULL;
+
+    s->last_seq = 0;
+    for (int i = 0; i < PROC_TOP_COUNT; i++) {
+        s->last_name[i][0] = '\0';
+        s->last_cpu_tenths[i] = SCREEN_VALUE_SENTINEL;
+        s->last_mem_mb[i] = SCREEN_VALUE_SENTINEL;
+    }
+
+    /* Fullscreen overlay (same geometry as the screensaver overlay) */
+    s->overlay = lv_obj_create(parent);
+    lv_obj_set_size(s->overlay, 240, 240);
+    lv_obj_set_pos(s->overlay, 0, 0);
+    lv_obj_set_style_bg_color(s->overlay, lv_color_hex(gui_settings.bg_color[SCREEN_CPU]), 0);
+    lv_obj_set_style_bg_opa(s->overlay, LV_OPA_COVER, 0);
+    lv_obj_set_style_border_width(s->overlay, 0, 0);
+    lv_obj_set_style_radius(s->overlay, 0, 0);
+    lv_obj_set_style_pad_all(s->overlay, 0, 0);
+    lv_obj_clear_flag(s->overlay, LV_OBJ_FLAG_SCROLLABLE);
+
+    /* Header */
+    s->label_header = lv_label_create(s->overlay);
+    lv_label_set_text(s->label_header, "TOP CPU");
+    lv_obj_set_style_text_font(s->label_header, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(s->label_header, lv_color_hex(gui_settings.text_title_cpu), 0);
+    lv_obj_align(s->label_header, LV_ALIGN_CENTER, 0, -84);
+
+    /* Rows: name left-aligned, value right-aligned, both inside the circle */
+    for (int i = 0; i < PROC_TOP_COUNT; i++) {
+        int y = PROC_ROW_Y0 + i * PROC_ROW_PITCH;
+
+        s->label_name[i] = lv_label_create(s->overlay);
+        lv_obj_set_width(s->label_name[i], 100);
+        lv_label_set_text(s->label_name[i], "");
+        lv_obj_set_style_text_font(s->label_name[i], &lv_font_montserrat_16, 0);
+        lv_obj_set_style_text_color(s->label_name[i], lv_color_hex(gui_settings.text_value), 0);
+        lv_obj_set_style_text_align(s->label_name[i], LV_TEXT_ALIGN_LEFT, 0);
+        lv_obj_align(s->label_name[i], LV_ALIGN_CENTER, -40, y);
+
+        s->label_value[i] = lv_label_create(s->overlay);
+        lv_obj_set_width(s->label_value[i], 80);
+        lv_label_set_text(s->label_value[i], "");
+        lv_obj_set_style_text_font(s->label_value[i], &lv_font_montserrat_14, 0);
+        lv_obj_set_style_text_color(s->label_value[i], lv_color_hex(gui_settings.text_secondary), 0);
+        lv_obj_set_style_text_align(s->label_value[i], LV_TEXT_ALIGN_RIGHT, 0);
+        lv_obj_align(s->label_value[i], LV_ALIGN_CENTER, 50, y);
+    }
+
+    /* Start hidden - the CPU gauge is the default view */
+    lv_obj_add_flag(s->overlay, LV_OBJ_FLAG_HIDDEN);
+
+    return s;
+}
+
+void screen_proc_show(screen_proc_t *s, bool show)
+{
+    if (!s) return;
+
+    if (show) {
+        lv_obj_clear_flag(s->overlay, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(s->overlay, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+void screen_proc_update(screen_proc_t *s, const proc_top_t *top)
+{
+    if (!s || !top) return;
+
+    /* Nothing new since the last draw (client sends on ranking change only) */
+    if (top->seq == s->last_seq) return;
+    s->last_seq = top->seq;
+
+    for (int i = 0; i < PROC_TOP_COUNT; i++) {
+        const proc_entry_t *e = (i < top->count) ? &top->entries[i] : NULL;
+        const char *name = e ? e->name : "";
+        int32_t cpu_tenths = e ? (int32_t)(e->cpu_percent * 10.0f + 0.5f) : -1;
+        int32_t mem_mb = e ? (int32_t)e->mem_mb : -1;
+
+        /* Compare on displayed values, not raw floats */
+        if (strcmp(name, s->last_name[i]) != 0) {
+            strncpy(s->last_name[i], name, PROC_NAME_LEN - 1);
+            s->last_name[i][PROC_NAME_LEN - 1] = '\0';
+            lv_label_set_text(s->label_name[i], s->last_name[i]);
+        }
+
+        if (cpu_tenths != s->last_cpu_tenths[i] || mem_mb != s->last_mem_mb[i]) {
+            s->last_cpu_tenths[i] = cpu_tenths;
+            s->last_mem_mb[i] = mem_mb;
+
+            if (!e) {
+                lv_label_set_text(s->label_value[i], "");
+            } else {
+                char buf[24];
+                snprintf(buf, sizeof(buf), "%d.%d%% %luM",
+                         (int)(cpu_tenths / 10), (int)(cpu_tenths % 10), (unsigned long)mem_mb);
+                lv_label_set_text(s->label_value[i], buf);
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
  * - Gradient: Green (#43e97b) → Turquoise (#38f9d7)
  * - Segments for visual clarity
  * - Shows RAM used, percentage, total
+ * - Bar turns orange above 70%, red above 85% (shared value-band styles)
  */
 
 #include "screens_lvgl.h"
@@ -19,9 +20,6 @@ screen_ram_t *screen_ram_create(lv_display_t *disp)
     screen_ram_t *s = malloc(sizeof(screen_ram_t));
     if (!s) return NULL;
 
-    s->last_used = SCREEN_VALUE_SENTINEL;
-    s->last_total = SCREEN_VALUE_SENTINEL;
-
     /* Set this display as default temporarily */
     lv_display_t *old_default = lv_display_get_default();
     lv_display_set_default(disp);
@@ -48,6 +46,7 @@ screen_ram_t *screen_ram_create(lv_display_t *disp)
     lv_obj_set_style_text_font(s->label_value, &lv_font_montserrat_32, 0);
     lv_obj_set_style_text_color(s->label_value, lv_color_white(), 0);
     lv_obj_align(s->label_value, LV_ALIGN_CENTER, 0, -30);
+    screen_band_add_text_styles(s->label_value);
 
     /* Percentage */
     s->label_percent = lv_label_create(s->screen);
@@ -55,6 +54,7 @@ screen_ram_t *screen_ram_create(lv_display_t *disp)
     lv_obj_set_style_text_font(s->label_percent, &lv_font_montserrat_24, 0);
     lv_obj_set_style_text_color(s->label_percent, lv_color_make(0x43, 0xe9, 0x7b), 0);
     lv_obj_align(s->label_percent, LV_ALIGN_CENTER, 0, 0);
+    screen_band_add_text_styles(s->label_percent);
 
     /* ========================================================================
      * PROGRESS BAR
@@ -71,6 +71,7 @@ screen_ram_t *screen_ram_create(lv_display_t *disp)
     lv_obj_set_style_bg_color(s->bar, lv_color_make(0x43, 0xe9, 0x7b), LV_PART_INDICATOR);
     lv_obj_set_style_radius(s->bar, 15, LV_PART_MAIN);
     lv_obj_set_style_radius(s->bar, 15, LV_PART_INDICATOR);
+    screen_band_add_bar_styles(s->bar);
 
     /* Total RAM */
     s->label_total = lv_label_create(s->screen);
@@ -98,27 +99,21 @@ lv_obj_t *screen_ram_get_screen(screen_ram_t *s)
     return s ? s->screen : NULL;
 }
 
-void screen_ram_update(screen_ram_t *s, const pc_stats_t *stats)
+void screen_ram_update(screen_ram_t *s, const pc_stats_t *stats, uint32_t dirty)
 {
-    if (!s) return;
-
-    /* Skip redraw if nothing changed (display task runs faster than data arrives) */
-    if (stats->ram_used_gb == s->last_used && stats->ram_total_gb == s->last_total) {
-        return;
-    }
-    s->last_used = stats->ram_used_gb;
-    s->last_total = stats->ram_total_gb;
+    /* Every widget here shows the used/total pair */
+    if (!s || !(dirty & STATS_DIRTY_RAM)) return;
 
     /* ---- Check for sensor error (N/A case) ---- */
     if (stats->ram_used_gb < 0.0f || stats->ram_total_gb < 0.0f) {
         /* Sensor error - show N/A in red */
         lv_bar_set_value(s->bar, 0, LV_ANIM_OFF);
         lv_label_set_text(s->label_value, "N/A");
-        lv_obj_set_style_text_color(s->label_value, lv_color_hex(0xFF4444), 0);
+        screen_band_set(s->label_value, SCREEN_BAND_NA);
         lv_label_set_text(s->label_percent, "N/A");
-        lv_obj_set_style_text_color(s->label_percent, lv_color_hex(0xFF4444), 0);
+        screen_band_set(s->label_percent, SCREEN_BAND_NA);
         lv_label_set_text(s->label_total, "");
-        lv_obj_set_style_bg_color(s->bar, lv_color_hex(0xFF4444), LV_PART_INDICATOR);
+        screen_band_set(s->bar, SCREEN_BAND_NA);
         return;
     }
 
@@ -141,27 +136,20 @@ void screen_ram_update(screen_ram_t *s, const pc_stats_t *stats)
     char buf[16];
     snprintf(buf, sizeof(buf), "%.1f GB", stats->ram_used_gb);
     lv_label_set_text(s->label_value, buf);
-    lv_obj_set_style_text_color(s->label_value, lv_color_white(), 0);
+    screen_band_set(s->label_value, SCREEN_BAND_NORMAL);
 
     /* Update percentage */
     char percent_buf[8];
     snprintf(percent_buf, sizeof(percent_buf), "%d%%", percent);
     lv_label_set_text(s->label_percent, percent_buf);
-    lv_obj_set_style_text_color(s->label_percent, lv_color_make(0x43, 0xe9, 0x7b), 0);
+    screen_band_set(s->label_percent, SCREEN_BAND_NORMAL);
 
     /* Update total */
     char total_buf[16];
     snprintf(total_buf, sizeof(total_buf), "von %.0f GB", stats->ram_total_gb);
     lv_label_set_text(s->label_total, total_buf);
 
-    /* Change bar color based on usage */
-    lv_color_t bar_color;
-    if (percent > 85) {
-        bar_color = lv_color_make(0xff, 0x44, 0x44); /* Red */
-    } else if (percent > 70) {
-        bar_color = lv_color_make(0xff, 0xa5, 0x00); /* Orange */
-    } else {
-        bar_color = lv_color_make(0x43, 0xe9, 0x7b); /* Green */
-    }
-    lv_obj_set_style_bg_color(s->bar, bar_color, LV_PART_INDICATOR);
+    /* Bar colour by usage band (state only changes when the band does) */
+    screen_band_set(s->bar, percent > 85 ? SCREEN_BAND_CRIT :
+                            percent > 70 ? SCREEN_BAND_WARN : SCREEN_BAND_NORMAL);
 }
@@ -0,0 +1,219 @@
+/**
+ * @file screen_storage_lvgl.c
+ * @brief Storage View (Display 3 alternate) - LVGL Implementation
+ *
+ * Disk I/O from the client's DSK: field:
+ * - Fullscreen overlay on the RAM screen (hidden unless the view is active)
+ * - Read / write throughput sparklines, IOPS, queue depth and latency
+ * - Sparklines run in circular mode: each packet overwrites one column and
+ *   LVGL only invalidates that column (shift mode redraws the whole chart)
+ * - Y axis is log2(1 + MB/s) so idle, HDD and NVMe rates share one fixed
+ *   range - a range change would invalidate the full chart again
+ */
+
+#include "screens_lvgl.h"
+#include "../gui_settings.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STORAGE_CHART_W         170
+#define STORAGE_CHART_H         36
+#define STORAGE_LOG_SCALE       100     /* Chart units per log2 step */
+#define STORAGE_RANGE_MAX_MBS   8192.0f /* Top of the chart (~8 GB/s) */
+
+#define STORAGE_COLOR_READ      lv_color_make(0x00, 0xff, 0xff)
+#define STORAGE_COLOR_WRITE     lv_color_make(0xff, 0x00, 0xff)
+
+static int32_t mbs_to_point(float mbs)
+{
+    if (mbs <= 0.0f) return 0;
+    if (mbs > STORAGE_RANGE_MAX_MBS) mbs = STORAGE_RANGE_MAX_MBS;
+    return (int32_t)(log2f(1.0f + mbs) * STORAGE_LOG_SCALE);
+}
+
+static void format_rate(char *buf, size_t size, const char *prefix, float mbs)
+{
+    if (mbs < 0.0f) {
+        snprintf(buf, size, "%s N/A", prefix);
+    } else if (mbs >= 1000.0f) {
+        snprintf(buf, size, "%s %.2f GB/s", prefix, mbs / 1024.0f);
+    } else {
+        snprintf(buf, size, "%s %.1f MB/s", prefix, mbs);
+    }
+}
+
+static lv_obj_t *create_sparkline(lv_obj_t *parent, int y, lv_color_t color, lv_chart_series_t **ser)
+{
+    lv_obj_t *chart = lv_chart_create(parent);
+    lv_obj_set_size(chart, STORAGE_CHART_W, STORAGE_CHART_H);
+    lv_obj_align(chart, LV_ALIGN_CENTER, 0, y);
+
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_point_count(chart, STORAGE_HISTORY_SIZE);
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, mbs_to_point(STORAGE_RANGE_MAX_MBS));
+    lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_CIRCULAR);
+    lv_chart_set_div_line_count(chart, 0, 0);
+
+    /* Plain line, no point markers (smaller invalidated column) */
+    lv_obj_set_style_bg_color(chart, lv_color_hex(gui_settings.net_chart_bg), 0);
+    lv_obj_set_style_border_color(chart, lv_color_hex(gui_settings.net_chart_border), 0);
+    lv_obj_set_style_border_width(chart, 1, 0);
+    lv_obj_set_style_pad_all(chart, 2, 0);
+    lv_obj_set_style_size(chart, 0, 0, LV_PART_INDICATOR);
+    lv_obj_set_style_line_width(chart, 2, LV_PART_ITEMS);
+
+    *ser = lv_chart_add_series(chart, color, LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_set_all_value(chart, *ser, 0);
+
+    return chart;
+}
+
+static lv_obj_t *create_label(lv_obj_t *parent, const lv_font_t *font, lv_color_t color, int y)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, "");
+    lv_obj_set_style_text_font(label, font, 0);
+    lv_obj_set_style_text_color(label, color, 0);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_align(label, LV_ALIGN_CENTER, 0, y);
+    return label;
+}
+
+screen_storage_t *screen_storage_create(lv_obj_t *parent)
+{
+    if (!parent) return NULL;
+
+    screen_storage_t *s = malloc(sizeof(screen_storage_t));
+    if (!s) return NULL;
+
+    s->last_seq = 0;
+    s->last_read_tenths = SCREEN_VALUE_SENTINEL;
+    s->last_write_tenths = SCREEN_VALUE_SENTINEL;
+    s->last_read_iops = SCREEN_VALUE_SENTINEL;
+    s->last_write_iops = SCREEN_VALUE_SENTINEL;
+    s->last_queue_tenths = SCREEN_VALUE_SENTINEL;
+    s->last_latency_tenths = SCREEN_VALUE_SENTINEL;
+
+    /* Fullscreen overlay (same geometry as the screensaver overlay) */
+    s->overlay = lv_obj_create(parent);
+    lv_obj_set_size(s->overlay, 240, 240);
+    lv_obj_set_pos(s->overlay, 0, 0);
+    lv_obj_set_style_bg_color(s->overlay, lv_color_hex(gui_settings.bg_color[SCREEN_RAM]), 0);
+    lv_obj_set_style_bg_opa(s->overlay, LV_OPA_COVER, 0);
+    lv_obj_set_style_border_width(s->overlay, 0, 0);
+    lv_obj_set_style_radius(s->overlay, 0, 0);
+    lv_obj_set_style_pad_all(s->overlay, 0, 0);
+    lv_obj_clear_flag(s->overlay, LV_OBJ_FLAG_SCROLLABLE);
+
+    /* Header */
+    s->label_header = lv_label_create(s->overlay);
+    lv_label_set_text(s->label_header, "DISK");
+    lv_obj_set_style_text_font(s->label_header, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(s->label_header, lv_color_hex(gui_settings.text_title_ram), 0);
+    lv_obj_align(s->label_header, LV_ALIGN_TOP_MID, 0, 22);
+
+    /* Read: value above its sparkline, write below - all inside the circle */
+    s->label_read = create_label(s->overlay, &lv_font_montserrat_14, STORAGE_COLOR_READ, -72);
+    s->chart_read = create_sparkline(s->overlay, -42, STORAGE_COLOR_READ, &s->ser_read);
+    s->label_write = create_label(s->overlay, &lv_font_montserrat_14, STORAGE_COLOR_WRITE, -10);
+    s->chart_write = create_sparkline(s->overlay, 20, STORAGE_COLOR_WRITE, &s->ser_write);
+
+    s->label_iops = create_label(s->overlay, &lv_font_montserrat_14,
+                                 lv_color_hex(gui_settings.text_value), 52);
+    s->label_queue = create_label(s->overlay, &lv_font_montserrat_12,
+                                  lv_color_hex(gui_settings.text_secondary), 72);
+
+    /* Start hidden - the RAM bar is the default view */
+    lv_obj_add_flag(s->overlay, LV_OBJ_FLAG_HIDDEN);
+
+    return s;
+}
+
+void screen_storage_show(screen_storage_t *s, bool show)
+{
+    if (!s) return;
+
+    if (show) {
+        lv_obj_clear_flag(s->overlay, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(s->overlay, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+/* Circular mode draws from index 0 and writes the next point at start_point:
+ * put the backfill at the left and let live packets continue after it */
+static void load_sparkline(lv_obj_t *chart, lv_chart_series_t *ser, const int32_t *tenths, int count)
+{
+    int32_t *y = lv_chart_get_series_y_array(chart, ser);
+    for (int i = 0; i < STORAGE_HISTORY_SIZE; i++) {
+        y[i] = (i < count) ? mbs_to_point(tenths[i] / 10.0f) : 0;
+    }
+    lv_chart_set_x_start_point(chart, ser, (uint32_t)(count % STORAGE_HISTORY_SIZE));
+    lv_chart_refresh(chart);
+}
+
+void screen_storage_load_history(screen_storage_t *s, const history_backfill_t *history)
+{
+    if (!s || !history || !history->has_disk || history->count == 0) return;
+
+    int count = history->count;
+    if (count > STORAGE_HISTORY_SIZE) count = STORAGE_HISTORY_SIZE;
+    load_sparkline(s->chart_read, s->ser_read, history->disk_read, count);
+    load_sparkline(s->chart_write, s->ser_write, history->disk_write, count);
+}
+
+void screen_storage_update(screen_storage_t *s, const pc_stats_t *stats)
+{
+    if (!s || !stats) return;
+
+    /* One sparkline column per data packet, not per display frame */
+    if (stats->seq == s->last_seq) return;
+    s->last_seq = stats->seq;
+
+    /* Circular mode: only the new column (and its neighbour) is invalidated.
+     * Called while hidden too, so the history keeps running when the view
+     * is cycled away - invalidating a hidden object costs nothing. */
+    lv_chart_set_next_value(s->chart_read, s->ser_read, mbs_to_point(stats->disk_read_mbs));
+    lv_chart_set_next_value(s->chart_write, s->ser_write, mbs_to_point(stats->disk_write_mbs));
+
+    /* Labels: compare on displayed values */
+    int32_t read_tenths = (int32_t)(stats->disk_read_mbs * 10.0f);
+    int32_t write_tenths = (int32_t)(stats->disk_write_mbs * 10.0f);
+    int32_t read_iops = (int32_t)stats->disk_read_iops;
+    int32_t write_iops = (int32_t)stats->disk_write_iops;
+    int32_t queue_tenths = (int32_t)(stats->disk_queue * 10.0f);
+    int32_t latency_tenths = (int32_t)(stats->disk_latency_ms * 10.0f);
+    char buf[32];
+
+    if (read_tenths != s->last_read_tenths) {
+        s->last_read_tenths = read_tenths;
+        format_rate(buf, sizeof(buf), "RD", stats->disk_read_mbs);
+        lv_label_set_text(s->label_read, buf);
+    }
+    if (write_tenths != s->last_write_tenths) {
+        s->last_write_tenths = write_tenths;
+        format_rate(buf, sizeof(buf), "WR", stats->disk_write_mbs);
+        lv_label_set_text(s->label_write, buf);
+    }
+    if (read_iops != s->last_read_iops || write_iops != s->last_write_iops) {
+        s->last_read_iops = read_iops;
+        s->last_write_iops = write_iops;
+        if (read_iops < 0) {
+            lv_label_set_text(s->label_iops, "IOPS N/A");
+        } else {
+            snprintf(buf, sizeof(buf), "IOPS %ld / %ld", (long)read_iops, (long)write_iops);
+            lv_label_set_text(s->label_iops, buf);
+        }
+    }
+    if (queue_tenths != s->last_queue_tenths || latency_tenths != s->last_latency_tenths) {
+        s->last_queue_tenths = queue_tenths;
+        s->last_latency_tenths = latency_tenths;
+        if (stats->disk_queue < 0.0f) {
+            lv_label_set_text(s->label_queue, "");
+        } else {
+            snprintf(buf, sizeof(buf), "QD %.1f  %.1f ms", stats->disk_queue, stats->disk_latency_ms);
+            lv_label_set_text(s->label_queue, buf);
+        }
+    }
+}
@@ -7,6 +7,8 @@
  * - Display 2: GPU Gauge (Arc widget)
  * - Display 3: RAM Bar (Bar widget)
  * - Display 4: Network Graph (Chart widget)
+ *
+ * Alternate views (SET_VIEW): process list on Display 1, storage on Display 3
  */
 
 #ifndef SCREENS_LVGL_H
@@ -14,6 +16,7 @@
 
 #include "lvgl.h"
 #include <stdint.h>
+#include <stdbool.h>
 #include "core/system_types.h"
 
 #ifdef __cplusplus
@@ -25,21 +28,34 @@ extern "C" {
  */
 #define NETWORK_HISTORY_SIZE 60
 
-/* last_* fields cache the previously displayed values so update functions can
- * skip redundant LVGL calls. The display task runs at 10 FPS but real data
- * arrives ~1x/s; without this every widget is redrawn 10x/s (visible flicker,
- * and the network chart scrolls 10x too fast). Sentinel -999 forces the first
- * update to draw. */
+/* Network chart points are stored in 0.1 MB/s so the Y range can follow the
+ * link speed (100 Mbps .. 10 GbE) without rescaling the history. */
+#define NETWORK_CHART_UNITS_PER_MB  10
+
+/* Gauge, bar and chart updates take the STATS_DIRTY_* mask of the line and
+ * touch only the widgets bound to a changed field group; the UI manager
+ * does not call them at all for lines that change nothing they show. The
+ * display task runs at 10 FPS but real data arrives ~1x/s - redrawing every
+ * frame would flicker and scroll the network chart 10x too fast.
+ *
+ * The overlays cache their displayed values in last_* fields instead
+ * (finer than a field group); sentinel -999 forces the first update to draw. */
 #define SCREEN_VALUE_SENTINEL (-999)
 
+typedef struct screen_gauge_t screen_gauge_t;
+
+/* CPU and GPU screens are either widget trees (arc + labels) or, with
+ * CONFIG_PCMON_IMMEDIATE_GAUGES, one immediate-mode gauge - the handles of
+ * the other variant are NULL. gauge == NULL means widgets, also when the
+ * immediate build could not allocate its gauge. */
 struct screen_cpu_t {
     lv_obj_t *screen;
     lv_obj_t *arc;
     lv_obj_t *label_title;
     lv_obj_t *label_percent;
     lv_obj_t *label_temp;
-    int16_t last_percent;
-    float last_temp;
+    screen_gauge_t *gauge;
+    uint32_t temp_color;        /* RRGGBB for valid readings (alert rules) */
 };
 
 struct screen_gpu_t {
@@ -49,10 +65,8 @@ struct screen_gpu_t {
     lv_obj_t *label_percent;
     lv_obj_t *label_temp;
     lv_obj_t *label_vram;
-    int16_t last_percent;
-    float last_temp;
-    float last_vram_used;
-    float last_vram_total;
+    screen_gauge_t *gauge;
+    uint32_t temp_color;        /* RRGGBB for valid readings (alert rules) */
 };
 
 struct screen_ram_t {
@@ -62,8 +76,6 @@ struct screen_ram_t {
     lv_obj_t *label_percent;
     lv_obj_t *bar;
     lv_obj_t *label_total;
-    float last_used;
-    float last_total;
 };
 
 struct screen_network_t {
@@ -77,40 +89,142 @@ struct screen_network_t {
     lv_obj_t *label_down;
     lv_obj_t *label_up;
     int history_index;
-    float last_down;
-    float last_up;
-    char last_type[16];
-    char last_speed[16];
+    int32_t chart_max;          /* Y range top in 0.1 MB/s (follows link speed) */
+};
+
+/* Process list overlay (alternate view on the CPU display).
+ * Rows cache what they currently show so an update only touches the rows
+ * whose name or displayed value changed. */
+struct screen_proc_t {
+    lv_obj_t *overlay;
+    lv_obj_t *label_header;
+    lv_obj_t *label_name[PROC_TOP_COUNT];
+    lv_obj_t *label_value[PROC_TOP_COUNT];
+    uint32_t last_seq;
+    char last_name[PROC_TOP_COUNT][PROC_NAME_LEN];
+    int32_t last_cpu_tenths[PROC_TOP_COUNT];
+    int32_t last_mem_mb[PROC_TOP_COUNT];
+};
+
+/* Storage overlay (alternate view on the RAM display).
+ * Sparklines are circular charts with one column per stats packet (seq). */
+#define STORAGE_HISTORY_SIZE 60
+
+struct screen_storage_t {
+    lv_obj_t *overlay;
+    lv_obj_t *label_header;
+    lv_obj_t *label_read;
+    lv_obj_t *chart_read;
+    lv_chart_series_t *ser_read;
+    lv_obj_t *label_write;
+    lv_obj_t *chart_write;
+    lv_chart_series_t *ser_write;
+    lv_obj_t *label_iops;
+    lv_obj_t *label_queue;
+    uint32_t last_seq;
+    int32_t last_read_tenths;
+    int32_t last_write_tenths;
+    int32_t last_read_iops;
+    int32_t last_write_iops;
+    int32_t last_queue_tenths;
+    int32_t last_latency_tenths;
 };
 
 typedef struct screen_cpu_t screen_cpu_t;
 typedef struct screen_gpu_t screen_gpu_t;
 typedef struct screen_ram_t screen_ram_t;
 typedef struct screen_network_t screen_network_t;
+typedef struct screen_proc_t screen_proc_t;
+typedef struct screen_storage_t screen_storage_t;
+
+/* ============================================================================
+ * VALUE BANDS (warning / critical / N/A looks)
+ *
+ * The looks are shared styles bound to LVGL user states, added to a widget
+ * once at create time; the normal look is the widget's own default style.
+ * Updates switch the state only when a value enters another band, so a
+ * steady band costs no style write, style refresh or extra invalidation.
+ * ========================================================================== */
+#define SCREEN_STATE_WARN   LV_STATE_USER_1
+#define SCREEN_STATE_CRIT   LV_STATE_USER_2
+#define SCREEN_STATE_NA     LV_STATE_USER_3
+
+typedef enum {
+    SCREEN_BAND_NORMAL = 0,
+    SCREEN_BAND_WARN,
+    SCREEN_BAND_CRIT,
+    SCREEN_BAND_NA
+} screen_band_t;
+
+void screen_band_add_text_styles(lv_obj_t *label);     /* Text colour per band */
+void screen_band_add_bar_styles(lv_obj_t *bar);        /* Indicator colour per band */
+void screen_band_set(lv_obj_t *obj, screen_band_t band);
+uint32_t screen_band_color(screen_band_t band, uint32_t normal);   /* RRGGBB of a band */
+
+/* ============================================================================
+ * IMMEDIATE-MODE RING GAUGE (CPU/GPU, CONFIG_PCMON_IMMEDIATE_GAUGES)
+ *
+ * Alternative to the arc + label widgets: a single object whose draw
+ * callback paints ring and texts from the values set here. Setters skip
+ * unchanged values and invalidate hand-computed areas (changed arc span,
+ * old and new text box) instead of going through widget layout and styles.
+ * ========================================================================== */
+typedef enum {
+    SCREEN_GAUGE_TITLE = 0,     /* Model name (top) */
+    SCREEN_GAUGE_VALUE,         /* Load percentage (centre) */
+    SCREEN_GAUGE_DETAIL,        /* VRAM line (GPU only) */
+    SCREEN_GAUGE_TEMP,          /* Temperature (bottom) */
+    SCREEN_GAUGE_ARC,           /* Ring indicator - colour and opacity only */
+    SCREEN_GAUGE_PART_COUNT
+} screen_gauge_part_t;
+
+screen_gauge_t *screen_gauge_create(lv_obj_t *parent);
+void screen_gauge_set_arc(screen_gauge_t *gauge, int value);    /* 0-100 */
+void screen_gauge_set_text(screen_gauge_t *gauge, screen_gauge_part_t part,
+                           const char *text, screen_band_t band);
+void screen_gauge_set_color(screen_gauge_t *gauge, screen_gauge_part_t part, uint32_t rgb);
+void screen_gauge_set_arc_bg(screen_gauge_t *gauge, uint32_t rgb);
+void screen_gauge_set_opa(screen_gauge_t *gauge, screen_gauge_part_t part, lv_opa_t opa);
 
 /* ============================================================================
  * SCREEN 1: CPU GAUGE (Ring with percentage and temperature)
  * ========================================================================== */
 screen_cpu_t *screen_cpu_create(lv_display_t *disp);
-void screen_cpu_update(screen_cpu_t *screen, const pc_stats_t *stats);
+void screen_cpu_update(screen_cpu_t *screen, const pc_stats_t *stats, uint32_t dirty);
 
 /* ============================================================================
  * SCREEN 2: GPU GAUGE (Ring with percentage, temperature, VRAM)
  * ========================================================================== */
 screen_gpu_t *screen_gpu_create(lv_display_t *disp);
-void screen_gpu_update(screen_gpu_t *screen, const pc_stats_t *stats);
+void screen_gpu_update(screen_gpu_t *screen, const pc_stats_t *stats, uint32_t dirty);
 
 /* ============================================================================
  * SCREEN 3: RAM BAR (Horizontal bar with segments)
  * ========================================================================== */
 screen_ram_t *screen_ram_create(lv_display_t *disp);
-void screen_ram_update(screen_ram_t *screen, const pc_stats_t *stats);
+void screen_ram_update(screen_ram_t *screen, const pc_stats_t *stats, uint32_t dirty);
 
 /* ============================================================================
  * SCREEN 4: NETWORK GRAPH (Cyberpunk style with chart)
  * ========================================================================== */
 screen_network_t *screen_network_create(lv_display_t *disp);
-void screen_network_update(screen_network_t *screen, const pc_stats_t *stats);
+void screen_network_update(screen_network_t *screen, const pc_stats_t *stats, uint32_t dirty);
+void screen_network_load_history(screen_network_t *screen, const history_backfill_t *history);
+
+/* ============================================================================
+ * VIEW: PROCESS LIST (Top-N overlay, shown instead of the CPU gauge)
+ * ========================================================================== */
+screen_proc_t *screen_proc_create(lv_obj_t *parent);
+void screen_proc_update(screen_proc_t *screen, const proc_top_t *top);
+void screen_proc_show(screen_proc_t *screen, bool show);
+
+/* ============================================================================
+ * VIEW: STORAGE (Disk I/O overlay, shown instead of the RAM bar)
+ * ========================================================================== */
+screen_storage_t *screen_storage_create(lv_obj_t *parent);
+void screen_storage_update(screen_storage_t *screen, const pc_stats_t *stats);
+void screen_storage_show(screen_storage_t *screen, bool show);
+void screen_storage_load_history(screen_storage_t *screen, const history_backfill_t *history);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,305 @@
+/**
+ * @file profile_mgr.c
+ * @brief On-device theme profiles - store, list, activate
+ */
+
+#include "profile_mgr.h"
+#include "ui_manager.h"
+#include "screensaver_mgr.h"
+#include "../gui_settings.h"
+#include "../core/codec.h"
+#include "../drivers/usb_serial_comm.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "PROFILE";
+
+#define PROFILE_PATH            "/storage/profiles.bin"
+#define PROFILE_MAGIC           0x50524630      /* "PRF0" */
+#define PROFILE_VERSION         1               /* Bump on layout change */
+#define PROFILE_LOCK_MS         100
+
+typedef struct {
+    char name[PROFILE_NAME_MAX + 1];
+    uint8_t used;
+    uint8_t img_ref[SS_IMG_COUNT];          /* Library slot per display, PROFILE_IMG_NONE = icon */
+    gui_settings_t colors;
+} profile_slot_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    int8_t active;                          /* -1 = none */
+    uint8_t reserved;
+    profile_slot_t slot[PROFILE_SLOTS];
+    uint32_t crc;                           /* Of everything before */
+} profile_table_t;
+
+/* Owned by the USB RX task after init */
+static profile_table_t s_table;
+
+/* =============================================================================
+ * PERSISTENCE
+ * ========================================================================== */
+
+static uint32_t table_crc(const profile_table_t *t)
+{
+    return ~codec_crc32_update(CODEC_CRC32_INIT, (const uint8_t *)t, offsetof(profile_table_t, crc));
+}
+
+static bool save_table(void)
+{
+    s_table.magic = PROFILE_MAGIC;
+    s_table.version = PROFILE_VERSION;
+    s_table.crc = table_crc(&s_table);
+
+    FILE *f = fopen(PROFILE_PATH, "wb");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Failed to open profiles.bin for writing");
+        return false;
+    }
+    size_t written = fwrite(&s_table, 1, sizeof(s_table), f);
+    fclose(f);
+
+    if (written != sizeof(s_table)) {
+        ESP_LOGE(TAG, "Failed to write profiles.bin (%d of %d bytes)", (int)written, (int)sizeof(s_table));
+        return false;
+    }
+    return true;
+}
+
+static void reset_table(void)
+{
+    memset(&s_table, 0, sizeof(s_table));
+    s_table.active = -1;
+}
+
+void profile_mgr_init(void)
+{
+    reset_table();
+
+    FILE *f = fopen(PROFILE_PATH, "rb");
+    if (f == NULL) return;
+
+    profile_table_t t;
+    size_t read = fread(&t, 1, sizeof(t), f);
+    fclose(f);
+
+    if (read != sizeof(t) || t.magic != PROFILE_MAGIC || t.version != PROFILE_VERSION ||
+        t.crc != table_crc(&t)) {
+        ESP_LOGW(TAG, "profiles.bin invalid - no profiles");
+        return;
+    }
+
+    s_table = t;
+    for (int n = 0; n < PROFILE_SLOTS; n++) {
+        profile_slot_t *p = &s_table.slot[n];
+        p->name[PROFILE_NAME_MAX] = '\0';
+        /* Colours saved by an older gui_settings layout cannot be applied */
+        if (p->used && (p->colors.magic != GUI_SETTINGS_MAGIC || p->colors.version != GUI_SETTINGS_VERSION)) {
+            ESP_LOGW(TAG, "Profile %d has outdated colours - dropped", n);
+            p->used = 0;
+        }
+    }
+    if (s_table.active < 0 || s_table.active >= PROFILE_SLOTS || !s_table.slot[s_table.active].used) {
+        s_table.active = -1;
+    }
+
+    /* Colours of the active profile are already in gui_config.bin (incl. any
+     * SET_CLR_* since); only the display references live here */
+    if (s_table.active >= 0) {
+        ss_image_set_refs(s_table.slot[s_table.active].img_ref);
+        ESP_LOGI(TAG, "Active profile %d '%s'", s_table.active, s_table.slot[s_table.active].name);
+    }
+}
+
+int profile_mgr_active(void)
+{
+    return s_table.active;
+}
+
+/* =============================================================================
+ * COMMANDS
+ * ========================================================================== */
+
+static bool parse_slot(const char *s, int *n)
+{
+    return sscanf(s, "%d", n) == 1 && *n >= 0 && *n < PROFILE_SLOTS;
+}
+
+/* PROFILE_SAVE:<n>:<name> - snapshot of the live colours and display references */
+static void handle_save(const char *args)
+{
+    int n;
+    const char *name = strchr(args, ':');
+    if (name == NULL) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "PARSE\n");
+        return;
+    }
+    name++;
+    if (!parse_slot(args, &n)) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "SLOT\n");
+        return;
+    }
+    size_t len = strlen(name);
+    if (len == 0 || len > PROFILE_NAME_MAX || strchr(name, ':') != NULL) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "PARSE\n");
+        return;
+    }
+
+    profile_slot_t *p = &s_table.slot[n];
+    memset(p, 0, sizeof(*p));
+    memcpy(p->name, name, len);
+    p->used = 1;
+    p->colors = gui_settings;
+    p->colors.magic = GUI_SETTINGS_MAGIC;
+    p->colors.version = GUI_SETTINGS_VERSION;
+    for (int i = 0; i < SS_IMG_COUNT; i++) {
+        p->img_ref[i] = ss_image_get_ref((ss_image_slot_t)i);
+    }
+
+    if (!save_table()) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "SAVE\n");
+        return;
+    }
+    ESP_LOGI(TAG, "Saved profile %d '%s'", n, p->name);
+    usb_serial_sendf(PROTO_CMD_PROFILE_OK "SAVE:%d\n", n);
+}
+
+/* PROFILE_IMG:<n>:<display>:<ref> */
+static void handle_img(const char *args)
+{
+    int n, display, ref;
+    if (sscanf(args, "%d:%d:%d", &n, &display, &ref) != 3) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "PARSE\n");
+        return;
+    }
+    if (n < 0 || n >= PROFILE_SLOTS || display < 0 || display >= SS_IMG_COUNT ||
+        ref < -1 || ref >= SS_IMG_LIBRARY) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "SLOT\n");
+        return;
+    }
+
+    profile_slot_t *p = &s_table.slot[n];
+    if (!p->used) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "EMPTY\n");
+        return;
+    }
+
+    p->img_ref[display] = (ref < 0) ? PROFILE_IMG_NONE : (uint8_t)ref;
+    if (n == s_table.active) {
+        ss_image_set_refs(p->img_ref);
+    }
+
+    if (!save_table()) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "SAVE\n");
+        return;
+    }
+    usb_serial_sendf(PROTO_CMD_PROFILE_OK "IMG:%d\n", n);
+}
+
+/* PROFILE_ACTIVATE:<n> - colours in one theme pass, then the changed images */
+static void handle_activate(const char *args)
+{
+    int n;
+    if (!parse_slot(args, &n)) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "SLOT\n");
+        return;
+    }
+
+    profile_slot_t *p = &s_table.slot[n];
+    if (!p->used) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "EMPTY\n");
+        return;
+    }
+
+    int64_t start = esp_timer_get_time();
+
+    /* Swap under the LVGL lock: the UI task reads gui_settings while drawing */
+    if (!ui_acquire_lock(PROFILE_LOCK_MS)) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "BUSY\n");
+        return;
+    }
+    gui_settings = p->colors;
+    ui_manager_apply_theme();
+    ui_release_lock();
+
+    /* Images are swapped by the UI task on its next pass */
+    ss_image_set_refs(p->img_ref);
+
+    int64_t applied = esp_timer_get_time();
+
+    s_table.active = (int8_t)n;
+    gui_settings_save();
+    save_table();
+
+    ESP_LOGI(TAG, "Activated profile %d '%s': theme %d us, saved %d us", n, p->name,
+             (int)(applied - start), (int)(esp_timer_get_time() - applied));
+    usb_serial_sendf(PROTO_CMD_PROFILE_OK "ACTIVATE:%d\n", n);
+}
+
+static void handle_delete(const char *args)
+{
+    int n;
+    if (!parse_slot(args, &n)) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "SLOT\n");
+        return;
+    }
+
+    memset(&s_table.slot[n], 0, sizeof(s_table.slot[n]));
+    if (s_table.active == n) {
+        s_table.active = -1;            /* Colours and images stay as they are */
+    }
+
+    if (!save_table()) {
+        usb_serial_sendf(PROTO_CMD_PROFILE_ERR "SAVE\n");
+        return;
+    }
+    usb_serial_sendf(PROTO_CMD_PROFILE_OK "DELETE:%d\n", n);
+}
+
+/* PROFILE:<n>:<name>:<ref>,<ref>,<ref>,<ref> per used slot, then PROFILE_END:<active> */
+static void send_list(void)
+{
+    for (int n = 0; n < PROFILE_SLOTS; n++) {
+        const profile_slot_t *p = &s_table.slot[n];
+        if (!p->used) continue;
+
+        char refs[SS_IMG_COUNT * 4 + 1];
+        int len = 0;
+        for (int i = 0; i < SS_IMG_COUNT; i++) {
+            int ref = (p->img_ref[i] == PROFILE_IMG_NONE) ? -1 : p->img_ref[i];
+            len += snprintf(refs + len, sizeof(refs) - len, i > 0 ? ",%d" : "%d", ref);
+        }
+        usb_serial_sendf(PROTO_CMD_PROFILE "%d:%s:%s\n", n, p->name, refs);
+    }
+    usb_serial_sendf(PROTO_CMD_PROFILE_END "%d\n", s_table.active);
+}
+
+bool profile_mgr_handle_command(const char *line)
+{
+    if (strcmp(line, PROTO_CMD_PROFILE_LIST) == 0) {
+        send_list();
+        return true;
+    }
+    if (strncmp(line, PROTO_CMD_PROFILE_SAVE, strlen(PROTO_CMD_PROFILE_SAVE)) == 0) {
+        handle_save(line + strlen(PROTO_CMD_PROFILE_SAVE));
+        return true;
+    }
+    if (strncmp(line, PROTO_CMD_PROFILE_IMG, strlen(PROTO_CMD_PROFILE_IMG)) == 0) {
+        handle_img(line + strlen(PROTO_CMD_PROFILE_IMG));
+        return true;
+    }
+    if (strncmp(line, PROTO_CMD_PROFILE_ACTIVATE, strlen(PROTO_CMD_PROFILE_ACTIVATE)) == 0) {
+        handle_activate(line + strlen(PROTO_CMD_PROFILE_ACTIVATE));
+        return true;
+    }
+    if (strncmp(line, PROTO_CMD_PROFILE_DELETE, strlen(PROTO_CMD_PROFILE_DELETE)) == 0) {
+        handle_delete(line + strlen(PROTO_CMD_PROFILE_DELETE));
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file profile_mgr.h
+ * @brief On-device theme profiles - colour set + image references in flash
+ *
+ * Up to PROFILE_SLOTS complete profiles live in /storage/profiles.bin: the
+ * whole gui_settings_t plus, per display, the image library slot it shows
+ * (screensaver_mgr). PROFILE_ACTIVATE:<n> copies the slot's colours into
+ * gui_settings, applies the theme once and repoints the displays; only
+ * images whose reference changed are read from flash again. Nothing is
+ * re-sent over USB. Wire format: scarab_protocol.def.
+ */
+
+#ifndef PROFILE_MGR_H
+#define PROFILE_MGR_H
+
+#include <stdbool.h>
+#include "protocol_gen.h"
+
+/**
+ * @brief Load the stored profiles and point the displays at the active
+ *        profile's images
+ *
+ * Call once at boot after gui_settings_load() and before ss_images_init().
+ */
+void profile_mgr_init(void);
+
+/**
+ * @brief Last activated profile slot, -1 if none
+ */
+int profile_mgr_active(void);
+
+/**
+ * @brief Handle PROFILE_* commands
+ * @param line Command line
+ * @return true if command was handled
+ */
+bool profile_mgr_handle_command(const char *line);
+
+#endif /* PROFILE_MGR_H */
@@ -11,12 +11,15 @@
 #include <inttypes.h>
 #include "esp_log.h"
 #include "esp_heap_caps.h"
-#include "driver/usb_serial_jtag.h"
+#include "../drivers/usb_serial_comm.h"
+#include "../core/codec.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 static const char *TAG = "SS-MGR";
 
+#define SS_DMA_ALIGN    64      /* PSRAM cache line - panel DMA without bounce buffer */
+
 /* =============================================================================
  * EXTERN: Compiled system icons (Desert-Spec v2.2)
  * ========================================================================== */
@@ -33,7 +36,7 @@ static const lv_image_dsc_t *fallback_images[SS_IMG_COUNT] = {
     &NET    /* SS_IMG_NET = 3 */
 };
 
-/* LittleFS paths table */
+/* LittleFS paths of library slots 0-3 (the pre-profile per-display files) */
 static const char *image_paths[SS_IMG_COUNT] = {
     SS_IMG_PATH_CPU,
     SS_IMG_PATH_GPU,
@@ -41,6 +44,9 @@ static const char *image_paths[SS_IMG_COUNT] = {
     SS_IMG_PATH_NET
 };
 
+/* Library slot shown per display (written by the USB task, read by the UI task) */
+static volatile uint8_t s_screen_ref[SS_IMG_COUNT] = { 0, 1, 2, 3 };
+
 /* =============================================================================
  * INTERNAL STRUCTURES
  * ========================================================================== */
@@ -50,6 +56,7 @@ typedef struct {
     scarab_img_header_t header;
     uint8_t *data;
     lv_image_dsc_t lvgl_dsc;
+    bool panel_order;               /* Pixels byte-swapped for the panel (LVGL must not draw) */
 } ss_loaded_image_t;
 
 typedef enum {
@@ -61,7 +68,7 @@ typedef enum {
 
 typedef struct {
     img_upload_state_t state;
-    ss_image_slot_t slot;
+    uint8_t slot;                   /* Library slot */
     uint32_t expected_size;
     uint32_t received_size;
     uint8_t *buffer;
@@ -72,56 +79,112 @@ typedef struct {
 static ss_loaded_image_t loaded_images[SS_IMG_COUNT] = {0};
 static img_upload_ctx_t upload_ctx = {0};
 
-/* Thread-safe reload/delete flags (set by USB task, processed by UI task) */
+/* Thread-safe reload/delete flags (set by USB task, processed by UI task).
+ * Reloads are per display, deletes per library slot. */
 static volatile bool s_reload_pending[SS_IMG_COUNT] = {0};
-static volatile bool s_delete_pending[SS_IMG_COUNT] = {0};
+static volatile bool s_delete_pending[SS_IMG_LIBRARY] = {0};
 
 /* Callback for UI notification when image is reloaded */
 static ss_image_reload_cb_t s_reload_callback = NULL;
+static ss_image_unload_cb_t s_unload_callback = NULL;
 
 /* =============================================================================
- * CRC32 CALCULATION (Incremental-safe)
- *
- * Usage for incremental CRC:
- *   uint32_t crc = CRC32_INIT;
- *   crc = crc32_update(crc, chunk1, len1);
- *   crc = crc32_update(crc, chunk2, len2);
- *   final_crc = crc32_finalize(crc);
+ * HELPER: Send response via USB Serial
  * ========================================================================== */
-#define CRC32_INIT 0xFFFFFFFF
+static void send_response(const char *fmt, ...)
+{
+    char buf[128];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (len > 0) {
+        usb_serial_send(buf);
+    }
+}
 
-static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+/* =============================================================================
+ * LIBRARY PATHS
+ * ========================================================================== */
+static void image_path(uint8_t lib_slot, char *buf, size_t len)
 {
-    /* NOTE: crc must be initialized with CRC32_INIT (0xFFFFFFFF) for first call.
-     * This function does NOT invert input/output - caller handles that. */
-    while (len--) {
-        crc ^= *data++;
-        for (int i = 0; i < 8; i++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & ~((crc & 1) - 1));
-        }
+    if (lib_slot < SS_IMG_COUNT) {
+        snprintf(buf, len, "%s", image_paths[lib_slot]);
+    } else {
+        snprintf(buf, len, SS_IMG_PATH_LIB, (unsigned)lib_slot);
     }
-    return crc;
 }
 
-static uint32_t crc32_finalize(uint32_t crc)
+/* Marks every display showing lib_slot for reload */
+static void mark_reload(uint8_t lib_slot)
 {
-    return ~crc;
+    for (int i = 0; i < SS_IMG_COUNT; i++) {
+        if (s_screen_ref[i] == lib_slot) {
+            s_reload_pending[i] = true;
+        }
+    }
 }
 
 /* =============================================================================
- * HELPER: Send response via USB Serial
+ * HEADER VALIDATION
+ *
+ * Version 1: 16-byte header, 240x240, centered.
+ * Version 2: 20-byte header, 1..240 x 1..240, align + offset.
+ * Returns the header size on disk, or 0 if the header is invalid.
  * ========================================================================== */
-static void send_response(const char *fmt, ...)
+static uint32_t img_header_size(const scarab_img_header_t *h)
 {
-    char buf[128];
-    va_list args;
-    va_start(args, fmt);
-    int len = vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
+    return (h->version >= 2) ? SCARAB_IMG_HEADER_SIZE : SCARAB_IMG_HEADER_V1_SIZE;
+}
 
-    if (len > 0) {
-        usb_serial_jtag_write_bytes((const uint8_t *)buf, len, pdMS_TO_TICKS(100));
+static uint32_t validate_header(const scarab_img_header_t *h, const char *what)
+{
+    if (h->magic != SCARAB_IMG_MAGIC) {
+        ESP_LOGE(TAG, "Invalid magic in %s: 0x%08" PRIX32, what, h->magic);
+        return 0;
+    }
+
+    if (h->version == 0 || h->version > SCARAB_IMG_VERSION) {
+        ESP_LOGE(TAG, "Unsupported header version in %s: %d", what, h->version);
+        return 0;
+    }
+
+    bool size_ok = (h->version == 1)
+        ? (h->width == SCARAB_IMG_WIDTH && h->height == SCARAB_IMG_HEIGHT)
+        : (h->width >= 1 && h->width <= SCARAB_IMG_WIDTH &&
+           h->height >= 1 && h->height <= SCARAB_IMG_HEIGHT);
+    if (!size_ok) {
+        ESP_LOGE(TAG, "Invalid dimensions in %s: %dx%d", what, h->width, h->height);
+        return 0;
+    }
+
+    if (h->format != SCARAB_FMT_RGB565 && h->format != SCARAB_FMT_RGB565A8) {
+        ESP_LOGE(TAG, "Invalid format in %s: %d", what, h->format);
+        return 0;
     }
+
+    uint32_t bpp = (h->format == SCARAB_FMT_RGB565A8) ? 3 : 2;
+    if (h->data_size != (uint32_t)h->width * h->height * bpp) {
+        ESP_LOGE(TAG, "Data size mismatch in %s: %" PRIu32 " for %dx%d",
+                 what, h->data_size, h->width, h->height);
+        return 0;
+    }
+
+    if (h->version >= 2 && h->align > SCARAB_ALIGN_BOTTOM_RIGHT) {
+        ESP_LOGE(TAG, "Invalid alignment in %s: %d", what, h->align);
+        return 0;
+    }
+
+    return img_header_size(h);
+}
+
+/* Opaque and covering the whole overlay: can go to the panel as it is */
+static bool is_fullscreen(const scarab_img_header_t *h)
+{
+    return h->format == SCARAB_FMT_RGB565 &&
+           h->width == SCARAB_IMG_WIDTH && h->height == SCARAB_IMG_HEIGHT &&
+           h->offset_x == 0 && h->offset_y == 0;
 }
 
 /* =============================================================================
@@ -134,6 +197,11 @@ void ss_images_init(void)
     memset(loaded_images, 0, sizeof(loaded_images));
     memset(&upload_ctx, 0, sizeof(upload_ctx));
 
+    /* References set by profile_mgr_init() are loaded right here */
+    for (int i = 0; i < SS_IMG_COUNT; i++) {
+        s_reload_pending[i] = false;
+    }
+
     size_t psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
     ESP_LOGI(TAG, "PSRAM free: %lu KB", (unsigned long)(psram_free / 1024));
 
@@ -155,39 +223,50 @@ bool ss_image_load(ss_image_slot_t slot)
 
     ss_image_unload(slot);
 
-    const char *path = image_paths[slot];
+    uint8_t ref = s_screen_ref[slot];
+    if (ref >= SS_IMG_LIBRARY) {
+        ESP_LOGD(TAG, "Slot %d shows the compiled icon", slot);
+        return false;
+    }
+
+    char path[32];
+    image_path(ref, path, sizeof(path));
     FILE *f = fopen(path, "rb");
     if (!f) {
         ESP_LOGD(TAG, "No custom image at %s", path);
         return false;
     }
 
-    scarab_img_header_t header;
-    if (fread(&header, 1, sizeof(header), f) != sizeof(header)) {
+    /* Read the v1 part first; v2 placement fields follow only if version >= 2 */
+    scarab_img_header_t header = {0};
+    if (fread(&header, 1, SCARAB_IMG_HEADER_V1_SIZE, f) != SCARAB_IMG_HEADER_V1_SIZE) {
         ESP_LOGE(TAG, "Failed to read header from %s", path);
         fclose(f);
         return false;
     }
 
-    if (header.magic != SCARAB_IMG_MAGIC) {
-        ESP_LOGE(TAG, "Invalid magic in %s: 0x%08" PRIX32, path, header.magic);
+    uint32_t hdr_size = img_header_size(&header);
+    if (hdr_size > SCARAB_IMG_HEADER_V1_SIZE &&
+        fread((uint8_t *)&header + SCARAB_IMG_HEADER_V1_SIZE, 1,
+              hdr_size - SCARAB_IMG_HEADER_V1_SIZE, f) != hdr_size - SCARAB_IMG_HEADER_V1_SIZE) {
+        ESP_LOGE(TAG, "Failed to read v%d header from %s", header.version, path);
         fclose(f);
         return false;
     }
 
-    if (header.width != SCARAB_IMG_WIDTH || header.height != SCARAB_IMG_HEIGHT) {
-        ESP_LOGE(TAG, "Invalid dimensions in %s: %dx%d", path, header.width, header.height);
-        fclose(f);
-        return false;
+    if (header.version < 2) {
+        header.align = SCARAB_ALIGN_CENTER;
+        header.offset_x = 0;
+        header.offset_y = 0;
     }
 
-    if (header.format != SCARAB_FMT_RGB565 && header.format != SCARAB_FMT_RGB565A8) {
-        ESP_LOGE(TAG, "Invalid format in %s: %d", path, header.format);
+    if (validate_header(&header, path) == 0) {
         fclose(f);
         return false;
     }
 
-    uint8_t *data = heap_caps_malloc(header.data_size, MALLOC_CAP_SPIRAM);
+    /* Cache-line aligned: a full-screen frame is DMAed from here */
+    uint8_t *data = heap_caps_aligned_alloc(SS_DMA_ALIGN, header.data_size, MALLOC_CAP_SPIRAM);
     if (!data) {
         ESP_LOGE(TAG, "Failed to allocate %" PRIu32 " bytes PSRAM for %s", header.data_size, path);
         fclose(f);
@@ -221,8 +300,16 @@ bool ss_image_load(ss_image_slot_t slot)
     img->lvgl_dsc.data = data;
     img->lvgl_dsc.data_size = header.data_size;
 
-    ESP_LOGI(TAG, "Loaded %s: %dx%d, format=%d, size=%" PRIu32,
-             path, header.width, header.height, header.format, header.data_size);
+    ESP_LOGI(TAG, "Loaded %s: %dx%d @ align %d %+d/%+d, format=%d, size=%" PRIu32,
+             path, header.width, header.height, header.align,
+             header.offset_x, header.offset_y, header.format, header.data_size);
+
+    /* A full-screen frame is only ever shown by direct blit while the
+     * overlay is visible - swap it for the panel once, here */
+    if (is_fullscreen(&header)) {
+        lv_draw_sw_rgb565_swap(data, header.width * header.height);
+        img->panel_order = true;
+    }
 
     return true;
 }
@@ -241,6 +328,26 @@ const lv_image_dsc_t *ss_image_get_dsc(ss_image_slot_t slot)
     return fallback_images[slot];
 }
 
+/* =============================================================================
+ * GET IMAGE PLACEMENT
+ * ========================================================================== */
+void ss_image_get_placement(ss_image_slot_t slot, scarab_img_align_t *align,
+                            int16_t *x_ofs, int16_t *y_ofs)
+{
+    scarab_img_align_t a = SCARAB_ALIGN_CENTER;
+    int16_t x = 0, y = 0;
+
+    if (slot < SS_IMG_COUNT && loaded_images[slot].loaded) {
+        a = (scarab_img_align_t)loaded_images[slot].header.align;
+        x = loaded_images[slot].header.offset_x;
+        y = loaded_images[slot].header.offset_y;
+    }
+
+    if (align) *align = a;
+    if (x_ofs) *x_ofs = x;
+    if (y_ofs) *y_ofs = y;
+}
+
 /* =============================================================================
  * CHECK IF CUSTOM IMAGE
  * ========================================================================== */
@@ -250,6 +357,27 @@ bool ss_image_is_custom(ss_image_slot_t slot)
     return loaded_images[slot].loaded;
 }
 
+/* =============================================================================
+ * FULL-SCREEN OPAQUE IMAGE
+ * ========================================================================== */
+const uint16_t *ss_image_get_fullscreen(ss_image_slot_t slot)
+{
+    if (slot >= SS_IMG_COUNT || !loaded_images[slot].loaded || !loaded_images[slot].panel_order) {
+        return NULL;
+    }
+    return (const uint16_t *)loaded_images[slot].data;
+}
+
+void ss_image_release_fullscreen(ss_image_slot_t slot)
+{
+    if (slot >= SS_IMG_COUNT || !loaded_images[slot].panel_order) return;
+
+    ss_loaded_image_t *img = &loaded_images[slot];
+    lv_draw_sw_rgb565_swap(img->data, img->header.width * img->header.height);
+    img->panel_order = false;
+    ESP_LOGI(TAG, "Slot %d handed back to LVGL", slot);
+}
+
 /* =============================================================================
  * UNLOAD IMAGE FROM PSRAM
  * ========================================================================== */
@@ -258,10 +386,14 @@ void ss_image_unload(ss_image_slot_t slot)
     if (slot >= SS_IMG_COUNT) return;
 
     ss_loaded_image_t *img = &loaded_images[slot];
+    if (img->panel_order && s_unload_callback) {
+        s_unload_callback(slot);        /* Off the panel's DMA before the free */
+    }
     if (img->data) {
         heap_caps_free(img->data);
         img->data = NULL;
     }
+    img->panel_order = false;
     img->loaded = false;
     memset(&img->header, 0, sizeof(img->header));
     memset(&img->lvgl_dsc, 0, sizeof(img->lvgl_dsc));
@@ -270,19 +402,24 @@ void ss_image_unload(ss_image_slot_t slot)
 /* =============================================================================
  * SAVE IMAGE TO LITTLEFS
  * ========================================================================== */
-bool ss_image_save(ss_image_slot_t slot, const uint8_t *data, uint32_t size)
+bool ss_image_save(uint8_t lib_slot, const uint8_t *data, uint32_t size)
 {
-    if (slot >= SS_IMG_COUNT || !data || size < SCARAB_IMG_HEADER_SIZE) {
+    if (lib_slot >= SS_IMG_LIBRARY || !data || size < SCARAB_IMG_HEADER_V1_SIZE) {
         return false;
     }
 
-    const scarab_img_header_t *header = (const scarab_img_header_t *)data;
-    if (header->magic != SCARAB_IMG_MAGIC) {
-        ESP_LOGE(TAG, "Invalid magic in upload data");
+    /* Validate a copy: a v1 upload is only 16 bytes of header, and the
+     * buffer may not be aligned for direct struct access */
+    scarab_img_header_t header = {0};
+    memcpy(&header, data, (size < SCARAB_IMG_HEADER_SIZE) ? size : SCARAB_IMG_HEADER_SIZE);
+    uint32_t hdr_size = validate_header(&header, "upload data");
+    if (hdr_size == 0 || size != hdr_size + header.data_size) {
+        ESP_LOGE(TAG, "Rejected upload (%" PRIu32 " bytes)", size);
         return false;
     }
 
-    const char *path = image_paths[slot];
+    char path[32];
+    image_path(lib_slot, path, sizeof(path));
     FILE *f = fopen(path, "wb");
     if (!f) {
         ESP_LOGE(TAG, "Failed to open %s for writing", path);
@@ -304,13 +441,12 @@ bool ss_image_save(ss_image_slot_t slot, const uint8_t *data, uint32_t size)
 /* =============================================================================
  * DELETE IMAGE FROM LITTLEFS
  * ========================================================================== */
-bool ss_image_delete(ss_image_slot_t slot)
+bool ss_image_delete(uint8_t lib_slot)
 {
-    if (slot >= SS_IMG_COUNT) return false;
-
-    ss_image_unload(slot);
+    if (lib_slot >= SS_IMG_LIBRARY) return false;
 
-    const char *path = image_paths[slot];
+    char path[32];
+    image_path(lib_slot, path, sizeof(path));
     if (remove(path) == 0) {
         ESP_LOGI(TAG, "Deleted %s", path);
         return true;
@@ -320,6 +456,26 @@ bool ss_image_delete(ss_image_slot_t slot)
     return true;
 }
 
+/* =============================================================================
+ * DISPLAY -> LIBRARY REFERENCES
+ * ========================================================================== */
+uint8_t ss_image_get_ref(ss_image_slot_t slot)
+{
+    return (slot < SS_IMG_COUNT) ? s_screen_ref[slot] : PROFILE_IMG_NONE;
+}
+
+void ss_image_set_refs(const uint8_t refs[SS_IMG_COUNT])
+{
+    for (int i = 0; i < SS_IMG_COUNT; i++) {
+        uint8_t ref = (refs[i] < SS_IMG_LIBRARY) ? refs[i] : PROFILE_IMG_NONE;
+        if (ref != s_screen_ref[i]) {
+            /* Reference first: the UI task loads whatever it names once the flag is seen */
+            s_screen_ref[i] = ref;
+            s_reload_pending[i] = true;
+        }
+    }
+}
+
 /* =============================================================================
  * UPLOAD PROTOCOL HANDLERS
  * ========================================================================== */
@@ -334,12 +490,12 @@ static bool handle_img_begin(const char *line)
         return true;
     }
 
-    if (slot < 0 || slot >= SS_IMG_COUNT) {
+    if (slot < 0 || slot >= SS_IMG_LIBRARY) {
         send_response("IMG_ERR:SLOT\n");
         return true;
     }
 
-    if (size < SCARAB_IMG_HEADER_SIZE || size > SCARAB_IMG_MAX_SIZE) {
+    if (size < SCARAB_IMG_HEADER_V1_SIZE || size > SCARAB_IMG_MAX_SIZE) {
         send_response("IMG_ERR:SIZE\n");
         return true;
     }
@@ -355,10 +511,10 @@ static bool handle_img_begin(const char *line)
     }
 
     upload_ctx.state = IMG_UPLOAD_RECEIVING;
-    upload_ctx.slot = (ss_image_slot_t)slot;
+    upload_ctx.slot = (uint8_t)slot;
     upload_ctx.expected_size = (uint32_t)size;
     upload_ctx.received_size = 0;
-    upload_ctx.crc32 = CRC32_INIT;  /* Must start with 0xFFFFFFFF for incremental CRC */
+    upload_ctx.crc32 = CODEC_CRC32_INIT;  /* Must start with 0xFFFFFFFF for incremental CRC */
 
     ESP_LOGI(TAG, "Upload started: slot=%d, size=%lu", slot, size);
     send_response("IMG_OK:BEGIN\n");
@@ -391,25 +547,32 @@ static bool handle_img_data(const char *line)
         return true;
     }
 
-    size_t hex_len = strlen(hex_start);
-    if (hex_len % 2 != 0) {
-        send_response("IMG_ERR:HEXLEN\n");
+    /* Decode and verify before touching the image buffer. A chunk with a CRC
+     * that fails either way was damaged on the wire: NAK it so the client
+     * resends just this chunk at the same offset. */
+    static uint8_t chunk_buf[USB_MAX_CHUNK_BYTES];
+    bool has_crc;
+    int decoded = codec_chunk_decode(hex_start, chunk_buf, sizeof(chunk_buf), &has_crc);
+    if (decoded <= 0) {
+        if (has_crc) {
+            ESP_LOGW(TAG, "Chunk at %" PRIu32 " damaged - NAK", upload_ctx.received_size);
+            send_response("IMG_NAK:%" PRIu32 "\n", upload_ctx.received_size);
+        } else {
+            send_response("IMG_ERR:HEXLEN\n");
+        }
         return true;
     }
 
-    size_t data_len = hex_len / 2;
+    size_t data_len = (size_t)decoded;
     if (upload_ctx.received_size + data_len > upload_ctx.expected_size) {
         send_response("IMG_ERR:OVERFLOW\n");
         return true;
     }
 
     uint8_t *dest = upload_ctx.buffer + upload_ctx.received_size;
-    for (size_t i = 0; i < data_len; i++) {
-        char byte_str[3] = { hex_start[i*2], hex_start[i*2+1], 0 };
-        dest[i] = (uint8_t)strtoul(byte_str, NULL, 16);
-    }
+    memcpy(dest, chunk_buf, data_len);
 
-    upload_ctx.crc32 = crc32_update(upload_ctx.crc32, dest, data_len);
+    upload_ctx.crc32 = codec_crc32_update(upload_ctx.crc32, dest, data_len);
     upload_ctx.received_size += (uint32_t)data_len;
 
     if (upload_ctx.received_size % 10240 < data_len) {
@@ -440,7 +603,7 @@ static bool handle_img_end(const char *line)
     }
 
     /* Finalize CRC (apply final XOR) */
-    uint32_t final_crc = crc32_finalize(upload_ctx.crc32);
+    uint32_t final_crc = ~upload_ctx.crc32;
 
     if (final_crc != (uint32_t)expected_crc) {
         ESP_LOGE(TAG, "CRC mismatch: got 0x%08" PRIX32 ", expected 0x%08X",
@@ -453,8 +616,11 @@ static bool handle_img_end(const char *line)
         return true;
     }
 
-    const scarab_img_header_t *header = (const scarab_img_header_t *)upload_ctx.buffer;
-    if (header->magic != SCARAB_IMG_MAGIC) {
+    scarab_img_header_t header = {0};
+    memcpy(&header, upload_ctx.buffer,
+           (upload_ctx.received_size < SCARAB_IMG_HEADER_SIZE) ? upload_ctx.received_size
+                                                               : SCARAB_IMG_HEADER_SIZE);
+    if (header.magic != SCARAB_IMG_MAGIC) {
         send_response("IMG_ERR:MAGIC\n");
         heap_caps_free(upload_ctx.buffer);
         upload_ctx.buffer = NULL;
@@ -462,6 +628,15 @@ static bool handle_img_end(const char *line)
         return true;
     }
 
+    uint32_t hdr_size = validate_header(&header, "upload");
+    if (hdr_size == 0 || upload_ctx.received_size != hdr_size + header.data_size) {
+        send_response("IMG_ERR:HEADER\n");
+        heap_caps_free(upload_ctx.buffer);
+        upload_ctx.buffer = NULL;
+        upload_ctx.state = IMG_UPLOAD_IDLE;
+        return true;
+    }
+
     if (!ss_image_save(upload_ctx.slot, upload_ctx.buffer, upload_ctx.received_size)) {
         send_response("IMG_ERR:SAVE\n");
         heap_caps_free(upload_ctx.buffer);
@@ -478,7 +653,7 @@ static bool handle_img_end(const char *line)
      * DO NOT call ss_image_load() here - it would cause race condition
      * with LVGL rendering! The UI thread will process this flag. */
     ESP_LOGI(TAG, "Upload complete, marking slot %d for reload", upload_ctx.slot);
-    s_reload_pending[upload_ctx.slot] = true;
+    mark_reload(upload_ctx.slot);
     send_response("IMG_OK:COMPLETE:%d\n", upload_ctx.slot);
 
     upload_ctx.state = IMG_UPLOAD_IDLE;
@@ -507,7 +682,7 @@ static bool handle_img_delete(const char *line)
         return true;
     }
 
-    if (slot < 0 || slot >= SS_IMG_COUNT) {
+    if (slot < 0 || slot >= SS_IMG_LIBRARY) {
         send_response("IMG_ERR:SLOT\n");
         return true;
     }
@@ -538,6 +713,11 @@ static bool handle_img_status(void)
     return true;
 }
 
+bool ss_image_upload_active(void)
+{
+    return upload_ctx.state == IMG_UPLOAD_RECEIVING;
+}
+
 /* =============================================================================
  * MAIN COMMAND DISPATCHER
  * ========================================================================== */
@@ -583,26 +763,40 @@ void ss_set_reload_callback(ss_image_reload_cb_t callback)
     s_reload_callback = callback;
 }
 
+void ss_set_unload_callback(ss_image_unload_cb_t callback)
+{
+    s_unload_callback = callback;
+}
+
 void ss_process_updates(void)
 {
-    for (int i = 0; i < SS_IMG_COUNT; i++) {
-        /* Process delete requests first (takes priority over reload) */
-        if (s_delete_pending[i]) {
-            /* Clear flag first (atomic on ESP32) */
-            s_delete_pending[i] = false;
-            s_reload_pending[i] = false;  /* Cancel any pending reload */
+    /* Process delete requests first (takes priority over reload) */
+    for (int lib = 0; lib < SS_IMG_LIBRARY; lib++) {
+        if (!s_delete_pending[lib]) continue;
 
-            /* Now safely delete the image (we're in the UI thread) */
-            ss_image_delete((ss_image_slot_t)i);
-            ESP_LOGI(TAG, "Slot %d deleted in UI thread", i);
+        /* Clear flag first (atomic on ESP32) */
+        s_delete_pending[lib] = false;
+
+        /* Now safely delete the image (we're in the UI thread) */
+        ss_image_delete((uint8_t)lib);
+        ESP_LOGI(TAG, "Slot %d deleted in UI thread", lib);
+
+        for (int i = 0; i < SS_IMG_COUNT; i++) {
+            if (s_screen_ref[i] != lib) continue;
+
+            s_reload_pending[i] = false;  /* Cancel any pending reload */
+            ss_image_unload((ss_image_slot_t)i);
 
             /* Notify UI to refresh (will get fallback image) */
             if (s_reload_callback) {
                 s_reload_callback((ss_image_slot_t)i, ss_image_get_dsc((ss_image_slot_t)i));
             }
         }
+    }
+
+    for (int i = 0; i < SS_IMG_COUNT; i++) {
         /* Process reload requests */
-        else if (s_reload_pending[i]) {
+        if (s_reload_pending[i]) {
             /* Clear flag first (atomic on ESP32) */
             s_reload_pending[i] = false;
 
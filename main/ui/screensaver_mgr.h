@@ -11,32 +11,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "lvgl.h"
+#include "protocol_gen.h"
 
 /* =============================================================================
  * IMAGE FORMAT DEFINITIONS
  * ========================================================================== */
 
-#define SCARAB_IMG_MAGIC        0x53434152  /* "SCAR" in little-endian */
-#define SCARAB_IMG_VERSION      1
+/* SCARAB_IMG_MAGIC/VERSION, scarab_img_format_t and scarab_img_header_t
+ * are generated from protocol/scarab_protocol.def (shared with the client) */
 
-/* Image format types */
-typedef enum {
-    SCARAB_FMT_RGB565   = 0,    /* 16-bit color, no alpha (2 bytes/pixel) */
-    SCARAB_FMT_RGB565A8 = 1,    /* 16-bit color + 8-bit alpha (3 bytes/pixel) */
-} scarab_img_format_t;
-
-/* Image file header (16 bytes, aligned) */
-typedef struct __attribute__((packed)) {
-    uint32_t magic;             /* Must be SCARAB_IMG_MAGIC */
-    uint16_t width;             /* Image width (typically 240) */
-    uint16_t height;            /* Image height (typically 240) */
-    uint8_t  format;            /* scarab_img_format_t */
-    uint8_t  version;           /* Header version */
-    uint16_t reserved;          /* Padding for alignment */
-    uint32_t data_size;         /* Size of pixel data in bytes */
-} scarab_img_header_t;
-
-/* Size calculations for 240x240 images */
+/* Maximum image size (= display). Version 2 images may be smaller and are
+ * placed by align + offset; version 1 images are always 240x240. */
 #define SCARAB_IMG_WIDTH        240
 #define SCARAB_IMG_HEIGHT       240
 #define SCARAB_IMG_PIXELS       (SCARAB_IMG_WIDTH * SCARAB_IMG_HEIGHT)
@@ -65,6 +50,13 @@ typedef enum {
 #define SS_IMG_PATH_RAM     "/storage/ss_ram.bin"
 #define SS_IMG_PATH_NET     "/storage/ss_net.bin"
 
+/* Image library: IMG_BEGIN slots 0..SS_IMG_LIBRARY-1 (protocol_gen.h).
+ * Slots 0-3 keep the paths above, so images uploaded before profiles stay
+ * where they are; the others are numbered files. Each display shows the
+ * library slot its reference names - by default its own index, profiles
+ * (profile_mgr) point them elsewhere. PROFILE_IMG_NONE = compiled icon. */
+#define SS_IMG_PATH_LIB     "/storage/ss_lib%02u.bin"
+
 /* =============================================================================
  * FUNCTION PROTOTYPES
  * ========================================================================== */
@@ -88,11 +80,45 @@ bool ss_image_load(ss_image_slot_t slot);
  */
 const lv_image_dsc_t *ss_image_get_dsc(ss_image_slot_t slot);
 
+/**
+ * @brief Get where the slot's image is drawn on the overlay
+ *
+ * Compiled fallbacks and version 1 images are centered.
+ * @param slot Image slot
+ * @param align Output: alignment on the 240x240 overlay
+ * @param x_ofs Output: horizontal shift from the aligned position
+ * @param y_ofs Output: vertical shift from the aligned position
+ */
+void ss_image_get_placement(ss_image_slot_t slot, scarab_img_align_t *align,
+                            int16_t *x_ofs, int16_t *y_ofs);
+
 /**
  * @brief Check if custom image is loaded for slot
  */
 bool ss_image_is_custom(ss_image_slot_t slot);
 
+/**
+ * @brief Pixels of a custom image that covers the whole overlay opaquely
+ *
+ * RGB565 (no alpha), 240x240, no offset. Such an image is byte-swapped for
+ * the panel when it is loaded and shown by direct blit (lvgl_gc9a01_blit)
+ * instead of through LVGL - LVGL must not draw the slot while it is in
+ * panel order. Valid until the slot is unloaded; the unload callback runs
+ * first so the DMA can be stopped.
+ * @param slot Image slot
+ * @return Pixel data in panel byte order, NULL if not applicable
+ */
+const uint16_t *ss_image_get_fullscreen(ss_image_slot_t slot);
+
+/**
+ * @brief Swap a full-screen image back to LVGL byte order
+ *
+ * For when the direct blit is not available - stop it first. LVGL then
+ * draws the slot as usual until it is reloaded. No-op otherwise.
+ * @param slot Image slot
+ */
+void ss_image_release_fullscreen(ss_image_slot_t slot);
+
 /**
  * @brief Free loaded image from PSRAM
  */
@@ -100,13 +126,31 @@ void ss_image_unload(ss_image_slot_t slot);
 
 /**
  * @brief Save image data to LittleFS
+ * @param lib_slot Image library slot (0..SS_IMG_LIBRARY-1)
  */
-bool ss_image_save(ss_image_slot_t slot, const uint8_t *data, uint32_t size);
+bool ss_image_save(uint8_t lib_slot, const uint8_t *data, uint32_t size);
 
 /**
- * @brief Delete custom image from LittleFS
+ * @brief Delete a library image from LittleFS
+ *
+ * Displays showing it keep their PSRAM copy until ss_image_unload().
+ * @param lib_slot Image library slot (0..SS_IMG_LIBRARY-1)
  */
-bool ss_image_delete(ss_image_slot_t slot);
+bool ss_image_delete(uint8_t lib_slot);
+
+/**
+ * @brief Library slot a display shows (PROFILE_IMG_NONE = compiled icon)
+ */
+uint8_t ss_image_get_ref(ss_image_slot_t slot);
+
+/**
+ * @brief Point the displays at other library slots
+ *
+ * Only displays whose reference changes are marked for reload; the UI
+ * thread loads them in ss_process_updates(). Safe to call from the USB task.
+ * @param refs Library slot (or PROFILE_IMG_NONE) per display
+ */
+void ss_image_set_refs(const uint8_t refs[SS_IMG_COUNT]);
 
 /**
  * @brief Main image command dispatcher
@@ -115,6 +159,11 @@ bool ss_image_delete(ss_image_slot_t slot);
  */
 bool ss_image_handle_command(const char *line);
 
+/**
+ * @brief Check if an IMG_BEGIN..IMG_END transfer is in progress
+ */
+bool ss_image_upload_active(void);
+
 /* =============================================================================
  * THREAD-SAFE IMAGE RELOAD API
  *
@@ -138,6 +187,20 @@ typedef void (*ss_image_reload_cb_t)(ss_image_slot_t slot, const lv_image_dsc_t
  */
 void ss_set_reload_callback(ss_image_reload_cb_t callback);
 
+/**
+ * @brief Callback type for unloading a full-screen image in panel order
+ * @param slot The slot whose pixels are about to be freed
+ */
+typedef void (*ss_image_unload_cb_t)(ss_image_slot_t slot);
+
+/**
+ * @brief Register callback that stops any DMA from a slot before it is freed
+ *
+ * Called from ss_image_unload() (UI thread) only for images handed out by
+ * ss_image_get_fullscreen().
+ */
+void ss_set_unload_callback(ss_image_unload_cb_t callback);
+
 /**
  * @brief Process pending image reloads (MUST be called from UI thread!)
  *
@@ -8,6 +8,7 @@
 #include "../gui_settings.h"
 #include "../storage/hw_identity.h"
 #include "../screens/screens_lvgl.h"
+#include "../core/postmortem.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -22,6 +23,31 @@ static ui_status_dots_t *s_dots = NULL;
 static SemaphoreHandle_t s_lvgl_mutex = NULL;
 static bool s_screensaver_active = false;
 
+/* Requested view mode per display (UI_VIEW_NORMAL/ALT/CYCLE) and the view
+ * currently on screen (UI_VIEW_NORMAL/ALT) */
+static uint8_t s_view_mode[SCREEN_COUNT] = {0};
+static uint8_t s_view[SCREEN_COUNT] = {0};
+static uint32_t s_view_switched_ms[SCREEN_COUNT] = {0};
+
+/* Field groups each screen draws (see STATS_DIRTY_*) */
+#define UI_FIELDS_CPU   (STATS_DIRTY_CPU_LOAD | STATS_DIRTY_CPU_TEMP)
+#define UI_FIELDS_GPU   (STATS_DIRTY_GPU_LOAD | STATS_DIRTY_GPU_TEMP | STATS_DIRTY_VRAM)
+#define UI_FIELDS_RAM   STATS_DIRTY_RAM
+#define UI_FIELDS_NET   (STATS_DIRTY_NET_RATE | STATS_DIRTY_NET_LINK)
+
+/* Stats generation last drawn, and field groups to redraw on the next update
+ * regardless of the line's own mask (first frame, view shown again). */
+static uint32_t s_stats_seq = 0;
+static uint32_t s_force_dirty = STATS_DIRTY_ALL;
+
+/* Alert state in effect (ALERT_RULES:) and the blink targets currently
+ * dimmed. Until the first stats line no rule is active. */
+#define UI_ALERT_BLINK_MS   500     /* Half period of a blinking target */
+static alert_state_t s_alerts = {
+    .force_view = { ALERT_NO_VIEW, ALERT_NO_VIEW, ALERT_NO_VIEW, ALERT_NO_VIEW }
+};
+static uint8_t s_dimmed_mask = 0;
+
 /* Screensaver image widget handles (for hot-swap updates) */
 static lv_obj_t *s_ss_images[4] = {NULL, NULL, NULL, NULL};
 
@@ -40,7 +66,7 @@ bool ui_acquire_lock(uint32_t timeout_ms)
         return false;
     }
 
-    if (xSemaphoreTake(s_lvgl_mutex, pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
+    if (postmortem_take(POSTMORTEM_LOCK_LVGL, s_lvgl_mutex, pdMS_TO_TICKS(timeout_ms))) {
         s_lock_successes++;
         return true;
     }
@@ -69,9 +95,12 @@ void ui_manager_init(SemaphoreHandle_t lvgl_mutex)
     ESP_LOGI(TAG, "UI Manager initialized");
 }
 
+static void apply_alert_colors(void);
+
 void ui_manager_set_screens(ui_screens_t *screens)
 {
     s_screens = screens;
+    apply_alert_colors();
 }
 
 void ui_manager_set_screensavers(ui_screensavers_t *screensavers)
@@ -109,6 +138,26 @@ void ui_manager_apply_theme(void)
             lv_obj_set_style_text_color(scr->label_title,
                 lv_color_hex(gui_settings.text_title_cpu), LV_PART_MAIN);
         }
+        if (scr->gauge) {
+            screen_gauge_set_arc_bg(scr->gauge, gui_settings.arc_bg_color);
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_ARC, gui_settings.arc_color_cpu);
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_TITLE, gui_settings.text_title_cpu);
+        }
+    }
+
+    /* --- Process list view (CPU display) --- */
+    if (s_screens && s_screens->proc) {
+        screen_proc_t *scr = s_screens->proc;
+        lv_obj_set_style_bg_color(scr->overlay,
+            lv_color_hex(gui_settings.bg_color[SCREEN_CPU]), 0);
+        lv_obj_set_style_text_color(scr->label_header,
+            lv_color_hex(gui_settings.text_title_cpu), 0);
+        for (int i = 0; i < PROC_TOP_COUNT; i++) {
+            lv_obj_set_style_text_color(scr->label_name[i],
+                lv_color_hex(gui_settings.text_value), 0);
+            lv_obj_set_style_text_color(scr->label_value[i],
+                lv_color_hex(gui_settings.text_secondary), 0);
+        }
     }
 
     /* --- GPU Screen --- */
@@ -128,6 +177,11 @@ void ui_manager_apply_theme(void)
             lv_obj_set_style_text_color(scr->label_title,
                 lv_color_hex(gui_settings.text_title_gpu), LV_PART_MAIN);
         }
+        if (scr->gauge) {
+            screen_gauge_set_arc_bg(scr->gauge, gui_settings.arc_bg_color);
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_ARC, gui_settings.arc_color_gpu);
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_TITLE, gui_settings.text_title_gpu);
+        }
     }
 
     /* --- RAM Screen --- */
@@ -143,6 +197,27 @@ void ui_manager_apply_theme(void)
         }
     }
 
+    /* --- Storage view (RAM display) --- */
+    if (s_screens && s_screens->storage) {
+        screen_storage_t *scr = s_screens->storage;
+        lv_obj_set_style_bg_color(scr->overlay,
+            lv_color_hex(gui_settings.bg_color[SCREEN_RAM]), 0);
+        lv_obj_set_style_text_color(scr->label_header,
+            lv_color_hex(gui_settings.text_title_ram), 0);
+        lv_obj_set_style_text_color(scr->label_iops,
+            lv_color_hex(gui_settings.text_value), 0);
+        lv_obj_set_style_text_color(scr->label_queue,
+            lv_color_hex(gui_settings.text_secondary), 0);
+        lv_obj_set_style_bg_color(scr->chart_read,
+            lv_color_hex(gui_settings.net_chart_bg), 0);
+        lv_obj_set_style_border_color(scr->chart_read,
+            lv_color_hex(gui_settings.net_chart_border), 0);
+        lv_obj_set_style_bg_color(scr->chart_write,
+            lv_color_hex(gui_settings.net_chart_bg), 0);
+        lv_obj_set_style_border_color(scr->chart_write,
+            lv_color_hex(gui_settings.net_chart_border), 0);
+    }
+
     /* --- Network Screen --- */
     if (s_screens && s_screens->network) {
         screen_network_t *scr = s_screens->network;
@@ -182,6 +257,9 @@ void ui_manager_apply_theme(void)
         }
     }
 
+    /* Alert colours sit on top of the theme (and follow SET_CLR_TEMP) */
+    apply_alert_colors();
+
     ESP_LOGI(TAG, "Theme applied");
 }
 
@@ -197,9 +275,15 @@ void ui_manager_apply_hardware_names(void)
         if (s_screens->cpu && s_screens->cpu->label_title) {
             lv_label_set_text(s_screens->cpu->label_title, id->cpu_name);
         }
+        if (s_screens->cpu && s_screens->cpu->gauge) {
+            screen_gauge_set_text(s_screens->cpu->gauge, SCREEN_GAUGE_TITLE, id->cpu_name, SCREEN_BAND_NORMAL);
+        }
         if (s_screens->gpu && s_screens->gpu->label_title) {
             lv_label_set_text(s_screens->gpu->label_title, id->gpu_name);
         }
+        if (s_screens->gpu && s_screens->gpu->gauge) {
+            screen_gauge_set_text(s_screens->gpu->gauge, SCREEN_GAUGE_TITLE, id->gpu_name, SCREEN_BAND_NORMAL);
+        }
     }
 }
 
@@ -209,12 +293,273 @@ void ui_manager_apply_hardware_names(void)
 
 void ui_manager_update_screens(const pc_stats_t *stats)
 {
-    if (!s_screens || !stats) return;
+    /* seq 0: nothing received yet - keep the create-time placeholders */
+    if (!s_screens || !stats || stats->seq == 0) return;
+
+    /* Idle frame: the display task runs at 10 FPS, lines arrive ~1x/s */
+    bool new_line = (stats->seq != s_stats_seq);
+    if (!new_line && !s_force_dirty) return;
+
+    /* Each line only carries its changes vs. the line before it. If the
+     * display task missed a generation (mutex timeout, screensaver) that
+     * mask is gone - redraw everything once. */
+    uint32_t dirty = s_force_dirty;
+    if (new_line) {
+        dirty |= (stats->seq == s_stats_seq + 1) ? stats->dirty : STATS_DIRTY_ALL;
+    }
+    s_stats_seq = stats->seq;
+    s_force_dirty = 0;
+
+    /* Normal views covered by their alternate view are not updated - don't
+     * invalidate widgets nobody can see (show_view forces a redraw) */
+    if (s_screens->cpu && s_view[SCREEN_CPU] == UI_VIEW_NORMAL && (dirty & UI_FIELDS_CPU)) {
+        screen_cpu_update(s_screens->cpu, stats, dirty);
+    }
+    if (s_screens->gpu && (dirty & UI_FIELDS_GPU)) {
+        screen_gpu_update(s_screens->gpu, stats, dirty);
+    }
+    if (s_screens->ram && s_view[SCREEN_RAM] == UI_VIEW_NORMAL && (dirty & UI_FIELDS_RAM)) {
+        screen_ram_update(s_screens->ram, stats, dirty);
+    }
+    if (s_screens->network && (dirty & UI_FIELDS_NET)) {
+        screen_network_update(s_screens->network, stats, dirty);
+    }
+
+    /* Storage sparklines advance once per line, changed or not, and keep
+     * their history while hidden (no redraw cost) */
+    if (s_screens->storage && new_line) {
+        screen_storage_update(s_screens->storage, stats);
+    }
+}
+
+void ui_manager_update_proc_list(const proc_top_t *top)
+{
+    if (!s_screens || !s_screens->proc || !top) return;
+    if (s_view[SCREEN_CPU] != UI_VIEW_ALT) return;
+
+    screen_proc_update(s_screens->proc, top);
+}
+
+void ui_manager_load_history(const history_backfill_t *history)
+{
+    if (!s_screens || !history) return;
+
+    if (s_screens->network) screen_network_load_history(s_screens->network, history);
+    if (s_screens->storage) screen_storage_load_history(s_screens->storage, history);
+}
+
+/* =============================================================================
+ * VIEW SWITCHING
+ * ========================================================================== */
+
+/* Must be called with the LVGL mutex held.
+ * @return false if the display has no alternate view */
+static bool show_view(int screen, uint8_t view)
+{
+    if (!s_screens) return false;
+
+    switch (screen) {
+        case SCREEN_CPU:
+            if (!s_screens->proc) return false;
+            screen_proc_show(s_screens->proc, view == UI_VIEW_ALT);
+            if (view == UI_VIEW_ALT) {
+                /* Redraw all rows from the current list on next update */
+                s_screens->proc->last_seq = 0;
+            } else {
+                /* Gauge was not updated while hidden - force a redraw */
+                s_force_dirty |= UI_FIELDS_CPU;
+            }
+            break;
+        case SCREEN_RAM:
+            if (!s_screens->storage) return false;
+            screen_storage_show(s_screens->storage, view == UI_VIEW_ALT);
+            if (view == UI_VIEW_NORMAL) {
+                /* Bar was not updated while hidden - force a redraw */
+                s_force_dirty |= UI_FIELDS_RAM;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    s_view[screen] = view;
+    s_view_switched_ms[screen] = lv_tick_get();
+    return true;
+}
+
+void ui_manager_tick_views(void)
+{
+    uint32_t now = lv_tick_get();
+
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        if (s_view_mode[i] != UI_VIEW_CYCLE) continue;
+        if (s_alerts.force_view[i] != ALERT_NO_VIEW) continue;
+        if (now - s_view_switched_ms[i] < UI_VIEW_CYCLE_MS) continue;
+        show_view(i, s_view[i] == UI_VIEW_ALT ? UI_VIEW_NORMAL : UI_VIEW_ALT);
+    }
+}
+
+bool ui_manager_handle_view_command(const char *line)
+{
+    /* SET_VIEW:Screen:View */
+    if (strncmp(line, "SET_VIEW:", 9) != 0) return false;
+
+    int screen = line[9] - '0';
+    int view = (line[10] == ':') ? atoi(line + 11) : -1;
+
+    if (screen < 0 || screen >= SCREEN_COUNT || view < UI_VIEW_NORMAL || view > UI_VIEW_CYCLE) {
+        ESP_LOGW(TAG, "Invalid SET_VIEW command: %s", line);
+        return true;
+    }
+
+    if (s_lvgl_mutex && postmortem_take(POSTMORTEM_LOCK_LVGL, s_lvgl_mutex, pdMS_TO_TICKS(100))) {
+        if (s_alerts.force_view[screen] != ALERT_NO_VIEW) {
+            /* An alert holds the view - the mode takes over when it ends */
+            s_view_mode[screen] = (uint8_t)view;
+            ESP_LOGI(TAG, "Display %d view -> %d (after alert)", screen, view);
+        }
+        /* Cycle starts on the alternate view so the switch is visible */
+        else if (show_view(screen, view == UI_VIEW_NORMAL ? UI_VIEW_NORMAL : UI_VIEW_ALT)) {
+            s_view_mode[screen] = (uint8_t)view;
+            ESP_LOGI(TAG, "Display %d view -> %d", screen, view);
+        } else {
+            ESP_LOGW(TAG, "No alternate view on display %d", screen);
+        }
+        xSemaphoreGive(s_lvgl_mutex);
+    } else {
+        ESP_LOGW(TAG, "Failed to acquire LVGL mutex for SET_VIEW");
+    }
+
+    return true;
+}
+
+/* =============================================================================
+ * ALERTS
+ * ========================================================================== */
+
+/* Immediate-mode gauges draw their targets themselves: gauge and part
+ * instead of an object (widget screens: NULL) */
+static screen_gauge_t *alert_target_gauge(int target, screen_gauge_part_t *part)
+{
+    if (!s_screens) return NULL;
+
+    switch (target) {
+        case ALERT_TARGET_CPU_TEMP: *part = SCREEN_GAUGE_TEMP; return s_screens->cpu ? s_screens->cpu->gauge : NULL;
+        case ALERT_TARGET_GPU_TEMP: *part = SCREEN_GAUGE_TEMP; return s_screens->gpu ? s_screens->gpu->gauge : NULL;
+        case ALERT_TARGET_CPU_ARC:  *part = SCREEN_GAUGE_ARC;  return s_screens->cpu ? s_screens->cpu->gauge : NULL;
+        case ALERT_TARGET_GPU_ARC:  *part = SCREEN_GAUGE_ARC;  return s_screens->gpu ? s_screens->gpu->gauge : NULL;
+        default:                    return NULL;
+    }
+}
 
-    if (s_screens->cpu) screen_cpu_update(s_screens->cpu, stats);
-    if (s_screens->gpu) screen_gpu_update(s_screens->gpu, stats);
-    if (s_screens->ram) screen_ram_update(s_screens->ram, stats);
-    if (s_screens->network) screen_network_update(s_screens->network, stats);
+static lv_obj_t *alert_target_obj(int target)
+{
+    if (!s_screens) return NULL;
+
+    switch (target) {
+        case ALERT_TARGET_CPU_TEMP: return s_screens->cpu ? s_screens->cpu->label_temp : NULL;
+        case ALERT_TARGET_GPU_TEMP: return s_screens->gpu ? s_screens->gpu->label_temp : NULL;
+        case ALERT_TARGET_CPU_ARC:  return s_screens->cpu ? s_screens->cpu->arc : NULL;
+        case ALERT_TARGET_GPU_ARC:  return s_screens->gpu ? s_screens->gpu->arc : NULL;
+        default:                    return NULL;
+    }
+}
+
+/* Theme colour of a target, overridden by an active COLOR rule */
+static uint32_t alert_color(int target, uint32_t theme_color)
+{
+    if (s_alerts.color_mask & (1u << target)) {
+        return alert_rules_resolve_color(s_alerts.color[target]);
+    }
+    return theme_color;
+}
+
+/* Must be called with the LVGL mutex held */
+static void apply_alert_colors(void)
+{
+    if (!s_screens) return;
+
+    if (s_screens->cpu) {
+        screen_cpu_t *scr = s_screens->cpu;
+        uint32_t temp = alert_color(ALERT_TARGET_CPU_TEMP, gui_settings.temp_cold);
+        uint32_t arc = alert_color(ALERT_TARGET_CPU_ARC, gui_settings.arc_color_cpu);
+        if (scr->gauge) {
+            /* Band colours (N/A) are resolved at draw time on top */
+            scr->temp_color = temp;
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_TEMP, temp);
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_ARC, arc);
+        } else {
+            if (temp != scr->temp_color) {
+                /* Default-state colour; N/A keeps its band style on top */
+                scr->temp_color = temp;
+                lv_obj_set_style_text_color(scr->label_temp, lv_color_hex(temp), LV_PART_MAIN);
+            }
+            lv_obj_set_style_arc_color(scr->arc, lv_color_hex(arc), LV_PART_INDICATOR);
+        }
+    }
+    if (s_screens->gpu) {
+        screen_gpu_t *scr = s_screens->gpu;
+        uint32_t temp = alert_color(ALERT_TARGET_GPU_TEMP, gui_settings.temp_cold);
+        uint32_t arc = alert_color(ALERT_TARGET_GPU_ARC, gui_settings.arc_color_gpu);
+        if (scr->gauge) {
+            scr->temp_color = temp;
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_TEMP, temp);
+            screen_gauge_set_color(scr->gauge, SCREEN_GAUGE_ARC, arc);
+        } else {
+            if (temp != scr->temp_color) {
+                scr->temp_color = temp;
+                lv_obj_set_style_text_color(scr->label_temp, lv_color_hex(temp), LV_PART_MAIN);
+            }
+            lv_obj_set_style_arc_color(scr->arc, lv_color_hex(arc), LV_PART_INDICATOR);
+        }
+    }
+}
+
+void ui_manager_apply_alerts(const alert_state_t *alerts)
+{
+    if (!alerts) return;
+
+    int8_t old_view[SCREEN_COUNT];
+    memcpy(old_view, s_alerts.force_view, sizeof(old_view));
+    s_alerts = *alerts;
+
+    apply_alert_colors();
+
+    /* Forced views: enter on start, return to the SET_VIEW mode on release */
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        int8_t view = s_alerts.force_view[i];
+        if (view == old_view[i]) continue;
+
+        if (view != ALERT_NO_VIEW) {
+            show_view(i, (uint8_t)view);
+        } else {
+            show_view(i, s_view_mode[i] == UI_VIEW_NORMAL ? UI_VIEW_NORMAL : UI_VIEW_ALT);
+        }
+        ESP_LOGI(TAG, "Display %d view %s by alert", i, view != ALERT_NO_VIEW ? "forced" : "released");
+    }
+}
+
+void ui_manager_tick_alerts(void)
+{
+    /* Blinking targets are dimmed in the off half of the period */
+    bool off_phase = (lv_tick_get() / UI_ALERT_BLINK_MS) & 1;
+    uint8_t dimmed = off_phase ? s_alerts.blink_mask : 0;
+    uint8_t changed = dimmed ^ s_dimmed_mask;
+    if (!changed) return;
+
+    for (int t = 0; t < ALERT_TARGET_COUNT; t++) {
+        if (!(changed & (1u << t))) continue;
+        lv_opa_t opa = (dimmed & (1u << t)) ? LV_OPA_20 : LV_OPA_COVER;
+        screen_gauge_part_t part;
+        screen_gauge_t *gauge = alert_target_gauge(t, &part);
+        lv_obj_t *obj = alert_target_obj(t);
+        if (gauge) {
+            screen_gauge_set_opa(gauge, part, opa);
+        } else if (obj) {
+            lv_obj_set_style_opa(obj, opa, 0);
+        }
+    }
+    s_dimmed_mask = dimmed;
 }
 
 /* =============================================================================
@@ -368,7 +713,7 @@ bool ui_manager_handle_color_command(const char *line)
                 case 2: gui_settings.temp_hot = color; break;
             }
             ESP_LOGI(TAG, "Set temp color[%d]: 0x%06lX", idx, (unsigned long)color);
-            needs_save = true;
+            needs_save = needs_theme_update = true;
         }
     }
     /* RESET_THEME */
@@ -388,7 +733,7 @@ bool ui_manager_handle_color_command(const char *line)
 
     /* Apply theme if needed (must be done in LVGL context) */
     if (needs_theme_update && s_lvgl_mutex) {
-        if (xSemaphoreTake(s_lvgl_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        if (postmortem_take(POSTMORTEM_LOCK_LVGL, s_lvgl_mutex, pdMS_TO_TICKS(100))) {
             ui_manager_apply_theme();
             xSemaphoreGive(s_lvgl_mutex);
         }
@@ -418,6 +763,35 @@ lv_obj_t *ui_manager_create_status_dot(lv_obj_t *parent)
     return dot;
 }
 
+/* scarab_img_align_t -> LVGL alignment on the overlay */
+static const lv_align_t s_ss_align_map[] = {
+    [SCARAB_ALIGN_CENTER]       = LV_ALIGN_CENTER,
+    [SCARAB_ALIGN_TOP_LEFT]     = LV_ALIGN_TOP_LEFT,
+    [SCARAB_ALIGN_TOP_MID]      = LV_ALIGN_TOP_MID,
+    [SCARAB_ALIGN_TOP_RIGHT]    = LV_ALIGN_TOP_RIGHT,
+    [SCARAB_ALIGN_LEFT_MID]     = LV_ALIGN_LEFT_MID,
+    [SCARAB_ALIGN_RIGHT_MID]    = LV_ALIGN_RIGHT_MID,
+    [SCARAB_ALIGN_BOTTOM_LEFT]  = LV_ALIGN_BOTTOM_LEFT,
+    [SCARAB_ALIGN_BOTTOM_MID]   = LV_ALIGN_BOTTOM_MID,
+    [SCARAB_ALIGN_BOTTOM_RIGHT] = LV_ALIGN_BOTTOM_RIGHT,
+};
+
+/* Position the image widget from the slot's header. The widget is sized to
+ * the image, so only its bounding box is drawn over the flat background. */
+static void place_ss_image(lv_obj_t *img, int slot)
+{
+    scarab_img_align_t align = SCARAB_ALIGN_CENTER;
+    int16_t x_ofs = 0, y_ofs = 0;
+
+    if (slot >= 0) {
+        ss_image_get_placement((ss_image_slot_t)slot, &align, &x_ofs, &y_ofs);
+    }
+    if ((unsigned)align >= sizeof(s_ss_align_map) / sizeof(s_ss_align_map[0])) {
+        align = SCARAB_ALIGN_CENTER;
+    }
+    lv_obj_align(img, s_ss_align_map[align], x_ofs, y_ofs);
+}
+
 lv_obj_t *ui_manager_create_screensaver_ex(lv_obj_t *parent, lv_color_t bg_color,
                                            const lv_image_dsc_t *icon_src, int slot_index)
 {
@@ -434,10 +808,10 @@ lv_obj_t *ui_manager_create_screensaver_ex(lv_obj_t *parent, lv_color_t bg_color
     lv_obj_set_style_pad_all(overlay, 0, 0);
     lv_obj_clear_flag(overlay, LV_OBJ_FLAG_SCROLLABLE);
 
-    /* Centered image */
+    /* Image at its header placement (centered for fallbacks) */
     lv_obj_t *img = lv_img_create(overlay);
     lv_img_set_src(img, icon_src);
-    lv_obj_center(img);
+    place_ss_image(img, slot_index);
 
     /* Store image handle for hot-swap updates */
     if (slot_index >= 0 && slot_index < 4) {
@@ -470,6 +844,7 @@ void ui_manager_on_image_reload(int slot, const lv_image_dsc_t *new_dsc)
     lv_obj_t *img = s_ss_images[slot];
     if (img) {
         lv_img_set_src(img, new_dsc);
+        place_ss_image(img, slot);
         ESP_LOGI(TAG, "Screensaver slot %d image source refreshed", slot);
     } else {
         ESP_LOGW(TAG, "Screensaver slot %d image handle not found", slot);
@@ -13,12 +13,15 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "core/system_types.h"
+#include "core/alert_rules.h"
 
 /* Forward declarations for screen types */
 typedef struct screen_cpu_t screen_cpu_t;
 typedef struct screen_gpu_t screen_gpu_t;
 typedef struct screen_ram_t screen_ram_t;
 typedef struct screen_network_t screen_network_t;
+typedef struct screen_proc_t screen_proc_t;
+typedef struct screen_storage_t screen_storage_t;
 
 /* Screen handles structure */
 typedef struct {
@@ -26,8 +29,18 @@ typedef struct {
     screen_gpu_t *gpu;
     screen_ram_t *ram;
     screen_network_t *network;
+    screen_proc_t *proc;        /* Alternate view on the CPU display */
+    screen_storage_t *storage;  /* Alternate view on the RAM display */
 } ui_screens_t;
 
+/* Per-display view modes (SET_VIEW). Runtime only - not persisted, every
+ * display boots into its normal view. */
+#define UI_VIEW_NORMAL      0   /* Default gauge/bar/chart */
+#define UI_VIEW_ALT         1   /* Alternate view (CPU: process list, RAM: storage) */
+#define UI_VIEW_CYCLE       2   /* Alternate between both every UI_VIEW_CYCLE_MS */
+
+#define UI_VIEW_CYCLE_MS    8000
+
 /* Screensaver handles structure */
 typedef struct {
     lv_obj_t *cpu;
@@ -126,10 +139,65 @@ void ui_manager_apply_hardware_names(void);
  * @brief Update all screens with current PC stats
  * @param stats Pointer to PC stats structure
  *
+ * Dispatches on stats->seq and stats->dirty: a frame without a new line
+ * returns after one compare, and only screens bound to a changed field
+ * group are updated.
+ *
  * Must be called from LVGL context (with mutex held).
  */
 void ui_manager_update_screens(const pc_stats_t *stats);
 
+/**
+ * @brief Update the process list view with the latest top-N list
+ * @param top Pointer to process list
+ *
+ * No-op while the CPU display shows its normal view.
+ * Must be called from LVGL context (with mutex held).
+ */
+void ui_manager_update_proc_list(const proc_top_t *top);
+
+/**
+ * @brief Load a history backfill into the network chart and storage sparklines
+ * @param history Backfill from the client (HIST: line)
+ *
+ * Each chart is redrawn once. Applied even while hidden or in screensaver.
+ * Must be called from LVGL context (with mutex held).
+ */
+void ui_manager_load_history(const history_backfill_t *history);
+
+/**
+ * @brief Apply a new alert state (colour overrides, blinking, forced views)
+ * @param alerts Alert state of the last stats line (usb_serial_get_alerts)
+ *
+ * Call when alerts->seq changed, before ui_manager_update_screens(), so the
+ * sample that raised an alert is already drawn in its colour.
+ * Must be called from LVGL context (with mutex held).
+ */
+void ui_manager_apply_alerts(const alert_state_t *alerts);
+
+/**
+ * @brief Advance blinking alert targets
+ *
+ * Call once per display task iteration.
+ * Must be called from LVGL context (with mutex held).
+ */
+void ui_manager_tick_alerts(void);
+
+/**
+ * @brief Advance displays in UI_VIEW_CYCLE mode
+ *
+ * Call once per display task iteration, before ui_manager_update_screens().
+ * Must be called from LVGL context (with mutex held).
+ */
+void ui_manager_tick_views(void);
+
+/**
+ * @brief Handle SET_VIEW:<screen>:<view> commands
+ * @param line Command line
+ * @return true if command was handled
+ */
+bool ui_manager_handle_view_command(const char *line);
+
 /**
  * @brief Show/hide screensavers
  * @param show true to show, false to hide
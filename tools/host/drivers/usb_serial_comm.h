@@ -0,0 +1,14 @@
+/**
+ * @file usb_serial_comm.h
+ * @brief Host stand-in for the USB transport (tools/metric_vm_bench.c)
+ *
+ * Only what the core modules built on the host call; replies are dropped.
+ */
+
+#ifndef USB_SERIAL_COMM_H
+#define USB_SERIAL_COMM_H
+
+void usb_serial_send(const char *response);
+void usb_serial_sendf(const char *fmt, ...);
+
+#endif /* USB_SERIAL_COMM_H */
@@ -0,0 +1,103 @@
+/**
+ * @file metric_vm_bench.c
+ * @brief Times the firmware's metric VM (main/core/metric_vm.c) on the host
+ *
+ * Builds the unmodified interpreter, CRC and stats decoder with a host
+ * compiler, so the numbers are for the C the device runs - not for the C#
+ * model in PCMonitorClient.Benchmarks. Host CPU, not the ESP32-S3: compare
+ * runs on one machine; BENCH case EXPR gives the device time.
+ *
+ *   gcc -O2 -Itools/host -Imain -Imain/core tools/metric_vm_bench.c \
+ *       main/core/metric_vm.c main/core/codec.c main/core/protocol_gen.c \
+ *       -lm -o metric_vm_bench
+ *   ./metric_vm_bench metric_vm_bench.txt
+ *
+ * The input holds the METRICS: line and the stats line the benchmark suite
+ * uses; write it with
+ *   dotnet run -c Release -- --export-metric-vm metric_vm_bench.txt
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "core/metric_vm.h"
+#include "codec.h"
+
+#define BENCH_FRAMES    200000
+#define BENCH_BATCHES   5       /* Best batch reported - least disturbed */
+#define BENCH_LINE_MAX  4096
+
+void usb_serial_send(const char *response) { (void)response; }
+void usb_serial_sendf(const char *fmt, ...) { (void)fmt; }
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static bool read_line(FILE *f, char *buf, size_t size)
+{
+    if (!fgets(buf, (int)size, f)) return false;
+    buf[strcspn(buf, "\r\n")] = '\0';
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <metric_vm_bench.txt>\n", argv[0]);
+        return 2;
+    }
+
+    static char metrics_line[BENCH_LINE_MAX];
+    static uint8_t table[BENCH_LINE_MAX / 2];
+    char stats_line[PROTO_STATS_MAX_LEN];
+    FILE *f = fopen(argv[1], "r");
+    if (!f || !read_line(f, metrics_line, sizeof(metrics_line)) ||
+        !read_line(f, stats_line, sizeof(stats_line))) {
+        fprintf(stderr, "%s: need a METRICS: line and a stats line\n", argv[1]);
+        if (f) fclose(f);
+        return 1;
+    }
+    fclose(f);
+
+    size_t prefix = strlen(PROTO_CMD_METRICS);
+    int len = strncmp(metrics_line, PROTO_CMD_METRICS, prefix) == 0
+              ? codec_hex_decode(metrics_line + prefix, table, sizeof(table)) : -1;
+    pc_stats_t stats;
+    if (len <= 0 || proto_stats_decode(stats_line, &stats) < PROTO_STATS_MIN_FIELDS) {
+        fprintf(stderr, "%s: unreadable METRICS: or stats line\n", argv[1]);
+        return 1;
+    }
+
+    metric_vm_t *vm = metric_vm_create();
+    int bad_slot;
+    int slots = vm ? metric_vm_load(vm, table, (size_t)len, &bad_slot) : METRIC_VM_BAD_TABLE;
+    if (slots <= 0) {
+        fprintf(stderr, "Table rejected (slots %d, bad metric %d)\n", slots, vm ? bad_slot : -1);
+        return 1;
+    }
+
+    uint32_t now_ms = 0;
+    int64_t best = INT64_MAX;
+    for (int b = 0; b < BENCH_BATCHES; b++) {
+        int64_t t0 = now_ns();
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            now_ms += 1000;
+            metric_vm_run(vm, &stats, now_ms);
+        }
+        int64_t t = now_ns() - t0;
+        if (t < best) best = t;
+    }
+
+    printf("%d metrics, %d byte table: %.1f ns per frame (best of %d x %d), last metric %g\n",
+           slots, len, (double)best / BENCH_FRAMES, BENCH_BATCHES, BENCH_FRAMES,
+           (double)metric_vm_get(vm, slots - 1));
+    metric_vm_free(vm);
+    return 0;
+}
@@ -0,0 +1,959 @@
+#!/usr/bin/env python3
+"""
+Scarab protocol code generator.
+
+Reads protocol/scarab_protocol.def and writes the firmware codec
+(main/core/protocol_gen.h/.c) and the client codec
+(PCMonitorClient/PCMonitorClient/Protocol.g.cs).
+
+    python tools/protogen.py           regenerate
+    python tools/protogen.py --check   exit 1 if a generated file is stale
+
+Standard library only - runs wherever ESP-IDF's Python does.
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCHEMA = os.path.join(ROOT, "protocol", "scarab_protocol.def")
+OUT_H = os.path.join(ROOT, "main", "core", "protocol_gen.h")
+OUT_C = os.path.join(ROOT, "main", "core", "protocol_gen.c")
+OUT_CS = os.path.join(ROOT, "PCMonitorClient", "PCMonitorClient", "Protocol.g.cs")
+
+BANNER = "GENERATED by tools/protogen.py from protocol/scarab_protocol.def - DO NOT EDIT"
+
+# Encoders clamp numbers to this magnitude so the line length is bounded
+NUM_LIMIT_DIGITS = 9
+
+# type: (C type, C# type, size, BinaryPrimitives suffix)
+STRUCT_TYPES = {
+    "u8": ("uint8_t", "byte", 1, None),
+    "u16": ("uint16_t", "ushort", 2, "UInt16"),
+    "i16": ("int16_t", "short", 2, "Int16"),
+    "u32": ("uint32_t", "uint", 4, "UInt32"),
+}
+
+
+class SchemaError(Exception):
+    pass
+
+
+# =============================================================================
+# SCHEMA PARSER
+# =============================================================================
+
+class Value:
+    """One value of a frame field (a KEY:a/b/c field has three)."""
+
+    def __init__(self, enc, c_member, cs_prop):
+        self.enc = enc
+        self.c_member = c_member
+        self.cs_prop = cs_prop
+        m = re.fullmatch(r"i16|f(\d)|str(\d+)", enc)
+        if not m:
+            raise SchemaError("unknown encoding '%s'" % enc)
+        self.kind = "int" if enc == "i16" else ("float" if enc.startswith("f") else "str")
+        self.decimals = int(m.group(1)) if m.group(1) else 0
+        self.str_size = int(m.group(2)) if m.group(2) else 0
+
+    def max_len(self):
+        if self.kind == "int":
+            return 6                                    # -32768
+        if self.kind == "float":
+            # sign + digits (+1: the clamp limit rounds up to 10^N as float)
+            return 1 + NUM_LIMIT_DIGITS + 1 + (1 + self.decimals if self.decimals else 0)
+        return self.str_size - 1
+
+
+class Field:
+    def __init__(self, key, values, absent, invalid):
+        self.key = key
+        self.values = values
+        self.absent = absent
+        self.invalid = invalid
+
+
+class Frame:
+    def __init__(self, name, c_struct, cs_class, sep, min_fields):
+        self.name = name
+        self.c_struct = c_struct
+        self.cs_class = cs_class
+        self.sep = sep
+        self.min_fields = min_fields
+        self.fields = []
+
+    def max_len(self):
+        n = 0
+        for f in self.fields:
+            n += len(f.key) + 1 + sum(v.max_len() for v in f.values) + (len(f.values) - 1)
+        n += len(self.fields) - 1                       # separators
+        return n + 1                                    # '\n'
+
+
+class Schema:
+    def __init__(self):
+        self.commands = []      # (name, token)
+        self.consts = []        # (name, value, comment)
+        self.enums = []         # (name, prefix, [(name, value, comment)])
+        self.structs = []       # (name, size, [(type, field, comment)])
+        self.frames = []
+
+
+def split_comment(line):
+    if "#" in line:
+        code, comment = line.split("#", 1)
+        return code.strip(), comment.strip()
+    return line.strip(), ""
+
+
+def parse_schema(path):
+    schema = Schema()
+    block = None            # ("frame"|"enum"|"struct", object)
+
+    with open(path, encoding="utf-8") as f:
+        for lineno, raw in enumerate(f, 1):
+            code, comment = split_comment(raw)
+            if not code:
+                continue
+            tok = code.split()
+            try:
+                if block is not None:
+                    if tok[0] == "end":
+                        block = None
+                        continue
+                    kind, obj = block
+                    if kind == "frame":
+                        parse_frame_field(obj, tok)
+                    elif kind == "enum":
+                        obj[2].append((tok[0], int(tok[1], 0), comment))
+                    else:
+                        if tok[0] not in STRUCT_TYPES:
+                            raise SchemaError("unknown struct type '%s'" % tok[0])
+                        obj[2].append((tok[0], tok[1], comment))
+                    continue
+
+                if tok[0] == "command":
+                    schema.commands.append((tok[1], tok[2]))
+                elif tok[0] == "const":
+                    schema.consts.append((tok[1], tok[2], comment))
+                elif tok[0] == "enum":
+                    e = (tok[1], tok[2], [])
+                    schema.enums.append(e)
+                    block = ("enum", e)
+                elif tok[0] == "struct":
+                    s = (tok[1], int(tok[2]), [])
+                    schema.structs.append(s)
+                    block = ("struct", s)
+                elif tok[0] == "frame":
+                    opts = dict(t.split("=", 1) for t in tok[4:])
+                    fr = Frame(tok[1], tok[2], tok[3], opts.get("sep", ","), int(opts.get("min", "1")))
+                    schema.frames.append(fr)
+                    block = ("frame", fr)
+                else:
+                    raise SchemaError("unknown statement '%s'" % tok[0])
+            except (SchemaError, IndexError, ValueError) as ex:
+                raise SchemaError("%s:%d: %s" % (path, lineno, ex))
+
+    if block is not None:
+        raise SchemaError("%s: missing 'end'" % path)
+
+    for name, size, fields in schema.structs:
+        actual = sum(STRUCT_TYPES[t][2] for t, _, _ in fields)
+        if actual != size:
+            raise SchemaError("struct %s: fields add up to %d bytes, declared %d" % (name, actual, size))
+    return schema
+
+
+def parse_frame_field(frame, tok):
+    key, encs, members, props = tok[0], tok[1].split("/"), tok[2].split("/"), tok[3].split("/")
+    if not (len(encs) == len(members) == len(props)):
+        raise SchemaError("field %s: encodings, members and properties differ in count" % key)
+    opts = dict(t.split("=", 1) for t in tok[4:])
+    values = [Value(e, m, p) for e, m, p in zip(encs, members, props)]
+    if len(values) > 1 and any(v.kind == "str" for v in values):
+        raise SchemaError("field %s: text cannot be part of a multi-value field" % key)
+    frame.fields.append(Field(key, values, opts.get("absent"), opts.get("invalid")))
+
+
+# =============================================================================
+# HELPERS
+# =============================================================================
+
+def camel(name):
+    return "".join(p.capitalize() for p in name.split("_"))
+
+
+def c_str(s):
+    return '"' + s.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def c_num(v):
+    """Literal for a float member."""
+    return v + ".0f" if re.fullmatch(r"-?\d+", v) else v + "f"
+
+
+def c_assign(value, expr):
+    cast = "(int16_t)" if value.kind == "int" else ""
+    return "out->%s = %s%s;" % (value.c_member, cast, expr)
+
+
+# =============================================================================
+# C OUTPUT
+# =============================================================================
+
+def gen_c_header(schema):
+    o = []
+    o.append("/**")
+    o.append(" * @file protocol_gen.h")
+    o.append(" * @brief Wire protocol codecs and formats")
+    o.append(" *")
+    o.append(" * " + BANNER)
+    o.append(" */")
+    o.append("")
+    o.append("#ifndef PROTOCOL_GEN_H")
+    o.append("#define PROTOCOL_GEN_H")
+    o.append("")
+    o.append("#include <stdint.h>")
+    o.append("#include <stddef.h>")
+    o.append('#include "system_types.h"')
+    o.append("")
+    o.append("#ifdef __cplusplus")
+    o.append('extern "C" {')
+    o.append("#endif")
+    o.append("")
+
+    o.append("/* Commands / line tokens */")
+    width = max(len(n) for n, _ in schema.commands) + len("PROTO_CMD_") + 1
+    for name, token in schema.commands:
+        o.append("#define %-*s%s" % (width, "PROTO_CMD_" + name, c_str(token)))
+    o.append("")
+
+    cwidth = max([24] + [len(n) + 1 for n, _, _ in schema.consts])
+    for name, value, comment in schema.consts:
+        line = "#define %-*s%s" % (cwidth, name, value)
+        o.append(line + ("  /* %s */" % comment if comment else ""))
+    o.append("")
+
+    for name, prefix, items in schema.enums:
+        o.append("typedef enum {")
+        for iname, ival, comment in items:
+            line = "    %s_%s = %d," % (prefix, iname, ival)
+            o.append(("%-31s /* %s */" % (line, comment)) if comment else line)
+        o.append("} %s_t;" % name)
+        o.append("")
+
+    for name, size, fields in schema.structs:
+        o.append("typedef struct __attribute__((packed)) {")
+        for t, fname, comment in fields:
+            line = "    %-9s%s;" % (STRUCT_TYPES[t][0], fname)
+            o.append(("%-31s /* %s */" % (line, comment)) if comment else line)
+        o.append("} %s_t;" % name)
+        o.append("")
+        o.append('_Static_assert(sizeof(%s_t) == %d, "%s layout");' % (name, size, name))
+        o.append("")
+
+    for fr in schema.frames:
+        up = fr.name.upper()
+        o.append("/* %s line: %s */" % (fr.name, fr.sep.join(f.key + ":.." for f in fr.fields)))
+        o.append("#define PROTO_%s_MIN_FIELDS  %d" % (up, fr.min_fields))
+        o.append("#define PROTO_%s_MAX_LEN     %d   /**< incl. newline and terminator */" % (up, fr.max_len() + 1))
+        o.append("")
+        o.append("/**")
+        o.append(" * @brief Decode a %s line into @p out (no copy, no allocation)" % fr.name)
+        o.append(" *")
+        o.append(" * @p out is reset first; absent keys get their schema default.")
+        o.append(" * @return Number of fields parsed (commit only if >= PROTO_%s_MIN_FIELDS)" % up)
+        o.append(" */")
+        o.append("int proto_%s_decode(const char *line, %s *out);" % (fr.name, fr.c_struct))
+        o.append("")
+        o.append("/**")
+        o.append(" * @brief Encode @p in as a %s line incl. '\\n'" % fr.name)
+        o.append(" * @return Length written (without terminator), -1 if size < PROTO_%s_MAX_LEN" % up)
+        o.append(" */")
+        o.append("int proto_%s_encode(const %s *in, char *buf, size_t size);" % (fr.name, fr.c_struct))
+        o.append("")
+
+    o.append("#ifdef __cplusplus")
+    o.append("}")
+    o.append("#endif")
+    o.append("")
+    o.append("#endif /* PROTOCOL_GEN_H */")
+    return "\n".join(o) + "\n"
+
+
+C_HELPERS = r"""
+/* =============================================================================
+ * SCANNERS
+ * Work on [p, end) of the original line - no strtok copy, no locale.
+ * Return the position after the number, or NULL if there are no digits.
+ * ========================================================================== */
+
+static const char *scan_int(const char *p, const char *end, int32_t *out)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+    const char *digits = p;
+    int32_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (v < 100000000) {
+            v = v * 10 + (*p - '0');
+        }
+        p++;
+    }
+    if (p == digits) return NULL;
+    *out = neg ? -v : v;
+    return p;
+}
+
+static const char *scan_num(const char *p, const char *end, float *out)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+    const char *digits = p;
+    uint32_t ip = 0, frac = 0, div = 1;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (ip < 1000000000u) {
+            ip = ip * 10 + (uint32_t)(*p - '0');
+        }
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (div < 100000000u) {
+                frac = frac * 10 + (uint32_t)(*p - '0');
+                div *= 10;
+            }
+            p++;
+        }
+    }
+    if (p == digits || (p == digits + 1 && *digits == '.')) return NULL;
+    float v = (float)ip + (float)frac / (float)div;
+    *out = neg ? -v : v;
+    return p;
+}
+
+/* n numbers separated by '/', filling exactly [p, end) */
+static bool scan_list(const char *p, const char *end, float *out, int n)
+{
+    for (int i = 0; i < n; i++) {
+        p = scan_num(p, end, &out[i]);
+        if (!p) return false;
+        if (i < n - 1) {
+            if (p >= end || *p != '/') return false;
+            p++;
+        }
+    }
+    return p == end;
+}
+
+static void copy_text(char *dst, size_t size, const char *p, const char *end)
+{
+    size_t len = (size_t)(end - p);
+    if (len >= size) len = size - 1;
+    memcpy(dst, p, len);
+    dst[len] = '\0';
+}
+
+/* =============================================================================
+ * WRITERS (caller guarantees space - see PROTO_*_MAX_LEN)
+ * ========================================================================== */
+
+static char *put_text(char *p, const char *s, size_t max)
+{
+    for (size_t i = 0; i < max && s[i]; i++) {
+        char c = s[i];
+        *p++ = (c == SEP_CHAR || c == '\n' || c == '\r') ? ' ' : c;
+    }
+    return p;
+}
+
+static char *put_uint(char *p, uint64_t v)
+{
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+static char *put_int(char *p, int32_t v)
+{
+    if (v < 0) {
+        *p++ = '-';
+        return put_uint(p, (uint64_t)(-(int64_t)v));
+    }
+    return put_uint(p, (uint64_t)v);
+}
+
+/* Fixed-point with 'decimals' digits, rounded half away from zero.
+ * NaN is sent as -1 (N/A); magnitude is clamped to NUM_LIMIT. */
+static char *put_fixed(char *p, float v, int decimals)
+{
+    static const uint32_t scales[] = { 1, 10, 100, 1000, 10000 };
+    if (v != v) v = -1.0f;
+    if (v > NUM_LIMIT) v = NUM_LIMIT;
+    if (v < -NUM_LIMIT) v = -NUM_LIMIT;
+
+    uint32_t scale = scales[decimals];
+    bool neg = v < 0;
+    uint64_t s = (uint64_t)((neg ? -v : v) * (float)scale + 0.5f);
+    if (neg && s) *p++ = '-';
+    p = put_uint(p, s / scale);
+    if (decimals) {
+        *p++ = '.';
+        uint32_t frac = (uint32_t)(s % scale);
+        for (uint32_t d = scale / 10; d; d /= 10) {
+            *p++ = (char)('0' + (frac / d) % 10);
+        }
+    }
+    return p;
+}
+"""
+
+
+def gen_c_source(schema):
+    o = []
+    o.append("/**")
+    o.append(" * @file protocol_gen.c")
+    o.append(" * @brief Wire protocol codecs")
+    o.append(" *")
+    o.append(" * " + BANNER)
+    o.append(" */")
+    o.append("")
+    o.append('#include "protocol_gen.h"')
+    o.append("#include <stdbool.h>")
+    o.append("#include <string.h>")
+    o.append("")
+    # All frames share the separator today; the writers need it as a constant
+    seps = {fr.sep for fr in schema.frames}
+    if len(seps) > 1:
+        raise SchemaError("frames with different separators are not supported")
+    o.append("#define SEP_CHAR   '%s'" % (seps.pop() if seps else ","))
+    o.append("#define NUM_LIMIT  %s.0f" % ("9" * NUM_LIMIT_DIGITS))
+    o.append(C_HELPERS.rstrip("\n"))
+    o.append("")
+
+    for fr in schema.frames:
+        o.extend(gen_c_decoder(fr))
+        o.append("")
+        o.extend(gen_c_encoder(fr))
+        o.append("")
+    return "\n".join(o).rstrip("\n") + "\n"
+
+
+def gen_c_decoder(fr):
+    o = []
+    o.append("/* =============================================================================")
+    o.append(" * %s FRAME" % fr.name.upper())
+    o.append(" * ========================================================================== */")
+    o.append("")
+    o.append("int proto_%s_decode(const char *line, %s *out)" % (fr.name, fr.c_struct))
+    o.append("{")
+    o.append("    memset(out, 0, sizeof(*out));")
+    for f in fr.fields:
+        if f.absent is not None:
+            for v in f.values:
+                o.append("    " + c_assign(v, c_num(f.absent) if v.kind == "float" else f.absent))
+    o.append("")
+    o.append("    int fields = 0;")
+    o.append("    const char *p = line;")
+    o.append("    while (*p) {")
+    o.append("        const char *end = strchr(p, SEP_CHAR);")
+    o.append("        if (!end) end = p + strlen(p);")
+    o.append("        const char *colon = memchr(p, ':', (size_t)(end - p));")
+    o.append("")
+    o.append("        if (colon) {")
+    o.append("            const char *val = colon + 1;")
+    o.append("            switch (colon - p) {")
+
+    by_len = {}
+    for f in fr.fields:
+        by_len.setdefault(len(f.key), []).append(f)
+    for klen in sorted(by_len):
+        o.append("            case %d:" % klen)
+        for i, f in enumerate(by_len[klen]):
+            kw = "if" if i == 0 else "else if"
+            o.append("                %s (memcmp(p, %s, %d) == 0) {" % (kw, c_str(f.key), klen))
+            o.extend("                    " + l for l in gen_c_field_decode(f))
+            o.append("                }")
+        o.append("                break;")
+    o.append("            default:")
+    o.append("                break;")
+    o.append("            }")
+    o.append("        }")
+    o.append("")
+    o.append("        if (!*end) break;")
+    o.append("        p = end + 1;")
+    o.append("    }")
+    o.append("    return fields;")
+    o.append("}")
+    return o
+
+
+def gen_c_field_decode(f):
+    if len(f.values) == 1:
+        v = f.values[0]
+        if v.kind == "str":
+            return ["copy_text(out->%s, sizeof(out->%s), val, end);" % (v.c_member, v.c_member),
+                    "fields++;"]
+        if v.kind == "int":
+            return ["int32_t i = 0;",
+                    "scan_int(val, end, &i);",
+                    c_assign(v, "i"),
+                    "fields++;"]
+        return ["float f = 0.0f;",
+                "scan_num(val, end, &f);",
+                c_assign(v, "f"),
+                "fields++;"]
+
+    n = len(f.values)
+    o = ["float v[%d];" % n,
+         "if (scan_list(val, end, v, %d)) {" % n]
+    for i, v in enumerate(f.values):
+        o.append("    " + c_assign(v, "v[%d]" % i))
+    o.append("    fields++;")
+    o.append("}")
+    if f.invalid is not None:
+        o[-1] = "} else {"
+        for v in f.values:
+            o.append("    " + c_assign(v, c_num(f.invalid)))
+        o.append("}")
+    return o
+
+
+def gen_c_encoder(fr):
+    o = []
+    o.append("int proto_%s_encode(const %s *in, char *buf, size_t size)" % (fr.name, fr.c_struct))
+    o.append("{")
+    o.append("    if (size < PROTO_%s_MAX_LEN) return -1;" % fr.name.upper())
+    o.append("")
+    o.append("    char *p = buf;")
+    for i, f in enumerate(fr.fields):
+        prefix = ("" if i == 0 else fr.sep) + f.key + ":"
+        o.append("    memcpy(p, %s, %d); p += %d;" % (c_str(prefix), len(prefix), len(prefix)))
+        for j, v in enumerate(f.values):
+            if j:
+                o.append("    *p++ = '/';")
+            if v.kind == "str":
+                o.append("    p = put_text(p, in->%s, sizeof(in->%s) - 1);" % (v.c_member, v.c_member))
+            elif v.kind == "int":
+                o.append("    p = put_int(p, in->%s);" % v.c_member)
+            else:
+                o.append("    p = put_fixed(p, in->%s, %d);" % (v.c_member, v.decimals))
+    o.append("    *p++ = '\\n';")
+    o.append("    *p = '\\0';")
+    o.append("    return (int)(p - buf);")
+    o.append("}")
+    return o
+
+
+# =============================================================================
+# C# OUTPUT
+# =============================================================================
+
+CS_HELPERS = r"""
+    /// <summary>
+    /// ASCII scanners/writers shared by the generated codecs (same rules as
+    /// the firmware side: no culture, no allocation).
+    /// </summary>
+    internal static class ProtocolAscii
+    {
+        private static readonly int[] Scales = { 1, 10, 100, 1000, 10000 };
+
+        /// <summary>Index after the integer at [pos, end), or -1 if there are no digits.</summary>
+        public static int ScanInt(ReadOnlySpan<byte> s, int pos, int end, out int value)
+        {
+            bool neg = false;
+            if (pos < end && (s[pos] == '-' || s[pos] == '+')) { neg = s[pos] == '-'; pos++; }
+            int start = pos, v = 0;
+            while (pos < end && s[pos] >= '0' && s[pos] <= '9')
+            {
+                if (v < 100000000) v = v * 10 + (s[pos] - '0');
+                pos++;
+            }
+            value = neg ? -v : v;
+            return pos == start ? -1 : pos;
+        }
+
+        /// <summary>Index after the decimal number at [pos, end), or -1 if there are no digits.</summary>
+        public static int ScanNum(ReadOnlySpan<byte> s, int pos, int end, out float value)
+        {
+            bool neg = false;
+            if (pos < end && (s[pos] == '-' || s[pos] == '+')) { neg = s[pos] == '-'; pos++; }
+            int start = pos;
+            uint ip = 0, frac = 0, div = 1;
+            while (pos < end && s[pos] >= '0' && s[pos] <= '9')
+            {
+                if (ip < 1000000000u) ip = ip * 10 + (uint)(s[pos] - '0');
+                pos++;
+            }
+            if (pos < end && s[pos] == '.')
+            {
+                pos++;
+                while (pos < end && s[pos] >= '0' && s[pos] <= '9')
+                {
+                    if (div < 100000000u) { frac = frac * 10 + (uint)(s[pos] - '0'); div *= 10; }
+                    pos++;
+                }
+            }
+            float v = (float)ip + (float)frac / div;
+            value = neg ? -v : v;
+            bool noDigits = pos == start || (pos == start + 1 && s[start] == '.');
+            return noDigits ? -1 : pos;
+        }
+
+        /// <summary>n numbers separated by '/', filling exactly [pos, end).</summary>
+        public static bool ScanList(ReadOnlySpan<byte> s, int pos, int end, Span<float> values)
+        {
+            for (int i = 0; i < values.Length; i++)
+            {
+                pos = ScanNum(s, pos, end, out values[i]);
+                if (pos < 0) return false;
+                if (i < values.Length - 1)
+                {
+                    if (pos >= end || s[pos] != '/') return false;
+                    pos++;
+                }
+            }
+            return pos == end;
+        }
+
+        public static string ReadText(ReadOnlySpan<byte> s, int pos, int end, int max)
+        {
+            int len = Math.Min(end - pos, max);
+            var chars = new char[len];
+            for (int i = 0; i < len; i++) chars[i] = (char)s[pos + i];
+            return new string(chars);
+        }
+
+        public static void PutLiteral(Span<byte> d, ref int pos, string s)
+        {
+            for (int i = 0; i < s.Length; i++) d[pos++] = (byte)s[i];
+        }
+
+        /// <summary>Text truncated to max chars; separators/newlines become ' ', non-ASCII '?'.</summary>
+        public static void PutText(Span<byte> d, ref int pos, string s, int max, char sep)
+        {
+            if (s == null) return;
+            int n = Math.Min(s.Length, max);
+            for (int i = 0; i < n; i++)
+            {
+                char c = s[i];
+                d[pos++] = (c == sep || c == '\n' || c == '\r') ? (byte)' ' : (c > 127 ? (byte)'?' : (byte)c);
+            }
+        }
+
+        public static void PutUInt(Span<byte> d, ref int pos, ulong v)
+        {
+            int start = pos;
+            do { d[pos++] = (byte)('0' + (int)(v % 10)); v /= 10; } while (v != 0);
+            // Digits were written least significant first
+            for (int i = start, j = pos - 1; i < j; i++, j--)
+            {
+                byte t = d[i]; d[i] = d[j]; d[j] = t;
+            }
+        }
+
+        public static void PutInt(Span<byte> d, ref int pos, int v)
+        {
+            if (v < 0) { d[pos++] = (byte)'-'; PutUInt(d, ref pos, (ulong)(-(long)v)); }
+            else PutUInt(d, ref pos, (ulong)v);
+        }
+
+        /// <summary>
+        /// Fixed-point, rounded half away from zero. NaN is sent as -1 (N/A);
+        /// magnitude is clamped to NUM_LIMIT.
+        /// </summary>
+        public static void PutFixed(Span<byte> d, ref int pos, float v, int decimals)
+        {
+            if (float.IsNaN(v)) v = -1f;
+            if (v > NUM_LIMIT) v = NUM_LIMIT;
+            if (v < -NUM_LIMIT) v = -NUM_LIMIT;
+
+            int scale = Scales[decimals];
+            bool neg = v < 0;
+            ulong s = (ulong)Math.Round((neg ? -(double)v : v) * scale, MidpointRounding.AwayFromZero);
+            if (neg && s != 0) d[pos++] = (byte)'-';
+            PutUInt(d, ref pos, s / (ulong)scale);
+            if (decimals > 0)
+            {
+                d[pos++] = (byte)'.';
+                ulong frac = s % (ulong)scale;
+                for (int div = scale / 10; div > 0; div /= 10)
+                    d[pos++] = (byte)('0' + (int)(frac / (ulong)div % 10));
+            }
+        }
+    }
+"""
+
+
+def gen_cs(schema):
+    o = []
+    o.append("// <auto-generated>")
+    o.append("// " + BANNER)
+    o.append("// </auto-generated>")
+    o.append("using System;")
+    o.append("using System.Buffers.Binary;")
+    o.append("")
+    o.append("namespace PCMonitorClient")
+    o.append("{")
+
+    o.append("    /// <summary>Command / line tokens (scarab_protocol.def).</summary>")
+    o.append("    public static class ProtocolCommands")
+    o.append("    {")
+    for name, token in schema.commands:
+        o.append("        public const string %s = %s;" % (name, c_str(token)))
+    o.append("    }")
+    o.append("")
+
+    o.append("    /// <summary>Format constants (scarab_protocol.def).</summary>")
+    o.append("    public static class ProtocolConstants")
+    o.append("    {")
+    for name, value, comment in schema.consts:
+        cs_type = "uint" if value.lower().startswith("0x") else "int"
+        line = "        public const %s %s = %s;" % (cs_type, name, value)
+        o.append(line + ("  // " + comment if comment else ""))
+    o.append("    }")
+    o.append("")
+
+    for name, prefix, items in schema.enums:
+        o.append("    public enum %s : byte" % camel(name))
+        o.append("    {")
+        for iname, ival, comment in items:
+            o.append("        %s = %d,%s" % (iname, ival, ("  // " + comment) if comment else ""))
+        o.append("    }")
+        o.append("")
+
+    for name, size, fields in schema.structs:
+        o.extend(gen_cs_struct(name, size, fields))
+        o.append("")
+
+    for fr in schema.frames:
+        o.extend(gen_cs_frame(fr))
+        o.append("")
+
+    helpers = CS_HELPERS.strip("\n").replace("NUM_LIMIT", "%s" % ("9" * NUM_LIMIT_DIGITS) + "f")
+    # Keep the doc comment readable
+    helpers = helpers.replace("clamped to %sf." % ("9" * NUM_LIMIT_DIGITS), "clamped to %s." % ("9" * NUM_LIMIT_DIGITS))
+    o.append(helpers)
+    o.append("}")
+    return "\n".join(o) + "\n"
+
+
+def gen_cs_struct(name, size, fields):
+    cls = camel(name)
+    o = []
+    o.append("    /// <summary>%s_t - %d bytes, little-endian, packed.</summary>" % (name, size))
+    o.append("    public struct %s" % cls)
+    o.append("    {")
+    o.append("        public const int SIZE = %d;" % size)
+    o.append("")
+    for t, fname, comment in fields:
+        if comment:
+            o.append("        /// <summary>%s</summary>" % comment)
+        o.append("        public %s %s;" % (STRUCT_TYPES[t][1], camel(fname)))
+    o.append("")
+    o.append("        public void Write(Span<byte> dst)")
+    o.append("        {")
+    off = 0
+    for t, fname, _ in fields:
+        bits = STRUCT_TYPES[t][3]
+        if bits is None:
+            o.append("            dst[%d] = %s;" % (off, camel(fname)))
+        else:
+            o.append("            BinaryPrimitives.Write%sLittleEndian(dst.Slice(%d), %s);" % (bits, off, camel(fname)))
+        off += STRUCT_TYPES[t][2]
+    o.append("        }")
+    o.append("")
+    o.append("        public static %s Read(ReadOnlySpan<byte> src)" % cls)
+    o.append("        {")
+    o.append("            return new %s" % cls)
+    o.append("            {")
+    off = 0
+    items = []
+    for t, fname, _ in fields:
+        bits = STRUCT_TYPES[t][3]
+        if bits is None:
+            items.append("                %s = src[%d]" % (camel(fname), off))
+        else:
+            items.append("                %s = BinaryPrimitives.Read%sLittleEndian(src.Slice(%d))" % (camel(fname), bits, off))
+        off += STRUCT_TYPES[t][2]
+    o.append(",\n".join(items))
+    o.append("            };")
+    o.append("        }")
+    o.append("    }")
+    return o
+
+
+def gen_cs_frame(fr):
+    cls = camel(fr.name) + "Frame"
+    o = []
+    o.append("    /// <summary>")
+    o.append("    /// %s line codec: %s" % (fr.name, fr.sep.join(f.key + ":.." for f in fr.fields)))
+    o.append("    /// </summary>")
+    o.append("    public static class %s" % cls)
+    o.append("    {")
+    o.append("        /// <summary>Longest possible line incl. newline.</summary>")
+    o.append("        public const int MAX_LENGTH = %d;" % fr.max_len())
+    o.append("        public const int MIN_FIELDS = %d;" % fr.min_fields)
+    o.append("")
+    o.append("        /// <summary>")
+    o.append("        /// Writes the line (incl. '\\n') to dst, which must hold MAX_LENGTH")
+    o.append("        /// bytes. Returns the number of bytes written.")
+    o.append("        /// </summary>")
+    o.append("        public static int Encode(%s s, Span<byte> dst)" % fr.cs_class)
+    o.append("        {")
+    o.append("            if (dst.Length < MAX_LENGTH) throw new ArgumentException(\"Buffer smaller than MAX_LENGTH\", nameof(dst));")
+    o.append("")
+    o.append("            int pos = 0;")
+    for i, f in enumerate(fr.fields):
+        prefix = ("" if i == 0 else fr.sep) + f.key + ":"
+        o.append("            ProtocolAscii.PutLiteral(dst, ref pos, %s);" % c_str(prefix))
+        for j, v in enumerate(f.values):
+            if j:
+                o.append("            dst[pos++] = (byte)'/';")
+            if v.kind == "str":
+                o.append("            ProtocolAscii.PutText(dst, ref pos, s.%s, %d, '%s');" % (v.cs_prop, v.str_size - 1, fr.sep))
+            elif v.kind == "int":
+                o.append("            ProtocolAscii.PutInt(dst, ref pos, (int)s.%s);" % v.cs_prop)
+            else:
+                o.append("            ProtocolAscii.PutFixed(dst, ref pos, s.%s, %d);" % (v.cs_prop, v.decimals))
+    o.append("            dst[pos++] = (byte)'\\n';")
+    o.append("            return pos;")
+    o.append("        }")
+    o.append("")
+    o.append("        /// <summary>")
+    o.append("        /// Parses a line (without newline) into s, same rules as the firmware:")
+    o.append("        /// absent keys get their schema default. Returns the number of fields parsed.")
+    o.append("        /// </summary>")
+    o.append("        public static int Decode(ReadOnlySpan<byte> line, %s s)" % fr.cs_class)
+    o.append("        {")
+    for f in fr.fields:
+        for v in f.values:
+            if v.kind == "str":
+                o.append("            s.%s = \"\";" % v.cs_prop)
+            else:
+                o.append("            s.%s = %s;" % (v.cs_prop, f.absent if f.absent is not None else "0"))
+    o.append("")
+    multi = max((len(f.values) for f in fr.fields), default=1)
+    o.append("            Span<float> v = stackalloc float[%d];" % multi)
+    o.append("            int fields = 0;")
+    o.append("            int p = 0;")
+    o.append("            while (p < line.Length)")
+    o.append("            {")
+    o.append("                int end = line.Slice(p).IndexOf((byte)'%s');" % fr.sep)
+    o.append("                end = end < 0 ? line.Length : p + end;")
+    o.append("                int colon = line.Slice(p, end - p).IndexOf((byte)':');")
+    o.append("")
+    o.append("                if (colon > 0)")
+    o.append("                {")
+    o.append("                    var key = line.Slice(p, colon);")
+    o.append("                    int val = p + colon + 1;")
+    for i, f in enumerate(fr.fields):
+        kw = "if" if i == 0 else "else if"
+        o.append("                    %s (Is(key, %s))" % (kw, c_str(f.key)))
+        o.append("                    {")
+        o.extend("                        " + l for l in gen_cs_field_decode(f))
+        o.append("                    }")
+    o.append("                }")
+    o.append("")
+    o.append("                p = end + 1;")
+    o.append("            }")
+    o.append("            return fields;")
+    o.append("        }")
+    o.append("")
+    o.append("        private static bool Is(ReadOnlySpan<byte> key, string name)")
+    o.append("        {")
+    o.append("            if (key.Length != name.Length) return false;")
+    o.append("            for (int i = 0; i < name.Length; i++)")
+    o.append("                if (key[i] != name[i]) return false;")
+    o.append("            return true;")
+    o.append("        }")
+    o.append("    }")
+    return o
+
+
+def gen_cs_field_decode(f):
+    if len(f.values) == 1:
+        v = f.values[0]
+        if v.kind == "str":
+            return ["s.%s = ProtocolAscii.ReadText(line, val, end, %d);" % (v.cs_prop, v.str_size - 1),
+                    "fields++;"]
+        if v.kind == "int":
+            return ["ProtocolAscii.ScanInt(line, val, end, out int i);",
+                    "s.%s = i;" % v.cs_prop,
+                    "fields++;"]
+        return ["ProtocolAscii.ScanNum(line, val, end, out float f);",
+                "s.%s = f;" % v.cs_prop,
+                "fields++;"]
+
+    n = len(f.values)
+    o = ["if (ProtocolAscii.ScanList(line, val, end, v.Slice(0, %d)))" % n, "{"]
+    for i, v in enumerate(f.values):
+        cast = "(int)" if v.kind == "int" else ""
+        o.append("    s.%s = %sv[%d];" % (v.cs_prop, cast, i))
+    o.append("    fields++;")
+    o.append("}")
+    if f.invalid is not None:
+        o.append("else")
+        o.append("{")
+        for v in f.values:
+            o.append("    s.%s = %s;" % (v.cs_prop, f.invalid))
+        o.append("}")
+    return o
+
+
+# =============================================================================
+# MAIN
+# =============================================================================
+
+def main(argv):
+    check = "--check" in argv
+    try:
+        schema = parse_schema(SCHEMA)
+        outputs = {
+            OUT_H: gen_c_header(schema),
+            OUT_C: gen_c_source(schema),
+            OUT_CS: gen_cs(schema),
+        }
+    except SchemaError as ex:
+        print("protogen: %s" % ex, file=sys.stderr)
+        return 2
+
+    stale = []
+    for path, text in outputs.items():
+        old = None
+        if os.path.exists(path):
+            with open(path, encoding="utf-8", newline="") as f:
+                old = f.read()
+        if old == text:
+            continue
+        stale.append(os.path.relpath(path, ROOT))
+        if not check:
+            with open(path, "w", encoding="utf-8", newline="\n") as f:
+                f.write(text)
+
+    if check:
+        for path in stale:
+            print("protogen: %s is out of date" % path, file=sys.stderr)
+        return 1 if stale else 0
+
+    for path in stale:
+        print("protogen: wrote %s" % path)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))